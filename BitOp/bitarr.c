@@ -33,138 +33,309 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <memory.h>
-#include "bitsop.h"
 #include "bitarr.h"
 
-#define CHAR_SIZE   8
+#define BIT_WORD_ALL_ONES   (~(bit_word_t)0)
+#define BIT_WORDS(n_bits)   (((n_bits) + BIT_WORD_SIZE - 1) / BIT_WORD_SIZE)
+#define BIT_WORD_INDEX(index)   ((index) / BIT_WORD_SIZE)
+#define BIT_WORD_MASK(index)    ((bit_word_t)1 << ((index) % BIT_WORD_SIZE))
+
+/*Mask of bits [from, to) within a word, 0 <= from < to <= 64*/
+static inline bit_word_t
+bit_word_range_mask(unsigned int from, unsigned int to){
+
+    bit_word_t mask = BIT_WORD_ALL_ONES << from;
+    if(to < BIT_WORD_SIZE)
+        mask &= ~(BIT_WORD_ALL_ONES << to);
+    return mask;
+}
+
+static inline void
+update_summary(bit_array_t *bitarr, unsigned int word){
+
+    unsigned int summary_word = BIT_WORD_INDEX(word);
+
+    if(bitarr->array[word] == BIT_WORD_ALL_ONES){
+        bitarr->summary[summary_word] |= BIT_WORD_MASK(word);
+        return;
+    }
+
+    bitarr->summary[summary_word] &= ~BIT_WORD_MASK(word);
+    if(summary_word < bitarr->hint)
+        bitarr->hint = summary_word;
+}
+
+static inline char
+is_index_out_of_bounds(bit_array_t *bitarr, unsigned int index, 
+                       unsigned int n_bits){
+
+    if(!n_bits)
+        return 1;
+    if(index < bitarr->size && n_bits <= bitarr->size - index)
+        return 0;
+
+    printf("[%u,%u] is out of array bounds [%u,%u]\n", 
+            index, index + n_bits - 1, 0, bitarr->size -1);
+    return 1;
+}
 
 void
 init_bit_array(bit_array_t *bitarr, unsigned int n_bits){
 
-    unsigned int n_byte_blocks = n_bits/CHAR_SIZE;
+    unsigned int n_words = BIT_WORDS(n_bits),
+                 n_summary_words = BIT_WORDS(n_words);
+
+    if(bitarr->array && bitarr->n_words != n_words){
+        free(bitarr->array);
+        free(bitarr->summary);
+        bitarr->array = NULL;
+        bitarr->summary = NULL;
+    }
+
+    if(!bitarr->array){
+        bitarr->array = calloc(n_words ? n_words : 1, sizeof(bit_word_t));
+        bitarr->summary = calloc(n_summary_words ? n_summary_words : 1, sizeof(bit_word_t));
+    }
+    else{
+        memset(bitarr->array, 0, n_words * sizeof(bit_word_t));
+        memset(bitarr->summary, 0, n_summary_words * sizeof(bit_word_t));
+    }
 
-    if(n_bits % CHAR_SIZE)
-        n_byte_blocks++;
-    if(!bitarr->array)
-        bitarr->array = calloc(1, n_byte_blocks);
-    else
-        memset(bitarr->array, 0, n_byte_blocks);
     bitarr->size = n_bits;
-    bitarr->trail_bits = n_bits % CHAR_SIZE;
+    bitarr->n_words = n_words;
+    bitarr->n_summary_words = n_summary_words;
+    bitarr->n_set = 0;
+    bitarr->hint = 0;
+
+    /*Trailing bits of last word and of last summary word are never
+     * available*/
+    if(n_bits % BIT_WORD_SIZE)
+        bitarr->array[n_words - 1] = BIT_WORD_ALL_ONES << (n_bits % BIT_WORD_SIZE);
+    if(n_words % BIT_WORD_SIZE)
+        bitarr->summary[n_summary_words - 1] = BIT_WORD_ALL_ONES << (n_words % BIT_WORD_SIZE);
 }
 
 void
 set_bit(bit_array_t *bitarr, unsigned int index){
 
-    if(index >= bitarr->size){
-        printf("%u is out of array bounds [%u,%u]\n", 
-            index, 0, bitarr->size -1);
+    if(is_index_out_of_bounds(bitarr, index, 1))
         return;
-    }
 
-    unsigned byte_block = 0,
-             residual_bit = 0;
+    unsigned int word = BIT_WORD_INDEX(index);
 
-    byte_block = index / CHAR_SIZE;
-    residual_bit = index % CHAR_SIZE;
-
-#if 0    
-    assert(bitarr->size/CHAR_SIZE == byte_block && 
-        bitarr->trail_bits >= residual_bit);
-#endif
+    if(bitarr->array[word] & BIT_WORD_MASK(index))
+        return;
 
-    char *ptr = bitarr->array + byte_block;
-    SET_BIT((*ptr), (CHAR_SIZE - residual_bit));
+    bitarr->array[word] |= BIT_WORD_MASK(index);
+    bitarr->n_set++;
+    update_summary(bitarr, word);
 }
 
 void
 unset_bit(bit_array_t *bitarr, unsigned int index){
 
-    if(index >= bitarr->size){
-        printf("%u is out of array bounds [%u,%u]\n", 
-            index, 0, bitarr->size -1);
+    if(is_index_out_of_bounds(bitarr, index, 1))
         return;
-    }
-
-    unsigned byte_block = 0,
-             residual_bit = 0;
 
-    byte_block = index / CHAR_SIZE;
-    residual_bit = index % CHAR_SIZE;
+    unsigned int word = BIT_WORD_INDEX(index);
 
-#if 0
-    assert(bitarr->size/CHAR_SIZE == byte_block && 
-        bitarr->trail_bits >= residual_bit);
-#endif
+    if(!(bitarr->array[word] & BIT_WORD_MASK(index)))
+        return;
 
-    char *ptr = bitarr->array + byte_block;
-    UNSET_BIT((*ptr), (CHAR_SIZE - residual_bit));
+    bitarr->array[word] &= ~BIT_WORD_MASK(index);
+    bitarr->n_set--;
+    update_summary(bitarr, word);
 }
 
 char
 is_bit_set(bit_array_t *bitarr, unsigned int index){
 
-    
-    if(index >= bitarr->size){
-        printf("%u is out of array bounds [%u,%u]\n", 
-            index, 0, bitarr->size -1);
+    if(is_index_out_of_bounds(bitarr, index, 1))
         return 0;
-    }
-
-    unsigned byte_block = 0,
-             residual_bit = 0;
 
-    byte_block = index / CHAR_SIZE;
-    residual_bit = index % CHAR_SIZE;
-    
-#if 0
-    assert(bitarr->size/CHAR_SIZE == byte_block && 
-        bitarr->trail_bits >= residual_bit);
-#endif
-    char *ptr = bitarr->array + byte_block;
-    return (char)(IS_BIT_SET((*ptr), (CHAR_SIZE - residual_bit)));
+    return (bitarr->array[BIT_WORD_INDEX(index)] & BIT_WORD_MASK(index)) ? 1 : 0;
 }
 
 unsigned int
 get_next_available_bit(bit_array_t *bitarr){
 
-    unsigned int i = 0;
-    for(; i < bitarr->size; i++){
-        if(is_bit_set(bitarr, i))
+    unsigned int summary_word = bitarr->hint,
+                 word = 0;
+
+    for(; summary_word < bitarr->n_summary_words; summary_word++){
+
+        if(bitarr->summary[summary_word] == BIT_WORD_ALL_ONES)
             continue;
-        return i;
+
+        bitarr->hint = summary_word;
+        word = summary_word * BIT_WORD_SIZE + 
+                __builtin_ctzll(~bitarr->summary[summary_word]);
+        return word * BIT_WORD_SIZE + __builtin_ctzll(~bitarr->array[word]);
     }
-    return 0xFFFFFFFF;
+
+    bitarr->hint = bitarr->n_summary_words;
+    return BIT_ARRAY_NO_BIT;
 }
 
-void
-print_bit_array(bit_array_t *bitarr){
+/*Returns size if there is no unset bit at or after index*/
+static unsigned int
+find_next_unset_bit(bit_array_t *bitarr, unsigned int index){
 
-    unsigned int i = 0, index = 0,
-                 byte_blocks = 0,
-                 residual_bits = 0;
+    unsigned int word = BIT_WORD_INDEX(index),
+                 summary_word = 0;
+    bit_word_t bits = 0;
 
-    int j = 0;
+    if(index >= bitarr->size)
+        return bitarr->size;
 
-    byte_blocks = bitarr->size / CHAR_SIZE;
-    residual_bits = bitarr->size % CHAR_SIZE;
-    //assert(bitarr->trail_bits >= residual_bit);
-    char *ptr = bitarr->array;
-    char byte = 0;
+    bits = ~bitarr->array[word] & (BIT_WORD_ALL_ONES << (index % BIT_WORD_SIZE));
+    if(bits)
+        return word * BIT_WORD_SIZE + __builtin_ctzll(bits);
 
-    for( ; i < byte_blocks; i++){
-        byte = *(ptr+i);
-        for(j = 7; j >= 0; j--, index++){
-            printf("[%u] : %c\n", index, IS_BIT_SET(byte, j) ? '1' : '0');
+    /*Skip full words using summary*/
+    for(word++; word < bitarr->n_words; ){
+        summary_word = BIT_WORD_INDEX(word);
+        bits = ~bitarr->summary[summary_word] & (BIT_WORD_ALL_ONES << (word % BIT_WORD_SIZE));
+        if(!bits){
+            word = (summary_word + 1) * BIT_WORD_SIZE;
+            continue;
         }
+        word = summary_word * BIT_WORD_SIZE + __builtin_ctzll(bits);
+        return word * BIT_WORD_SIZE + __builtin_ctzll(~bitarr->array[word]);
+    }
+    return bitarr->size;
+}
+
+/*Returns size if there is no set bit at or after index*/
+static unsigned int
+find_next_set_bit(bit_array_t *bitarr, unsigned int index){
+
+    unsigned int word = BIT_WORD_INDEX(index),
+                 pos = bitarr->size;
+    bit_word_t bits = 0;
+
+    if(index >= bitarr->size)
+        return bitarr->size;
+
+    bits = bitarr->array[word] & (BIT_WORD_ALL_ONES << (index % BIT_WORD_SIZE));
+    while(!bits && ++word < bitarr->n_words)
+        bits = bitarr->array[word];
+
+    if(bits)
+        pos = word * BIT_WORD_SIZE + __builtin_ctzll(bits);
+    return pos < bitarr->size ? pos : bitarr->size;
+}
+
+void
+free_bit_array(bit_array_t *bitarr){
+
+    free(bitarr->array);
+    free(bitarr->summary);
+    memset(bitarr, 0, sizeof(bit_array_t));
+}
+
+/*Bits below min(old size, n_bits) retain their state*/
+void
+resize_bit_array(bit_array_t *bitarr, unsigned int n_bits){
+
+    bit_array_t new_bitarr;
+    unsigned int start = 0, end = 0;
+
+    memset(&new_bitarr, 0, sizeof(bit_array_t));
+    init_bit_array(&new_bitarr, n_bits);
+
+    start = find_next_set_bit(bitarr, 0);
+    while(start < bitarr->size && start < n_bits){
+        end = find_next_unset_bit(bitarr, start);
+        if(end > n_bits)
+            end = n_bits;
+        set_bit_range(&new_bitarr, start, end - start);
+        start = find_next_set_bit(bitarr, end);
+    }
+
+    free_bit_array(bitarr);
+    *bitarr = new_bitarr;
+}
+
+unsigned int
+get_next_available_bit_range(bit_array_t *bitarr, unsigned int n_bits){
+
+    unsigned int start = 0, end = 0;
+
+    if(!n_bits)
+        return BIT_ARRAY_NO_BIT;
+
+    start = get_next_available_bit(bitarr);
+    while(start < bitarr->size){
+        end = find_next_set_bit(bitarr, start);
+        if(end - start >= n_bits)
+            return start;
+        start = find_next_unset_bit(bitarr, end);
+    }
+    return BIT_ARRAY_NO_BIT;
+}
+
+void
+set_bit_range(bit_array_t *bitarr, unsigned int index, unsigned int n_bits){
+
+    unsigned int word = 0, 
+                 from = 0, to = 0, 
+                 end = index + n_bits;
+    bit_word_t mask = 0;
+
+    if(is_index_out_of_bounds(bitarr, index, n_bits))
+        return;
+
+    for(word = BIT_WORD_INDEX(index); word * BIT_WORD_SIZE < end; word++){
+        from = word == BIT_WORD_INDEX(index) ? index % BIT_WORD_SIZE : 0;
+        to = end - word * BIT_WORD_SIZE;
+        if(to > BIT_WORD_SIZE) to = BIT_WORD_SIZE;
+        mask = bit_word_range_mask(from, to);
+        bitarr->n_set += __builtin_popcountll(mask & ~bitarr->array[word]);
+        bitarr->array[word] |= mask;
+        update_summary(bitarr, word);
     }
+}
 
-    if(!residual_bits)
+void
+unset_bit_range(bit_array_t *bitarr, unsigned int index, unsigned int n_bits){
+
+    unsigned int word = 0, 
+                 from = 0, to = 0, 
+                 end = index + n_bits;
+    bit_word_t mask = 0;
+
+    if(is_index_out_of_bounds(bitarr, index, n_bits))
         return;
 
-    byte = *(ptr+i);
-    for(j = 7; j >= CHAR_SIZE - residual_bits; j--, index++){
-        printf("[%u] : %c\n", index, IS_BIT_SET(byte, j) ? '1' : '0');
+    for(word = BIT_WORD_INDEX(index); word * BIT_WORD_SIZE < end; word++){
+        from = word == BIT_WORD_INDEX(index) ? index % BIT_WORD_SIZE : 0;
+        to = end - word * BIT_WORD_SIZE;
+        if(to > BIT_WORD_SIZE) to = BIT_WORD_SIZE;
+        mask = bit_word_range_mask(from, to);
+        bitarr->n_set -= __builtin_popcountll(mask & bitarr->array[word]);
+        bitarr->array[word] &= ~mask;
+        update_summary(bitarr, word);
+    }
+}
+
+char
+is_bit_range_free(bit_array_t *bitarr, unsigned int index, unsigned int n_bits){
+
+    if(is_index_out_of_bounds(bitarr, index, n_bits))
+        return 0;
+
+    return find_next_set_bit(bitarr, index) >= index + n_bits ? 1 : 0;
+}
+
+void
+print_bit_array(bit_array_t *bitarr){
+
+    unsigned int i = 0;
+
+    for( ; i < bitarr->size; i++){
+        printf("[%u] : %c\n", i, 
+            (bitarr->array[BIT_WORD_INDEX(i)] & BIT_WORD_MASK(i)) ? '1' : '0');
     }
 }
 
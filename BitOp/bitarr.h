@@ -33,10 +33,22 @@
 #ifndef __BIT_ARRAY__
 #define __BIT_ARRAY__
 
+/*Bits are kept in 64 bit words, bit i is bit (i % 64) of word i / 64.
+ * Summary bitmap has one bit per word, set if the word is full, so that a
+ * free bit is located by skipping 64 full words at a time*/
+typedef unsigned long long bit_word_t;
+
+#define BIT_WORD_SIZE   64
+#define BIT_ARRAY_NO_BIT    0xFFFFFFFF
+
 typedef struct _bit_array{
-    unsigned int size;
-    char *array;
-    char trail_bits;
+    unsigned int size;              /*No of usable bits*/
+    unsigned int n_words;
+    unsigned int n_summary_words;
+    unsigned int n_set;             /*No of usable bits set*/
+    unsigned int hint;              /*Summary words below hint are all full*/
+    bit_word_t *array;
+    bit_word_t *summary;
 } bit_array_t;
 
 void 
@@ -51,7 +63,32 @@ unset_bit(bit_array_t *bitarr, unsigned int index);
 char
 is_bit_set(bit_array_t *bitarr, unsigned int index);
 
+void
+free_bit_array(bit_array_t *bitarr);
+
+/*Bits below min(old size, n_bits) retain their state*/
+void
+resize_bit_array(bit_array_t *bitarr, unsigned int n_bits);
+
+/*Returns the lowest unset bit, BIT_ARRAY_NO_BIT if array is full*/
 unsigned int
 get_next_available_bit(bit_array_t *bitarr);
 
+/*Range operations, [index, index + n_bits - 1]*/
+void
+set_bit_range(bit_array_t *bitarr, unsigned int index, unsigned int n_bits);
+
+void
+unset_bit_range(bit_array_t *bitarr, unsigned int index, unsigned int n_bits);
+
+char
+is_bit_range_free(bit_array_t *bitarr, unsigned int index, unsigned int n_bits);
+
+/*Returns the lowest index of n_bits contiguous unset bits, 
+ * BIT_ARRAY_NO_BIT if there is no such run*/
+unsigned int
+get_next_available_bit_range(bit_array_t *bitarr, unsigned int n_bits);
+
+#define BIT_ARRAY_SET_COUNT(bitarr)    ((bitarr)->n_set)
+
 #endif /* __BIT_ARRAY__ */
@@ -0,0 +1,172 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  bitarrtest.c
+ *
+ *    Description:  Test driver of Bit Array.
+ *                  gcc -g BitOp/bitarrtest.c BitOp/bitarr.c -o bitarrtest
+ *
+ *        This file is part of the BIT Array distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+#include "bitarr.h"
+
+/*Bits covered by one summary word*/
+#define SUMMARY_WORD_BITS   (BIT_WORD_SIZE * BIT_WORD_SIZE)
+
+/*Sets bits one at a time the way label allocators do, and checks that
+ * allocation stops at size, not at the end of the last word*/
+static void
+test_odd_sizes(){
+
+    unsigned int sizes[] = {1, 15, 63, 65, 127, 200, SUMMARY_WORD_BITS + 1};
+    unsigned int i = 0, j = 0, bit = 0;
+    bit_array_t arr;
+
+    for(i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++){
+
+        memset(&arr, 0, sizeof(bit_array_t));
+        init_bit_array(&arr, sizes[i]);
+
+        for(j = 0; j < sizes[i]; j++){
+            bit = get_next_available_bit(&arr);
+            assert(bit == j);
+            set_bit(&arr, bit);
+        }
+        assert(BIT_ARRAY_SET_COUNT(&arr) == sizes[i]);
+        assert(get_next_available_bit(&arr) == BIT_ARRAY_NO_BIT);
+        assert(get_next_available_bit_range(&arr, 1) == BIT_ARRAY_NO_BIT);
+        free_bit_array(&arr);
+    }
+    printf("%s passed\n", __FUNCTION__);
+}
+
+/*Freed bit is handed out again even if it is below the hint*/
+static void
+test_unset_reuse(){
+
+    bit_array_t arr;
+
+    memset(&arr, 0, sizeof(bit_array_t));
+    init_bit_array(&arr, SUMMARY_WORD_BITS * 2 + 37);
+
+    set_bit_range(&arr, 0, SUMMARY_WORD_BITS * 2);
+    assert(get_next_available_bit(&arr) == SUMMARY_WORD_BITS * 2);
+
+    unset_bit(&arr, 70);
+    assert(!is_bit_set(&arr, 70));
+    assert(get_next_available_bit(&arr) == 70);
+    set_bit(&arr, 70);
+
+    unset_bit(&arr, SUMMARY_WORD_BITS + 5);
+    unset_bit(&arr, 3);
+    assert(get_next_available_bit(&arr) == 3);
+    set_bit(&arr, 3);
+    assert(get_next_available_bit(&arr) == SUMMARY_WORD_BITS + 5);
+
+    /*Unsetting an unset bit does not change the count*/
+    unset_bit(&arr, SUMMARY_WORD_BITS + 5);
+    assert(BIT_ARRAY_SET_COUNT(&arr) == SUMMARY_WORD_BITS * 2 - 1);
+    free_bit_array(&arr);
+    printf("%s passed\n", __FUNCTION__);
+}
+
+static void
+test_resize(){
+
+    bit_array_t arr;
+
+    memset(&arr, 0, sizeof(bit_array_t));
+    init_bit_array(&arr, 100);
+    set_bit_range(&arr, 10, 80);
+    set_bit(&arr, 99);
+
+    /*Shrink into the middle of a run, bits past new size are dropped*/
+    resize_bit_array(&arr, 50);
+    assert(arr.size == 50);
+    assert(BIT_ARRAY_SET_COUNT(&arr) == 40);
+    assert(is_bit_set(&arr, 10) && is_bit_set(&arr, 49));
+    assert(get_next_available_bit(&arr) == 0);
+    set_bit_range(&arr, 0, 10);
+    assert(get_next_available_bit(&arr) == BIT_ARRAY_NO_BIT);
+
+    /*Grow across a summary word, old bits retained and new ones free*/
+    resize_bit_array(&arr, SUMMARY_WORD_BITS + 300);
+    assert(arr.size == SUMMARY_WORD_BITS + 300);
+    assert(BIT_ARRAY_SET_COUNT(&arr) == 50);
+    assert(is_bit_set(&arr, 0) && is_bit_set(&arr, 49));
+    assert(!is_bit_set(&arr, 50));
+    assert(get_next_available_bit(&arr) == 50);
+    assert(is_bit_range_free(&arr, 50, SUMMARY_WORD_BITS + 250));
+
+    set_bit(&arr, SUMMARY_WORD_BITS + 299);
+    resize_bit_array(&arr, SUMMARY_WORD_BITS + 300);
+    assert(is_bit_set(&arr, SUMMARY_WORD_BITS + 299));
+    assert(BIT_ARRAY_SET_COUNT(&arr) == 51);
+    free_bit_array(&arr);
+    printf("%s passed\n", __FUNCTION__);
+}
+
+static void
+test_ranges(){
+
+    bit_array_t arr;
+
+    memset(&arr, 0, sizeof(bit_array_t));
+    init_bit_array(&arr, SUMMARY_WORD_BITS * 2 + 100);
+
+    /*Run crossing a word boundary*/
+    set_bit_range(&arr, 0, 60);
+    set_bit(&arr, 70);
+    assert(get_next_available_bit_range(&arr, 10) == 60);
+    assert(get_next_available_bit_range(&arr, 11) == 71);
+    assert(is_bit_range_free(&arr, 71, 100));
+    assert(!is_bit_range_free(&arr, 60, 11));
+
+    /*Only run long enough starts in one summary word and ends in the next*/
+    unset_bit_range(&arr, 0, 71);
+    set_bit_range(&arr, 0, SUMMARY_WORD_BITS - 20);
+    set_bit_range(&arr, SUMMARY_WORD_BITS + 30, SUMMARY_WORD_BITS - 30);
+    assert(BIT_ARRAY_SET_COUNT(&arr) == SUMMARY_WORD_BITS * 2 - 50);
+    assert(get_next_available_bit_range(&arr, 50) == SUMMARY_WORD_BITS - 20);
+    assert(get_next_available_bit_range(&arr, 51) == SUMMARY_WORD_BITS * 2);
+    assert(get_next_available_bit_range(&arr, 100) == SUMMARY_WORD_BITS * 2);
+
+    /*Run may end at the last usable bit but not go past it*/
+    assert(get_next_available_bit_range(&arr, 101) == BIT_ARRAY_NO_BIT);
+    set_bit_range(&arr, SUMMARY_WORD_BITS - 20, 50);
+    assert(get_next_available_bit_range(&arr, 1) == SUMMARY_WORD_BITS * 2);
+    set_bit_range(&arr, SUMMARY_WORD_BITS * 2, 100);
+    assert(get_next_available_bit_range(&arr, 1) == BIT_ARRAY_NO_BIT);
+    assert(BIT_ARRAY_SET_COUNT(&arr) == arr.size);
+
+    assert(get_next_available_bit_range(&arr, 0) == BIT_ARRAY_NO_BIT);
+    free_bit_array(&arr);
+    printf("%s passed\n", __FUNCTION__);
+}
+
+int
+main(int argc, char **argv){
+
+    test_odd_sizes();
+    test_unset_reuse();
+    test_resize();
+    test_ranges();
+    return 0;
+}
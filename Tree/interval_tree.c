@@ -0,0 +1,220 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  interval_tree.c
+ *
+ *    Description:  This file implements the intrusive interval tree.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "interval_tree.h"
+
+static inline int
+itree_height(itree_node_t *itree_node){
+
+    return itree_node ? itree_node->height : 0;
+}
+
+static void
+itree_update(itree_node_t *itree_node){
+
+    int lh = itree_height(itree_node->left),
+        rh = itree_height(itree_node->right);
+
+    itree_node->height = (lh > rh ? lh : rh) + 1;
+    itree_node->max_high = itree_node->high;
+
+    if(itree_node->left && itree_node->left->max_high > itree_node->max_high)
+        itree_node->max_high = itree_node->left->max_high;
+    if(itree_node->right && itree_node->right->max_high > itree_node->max_high)
+        itree_node->max_high = itree_node->right->max_high;
+}
+
+/*Total order, duplicate intervals are ordered by address*/
+static int
+itree_compare(itree_node_t *itree_node1, itree_node_t *itree_node2){
+
+    if(itree_node1->low != itree_node2->low)
+        return itree_node1->low < itree_node2->low ? -1 : 1;
+    if(itree_node1->high != itree_node2->high)
+        return itree_node1->high < itree_node2->high ? -1 : 1;
+    if(itree_node1 == itree_node2)
+        return 0;
+    return (uintptr_t)itree_node1 < (uintptr_t)itree_node2 ? -1 : 1;
+}
+
+static itree_node_t *
+itree_rotate_right(itree_node_t *itree_node){
+
+    itree_node_t *left = itree_node->left;
+
+    itree_node->left = left->right;
+    left->right = itree_node;
+    itree_update(itree_node);
+    itree_update(left);
+    return left;
+}
+
+static itree_node_t *
+itree_rotate_left(itree_node_t *itree_node){
+
+    itree_node_t *right = itree_node->right;
+
+    itree_node->right = right->left;
+    right->left = itree_node;
+    itree_update(itree_node);
+    itree_update(right);
+    return right;
+}
+
+static itree_node_t *
+itree_balance(itree_node_t *itree_node){
+
+    int balance = 0;
+
+    itree_update(itree_node);
+    balance = itree_height(itree_node->left) - itree_height(itree_node->right);
+
+    if(balance > 1){
+        if(itree_height(itree_node->left->left) < itree_height(itree_node->left->right))
+            itree_node->left = itree_rotate_left(itree_node->left);
+        return itree_rotate_right(itree_node);
+    }
+
+    if(balance < -1){
+        if(itree_height(itree_node->right->right) < itree_height(itree_node->right->left))
+            itree_node->right = itree_rotate_right(itree_node->right);
+        return itree_rotate_left(itree_node);
+    }
+    return itree_node;
+}
+
+static itree_node_t *
+itree_insert_internal(itree_node_t *root, itree_node_t *itree_node){
+
+    if(!root)
+        return itree_node;
+
+    if(itree_compare(itree_node, root) < 0)
+        root->left = itree_insert_internal(root->left, itree_node);
+    else
+        root->right = itree_insert_internal(root->right, itree_node);
+    return itree_balance(root);
+}
+
+static itree_node_t *
+itree_remove_min(itree_node_t *root, itree_node_t **min){
+
+    if(!root->left){
+        *min = root;
+        return root->right;
+    }
+    root->left = itree_remove_min(root->left, min);
+    return itree_balance(root);
+}
+
+static itree_node_t *
+itree_remove_internal(itree_node_t *root, itree_node_t *itree_node){
+
+    int rc = 0;
+    itree_node_t *min = NULL;
+
+    assert(root);
+    rc = itree_compare(itree_node, root);
+
+    if(rc < 0){
+        root->left = itree_remove_internal(root->left, itree_node);
+        return itree_balance(root);
+    }
+    if(rc > 0){
+        root->right = itree_remove_internal(root->right, itree_node);
+        return itree_balance(root);
+    }
+
+    if(!root->left)
+        return root->right;
+    if(!root->right)
+        return root->left;
+
+    /*Replace by in order successor*/
+    root->right = itree_remove_min(root->right, &min);
+    min->left = root->left;
+    min->right = root->right;
+    return itree_balance(min);
+}
+
+void
+itree_init(itree_t *itree){
+
+    itree->root = NULL;
+    itree->count = 0;
+}
+
+void
+itree_insert(itree_t *itree, itree_node_t *itree_node){
+
+    assert(itree_node->low <= itree_node->high);
+    itree_node->left = NULL;
+    itree_node->right = NULL;
+    itree_node->height = 1;
+    itree_node->max_high = itree_node->high;
+    itree->root = itree_insert_internal(itree->root, itree_node);
+    itree->count++;
+}
+
+void
+itree_remove(itree_t *itree, itree_node_t *itree_node){
+
+    itree->root = itree_remove_internal(itree->root, itree_node);
+    itree_node->left = NULL;
+    itree_node->right = NULL;
+    itree->count--;
+}
+
+static unsigned int
+itree_overlap_walk_internal(itree_node_t *itree_node, unsigned int low, 
+                            unsigned int high, itree_walk_fn fn, void *arg){
+
+    unsigned int count = 0;
+
+    /*Nothing in this subtree reaches low*/
+    if(!itree_node || itree_node->max_high < low)
+        return 0;
+
+    count += itree_overlap_walk_internal(itree_node->left, low, high, fn, arg);
+
+    /*Everything in right subtree starts after high*/
+    if(itree_node->low > high)
+        return count;
+
+    if(itree_node->high >= low){
+        fn(itree_node, arg);
+        count++;
+    }
+
+    return count + itree_overlap_walk_internal(itree_node->right, low, high, fn, arg);
+}
+
+unsigned int
+itree_overlap_walk(itree_t *itree, unsigned int low, unsigned int high,
+                   itree_walk_fn fn, void *arg){
+
+    return itree_overlap_walk_internal(itree->root, low, high, fn, arg);
+}
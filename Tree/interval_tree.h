@@ -0,0 +1,72 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  interval_tree.h
+ *
+ *    Description:  Intrusive interval tree. AVL tree ordered by interval low end, every
+ *                  node is augmented with the max high end of its subtree so that all
+ *                  intervals overlapping a query range are found in O(log n + k).
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __INTERVAL_TREE__
+#define __INTERVAL_TREE__
+
+/*Embed this in the structure to be indexed, caller sets low and high
+ * before insertion and must not change them while node is in the tree*/
+typedef struct itree_node_{
+
+    unsigned int low;
+    unsigned int high;
+    unsigned int max_high;      /*Max high end in the subtree rooted here*/
+    int height;
+    struct itree_node_ *left;
+    struct itree_node_ *right;
+} itree_node_t;
+
+typedef struct itree_{
+
+    itree_node_t *root;
+    unsigned int count;
+} itree_t;
+
+/*Must not insert into or remove from the tree being walked*/
+typedef void (*itree_walk_fn)(itree_node_t *itree_node, void *arg);
+
+void
+itree_init(itree_t *itree);
+
+/*Duplicate intervals are allowed*/
+void
+itree_insert(itree_t *itree, itree_node_t *itree_node);
+
+void
+itree_remove(itree_t *itree, itree_node_t *itree_node);
+
+/*Invoke fn on every interval overlapping [low, high], in increasing
+ * order of low end. Returns the no of intervals visited*/
+unsigned int
+itree_overlap_walk(itree_t *itree, unsigned int low, unsigned int high,
+                   itree_walk_fn fn, void *arg);
+
+#define ITREE_NODE_TO_STRUCT(fn_name, structure_name, field_name)                   \
+    static inline structure_name * fn_name(itree_node_t *itree_node_ptr){            \
+        return (structure_name *)((char *)(itree_node_ptr) -                         \
+            (char *)&(((structure_name *)0)->field_name));                          \
+    }
+
+#endif /* __INTERVAL_TREE__ */
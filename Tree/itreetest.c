@@ -0,0 +1,204 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  itreetest.c
+ *
+ *    Description:  Test driver of the interval tree.
+ *                  gcc -g Tree/itreetest.c Tree/interval_tree.c -o itreetest
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+#include "interval_tree.h"
+
+#define N_RANGES    500
+
+typedef struct range_{
+
+    int id;
+    int in_tree;
+    itree_node_t itree_node;
+} range_t;
+
+ITREE_NODE_TO_STRUCT(itree_node_to_range, range_t, itree_node);
+
+typedef struct walk_result_{
+
+    unsigned int count;
+    unsigned int last_low;
+    int visited[N_RANGES];
+} walk_result_t;
+
+static void
+collect_range(itree_node_t *itree_node, void *arg){
+
+    walk_result_t *result = arg;
+    range_t *range = itree_node_to_range(itree_node);
+
+    /*Walk is in increasing order of low end*/
+    assert(!result->count || itree_node->low >= result->last_low);
+    result->last_low = itree_node->low;
+    result->visited[range->id]++;
+    result->count++;
+}
+
+/*Checks AVL balance and max_high of every subtree, returns its height*/
+static int
+check_subtree(itree_node_t *itree_node, unsigned int *count){
+
+    int lh = 0, rh = 0;
+    unsigned int max_high = 0;
+
+    if(!itree_node)
+        return 0;
+
+    lh = check_subtree(itree_node->left, count);
+    rh = check_subtree(itree_node->right, count);
+    assert(lh - rh <= 1 && rh - lh <= 1);
+    assert(itree_node->height == (lh > rh ? lh : rh) + 1);
+
+    if(itree_node->left)
+        assert(itree_node->left->low <= itree_node->low);
+    if(itree_node->right)
+        assert(itree_node->right->low >= itree_node->low);
+
+    max_high = itree_node->high;
+    if(itree_node->left && itree_node->left->max_high > max_high)
+        max_high = itree_node->left->max_high;
+    if(itree_node->right && itree_node->right->max_high > max_high)
+        max_high = itree_node->right->max_high;
+    assert(itree_node->max_high == max_high);
+
+    (*count)++;
+    return itree_node->height;
+}
+
+static void
+check_tree(itree_t *itree){
+
+    unsigned int count = 0;
+
+    check_subtree(itree->root, &count);
+    assert(count == itree->count);
+}
+
+/*Compares an overlap walk against a scan of all ranges*/
+static void
+check_overlap_walk(itree_t *itree, range_t *ranges, unsigned int low, unsigned int high){
+
+    int i = 0;
+    unsigned int n_expected = 0;
+    walk_result_t result;
+
+    memset(&result, 0, sizeof(walk_result_t));
+    assert(itree_overlap_walk(itree, low, high, collect_range, &result) == result.count);
+
+    for(i = 0; i < N_RANGES; i++){
+        if(ranges[i].in_tree &&
+            ranges[i].itree_node.low <= high && low <= ranges[i].itree_node.high){
+            assert(result.visited[i] == 1);
+            n_expected++;
+            continue;
+        }
+        assert(result.visited[i] == 0);
+    }
+    assert(result.count == n_expected);
+}
+
+static unsigned int rand_state = 12345;
+
+static unsigned int
+next_rand(){
+
+    rand_state = rand_state * 1103515245 + 12345;
+    return (rand_state >> 8) & 0xFFFFF;
+}
+
+int
+main(int argc, char **argv){
+
+    int i = 0;
+    unsigned int low = 0;
+    itree_t itree;
+    range_t ranges[N_RANGES];
+
+    itree_init(&itree);
+    memset(ranges, 0, sizeof(ranges));
+    check_overlap_walk(&itree, ranges, 0, 0xFFFFFFFF);
+
+    /*Mix of point, short and wide ranges, with duplicates*/
+    for(i = 0; i < N_RANGES; i++){
+        ranges[i].id = i;
+        if(i % 50 == 49){
+            ranges[i].itree_node.low  = ranges[i - 1].itree_node.low;
+            ranges[i].itree_node.high = ranges[i - 1].itree_node.high;
+        }
+        else{
+            low = next_rand();
+            ranges[i].itree_node.low  = low;
+            ranges[i].itree_node.high = low + (i % 7 == 0 ? next_rand() : i % 3 ? next_rand() % 64 : 0);
+        }
+        itree_insert(&itree, &ranges[i].itree_node);
+        ranges[i].in_tree = 1;
+    }
+    assert(itree.count == N_RANGES);
+    check_tree(&itree);
+    printf("insert passed\n");
+
+    for(i = 0; i < 200; i++){
+        low = next_rand();
+        check_overlap_walk(&itree, ranges, low, low + (i % 2 ? next_rand() % 1000 : 0));
+    }
+    check_overlap_walk(&itree, ranges, 0, 0xFFFFFFFF);
+    check_overlap_walk(&itree, ranges, ranges[10].itree_node.high, ranges[10].itree_node.high);
+    printf("overlap walk passed\n");
+
+    /*Remove every third range, including one of each duplicate pair*/
+    for(i = 0; i < N_RANGES; i += 3){
+        itree_remove(&itree, &ranges[i].itree_node);
+        ranges[i].in_tree = 0;
+        if(i % 30 == 0)
+            check_tree(&itree);
+    }
+    check_tree(&itree);
+    for(i = 0; i < 200; i++){
+        low = next_rand();
+        check_overlap_walk(&itree, ranges, low, low + next_rand() % 5000);
+    }
+    check_overlap_walk(&itree, ranges, 0, 0xFFFFFFFF);
+
+    /*Reinsert some, then drain the tree*/
+    for(i = 0; i < N_RANGES; i += 6){
+        itree_insert(&itree, &ranges[i].itree_node);
+        ranges[i].in_tree = 1;
+    }
+    check_tree(&itree);
+    check_overlap_walk(&itree, ranges, 0, 0xFFFFFFFF);
+
+    for(i = N_RANGES - 1; i >= 0; i--){
+        if(!ranges[i].in_tree)
+            continue;
+        itree_remove(&itree, &ranges[i].itree_node);
+        ranges[i].in_tree = 0;
+    }
+    assert(itree.count == 0 && itree.root == NULL);
+    check_overlap_walk(&itree, ranges, 0, 0xFFFFFFFF);
+    printf("remove passed\n");
+    return 0;
+}
@@ -37,6 +37,7 @@
 #include "spfutil.h"
 #include "Queue.h"
 #include "spftrace.h"
+#include "leak_policy.h"
 
 char *
 advert_id_str(ADVERT_ID_T advert_id){
@@ -45,6 +46,8 @@ advert_id_str(ADVERT_ID_T advert_id){
     {
         case TLV128:
             return "TLV128";
+        case TLV128_BULK:
+            return "TLV128_BULK";
         case TLV2:
             return "TLV2";
         default:
@@ -59,7 +62,23 @@ lsp_distribution_routine(node_t *lsp_generator,
     
      switch(dist_info->advert_id){
         case TLV128:
-                partial_spf_run(lsp_receiver, dist_info->info_dist_level);
+                {
+                    tlv128_ip_reach_t *ad_msg = (tlv128_ip_reach_t *)dist_info->info_data;
+                    common_pfx_key_t prefix_key;
+
+                    memset(&prefix_key, 0, sizeof(common_pfx_key_t));
+                    strncpy(prefix_key.u.prefix.prefix, ad_msg->prefix, PREFIX_LEN);
+                    prefix_key.u.prefix.mask = ad_msg->mask;
+                    partial_spf_run_prefixes(lsp_receiver, dist_info->info_dist_level, &prefix_key, 1);
+                }
+                break;
+
+        case TLV128_BULK:
+                {
+                    tlv128_ip_reach_bulk_t *ad_msg = (tlv128_ip_reach_bulk_t *)dist_info->info_data;
+                    partial_spf_run_prefixes(lsp_receiver, dist_info->info_dist_level, 
+                            ad_msg->prefixes, ad_msg->n_prefixes);
+                }
                 break;
 
         case TLV2:
@@ -99,6 +118,14 @@ init_instance_lsp_distribution_traversal(instance_t * instance){
     }ITERATE_LIST_END;
 }
 
+static unsigned int lsp_distribution_depth = 0;
+
+boolean
+is_lsp_distribution_in_progress(){
+
+    return lsp_distribution_depth ? TRUE : FALSE;
+}
+
 
 /*fn to simulate LSP generation and distribution at its simplest.*/
 void
@@ -106,6 +133,8 @@ generate_lsp(instance_t *instance,
                   node_t *lsp_generator,
                   info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info){
 
+    lsp_distribution_depth++;
+
     node_t  *curr_node = NULL,
             *nbr_node = NULL,
             *pn_node = NULL;
@@ -160,5 +189,9 @@ generate_lsp(instance_t *instance,
     }
     free(q);
     q = NULL;
+
+    /*Prefixes leaked by nodes while LSP was being distributed*/
+    if(--lsp_distribution_depth == 0)
+        leak_policy_flush_pending(instance);
 }
 
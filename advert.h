@@ -49,6 +49,7 @@ typedef enum{
 typedef enum{
 
    TLV128,
+   TLV128_BULK,
    TLV2,
    OVERLOAD
 } ADVERT_ID_T;
@@ -68,6 +69,10 @@ void
 generate_lsp(instance_t *instance, 
                   node_t *lsp_generator, 
                   info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info);
+
+/*TRUE while generate_lsp is on the stack, possibly nested*/
+boolean
+is_lsp_distribution_in_progress();
                   
 /* Information advertising structures*/
 
@@ -82,6 +87,16 @@ typedef struct tlv128_ip_reach_{
     node_t *hosting_node; /*This info is present in LSP common hdr*/
 } tlv128_ip_reach_t;
 
+/* Batch of TLV128 prefixes advertised by one node in a single LSP
+ * update, used for bulk redistribution*/
+typedef struct common_pfx_ common_pfx_key_t;
+
+typedef struct tlv128_ip_reach_bulk_{
+    common_pfx_key_t *prefixes; /*NULL if n_prefixes is more than PRC_MAX_PREFIXES*/
+    unsigned int n_prefixes;
+    node_t *hosting_node;
+} tlv128_ip_reach_bulk_t;
+
 typedef struct LSPHDR_{
 
     FLAG overload;
@@ -34,6 +34,7 @@
 #include "LinkedListApi.h"
 #include "sr_tlv_api.h"
 #include "spfutil.h"
+#include "conflct_res.h"
 #include <arpa/inet.h>
 
 extern instance_t *instance;
@@ -56,6 +57,8 @@ is_identical_mapping_entries(sr_mapping_entry_t *mapping_entry1,
 }
 
 
+/*Called only when the prefix SID is assigned or changed, result is
+ * cached in sr_conflict_entry_t*/
 void
 construct_prefix_mapping_entry(prefix_t *prefix,
         sr_mapping_entry_t *mapping_entry_out){
@@ -65,14 +68,14 @@ construct_prefix_mapping_entry(prefix_t *prefix,
     else
         mapping_entry_out->prf = IGP_DEFAULT_SID_PFX_PREFERENCE_VALUE;
 
-    char subnet[PREFIX_LEN + 1];
     unsigned int binary_prefix = 0;
     prefix_sid_subtlv_t *prefix_sid = get_prefix_sid(prefix);
 
-    memset(subnet, 0, PREFIX_LEN + 1);
-    apply_mask(prefix->prefix, prefix->mask, subnet);
-    inet_pton(AF_INET, subnet, &binary_prefix);
-    binary_prefix = htonl(binary_prefix);
+    inet_pton(AF_INET, prefix->prefix, &binary_prefix);
+    binary_prefix = ntohl(binary_prefix);
+    if(prefix->mask < 32)
+        binary_prefix &= prefix->mask ? ~(0xFFFFFFFFU >> prefix->mask) : 0;
+
     mapping_entry_out->pi          = binary_prefix;
     mapping_entry_out->pe          = binary_prefix;
     mapping_entry_out->pfx_len     = prefix->mask;
@@ -137,80 +140,67 @@ is_prefixes_sid_conflicting(sr_mapping_entry_t *pfx_mapping_entry1,
     return FALSE;
 }
 
-void
-resolve_prefix_sid_conflict(prefix_t *prefix1, sr_mapping_entry_t *pfx_mapping_entry1,
-        prefix_t *prefix2, sr_mapping_entry_t *pfx_mapping_entry2){
+/*Returns -1 if mapping_entry1 is preferred, 1 if mapping_entry2 is
+ * preferred, 0 if neither*/
+static int
+prefix_sid_conflict_preference(sr_mapping_entry_t *pfx_mapping_entry1,
+        sr_mapping_entry_t *pfx_mapping_entry2){
 
-    assert(IS_PREFIX_SR_ACTIVE(prefix1) &&
-            IS_PREFIX_SR_ACTIVE(prefix2));
+    if(pfx_mapping_entry1->prf != pfx_mapping_entry2->prf)
+        return pfx_mapping_entry1->prf > pfx_mapping_entry2->prf ? -1 : 1;
 
-    if(pfx_mapping_entry1->prf != pfx_mapping_entry2->prf){
+    if(pfx_mapping_entry1->range_value != pfx_mapping_entry2->range_value)
+        return pfx_mapping_entry1->range_value < pfx_mapping_entry2->range_value ? -1 : 1;
 
-        if(pfx_mapping_entry1->prf > pfx_mapping_entry2->prf)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
+    if(pfx_mapping_entry1->pfx_len != pfx_mapping_entry2->pfx_len)
+        return pfx_mapping_entry1->pfx_len > pfx_mapping_entry2->pfx_len ? -1 : 1;
 
+    if(pfx_mapping_entry1->pi != pfx_mapping_entry2->pi)
+        return pfx_mapping_entry1->pi < pfx_mapping_entry2->pi ? -1 : 1;
 
-    if(pfx_mapping_entry1->range_value != pfx_mapping_entry2->range_value){
+    if(pfx_mapping_entry1->algorithm != pfx_mapping_entry2->algorithm)
+        return pfx_mapping_entry1->algorithm < pfx_mapping_entry2->algorithm ? -1 : 1;
 
-        if(pfx_mapping_entry1->range_value < pfx_mapping_entry2->range_value)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
+    return 0;
+}
 
+static int
+prefix_conflict_preference(sr_mapping_entry_t *pfx_mapping_entry1,
+        sr_mapping_entry_t *pfx_mapping_entry2){
 
-    if(pfx_mapping_entry1->pfx_len != pfx_mapping_entry2->pfx_len){
+    if(pfx_mapping_entry1->prf != pfx_mapping_entry2->prf)
+        return pfx_mapping_entry1->prf > pfx_mapping_entry2->prf ? -1 : 1;
 
-        if(pfx_mapping_entry1->pfx_len < pfx_mapping_entry2->pfx_len)
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        return;
-    }
+    if(pfx_mapping_entry1->range_value != pfx_mapping_entry2->range_value)
+        return pfx_mapping_entry1->range_value < pfx_mapping_entry2->range_value ? -1 : 1;
 
-    if(pfx_mapping_entry1->pi != pfx_mapping_entry2->pi){
+    if(pfx_mapping_entry1->pfx_len != pfx_mapping_entry2->pfx_len)
+        return pfx_mapping_entry1->pfx_len > pfx_mapping_entry2->pfx_len ? -1 : 1;
 
-        if(pfx_mapping_entry1->pi < pfx_mapping_entry2->pi)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
+    if(pfx_mapping_entry1->si != pfx_mapping_entry2->si)
+        return pfx_mapping_entry1->si < pfx_mapping_entry2->si ? -1 : 1;
 
-    if(pfx_mapping_entry1->algorithm != pfx_mapping_entry2->algorithm){
+    return 0;
+}
 
-        if(pfx_mapping_entry1->algorithm < pfx_mapping_entry2->algorithm)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
+void
+resolve_prefix_sid_conflict(prefix_t *prefix1, sr_mapping_entry_t *pfx_mapping_entry1,
+        prefix_t *prefix2, sr_mapping_entry_t *pfx_mapping_entry2){
 
-#if 0
-    if(pfx_mapping_entry1->si != pfx_mapping_entry2->si){
+    assert(IS_PREFIX_SR_ACTIVE(prefix1) &&
+            IS_PREFIX_SR_ACTIVE(prefix2));
 
-        if(pfx_mapping_entry1->si < pfx_mapping_entry2->si)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
+    int rc = prefix_sid_conflict_preference(pfx_mapping_entry1, pfx_mapping_entry2);
+
+    if(rc){
+        rc < 0 ? MARK_PREFIX_SR_INACTIVE(prefix2) : MARK_PREFIX_SR_INACTIVE(prefix1);
         return;
     }
-#endif
 
     if(pfx_mapping_entry1->topology != pfx_mapping_entry2->topology){
         MARK_PREFIX_SR_INACTIVE(prefix1);
         MARK_PREFIX_SR_INACTIVE(prefix2);
-        return;
     }
-    else{
-        return;
-    }
-    assert(0);
 }
 
 
@@ -221,151 +211,298 @@ resolve_prefix_conflict(prefix_t *prefix1, sr_mapping_entry_t *pfx_mapping_entry
     assert(IS_PREFIX_SR_ACTIVE(prefix1) &&
             IS_PREFIX_SR_ACTIVE(prefix2));
 
-    if(pfx_mapping_entry1->prf != pfx_mapping_entry2->prf){
+    int rc = prefix_conflict_preference(pfx_mapping_entry1, pfx_mapping_entry2);
+    assert(rc);
 
-        if(pfx_mapping_entry1->prf > pfx_mapping_entry2->prf)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
+    rc < 0 ? MARK_PREFIX_SR_INACTIVE(prefix2) : MARK_PREFIX_SR_INACTIVE(prefix1);
+}
 
+/*Per level conflict index of all prefix SIDs*/
+static itree_t pfx_range_index[MAX_LEVEL];
+static itree_t sid_range_index[MAX_LEVEL];
+static sr_conflict_entry_t *pfx_hash_index[MAX_LEVEL][SR_CONFLICT_PFX_HASH_SIZE];
 
-    if(pfx_mapping_entry1->range_value != pfx_mapping_entry2->range_value){
+ITREE_NODE_TO_STRUCT(pfx_range_node_to_conflict_entry, sr_conflict_entry_t, pfx_range_node);
+ITREE_NODE_TO_STRUCT(sid_range_node_to_conflict_entry, sr_conflict_entry_t, sid_range_node);
 
-        if(pfx_mapping_entry1->range_value < pfx_mapping_entry2->range_value)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
+typedef struct conflict_entry_vector_{
 
+    unsigned int count;
+    unsigned int size;
+    sr_conflict_entry_t **entries;
+} conflict_entry_vector_t;
 
-    if(pfx_mapping_entry1->pfx_len != pfx_mapping_entry2->pfx_len){
+static void
+conflict_entry_vector_add(conflict_entry_vector_t *vector, 
+                          sr_conflict_entry_t *conflict_entry){
 
-        if(pfx_mapping_entry1->pfx_len < pfx_mapping_entry2->pfx_len)
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        return;
+    if(vector->count == vector->size){
+        vector->size = vector->size ? vector->size << 1 : 8;
+        vector->entries = realloc(vector->entries, 
+                            vector->size * sizeof(sr_conflict_entry_t *));
     }
+    vector->entries[vector->count++] = conflict_entry;
+}
 
-#if 0
-    if(pfx_mapping_entry1->pi != pfx_mapping_entry2->pi){
+static void
+collect_pfx_range_entries(itree_node_t *itree_node, void *arg){
 
-        if(pfx_mapping_entry1->pi < pfx_mapping_entry2->pi)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
-    }
-#endif
-    if(pfx_mapping_entry1->si != pfx_mapping_entry2->si){
+    conflict_entry_vector_add(arg, pfx_range_node_to_conflict_entry(itree_node));
+}
 
-        if(pfx_mapping_entry1->si < pfx_mapping_entry2->si)
-            MARK_PREFIX_SR_INACTIVE(prefix2);
-        else
-            MARK_PREFIX_SR_INACTIVE(prefix1);
-        return;
+static void
+collect_sid_range_entries(itree_node_t *itree_node, void *arg){
+
+    conflict_entry_vector_add(arg, sid_range_node_to_conflict_entry(itree_node));
+}
+
+/*SIDs to be re-resolved, duplicates are dropped when the set is sorted
+ * before resolution, see sr_conflict_resolve_sids()*/
+typedef struct sid_set_{
+
+    unsigned int count;
+    unsigned int size;
+    unsigned int *sids;
+} sid_set_t;
+
+static void
+sid_set_add(sid_set_t *sid_set, unsigned int sid){
+
+    if(sid_set->count == sid_set->size){
+        sid_set->size = sid_set->size ? sid_set->size << 1 : 8;
+        sid_set->sids = realloc(sid_set->sids, sid_set->size * sizeof(unsigned int));
     }
-    assert(0);
+    sid_set->sids[sid_set->count++] = sid;
 }
 
-ll_t *
-prefix_sid_conflict_resolution(ll_t *global_prefix_list){
+/*Same prefix as per section 3.2.1 : topology, algorithm, address-family,
+ * prefix length and prefix*/
+static boolean
+is_same_sr_prefix(sr_mapping_entry_t *pfx_mapping_entry1,
+        sr_mapping_entry_t *pfx_mapping_entry2){
 
-    singly_ll_node_t *list_node1 = NULL,
-                     *list_node2 = NULL;
+    return pfx_mapping_entry1->topology == pfx_mapping_entry2->topology       &&
+           pfx_mapping_entry1->algorithm == pfx_mapping_entry2->algorithm     &&
+           pfx_mapping_entry1->max_pfx_len == pfx_mapping_entry2->max_pfx_len &&
+           pfx_mapping_entry1->pfx_len == pfx_mapping_entry2->pfx_len         &&
+           pfx_mapping_entry1->pi == pfx_mapping_entry2->pi;
+}
 
-    sr_mapping_entry_t mapping_entry1,
-                       mapping_entry2;
+static unsigned int
+sr_prefix_hash(sr_mapping_entry_t *mapping_entry){
 
-    prefix_t *prefix1 = NULL,
-             *prefix2 = NULL;
+    return ((mapping_entry->pi ^ ((unsigned int)(unsigned char)mapping_entry->pfx_len << 24) ^
+             (mapping_entry->algorithm << 8) ^ mapping_entry->topology) * 2654435761U) &
+            (SR_CONFLICT_PFX_HASH_SIZE - 1);
+}
 
-    ITERATE_LIST_BEGIN(global_prefix_list, list_node1){
+/*Prefix conflict phase, re-resolve all entries advertising the prefix of
+ * mapping_entry. SIDs of the entries are collected in sid_set for the SID
+ * conflict phase*/
+static void
+resolve_prefix_conflict_group(LEVEL level, sr_mapping_entry_t *mapping_entry, 
+                              sid_set_t *sid_set){
 
-        prefix1 = list_node1->data;
-        if(!IS_PREFIX_SR_ACTIVE(prefix1)) continue;
+    sr_conflict_entry_t *conflict_entry = NULL,
+                        *best = NULL,
+                        *bucket = pfx_hash_index[level][sr_prefix_hash(mapping_entry)];
 
-        construct_prefix_mapping_entry(prefix1, &mapping_entry1);
-        for(list_node2 = list_node1->next; list_node2; list_node2 = list_node2->next){
+    for(conflict_entry = bucket; conflict_entry; conflict_entry = conflict_entry->pfx_hash_next){
+        if(!is_same_sr_prefix(&conflict_entry->mapping_entry, mapping_entry))
+            continue;
+        if(!best || prefix_conflict_preference(&conflict_entry->mapping_entry, 
+                    &best->mapping_entry) < 0)
+            best = conflict_entry;
+    }
 
-            prefix2 = list_node2->data;
-            if(!IS_PREFIX_SR_ACTIVE(prefix2)) continue;
+    for(conflict_entry = bucket; conflict_entry; conflict_entry = conflict_entry->pfx_hash_next){
+        if(!is_same_sr_prefix(&conflict_entry->mapping_entry, mapping_entry))
+            continue;
+        conflict_entry->prefix_conflict_free = 
+            !is_prefixes_conflicting(&best->mapping_entry, &conflict_entry->mapping_entry);
+        sid_set_add(sid_set, conflict_entry->mapping_entry.si);
+    }
+}
 
-            construct_prefix_mapping_entry(prefix2, &mapping_entry2);
-            if(is_prefixes_sid_conflicting(&mapping_entry1, &mapping_entry2) == FALSE)
-                continue;
+/*SID conflict phase over the prefix conflict free entries using the sid*/
+static void
+resolve_sid_conflict_group(LEVEL level, unsigned int sid){
 
-            resolve_prefix_sid_conflict(prefix1, &mapping_entry1,
-                    prefix2, &mapping_entry2);
+    unsigned int i = 0;
+    boolean best_lost = FALSE;
+    conflict_entry_vector_t group;
+    sr_conflict_entry_t *conflict_entry = NULL,
+                        *best = NULL;
 
-            if(!IS_PREFIX_SR_ACTIVE(prefix1))
-                break;
-        }
-    } ITERATE_LIST_END;
+    memset(&group, 0, sizeof(conflict_entry_vector_t));
+    itree_overlap_walk(&sid_range_index[level], sid, sid, 
+            collect_sid_range_entries, &group);
 
-    /*Clean up the weed out ones from the global list*/
-    ITERATE_LIST_BEGIN2(global_prefix_list, list_node1, list_node2){
+    for(i = 0; i < group.count; i++){
+        conflict_entry = group.entries[i];
+        if(!conflict_entry->prefix_conflict_free ||
+            conflict_entry->mapping_entry.si != sid)
+            continue;
+        if(!best || prefix_sid_conflict_preference(&conflict_entry->mapping_entry, 
+                    &best->mapping_entry) < 0)
+            best = conflict_entry;
+    }
 
-        prefix1 = list_node1->data;
-        if(!IS_PREFIX_SR_ACTIVE(prefix1)){
-            ITERATIVE_LIST_NODE_DELETE2(global_prefix_list, list_node1, list_node2);
-        }
-    } ITERATE_LIST_END2(global_prefix_list, list_node1, list_node2);
+    /*Entries differing only in topology knock out each other*/
+    for(i = 0; best && i < group.count; i++){
+        conflict_entry = group.entries[i];
+        if(!conflict_entry->prefix_conflict_free ||
+            conflict_entry->mapping_entry.si != sid)
+            continue;
+        if(is_prefixes_sid_conflicting(&best->mapping_entry, &conflict_entry->mapping_entry) &&
+            prefix_sid_conflict_preference(&best->mapping_entry, &conflict_entry->mapping_entry) == 0)
+            best_lost = TRUE;
+    }
 
-    return global_prefix_list;
+    for(i = 0; i < group.count; i++){
+        conflict_entry = group.entries[i];
+        if(conflict_entry->mapping_entry.si != sid)
+            continue;
+        if(conflict_entry->prefix_conflict_free && !best_lost &&
+            !is_prefixes_sid_conflicting(&best->mapping_entry, &conflict_entry->mapping_entry))
+            MARK_PREFIX_SR_ACTIVE(conflict_entry->prefix);
+        else
+            MARK_PREFIX_SR_INACTIVE(conflict_entry->prefix);
+    }
+    free(group.entries);
 }
 
-ll_t *
-prefix_conflict_resolution(node_t *node, LEVEL level){
+static void
+sr_conflict_index_link(sr_conflict_entry_t *conflict_entry){
 
-    singly_ll_node_t *list_node1 = NULL,
-                     *list_node2 = NULL;
+    sr_conflict_entry_t **bucket = 
+        &pfx_hash_index[conflict_entry->level][sr_prefix_hash(&conflict_entry->mapping_entry)];
 
-    sr_mapping_entry_t mapping_entry1,
-                       mapping_entry2;
+    conflict_entry->pfx_range_node.low  = conflict_entry->mapping_entry.pi;
+    conflict_entry->pfx_range_node.high = conflict_entry->mapping_entry.pe;
+    conflict_entry->sid_range_node.low  = conflict_entry->mapping_entry.si;
+    conflict_entry->sid_range_node.high = conflict_entry->mapping_entry.se;
+    itree_insert(&pfx_range_index[conflict_entry->level], &conflict_entry->pfx_range_node);
+    itree_insert(&sid_range_index[conflict_entry->level], &conflict_entry->sid_range_node);
+    conflict_entry->pfx_hash_next = *bucket;
+    *bucket = conflict_entry;
+}
 
-    prefix_t *prefix1 = NULL,
-             *prefix2 = NULL;
+static void
+sr_conflict_index_unlink(sr_conflict_entry_t *conflict_entry){
 
+    sr_conflict_entry_t **bucket = 
+        &pfx_hash_index[conflict_entry->level][sr_prefix_hash(&conflict_entry->mapping_entry)];
 
-    ll_t *global_prefix_list = NULL; //build_global_prefix_list(node, level);
+    itree_remove(&pfx_range_index[conflict_entry->level], &conflict_entry->pfx_range_node);
+    itree_remove(&sid_range_index[conflict_entry->level], &conflict_entry->sid_range_node);
+    while(*bucket != conflict_entry)
+        bucket = &(*bucket)->pfx_hash_next;
+    *bucket = conflict_entry->pfx_hash_next;
+    conflict_entry->pfx_hash_next = NULL;
+}
 
-    ITERATE_LIST_BEGIN(global_prefix_list, list_node1){
+static int
+sid_compare(const void *sid1, const void *sid2){
 
-        prefix1 = list_node1->data;
-        if(!IS_PREFIX_SR_ACTIVE(prefix1))
-            continue;
+    unsigned int s1 = *(const unsigned int *)sid1,
+                 s2 = *(const unsigned int *)sid2;
+
+    return s1 < s2 ? -1 : s1 > s2;
+}
+
+static void
+sr_conflict_resolve_sids(LEVEL level, sid_set_t *sid_set){
 
-        construct_prefix_mapping_entry(prefix1, &mapping_entry1);
+    unsigned int i = 0;
 
-        for(list_node2 = list_node1->next; list_node2; list_node2 = list_node2->next){
+    qsort(sid_set->sids, sid_set->count, sizeof(unsigned int), sid_compare);
+    for(i = 0; i < sid_set->count; i++){
+        if(i && sid_set->sids[i] == sid_set->sids[i - 1])
+            continue;
+        resolve_sid_conflict_group(level, sid_set->sids[i]);
+    }
+    free(sid_set->sids);
+}
 
-            prefix2 = list_node2->data;
-            if(!IS_PREFIX_SR_ACTIVE(prefix2))
-                continue;
+void
+sr_conflict_index_update(prefix_t *prefix, LEVEL level){
 
-            construct_prefix_mapping_entry(prefix2,  &mapping_entry2);
+    sid_set_t sid_set;
+    LEVEL old_level = LEVEL_UNKNOWN;
+    sr_mapping_entry_t old_mapping_entry;
+    prefix_sid_subtlv_t *prefix_sid = get_prefix_sid(prefix);
+    sr_conflict_entry_t *conflict_entry = NULL;
 
-            if(is_prefixes_conflicting(&mapping_entry1, &mapping_entry2) == FALSE)
-                continue;
-            /*Now resolve the conflict between prefix1 and prefix 2*/
-            resolve_prefix_conflict(prefix1, &mapping_entry1, prefix2, &mapping_entry2);
+    assert(prefix_sid);
+    memset(&sid_set, 0, sizeof(sid_set_t));
+    conflict_entry = prefix_sid->conflict_entry;
 
-            if(!IS_PREFIX_SR_ACTIVE(prefix1))
-                break;
+    if(conflict_entry){
+        old_level = conflict_entry->level;
+        memcpy(&old_mapping_entry, &conflict_entry->mapping_entry, sizeof(sr_mapping_entry_t));
+        sr_conflict_index_unlink(conflict_entry);
+    }
+    else{
+        conflict_entry = calloc(1, sizeof(sr_conflict_entry_t));
+        conflict_entry->prefix = prefix;
+        prefix_sid->conflict_entry = conflict_entry;
+    }
 
-            assert((IS_PREFIX_SR_ACTIVE(prefix1) && !IS_PREFIX_SR_ACTIVE(prefix2)) ||
-                    (!IS_PREFIX_SR_ACTIVE(prefix1) &&  IS_PREFIX_SR_ACTIVE(prefix2)));
+    conflict_entry->level = level;
+    construct_prefix_mapping_entry(prefix, &conflict_entry->mapping_entry);
+    sr_conflict_index_link(conflict_entry);
+
+    /*Prefixes which were competing with the old mapping*/
+    if(old_level != LEVEL_UNKNOWN){
+        resolve_prefix_conflict_group(old_level, &old_mapping_entry, &sid_set);
+        sid_set_add(&sid_set, old_mapping_entry.si);
+        if(old_level != level){
+            sr_conflict_resolve_sids(old_level, &sid_set);
+            memset(&sid_set, 0, sizeof(sid_set_t));
         }
-    } ITERATE_LIST_END;
+    }
+
+    resolve_prefix_conflict_group(level, &conflict_entry->mapping_entry, &sid_set);
+    sr_conflict_resolve_sids(level, &sid_set);
+}
+
+void
+sr_conflict_index_remove(prefix_t *prefix){
+
+    sid_set_t sid_set;
+    LEVEL level = LEVEL_UNKNOWN;
+    sr_mapping_entry_t old_mapping_entry;
+    prefix_sid_subtlv_t *prefix_sid = get_prefix_sid(prefix);
+    sr_conflict_entry_t *conflict_entry = NULL;
+
+    if(!prefix_sid || !prefix_sid->conflict_entry)
+        return;
 
+    conflict_entry = prefix_sid->conflict_entry;
+    prefix_sid->conflict_entry = NULL;
+    level = conflict_entry->level;
+    memcpy(&old_mapping_entry, &conflict_entry->mapping_entry, sizeof(sr_mapping_entry_t));
+    sr_conflict_index_unlink(conflict_entry);
+    free(conflict_entry);
+
+    memset(&sid_set, 0, sizeof(sid_set_t));
+    resolve_prefix_conflict_group(level, &old_mapping_entry, &sid_set);
+    sid_set_add(&sid_set, old_mapping_entry.si);
+    sr_conflict_resolve_sids(level, &sid_set);
+}
 
-    /*Now cleanup the prefixes which are filtered out and will not be considered
-     *     * for SID conflict resolution phase*/
+/*Conflicts are resolved incrementally as prefix SIDs change, below fns
+ * only report the current state of the index*/
+ll_t *
+prefix_sid_conflict_resolution(ll_t *global_prefix_list){
 
+    singly_ll_node_t *list_node1 = NULL,
+                     *list_node2 = NULL;
+
+    prefix_t *prefix1 = NULL;
+
+    /*Clean up the weed out ones from the global list*/
     ITERATE_LIST_BEGIN2(global_prefix_list, list_node1, list_node2){
 
         prefix1 = list_node1->data;
@@ -377,3 +514,24 @@ prefix_conflict_resolution(node_t *node, LEVEL level){
     return global_prefix_list;
 }
 
+ll_t *
+prefix_conflict_resolution(node_t *node, LEVEL level){
+
+    unsigned int i = 0;
+    conflict_entry_vector_t all;
+    ll_t *global_prefix_list = init_singly_ll();
+
+    memset(&all, 0, sizeof(conflict_entry_vector_t));
+    itree_overlap_walk(&pfx_range_index[level], 0, 0xFFFFFFFF,
+            collect_pfx_range_entries, &all);
+
+    /*list is built in reverse, so that it comes out in prefix order*/
+    for(i = all.count; i > 0; i--){
+        if(!all.entries[i - 1]->prefix_conflict_free)
+            continue;
+        singly_ll_add_node(global_prefix_list, 
+            singly_ll_init_node(all.entries[i - 1]->prefix));
+    }
+    free(all.entries);
+    return global_prefix_list;
+}
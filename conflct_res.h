@@ -33,6 +33,33 @@
 #ifndef __CONFLCT_RES__
 #define __CONFLCT_RES__
 
+#include "igp_sr_ext.h"
+#include "Tree/interval_tree.h"
 
+/*Must be power of 2*/
+#define SR_CONFLICT_PFX_HASH_SIZE   1024
+
+/*Every prefix SID of a level is indexed by its prefix range (pi..pe), its
+ * SID range (si..se) and its exact prefix (topology, algorithm, pfx_len, pi).
+ * On add/update/removal of a prefix SID, only the prefixes advertising the
+ * same prefix, and then the ones sharing their SIDs, are re-resolved*/
+typedef struct sr_conflict_entry_{
+
+    sr_mapping_entry_t mapping_entry;   /*Cached, rebuilt only when SID changes*/
+    prefix_t *prefix;
+    LEVEL level;
+    boolean prefix_conflict_free;       /*Survived the prefix conflict phase*/
+    itree_node_t pfx_range_node;
+    itree_node_t sid_range_node;
+    struct sr_conflict_entry_ *pfx_hash_next; /*exact prefix hash bucket chain*/
+} sr_conflict_entry_t;
+
+/*Called when the prefix SID is assigned or its value is changed*/
+void
+sr_conflict_index_update(prefix_t *prefix, LEVEL level);
+
+/*Called before the prefix SID is freed*/
+void
+sr_conflict_index_remove(prefix_t *prefix);
 
 #endif /* __CONFLCT_RES__ */
@@ -30,6 +30,7 @@
  * =====================================================================================
  */
 
+#include <arpa/inet.h>
 #include "data_plane.h"
 #include "instance.h"
 #include "spftrace.h"
@@ -37,7 +38,7 @@
 #include "routes.h"
 #include "ldp.h"
 #include "spfutil.h"
-#include "stack.h"
+#include "rib_changelog.h"
 
 extern instance_t *instance;
 void
@@ -53,9 +54,13 @@ get_un_next_hop_node(internal_un_nh_t *nh){
     return nh->nh_node;
 }
 
+/*gw_prefix must be PREFIX_LEN + 1 bytes*/
 char *
-get_un_next_hop_gateway_pfx(internal_un_nh_t *nh){
-    return nh->gw_prefix;
+get_un_next_hop_gateway_pfx(internal_un_nh_t *nh, char *gw_prefix){
+    gw_prefix[0] = '\0';
+    if(nh->gw_ip)
+        inet_ntop(AF_INET, &nh->gw_ip, gw_prefix, PREFIX_LEN + 1);
+    return gw_prefix;
 }
 
 char *
@@ -68,10 +73,18 @@ get_un_next_hop_protected_link_name(internal_un_nh_t *nh){
     return nh->protected_link->intf_name;
 }
 
+boolean
+is_un_next_hop_gw_pfx_equal(internal_un_nh_t *nh, char *pfx){
+    unsigned int gw_ip = 0;
+    if(pfx[0] && inet_pton(AF_INET, pfx, &gw_ip) != 1)
+        return FALSE;
+    return nh->gw_ip == gw_ip;
+}
+
 void
 set_un_next_hop_gw_pfx(internal_un_nh_t *nh, char *pfx){
-    strncpy(nh->gw_prefix, pfx, PREFIX_LEN);
-    nh->gw_prefix[PREFIX_LEN] = '\0';
+    if(!pfx[0] || inet_pton(AF_INET, pfx, &nh->gw_ip) != 1)
+        nh->gw_ip = 0;
 }
 
 boolean
@@ -88,10 +101,31 @@ init_un_next_hop(internal_un_nh_t *nh){
 void
 copy_un_next_hop_t(internal_un_nh_t *src, internal_un_nh_t *dst){
     
-    glthread_t glthread;
-    memcpy(&glthread, &dst->glthread, sizeof(glthread_t));
+    /*Preserve pool linkage of dst*/
+    unsigned int ref_count = dst->ref_count,
+                 hash = dst->hash;
+    internal_un_nh_t *pool_next = dst->pool_next;
+
     memcpy(dst, src, sizeof(internal_un_nh_t));
-    memcpy(&dst->glthread, &glthread, sizeof(glthread_t));
+    dst->ref_count = ref_count;
+    dst->hash = hash;
+    dst->pool_next = pool_next;
+}
+
+static boolean
+is_un_nh_label_ops_equal(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
+
+    unsigned int i = 0;
+
+    if(nh1->n_label_ops != nh2->n_label_ops)
+        return FALSE;
+
+    for(; i < nh1->n_label_ops; i++){
+        if(nh1->label_ops[i].label != nh2->label_ops[i].label ||
+            nh1->label_ops[i].stack_op != nh2->label_ops[i].stack_op)
+            return FALSE;
+    }
+    return TRUE;
 }
 
 boolean
@@ -100,22 +134,27 @@ is_un_nh_t_clones(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(nh1->protocol != nh2->protocol)
         return FALSE;
 
-    if(strncmp(nh1->oif->intf_name, nh2->oif->intf_name, IF_NAME_SIZE))
+    /*Egress (POP) nexthops have no oif*/
+    if(!nh1->oif || !nh2->oif){
+        if(nh1->oif != nh2->oif)
+            return FALSE;
+    }
+    else if(strncmp(nh1->oif->intf_name, nh2->oif->intf_name, IF_NAME_SIZE))
         return FALSE;
 
     if(nh1->nh_node != nh2->nh_node)
         return FALSE;
 
-    if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
+    if(nh1->gw_ip != nh2->gw_ip)
         return FALSE;
 
-    if(memcmp(&nh1->nh, &nh2->nh, sizeof(nh1->nh)))
+    if(!is_un_nh_label_ops_equal(nh1, nh2))
         return FALSE;
 
     if(nh1->flags != nh2->flags)
         return FALSE;
 
-    if(nh1->protected_link != nh1->protected_link)
+    if(nh1->protected_link != nh2->protected_link)
         return FALSE;
 
     if(nh1->lfa_type != nh2->lfa_type)
@@ -127,6 +166,9 @@ is_un_nh_t_clones(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(nh1->dest_metric != nh2->dest_metric)
         return FALSE;
 
+    if(nh1->ucmp_weight != nh2->ucmp_weight)
+        return FALSE;
+
     return TRUE;
 }
 
@@ -136,7 +178,7 @@ is_inet_0_un_nh_t_equal(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(nh1->oif != nh2->oif)
         return FALSE;
 
-    if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
+    if(nh1->gw_ip != nh2->gw_ip)
         return FALSE;
 
     return TRUE;
@@ -149,10 +191,10 @@ is_inet_3_un_nh_t_equal(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(nh1->oif != nh2->oif)
         return FALSE;
 
-    if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
+    if(nh1->gw_ip != nh2->gw_ip)
         return FALSE;
 
-    if(memcmp(&nh1->nh.inet3_nh, &nh2->nh.inet3_nh, sizeof(internal_un_nh_t)))
+    if(!is_un_nh_label_ops_equal(nh1, nh2))
         return FALSE;
 
     return TRUE;
@@ -165,10 +207,10 @@ is_mpls_0_un_nh_t_equal(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(nh1->oif != nh2->oif)
         return FALSE;
 
-    if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
+    if(nh1->gw_ip != nh2->gw_ip)
         return FALSE;
 
-    if(memcmp(&nh1->nh.mpls0_nh, &nh2->nh.mpls0_nh, sizeof(internal_un_nh_t)))
+    if(!is_un_nh_label_ops_equal(nh1, nh2))
         return FALSE;
 
     return TRUE;
@@ -184,24 +226,264 @@ malloc_un_nexthop(){
     return calloc(1, sizeof(internal_un_nh_t));
 }
 
-int
-free_rt_un_entry(rt_un_entry_t *rt_un_entry){
+#define RIB_NH_POOL_MASK    (RIB_NH_POOL_SIZE - 1)
 
-    internal_un_nh_t *nxt_hop = NULL;
+/*Hash over the contents of nexthop which identify it, refresh time
+ * and pool linkage are excluded*/
+static unsigned int
+un_nh_hash(internal_un_nh_t *nh){
+
+    unsigned int i = 0;
+    struct{
+        PROTOCOL protocol;
+        edge_end_t *oif;
+        node_t *nh_node;
+        unsigned int gw_ip;
+        unsigned char n_label_ops;
+        mpls_label_op_t label_ops[MPLS_STACK_OP_LIMIT_MAX];
+        FLAG flags;
+        lfa_type_t lfa_type;
+        edge_end_t *protected_link;
+        unsigned int root_metric;
+        unsigned int dest_metric;
+        unsigned int ucmp_weight;
+    } key;
+
+    memset(&key, 0, sizeof(key));
+    key.protocol = nh->protocol;
+    key.oif = nh->oif;
+    key.nh_node = nh->nh_node;
+    key.gw_ip = nh->gw_ip;
+    key.n_label_ops = nh->n_label_ops;
+    for(i = 0; i < nh->n_label_ops; i++){
+        key.label_ops[i].label = nh->label_ops[i].label;
+        key.label_ops[i].stack_op = nh->label_ops[i].stack_op;
+    }
+    key.flags = nh->flags;
+    key.lfa_type = nh->lfa_type;
+    key.protected_link = nh->protected_link;
+    key.root_metric = nh->root_metric;
+    key.dest_metric = nh->dest_metric;
+    key.ucmp_weight = nh->ucmp_weight;
+
+    return hash_code(&key, sizeof(key));
+}
+
+static boolean
+is_un_nh_t_identical(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
+
+    if(nh1->oif != nh2->oif)
+        return FALSE;
+
+    if(!is_un_nh_t_clones(nh1, nh2))
+        return FALSE;
+
+    return TRUE;
+}
+
+internal_un_nh_t *
+rib_un_nh_pool_intern(rt_un_table_t *rib, internal_un_nh_t *nexthop){
+
+    rt_un_nh_pool_t *pool = &rib->nh_pool;
+    internal_un_nh_t *pool_nh = NULL;
+    unsigned int hash = un_nh_hash(nexthop);
+    unsigned int bucket = hash & RIB_NH_POOL_MASK;
+
+    pool->refs++;
+
+    for(pool_nh = pool->bucket[bucket]; pool_nh; pool_nh = pool_nh->pool_next){
+        if(pool_nh->hash != hash)
+            continue;
+        if(!is_un_nh_t_identical(pool_nh, nexthop))
+            continue;
+        pool_nh->ref_count++;
+        pool_nh->last_refresh_time = nexthop->last_refresh_time;
+        return pool_nh;
+    }
+
+    pool_nh = malloc_un_nexthop();
+    memcpy(pool_nh, nexthop, sizeof(internal_un_nh_t));
+    pool_nh->hash = hash;
+    pool_nh->ref_count = 1;
+    pool_nh->pool_next = pool->bucket[bucket];
+    pool->bucket[bucket] = pool_nh;
+    pool->count++;
+    return pool_nh;
+}
+
+void
+rib_un_nh_pool_release(rt_un_table_t *rib, internal_un_nh_t *nexthop){
+
+    rt_un_nh_pool_t *pool = &rib->nh_pool;
+    internal_un_nh_t **pp = NULL;
+
+    assert(nexthop->ref_count);
+    pool->refs--;
+    nexthop->ref_count--;
+    if(nexthop->ref_count)
+        return;
+
+    for(pp = &pool->bucket[nexthop->hash & RIB_NH_POOL_MASK]; *pp; pp = &(*pp)->pool_next){
+        if(*pp != nexthop) continue;
+        *pp = nexthop->pool_next;
+        pool->count--;
+        free_un_nexthop(nexthop);
+        return;
+    }
+    assert(0);
+}
+
+static void
+rt_un_entry_flush_nexthops(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    rt_un_nh_ref_t *nh_ref = NULL;
     glthread_t *curr = NULL;
 
     ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
-        nxt_hop = glthread_to_unified_nh(curr);
+        nh_ref = glthread_to_rt_un_nh_ref(curr);
         remove_glthread(curr);
-        free_un_nexthop(nxt_hop);    
+        rib_un_nh_pool_release(rib, nh_ref->nexthop);
+        free(nh_ref);
     } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-    
-    if(IS_GLTHREAD_LIST_EMPTY((&rt_un_entry->glthread))){
-        remove_glthread(&rt_un_entry->glthread);
-        free(rt_un_entry);
-        return 0;
+}
+
+/*Primary nexthops are kept ahead of backups in routing entry*/
+static internal_un_nh_t *
+rt_un_entry_add_nexthop(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry,
+                        internal_un_nh_t *nexthop){
+
+    rt_un_nh_ref_t *nh_ref = calloc(1, sizeof(rt_un_nh_ref_t));
+
+    nh_ref->nexthop = rib_un_nh_pool_intern(rib, nexthop);
+    init_glthread(&nh_ref->glthread);
+    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
+        glthread_add_next(&rt_un_entry->nh_list_head, &nh_ref->glthread);
+    else
+        glthread_add_last(&rt_un_entry->nh_list_head, &nh_ref->glthread);
+    return nh_ref->nexthop;
+}
+
+static unsigned int
+rib_index_hash(rt_un_table_t *rib, rt_key_t *rt_key){
+
+    unsigned int i = 0, 
+                 hash = 2166136261U;
+    char *prefix = RT_ENTRY_PFX(rt_key);
+
+    if(rib->rib_type == MPLS_0)
+        return (RT_ENTRY_LABEL(rt_key) * 2654435761U) & (rib->hash_size - 1);
+
+    for(i = 0; i < PREFIX_LEN && prefix[i]; i++){
+        hash ^= (unsigned char)prefix[i];
+        hash *= 16777619U;
+    }
+    hash ^= (unsigned char)RT_ENTRY_MASK(rt_key);
+    hash *= 16777619U;
+    return hash & (rib->hash_size - 1);
+}
+
+static void
+rib_index_insert(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    unsigned int index = rib_index_hash(rib, &rt_un_entry->rt_key);
+
+    rt_un_entry->hash_next = rib->bucket[index];
+    rib->bucket[index] = rt_un_entry;
+}
+
+static void
+rib_index_rehash(rt_un_table_t *rib, unsigned int new_hash_size){
+
+    glthread_t *curr = NULL;
+
+    free(rib->bucket);
+    rib->hash_size = new_hash_size;
+    rib->bucket = calloc(new_hash_size, sizeof(rt_un_entry_t *));
+
+    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+        rib_index_insert(rib, glthread_to_rt_un_entry(curr));
+    } ITERATE_GLTHREAD_END(&rib->head, curr);
+}
+
+static rt_un_entry_t *
+rib_index_lookup(rt_un_table_t *rib, rt_key_t *rt_key){
+
+    rt_un_entry_t *rt_un_entry = rib->bucket[rib_index_hash(rib, rt_key)];
+
+    for(; rt_un_entry; rt_un_entry = rt_un_entry->hash_next){
+        if(rib->rib_type == MPLS_0){
+            if(UN_RTENTRY_LABEL_MATCH(rt_un_entry, rt_key))
+                return rt_un_entry;
+        }
+        else if(UN_RTENTRY_PFX_MATCH(rt_un_entry, rt_key))
+            return rt_un_entry;
+    }
+    return NULL;
+}
+
+/*Links the entry to rib list and rib index*/
+static void
+rib_link_rt_un_entry(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    glthread_add_next(&rib->head, &rt_un_entry->glthread);
+    rib->count++;
+    if(rib->count > rib->hash_size){
+        /*rehash links the new entry too*/
+        rib_index_rehash(rib, rib->hash_size << 1);
+        return;
     }
-    return -1;
+    rib_index_insert(rib, rt_un_entry);
+}
+
+static void
+rib_index_remove(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    rt_un_entry_t **link = &rib->bucket[rib_index_hash(rib, &rt_un_entry->rt_key)];
+
+    for(; *link; link = &(*link)->hash_next){
+        if(*link != rt_un_entry)
+            continue;
+        *link = rt_un_entry->hash_next;
+        rt_un_entry->hash_next = NULL;
+        return;
+    }
+}
+
+int
+free_rt_un_entry(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    rt_un_entry_flush_nexthops(rib, rt_un_entry);
+    if(rt_un_entry->nhg)
+        nh_group_release(rt_un_entry->nhg);
+    rib_index_remove(rib, rt_un_entry);
+    remove_glthread(&rt_un_entry->glthread);
+    free(rt_un_entry);
+    return 0;
+}
+
+void
+rt_un_entry_set_nh_group(rt_un_table_t *rib, rt_key_t *rt_key, nh_group_t *nhg){
+
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+
+    if(!rt_un_entry || rt_un_entry->nhg == nhg)
+        return;
+    if(nhg)
+        nh_group_hold(nhg);
+    if(rt_un_entry->nhg)
+        nh_group_release(rt_un_entry->nhg);
+    rt_un_entry->nhg = nhg;
+}
+
+boolean
+rt_un_entry_is_nh_usable(rt_un_entry_t *rt_un_entry, internal_un_nh_t *nexthop){
+
+    /*Local POP nexthop*/
+    if(!nexthop->oif)
+        return TRUE;
+    if(!(GET_EGDE_PTR_FROM_FROM_EDGE_END(nexthop->oif))->status)
+        return FALSE;
+    return !nh_group_is_oif_bypassed(rt_un_entry->nhg, nexthop->oif);
 }
 
 internal_un_nh_t *
@@ -223,19 +505,35 @@ lookup_clone_next_hop(rt_un_table_t *rib,
 
 
 /*Rib functions*/
+/*Logs the removal of all nexthops of entry*/
+static void
+rt_un_entry_clog_nh_delete(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    glthread_t *curr = NULL;
+
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+        rib_clog_event(rib, RIB_CLOG_NH_DELETE, &rt_un_entry->rt_key,
+                       rt_un_entry->level, glthread_to_unified_nh(curr));
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+}
+
 boolean
 inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level, 
                             internal_un_nh_t *nexthop){
    
-    glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
+    char gw_prefix[PREFIX_LEN + 1];
      
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
     
+    rib_clog_touch(rib, rt_key);
+
     rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
     internal_un_nh_t *existing_nh = NULL;
 
@@ -244,30 +542,29 @@ inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
         memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
         time(&rt_un_entry->last_refresh_time);
         rt_un_entry->level = level;
-        glthread_add_next(&rib->head, &rt_un_entry->glthread);
-        rib->count++;
+        rib_link_rt_un_entry(rib, rt_un_entry);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_ADD, rt_key, level, NULL);
     }
 
     if(rt_un_entry->level != level){
         /*replace the route with incoming version*/
+        rt_un_entry_clog_nh_delete(rib, rt_un_entry);
         rt_un_entry->flags = 0;
         rt_un_entry->level = level;
         time(&rt_un_entry->last_refresh_time);
         
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
-            nxt_hop = glthread_to_unified_nh(curr);
-            remove_glthread(curr);
-            free_un_nexthop(nxt_hop);
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-        
+        rt_un_entry_flush_nexthops(rib, rt_un_entry);
         init_glthread(&rt_un_entry->nh_list_head);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_MODIFY, rt_key, level, NULL);
     }
 
     if(!nexthop){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+            trace(instance->traceopts, ROUTING_TABLE_BIT);
+        }
 #endif
         return TRUE;
     }
@@ -279,19 +576,18 @@ inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     
     if(existing_nh){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
-            rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
-            RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+                rib->rib_name, existing_nh->oif->intf_name, get_un_next_hop_gateway_pfx(existing_nh, gw_prefix), existing_nh->nh_node->node_name,
+                RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+            trace(instance->traceopts, ROUTING_TABLE_BIT);
+        }
 #endif
         return FALSE;
     }
 
-    init_glthread(&nexthop->glthread);
-    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
-        glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    else
-        glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
+    nxt_hop = rt_un_entry_add_nexthop(rib, rt_un_entry, nexthop);
+    rib_clog_event(rib, RIB_CLOG_NH_ADD, rt_key, level, nxt_hop);
     
     return TRUE;
 }
@@ -300,31 +596,25 @@ static boolean
 inet_0_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
+    rib_clog_touch(rib, &rt_un_entry->rt_key);
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
-    glthread_add_next(&rib->head, &rt_un_entry->glthread);
-    rib->count++;
+    rib_link_rt_un_entry(rib, rt_un_entry);
+    rib_clog_event(rib, RIB_CLOG_ROUTE_ADD, &rt_un_entry->rt_key,
+                   rt_un_entry->level, NULL);
     return TRUE;
 }
 
 static rt_un_entry_t *
 inet_0_rt_un_route_lookup(rt_un_table_t *rib, rt_key_t *rt_key){
      
-    glthread_t *curr = NULL;
-    rt_un_entry_t *rt_un_entry = NULL;
-    
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        
-       rt_un_entry = glthread_to_rt_un_entry(curr);
-       if(UN_RTENTRY_PFX_MATCH(rt_un_entry, rt_key))
-           return rt_un_entry;    
-    } ITERATE_GLTHREAD_END(&rib->head, curr);
-
-    return NULL;
+    return rib_index_lookup(rib, rt_key);
 }
 
 static boolean
@@ -341,14 +631,19 @@ inet_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
-            RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
+                RT_ENTRY_MASK(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
+    /*Only the net change of delete + install is logged*/
+    rib_clog_begin(rib);
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
     rib->rt_un_route_install(rib, rt_un_entry);
+    rib_clog_commit(rib);
 
     rt_un_entry->last_refresh_time = time(NULL);
     return TRUE;
@@ -358,32 +653,27 @@ inet_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
 static boolean
 inet_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
 
-    glthread_t *curr = NULL;
-
-    rt_un_entry_t *temp = NULL,
-                  *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
 
     if(!rt_un_entry){
         printf("%s() : Warning route for %s/%d not found in routing table\n", 
-            __FUNCTION__, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+            __FUNCTION__, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
         return FALSE;
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        temp = glthread_to_rt_un_entry(curr);
-        if(UN_RTENTRY_PFX_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
-            return TRUE;
-        }
-    }ITERATE_GLTHREAD_END(&rib->head, curr);
-    return FALSE;
+    rib_clog_touch(rib, rt_key);
+    rib_clog_event(rib, RIB_CLOG_ROUTE_DELETE, &rt_un_entry->rt_key, rt_un_entry->level, NULL);
+    free_rt_un_entry(rib, rt_un_entry);
+    rib->count--;
+    return TRUE;
 }
 
 
@@ -391,15 +681,19 @@ boolean
 inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level,
                             internal_un_nh_t *nexthop){
    
-    glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
+    char gw_prefix[PREFIX_LEN + 1];
      
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
+    rib_clog_touch(rib, rt_key);
+
     rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
     internal_un_nh_t *existing_nh = NULL;
 
@@ -408,29 +702,30 @@ inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
         memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
         time(&rt_un_entry->last_refresh_time);
         rt_un_entry->level = level;
-        glthread_add_next(&rib->head, &rt_un_entry->glthread);
-        rib->count++;
+        rib_link_rt_un_entry(rib, rt_un_entry);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_ADD, rt_key, level, NULL);
     }
     
     if(rt_un_entry->level != level){
         /*replace the route with incoming version*/
+        rt_un_entry_clog_nh_delete(rib, rt_un_entry);
         rt_un_entry->flags = 0;
         rt_un_entry->level = level;
         time(&rt_un_entry->last_refresh_time);
         
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
-            nxt_hop = glthread_to_unified_nh(curr);
-            remove_glthread(curr);
-            free_un_nexthop(nxt_hop);
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-        
+        rt_un_entry_flush_nexthops(rib, rt_un_entry);
         init_glthread(&rt_un_entry->nh_list_head);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_MODIFY, rt_key, level, NULL);
     }
 
     if(!nexthop){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+            trace(instance->traceopts, ROUTING_TABLE_BIT);
+        }
+#endif
         return TRUE;
     }
 
@@ -439,19 +734,19 @@ inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
 
     if(existing_nh){
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+#ifdef __ENABLE_TRACE__        
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+                rib->rib_name, existing_nh->oif->intf_name, get_un_next_hop_gateway_pfx(existing_nh, gw_prefix), existing_nh->nh_node->node_name,
+                RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+            trace(instance->traceopts, ROUTING_TABLE_BIT);
+        }
 #endif
-            rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
-            RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
         return FALSE;
     }
 
-    init_glthread(&nexthop->glthread);
-    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
-        glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    else
-        glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
+    nxt_hop = rt_un_entry_add_nexthop(rib, rt_un_entry, nexthop);
+    rib_clog_event(rib, RIB_CLOG_NH_ADD, rt_key, level, nxt_hop);
     
     return TRUE;
 }
@@ -460,31 +755,25 @@ static boolean
 inet_3_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
+    rib_clog_touch(rib, &rt_un_entry->rt_key);
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
-    glthread_add_next(&rib->head, &rt_un_entry->glthread);
-    rib->count++;
+    rib_link_rt_un_entry(rib, rt_un_entry);
+    rib_clog_event(rib, RIB_CLOG_ROUTE_ADD, &rt_un_entry->rt_key,
+                   rt_un_entry->level, NULL);
     return TRUE;
 }
 
 static rt_un_entry_t *
 inet_3_rt_un_route_lookup(rt_un_table_t *rib, rt_key_t *rt_key){
      
-    glthread_t *curr = NULL;
-    rt_un_entry_t *rt_un_entry = NULL;
-    
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        
-       rt_un_entry = glthread_to_rt_un_entry(curr);
-       if(UN_RTENTRY_PFX_MATCH(rt_un_entry, rt_key))
-           return rt_un_entry;    
-    } ITERATE_GLTHREAD_END(&rib->head, curr);
-
-    return NULL;
+    return rib_index_lookup(rib, rt_key);
 }
 
 static boolean
@@ -501,14 +790,19 @@ inet_3_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
-            RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
+                RT_ENTRY_MASK(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
+    /*Only the net change of delete + install is logged*/
+    rib_clog_begin(rib);
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
     rib->rt_un_route_install(rib, rt_un_entry);
+    rib_clog_commit(rib);
 
     rt_un_entry->last_refresh_time = time(NULL);
     return TRUE;
@@ -518,32 +812,27 @@ inet_3_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
 static boolean
 inet_3_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
 
-    glthread_t *curr = NULL;
-
-    rt_un_entry_t *temp = NULL,
-                  *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
 
     if(!rt_un_entry){
         printf("%s() : Warning route for %s/%d not found in routing table\n", 
-            __FUNCTION__, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+            __FUNCTION__, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
         return FALSE;
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        temp = glthread_to_rt_un_entry(curr);
-        if(UN_RTENTRY_PFX_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
-            return TRUE;
-        }
-    }ITERATE_GLTHREAD_END(&rib->head, curr);
-    return FALSE;
+    rib_clog_touch(rib, rt_key);
+    rib_clog_event(rib, RIB_CLOG_ROUTE_DELETE, &rt_un_entry->rt_key, rt_un_entry->level, NULL);
+    free_rt_un_entry(rib, rt_un_entry);
+    rib->count--;
+    return TRUE;
 }
 
 
@@ -551,15 +840,19 @@ static boolean
 mpls_0_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d(%u) to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
-            RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d(%u) to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
+                RT_ENTRY_LABEL(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
+    rib_clog_touch(rib, &rt_un_entry->rt_key);
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
-    glthread_add_next(&rib->head, &rt_un_entry->glthread);
-    rib->count++;
+    rib_link_rt_un_entry(rib, rt_un_entry);
+    rib_clog_event(rib, RIB_CLOG_ROUTE_ADD, &rt_un_entry->rt_key,
+                   rt_un_entry->level, NULL);
     return TRUE;
 }
 
@@ -568,17 +861,21 @@ boolean
 mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level,
                             internal_un_nh_t *nexthop){
     
-    glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
+    char gw_prefix[PREFIX_LEN + 1];
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
     /*Refresh time before adding an enntry*/
     time(&nexthop->last_refresh_time);
 
+    rib_clog_touch(rib, rt_key);
+
     rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
     internal_un_nh_t *existing_nh = NULL;
 
@@ -587,59 +884,44 @@ mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
         memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
         time(&rt_un_entry->last_refresh_time);
         rt_un_entry->level = level;
-        glthread_add_next(&rib->head, &rt_un_entry->glthread);
-        rib->count++;
+        rib_link_rt_un_entry(rib, rt_un_entry);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_ADD, rt_key, level, NULL);
     }
 
     if(rt_un_entry->level != level){
         /*replace the route with incoming version*/
+        rt_un_entry_clog_nh_delete(rib, rt_un_entry);
         rt_un_entry->flags = 0;
         rt_un_entry->level = level;
         time(&rt_un_entry->last_refresh_time);
         
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
-            nxt_hop = glthread_to_unified_nh(curr);
-            remove_glthread(curr);
-            free_un_nexthop(nxt_hop);
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-        
+        rt_un_entry_flush_nexthops(rib, rt_un_entry);
         init_glthread(&rt_un_entry->nh_list_head);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_MODIFY, rt_key, level, NULL);
     }
 
     existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
     if(existing_nh){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
-            rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
-            RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+                rib->rib_name, existing_nh->oif->intf_name, get_un_next_hop_gateway_pfx(existing_nh, gw_prefix), existing_nh->nh_node->node_name,
+                RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+            trace(instance->traceopts, ROUTING_TABLE_BIT);
+        }
 #endif
         return FALSE;
     }
 
-    init_glthread(&nexthop->glthread);
-    
-    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
-        glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    else
-        glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
+    nxt_hop = rt_un_entry_add_nexthop(rib, rt_un_entry, nexthop);
+    rib_clog_event(rib, RIB_CLOG_NH_ADD, rt_key, level, nxt_hop);
     return TRUE;
 }
 
 static rt_un_entry_t *
 mpls_0_rt_un_route_lookup(rt_un_table_t *rib, rt_key_t *rt_key){
      
-    glthread_t *curr = NULL;
-    rt_un_entry_t *rt_un_entry = NULL;
-    
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        
-       rt_un_entry = glthread_to_rt_un_entry(curr);
-       if(UN_RTENTRY_LABEL_MATCH(rt_un_entry, rt_key))
-           return rt_un_entry;    
-    } ITERATE_GLTHREAD_END(&rib->head, curr);
-
-    return NULL;
+    return rib_index_lookup(rib, rt_key);
 }
 
 static boolean
@@ -656,14 +938,19 @@ mpls_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d(%u) to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
-            RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d(%u) to Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
+                RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
+    /*Only the net change of delete + install is logged*/
+    rib_clog_begin(rib);
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
     rib->rt_un_route_install(rib, rt_un_entry);
+    rib_clog_commit(rib);
 
     rt_un_entry->last_refresh_time = time(NULL);
     return TRUE;
@@ -673,10 +960,7 @@ mpls_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
 static boolean
 mpls_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
 
-    glthread_t *curr = NULL;
-
-    rt_un_entry_t *temp = NULL,
-                  *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
 
     if(!rt_un_entry){
         printf("%s() : Warning route for %s/%d(%u) not found in routing table\n", 
@@ -686,21 +970,19 @@ mpls_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d(%u) from Routing table",
-            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
-            RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d(%u) from Routing table",
+                rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
+                RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
+        trace(instance->traceopts, ROUTING_TABLE_BIT);
+    }
 #endif
 
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        temp = glthread_to_rt_un_entry(curr);
-        if(UN_RTENTRY_LABEL_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
-            return TRUE;
-        }
-    }ITERATE_GLTHREAD_END(&rib->head, curr);
-    return FALSE;
+    rib_clog_touch(rib, rt_key);
+    rib_clog_event(rib, RIB_CLOG_ROUTE_DELETE, &rt_un_entry->rt_key, rt_un_entry->level, NULL);
+    free_rt_un_entry(rib, rt_un_entry);
+    rib->count--;
+    return TRUE;
 }
 
 internal_un_nh_t *
@@ -710,8 +992,7 @@ inet_0_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto){
     un_nh->oif = nexthop->oif;
     un_nh->protocol = proto;
     un_nh->nh_node = nexthop->node;
-    strncpy(un_nh->gw_prefix, nexthop->gw_prefix, PREFIX_LEN);
-    un_nh->gw_prefix[PREFIX_LEN] = '\0';
+    set_un_next_hop_gw_pfx(un_nh, nexthop->gw_prefix);
     un_nh->protected_link = nexthop->protected_link;
     if(!un_nh->protected_link)
         SET_BIT(un_nh->flags, PRIMARY_NH);
@@ -720,11 +1001,29 @@ inet_0_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto){
     un_nh->lfa_type = nexthop->lfa_type;
     un_nh->root_metric = nexthop->root_metric;
     un_nh->dest_metric = nexthop->dest_metric;
+    un_nh->ucmp_weight = 1;
     time(&un_nh->last_refresh_time);
-    init_glthread(&un_nh->glthread);
     return un_nh;
 }
 
+/*Route nexthop label stack is executed from highest index to 0,
+ * skipping empty entries. Unified nexthop keeps it in that order*/
+static void
+un_nh_compile_label_ops(internal_un_nh_t *un_nh, internal_nh_t *nexthop){
+
+    int i = MPLS_STACK_OP_LIMIT_MAX -1;
+
+    memset(un_nh->label_ops, 0, sizeof(un_nh->label_ops));
+    un_nh->n_label_ops = 0;
+    for(; i >= 0; i--){
+        if(nexthop->stack_op[i] == STACK_OPS_UNKNOWN &&
+            nexthop->mpls_label_out[i] == 0)
+            continue;
+        add_internal_un_nh_label_op(un_nh, nexthop->stack_op[i],
+            nexthop->mpls_label_out[i]);
+    }
+}
+
 /*This fn converts the RSVP|LDP|SPRING nexthop on ingress router
  * into inet.3 route format*/
 internal_un_nh_t *
@@ -771,8 +1070,8 @@ inet_3_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto,
                 return un_nh;
             }
             SET_BIT(un_nh->flags, IPV4_LDP_NH);
-            un_nh->nh.inet3_nh.mpls_label_out[0] = nexthop->mpls_label_out[0];
-            un_nh->nh.inet3_nh.stack_op[0] = nexthop->stack_op[0];
+            if(nexthop->stack_op[0] != STACK_OPS_UNKNOWN || nexthop->mpls_label_out[0])
+                set_internal_un_nh_label_op(un_nh, nexthop->stack_op[0], nexthop->mpls_label_out[0]);
             return un_nh;
         }
         break;
@@ -793,15 +1092,10 @@ inet_3_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto,
                 break;
             }
             
-            /*copy stack*/
-            int i = MPLS_STACK_OP_LIMIT_MAX -1;
-            for(; i >= 0; i--){
-                un_nh->nh.mpls0_nh.mpls_label_out[i] = nexthop->mpls_label_out[i];
-                un_nh->nh.mpls0_nh.stack_op[i] = nexthop->stack_op[i];
-            }
+            un_nh_compile_label_ops(un_nh, nexthop);
             /*Change top Label stack operation to PUSH*/
-            unsigned int top_index = get_stack_top_index(un_nh);
-            un_nh->nh.mpls0_nh.stack_op[top_index] = PUSH;
+            if(un_nh->n_label_ops)
+                un_nh->label_ops[0].stack_op = PUSH;
             return un_nh;
         }
         break;
@@ -833,13 +1127,7 @@ mpls_0_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto){
     }
 
     /*Fill the MPLS label stack*/
-
-    unsigned int i = 0;
-    
-    for(; i < MPLS_STACK_OP_LIMIT_MAX; i++){
-        un_nh->nh.mpls0_nh.mpls_label_out[i] = nexthop->mpls_label_out[i];
-        un_nh->nh.mpls0_nh.stack_op[i] = nexthop->stack_op[i];
-    }
+    un_nh_compile_label_ops(un_nh, nexthop);
 
     return un_nh;
 }
@@ -851,6 +1139,10 @@ init_rib(rib_type_t rib_type){
     rt_un_table_t * rib = calloc(1, sizeof(rt_un_table_t));
     rib->count = 0;
     init_glthread(&rib->head);
+    rib->hash_size = RIB_INDEX_INIT_SIZE;
+    rib->bucket = calloc(rib->hash_size, sizeof(rt_un_entry_t *));
+    rib->rib_type = rib_type;
+    rib->clog = init_rib_clog();
 
     switch (rib_type){
         case INET_0:
@@ -900,21 +1192,42 @@ flush_rib(rt_un_table_t *rib, LEVEL level){
         rt_un_entry = glthread_to_rt_un_entry(curr);
         if(rt_un_entry->level != level)
             continue;
-        rc = free_rt_un_entry(rt_un_entry);
+        rib_clog_touch(rib, &rt_un_entry->rt_key);
+        rib_clog_event(rib, RIB_CLOG_ROUTE_DELETE, &rt_un_entry->rt_key, level, NULL);
+        rc = free_rt_un_entry(rib, rt_un_entry);
         if(rc == 0) count++;
     } ITERATE_GLTHREAD_END(&rib->head, curr);
     rib->count -= count;
 }
 
+/*Weights are displayed only when primary nexthops of the route
+ * do not share the traffic equally*/
+static boolean
+is_rt_un_entry_ucmp(rt_un_entry_t *rt_un_entry){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nexthop = NULL;
+
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+        nexthop = glthread_to_unified_nh(curr);
+        if(IS_BIT_SET(nexthop->flags, PRIMARY_NH) && nexthop->ucmp_weight > 1)
+            return TRUE;
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    return FALSE;
+}
+
 void
 inet_0_display(rt_un_table_t *rib, char *prefix, char mask){
 
     glthread_t *curr = NULL, *curr1 = NULL;
     rt_un_entry_t *rt_un_entry = NULL;
     internal_un_nh_t *nexthop = NULL;
+    char gw_prefix[PREFIX_LEN + 1];
     time_t curr_time = time(NULL);
+    boolean is_ucmp = FALSE;
 
-    printf("%s  count : %u\n\n", rib->rib_name, rib->count);
+    printf("%s  count : %u, nexthops : %u (shared by %u references)\n\n", rib->rib_name,
+            rib->count, rib->nh_pool.count, rib->nh_pool.refs);
     if(prefix){
         rt_key_t rt_key;
         memset(&rt_key, 0, sizeof(rt_key_t));
@@ -928,14 +1241,18 @@ inet_0_display(rt_un_table_t *rib, char *prefix, char mask){
         }
         printf("%s/%u(L%u)\n", RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key), rt_un_entry->level);
+        is_ucmp = is_rt_un_entry_ucmp(rt_un_entry);
 
         ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
             nexthop = glthread_to_unified_nh(curr1);
-            printf("\t%-12s %-16s %-16s   %s %-8si %s\n", protocol_name(nexthop->protocol),
-                    nexthop->oif->intf_name, nexthop->gw_prefix,
+            printf("\t%-12s %-16s %-16s   %s %-8si %s", protocol_name(nexthop->protocol),
+                    nexthop->oif->intf_name, get_un_next_hop_gateway_pfx(nexthop, gw_prefix),
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
+            if(is_ucmp && IS_BIT_SET(nexthop->flags, PRIMARY_NH))
+                printf("   weight %u", nexthop->ucmp_weight);
+            printf("\n");
         } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
         return;
     }
@@ -945,18 +1262,35 @@ inet_0_display(rt_un_table_t *rib, char *prefix, char mask){
         rt_un_entry = glthread_to_rt_un_entry(curr);
         printf("%s/%u(L%u)\n", RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
             rt_un_entry->level);
+        is_ucmp = is_rt_un_entry_ucmp(rt_un_entry);
 
         ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
             nexthop = glthread_to_unified_nh(curr1);
-            printf("\t%-12s %-16s %-16s   %s %-8s %s\n", protocol_name(nexthop->protocol),
-                    nexthop->oif->intf_name, nexthop->gw_prefix,
+            printf("\t%-12s %-16s %-16s   %s %-8s %s", protocol_name(nexthop->protocol),
+                    nexthop->oif->intf_name, get_un_next_hop_gateway_pfx(nexthop, gw_prefix),
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
+            if(is_ucmp && IS_BIT_SET(nexthop->flags, PRIMARY_NH))
+                printf("   weight %u", nexthop->ucmp_weight);
+            printf("\n");
         } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
     } ITERATE_GLTHREAD_END(&rib->head, curr);
 }
 
+static void
+print_un_nh_label_ops(internal_un_nh_t *nexthop){
+
+    unsigned int i = 0;
+
+    for(; i < nexthop->n_label_ops; i++){
+        if(nexthop->label_ops[i].stack_op == POP)
+            printf("%s  ", get_str_stackops(nexthop->label_ops[i].stack_op));
+        else
+            printf("%s:%u  ", get_str_stackops(nexthop->label_ops[i].stack_op),
+                    nexthop->label_ops[i].label);
+    }
+}
 
 void
 inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
@@ -964,10 +1298,11 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
     glthread_t *curr = NULL, *curr1 = NULL;
     rt_un_entry_t *rt_un_entry = NULL;
     internal_un_nh_t *nexthop = NULL;
-    int i = 0;
+    char gw_prefix[PREFIX_LEN + 1];
     time_t curr_time = time(NULL);
 
-    printf("%s  count : %u\n\n", rib->rib_name, rib->count);
+    printf("%s  count : %u, nexthops : %u (shared by %u references)\n\n", rib->rib_name,
+            rib->count, rib->nh_pool.count, rib->nh_pool.refs);
     if(prefix){
         rt_key_t rt_key;
         memset(&rt_key, 0, sizeof(rt_key_t));
@@ -984,25 +1319,14 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
         ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %s %-8s %s\n", protocol_name(nexthop->protocol), 
-                    nexthop->oif->intf_name, nexthop->gw_prefix,
+                    nexthop->oif->intf_name, get_un_next_hop_gateway_pfx(nexthop, gw_prefix),
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
 
             /*Print spring stack here*/
-            i = MPLS_STACK_OP_LIMIT_MAX -1;
             printf("\t\t");
-
-            for(; i >= 0; i--){
-                if(nexthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-                        nexthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-                    continue;
-                if(nexthop->nh.inet3_nh.stack_op[i] == POP)
-                    printf("%s  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]));
-                else
-                    printf("%s:%u  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]),   \
-                            nexthop->nh.inet3_nh.mpls_label_out[i]);
-            }
+            print_un_nh_label_ops(nexthop);
             printf("\n");
         } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
         return;
@@ -1018,25 +1342,14 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
         ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %s %-8s %s\n", protocol_name(nexthop->protocol),
-                    nexthop->oif->intf_name, nexthop->gw_prefix,
+                    nexthop->oif->intf_name, get_un_next_hop_gateway_pfx(nexthop, gw_prefix),
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
 
             /*Print spring stack here*/
-            i = MPLS_STACK_OP_LIMIT_MAX -1;
             printf("\t\t");
-
-            for(; i >= 0; i--){
-                if(nexthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-                        nexthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-                    continue;
-                if(nexthop->nh.inet3_nh.stack_op[i] == POP)
-                    printf("%s  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]));
-                else
-                    printf("%s:%u  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]),   \
-                            nexthop->nh.inet3_nh.mpls_label_out[i]);
-            }
+            print_un_nh_label_ops(nexthop);
             printf("\n");
         } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
     } ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -1048,10 +1361,11 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
     glthread_t *curr = NULL, *curr1 = NULL;
     rt_un_entry_t *rt_un_entry = NULL;
     internal_un_nh_t *nexthop = NULL;
-    int i = 0;
+    char gw_prefix[PREFIX_LEN + 1];
     time_t curr_time = time(NULL);
 
-    printf("%s  count : %u\n\n", rib->rib_name, rib->count);
+    printf("%s  count : %u, nexthops : %u (shared by %u references)\n\n", rib->rib_name,
+            rib->count, rib->nh_pool.count, rib->nh_pool.refs);
     if(in_label){
         rt_key_t rt_key;
         memset(&rt_key, 0, sizeof(rt_key_t));
@@ -1071,25 +1385,14 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
             printf("\tInLabel : %u, %-12s %-16s %-16s   %-8s %s %s\n", in_label, 
                     protocol_name(nexthop->protocol), 
                     nexthop->oif ? nexthop->oif->intf_name : "NULL", 
-                    nexthop->gw_prefix,
+                    get_un_next_hop_gateway_pfx(nexthop, gw_prefix),
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
 
             /*Print spring stack here*/
-            i = MPLS_STACK_OP_LIMIT_MAX -1;
             printf("\t\t");
-
-            for(; i >= 0; i--){
-                if(nexthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-                        nexthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-                    continue;
-                if(nexthop->nh.inet3_nh.stack_op[i] == POP)
-                    printf("%s  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]));
-                else
-                    printf("%s:%u  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]),   \
-                            nexthop->nh.inet3_nh.mpls_label_out[i]);
-            }
+            print_un_nh_label_ops(nexthop);
             printf("\n");
         } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
         return;
@@ -1108,75 +1411,38 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
             printf("\t%-12s %-16s %-16s   %-8s %s %s\n", 
                     protocol_name(nexthop->protocol), 
                     nexthop->oif ? nexthop->oif->intf_name : "NULL", 
-                    nexthop->gw_prefix,
+                    get_un_next_hop_gateway_pfx(nexthop, gw_prefix),
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
 
             /*Print spring stack here*/
-            i = MPLS_STACK_OP_LIMIT_MAX -1;
             printf("\t\t");
-
-            for(; i >= 0; i--){
-                if(nexthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-                        nexthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-                    continue;
-                if(nexthop->nh.inet3_nh.stack_op[i] == POP)
-                    printf("%s  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]));
-                else
-                    printf("%s:%u  ", get_str_stackops(nexthop->nh.inet3_nh.stack_op[i]),   \
-                            nexthop->nh.inet3_nh.mpls_label_out[i]);
-            }
+            print_un_nh_label_ops(nexthop);
             printf("\n");
         } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
     } ITERATE_GLTHREAD_END(&rib->head, curr);
 }
 
-int
-get_stack_top_index(internal_un_nh_t *nexthop){
-
-    int i = MPLS_STACK_OP_LIMIT_MAX -1;
-    for(; i >= 0; i--){
-        if(nexthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-            nexthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-            continue;
-        return i;   
-    }
-    return -1;
-}
-
-
-
 /*Applicable for inet.0 and inet.3 tables*/
 
 rt_un_entry_t *
 get_longest_prefix_match2(rt_un_table_t *rib, char *prefix){
 
-    rt_un_entry_t *rt_un_entry = NULL,
-                  *lpm_rt_un_entry = NULL,
-                  *rt_default_un_entry = NULL;
-
-    glthread_t *curr = NULL;
-    char subnet[PREFIX_LEN + 1];
-    char longest_mask = 0;
+    rt_un_entry_t *rt_un_entry = NULL;
+    rt_key_t rt_key;
+    int mask = 32;
 
-    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
-        
-        rt_un_entry = glthread_to_rt_un_entry(curr);
-        memset(subnet, 0, PREFIX_LEN + 1);
-        apply_mask(prefix, RT_ENTRY_MASK(&rt_un_entry->rt_key), subnet);
-        if(strncmp(ZERO_IP, RT_ENTRY_PFX(&rt_un_entry->rt_key), strlen(ZERO_IP)) == 0 &&
-                RT_ENTRY_MASK(&rt_un_entry->rt_key) == 0){
-            rt_default_un_entry = rt_un_entry;
-        }
-        else if(strncmp(subnet, RT_ENTRY_PFX(&rt_un_entry->rt_key), strlen(subnet)) == 0){
-            if( RT_ENTRY_MASK(&rt_un_entry->rt_key) > longest_mask){
-                longest_mask = RT_ENTRY_MASK(&rt_un_entry->rt_key);
-                lpm_rt_un_entry = rt_un_entry;
-            }
-        }
-    }ITERATE_GLTHREAD_END(&rib->head, curr);
-    return lpm_rt_un_entry ? lpm_rt_un_entry : rt_default_un_entry;
+    /*Probe the rib index for each mask, longest first*/
+    for(; mask >= 0; mask--){
+        memset(&rt_key, 0, sizeof(rt_key_t));
+        apply_mask(prefix, (char)mask, RT_ENTRY_PFX(&rt_key));
+        RT_ENTRY_MASK(&rt_key) = (unsigned char)mask;
+        rt_un_entry = rib_index_lookup(rib, &rt_key);
+        if(rt_un_entry)
+            return rt_un_entry;
+    }
+    return NULL;
 }
 
 static void
@@ -1185,16 +1451,11 @@ execute_nexthop_mpls_label_stack_on_packet(internal_un_nh_t *nxthop,
 
     /*Execute the Nexthop mpls label stack on incoming packet which could be
      * labelled or unlabelled*/
-    int i = MPLS_STACK_OP_LIMIT_MAX -1;
+    unsigned int i = 0;
 
-    for(; i >= 0; i--){
-        MPLS_STACK_OP stack_op = nxthop->nh.mpls0_nh.stack_op[i];
-        mpls_label_t imposing_label =  nxthop->nh.mpls0_nh.mpls_label_out[i];
-        
-        if(stack_op == STACK_OPS_UNKNOWN &&
-                imposing_label == 0){
-            continue;
-        }
+    for(; i < nxthop->n_label_ops; i++){
+        MPLS_STACK_OP stack_op = nxthop->label_ops[i].stack_op;
+        mpls_label_t imposing_label = nxthop->label_ops[i].label;
 
         switch(stack_op){
             case PUSH:
@@ -1229,16 +1490,20 @@ typedef enum{
     TRACE_INCOMPLETE
 } trace_rc_t;
 
+/*Labelled engines impose the labels on caller's mpls_label_stack and return it*/
 typedef mpls_label_stack_t * (*pfe_engine)(node_t *node, char *dst_prefix, 
+                        mpls_label_stack_t *mpls_label_stack,
                         trace_rc_t *trace_rc, node_t **next_node);
 
 
 mpls_label_stack_t *
 ipv4_pfe_engine(node_t *node, char *dst_prefix, 
+                mpls_label_stack_t *mpls_label_stack,
                 trace_rc_t *trace_rc, 
                 node_t **next_node){
 
     unsigned int i = 1;
+    char gw_prefix[PREFIX_LEN + 1];
 
     do{
         rt_un_entry_t * rt_un_entry = 
@@ -1261,13 +1526,10 @@ ipv4_pfe_engine(node_t *node, char *dst_prefix,
                 return NULL;
         }
 
-        edge_t *oif_adjacency = NULL;
-
         if(prim_nh){
-            oif_adjacency = GET_EGDE_PTR_FROM_FROM_EDGE_END(prim_nh->oif);
-            if(!oif_adjacency->status){
+            if(!rt_un_entry_is_nh_usable(rt_un_entry, prim_nh)){
                 backup_nh = GET_FIRST_BACKUP_NH(rt_un_entry, IPV4_NH, PRIMARY_NH);
-                if(!backup_nh || !((GET_EGDE_PTR_FROM_FROM_EDGE_END(backup_nh->oif))->status)){
+                if(!backup_nh || !rt_un_entry_is_nh_usable(rt_un_entry, backup_nh)){
                     /*Means, Primary and backup both are not available*/
                     return NULL;
                 }
@@ -1278,7 +1540,7 @@ ipv4_pfe_engine(node_t *node, char *dst_prefix,
             prim_nh = backup_nh;
 
         printf("%u. %s(%s)--IPNH-->(%s)%s\n", i++, node->node_name, get_un_next_hop_oif_name(prim_nh),
-                get_un_next_hop_gateway_pfx(prim_nh), get_un_next_hop_node(prim_nh)->node_name);
+                get_un_next_hop_gateway_pfx(prim_nh, gw_prefix), get_un_next_hop_node(prim_nh)->node_name);
 
         node = get_un_next_hop_node(prim_nh);
     }while(1);
@@ -1288,7 +1550,8 @@ ipv4_pfe_engine(node_t *node, char *dst_prefix,
 
 
 mpls_label_stack_t *
-ldp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc, 
+ldp_pfe_engine(node_t *node, char *dst_prefix, 
+                mpls_label_stack_t *mpls_label_stack, trace_rc_t *trace_rc, 
                 node_t **next_node){
     
     unsigned int i = 1;
@@ -1303,6 +1566,7 @@ ldp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
     }
 
     internal_un_nh_t *prim_nh = GET_FIRST_NH(rt_un_entry, IPV4_LDP_NH, PRIMARY_NH);
+    char gw_prefix[PREFIX_LEN + 1];
     internal_un_nh_t *backup_nh = NULL;
 
     if(!prim_nh){
@@ -1313,15 +1577,10 @@ ldp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
             return NULL;
     }
 
-    edge_t *oif_adjacency = NULL;
-
     if(prim_nh){
-        
-        oif_adjacency = GET_EGDE_PTR_FROM_FROM_EDGE_END(prim_nh->oif);
-
-        if(!oif_adjacency->status){
+        if(!rt_un_entry_is_nh_usable(rt_un_entry, prim_nh)){
             backup_nh = GET_FIRST_BACKUP_NH(rt_un_entry, IPV4_LDP_NH, PRIMARY_NH);
-            if(!backup_nh || !((GET_EGDE_PTR_FROM_FROM_EDGE_END(backup_nh->oif))->status)){
+            if(!backup_nh || !rt_un_entry_is_nh_usable(rt_un_entry, backup_nh)){
                 /*Means, Primary and backup both are not available*/
                 return NULL;
             }
@@ -1332,9 +1591,9 @@ ldp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
         prim_nh = backup_nh;
 
     printf("%u. %s(%s)--LDP_TUNN_IN->(%s)%s\n", i++, node->node_name, get_un_next_hop_oif_name(prim_nh),
-            get_un_next_hop_gateway_pfx(prim_nh), get_un_next_hop_node(prim_nh)->node_name);
+            get_un_next_hop_gateway_pfx(prim_nh, gw_prefix), get_un_next_hop_node(prim_nh)->node_name);
 
-    mpls_label_stack_t *mpls_label_stack = get_new_mpls_label_stack();
+    init_mpls_label_stack(mpls_label_stack);
     execute_nexthop_mpls_label_stack_on_packet(prim_nh, mpls_label_stack);
 
     *next_node = get_un_next_hop_node(prim_nh);
@@ -1343,7 +1602,8 @@ ldp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
 }
 
 mpls_label_stack_t *
-sr_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc, 
+sr_pfe_engine(node_t *node, char *dst_prefix, 
+                mpls_label_stack_t *mpls_label_stack, trace_rc_t *trace_rc, 
                 node_t **next_node){
     
     unsigned int i = 1;
@@ -1358,6 +1618,7 @@ sr_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
     }
 
     internal_un_nh_t *prim_nh = GET_FIRST_NH(rt_un_entry, IPV4_SPRING_NH, PRIMARY_NH);
+    char gw_prefix[PREFIX_LEN + 1];
     internal_un_nh_t *backup_nh = NULL;
 
     if(!prim_nh){
@@ -1368,15 +1629,10 @@ sr_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
             return NULL;
     }
 
-    edge_t *oif_adjacency = NULL;
-
     if(prim_nh){
-        
-        oif_adjacency = GET_EGDE_PTR_FROM_FROM_EDGE_END(prim_nh->oif);
-
-        if(!oif_adjacency->status){
+        if(!rt_un_entry_is_nh_usable(rt_un_entry, prim_nh)){
             backup_nh = GET_FIRST_BACKUP_NH(rt_un_entry, IPV4_SPRING_NH, PRIMARY_NH);
-            if(!backup_nh || !((GET_EGDE_PTR_FROM_FROM_EDGE_END(backup_nh->oif))->status)){
+            if(!backup_nh || !rt_un_entry_is_nh_usable(rt_un_entry, backup_nh)){
                 /*Means, Primary and backup both are not available*/
                 return NULL;
             }
@@ -1387,9 +1643,9 @@ sr_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
         prim_nh = backup_nh;
 
     printf("%u. %s(%s)--SPR_TUNN_IN->(%s)%s\n", i++, node->node_name, get_un_next_hop_oif_name(prim_nh),
-            get_un_next_hop_gateway_pfx(prim_nh), get_un_next_hop_node(prim_nh)->node_name);
+            get_un_next_hop_gateway_pfx(prim_nh, gw_prefix), get_un_next_hop_node(prim_nh)->node_name);
 
-    mpls_label_stack_t *mpls_label_stack = get_new_mpls_label_stack();
+    init_mpls_label_stack(mpls_label_stack);
     execute_nexthop_mpls_label_stack_on_packet(prim_nh, mpls_label_stack);
 
     *next_node = get_un_next_hop_node(prim_nh);
@@ -1398,7 +1654,8 @@ sr_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
 }
 
 mpls_label_stack_t *
-rsvp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc, 
+rsvp_pfe_engine(node_t *node, char *dst_prefix, 
+                mpls_label_stack_t *mpls_label_stack, trace_rc_t *trace_rc, 
                 node_t **next_node){
     
     unsigned int i = 1;
@@ -1413,6 +1670,7 @@ rsvp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
     }
 
     internal_un_nh_t *prim_nh = GET_FIRST_NH(rt_un_entry, IPV4_RSVP_NH, PRIMARY_NH);
+    char gw_prefix[PREFIX_LEN + 1];
     internal_un_nh_t *backup_nh = NULL;
 
     if(!prim_nh){
@@ -1423,15 +1681,10 @@ rsvp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
             return NULL;
     }
 
-    edge_t *oif_adjacency = NULL;
-
     if(prim_nh){
-        
-        oif_adjacency = GET_EGDE_PTR_FROM_FROM_EDGE_END(prim_nh->oif);
-
-        if(!oif_adjacency->status){
+        if(!rt_un_entry_is_nh_usable(rt_un_entry, prim_nh)){
             backup_nh = GET_FIRST_BACKUP_NH(rt_un_entry, IPV4_RSVP_NH, PRIMARY_NH);
-            if(!backup_nh || !((GET_EGDE_PTR_FROM_FROM_EDGE_END(backup_nh->oif))->status)){
+            if(!backup_nh || !rt_un_entry_is_nh_usable(rt_un_entry, backup_nh)){
                 /*Means, Primary and backup both are not available*/
                 return NULL;
             }
@@ -1442,9 +1695,9 @@ rsvp_pfe_engine(node_t *node, char *dst_prefix, trace_rc_t *trace_rc,
         prim_nh = backup_nh;
 
     printf("%u. %s(%s)--RSVP_TUNN_IN->(%s)%s\n", i++, node->node_name, get_un_next_hop_oif_name(prim_nh),
-            get_un_next_hop_gateway_pfx(prim_nh), get_un_next_hop_node(prim_nh)->node_name);
+            get_un_next_hop_gateway_pfx(prim_nh, gw_prefix), get_un_next_hop_node(prim_nh)->node_name);
 
-    mpls_label_stack_t *mpls_label_stack = get_new_mpls_label_stack();
+    init_mpls_label_stack(mpls_label_stack);
     execute_nexthop_mpls_label_stack_on_packet(prim_nh, mpls_label_stack);
 
     *next_node = get_un_next_hop_node(prim_nh);
@@ -1457,6 +1710,7 @@ transient_mpls_pfe_engine(node_t *node, mpls_label_stack_t *mpls_label_stack,
                           node_t **next_node){
 
     unsigned int i = 1;
+    char gw_prefix[PREFIX_LEN + 1];
     rt_un_entry_t *rt_un_entry = NULL;
     rt_key_t rt_key;
 
@@ -1482,11 +1736,9 @@ transient_mpls_pfe_engine(node_t *node, mpls_label_stack_t *mpls_label_stack,
                 
         if(prim_nh->oif){
 
-            edge_t *oif_adjacency = GET_EGDE_PTR_FROM_FROM_EDGE_END(prim_nh->oif);
-
-            if(!oif_adjacency->status){
+            if(!rt_un_entry_is_nh_usable(rt_un_entry, prim_nh)){
                 prim_nh = GET_FIRST_BACKUP_NH(rt_un_entry, PRIMARY_NH, PRIMARY_NH);
-                if(!prim_nh || !((GET_EGDE_PTR_FROM_FROM_EDGE_END(prim_nh->oif))->status)){
+                if(!prim_nh || !rt_un_entry_is_nh_usable(rt_un_entry, prim_nh)){
                     /*Means, Primary and backup both are not available*/
                     return;
                 }
@@ -1503,13 +1755,13 @@ transient_mpls_pfe_engine(node_t *node, mpls_label_stack_t *mpls_label_stack,
             case SWAP:
                 printf("%u. %s(%s)---swap[%u,%u]--->(%s)%s", i++, node->node_name, 
                     get_un_next_hop_oif_name(prim_nh), rt_key.u.label, outgoing_mpls_label, 
-                    get_un_next_hop_gateway_pfx(prim_nh),
+                    get_un_next_hop_gateway_pfx(prim_nh, gw_prefix),
                     get_un_next_hop_node(prim_nh)->node_name);
                 break;
             case NEXT:
                 printf("%u. %s(%s)---push[%u,%u]--->(%s)%s", i++, node->node_name, 
                     get_un_next_hop_oif_name(prim_nh), rt_key.u.label, outgoing_mpls_label, 
-                    get_un_next_hop_gateway_pfx(prim_nh),
+                    get_un_next_hop_gateway_pfx(prim_nh, gw_prefix),
                     get_un_next_hop_node(prim_nh)->node_name);
                 break;
             case POP:
@@ -1518,7 +1770,7 @@ transient_mpls_pfe_engine(node_t *node, mpls_label_stack_t *mpls_label_stack,
                             get_un_next_hop_oif_name(prim_nh), rt_key.u.label, 
                             IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack) ?  0  : \
                             GET_MPLS_LABEL_STACK_TOP(mpls_label_stack),
-                            get_un_next_hop_gateway_pfx(prim_nh),
+                            get_un_next_hop_gateway_pfx(prim_nh, gw_prefix),
                             get_un_next_hop_node(prim_nh)->node_name);
                 }
                 else{
@@ -1568,6 +1820,7 @@ int
 ping(char *node_name, char *dst_prefix){
 
     trace_rc_t trace_rc = TRACE_INCOMPLETE;
+    mpls_label_stack_t mpls_label_stack_data;
     mpls_label_stack_t *mpls_label_stack = NULL;
     trace_route_pref_order_t pref_order = FIRST_PREF_ORDER;
 
@@ -1577,7 +1830,8 @@ ping(char *node_name, char *dst_prefix){
     printf("Source Node : %s, Prefix traced : %s\n", node_name, dst_prefix);
 
     do{
-        mpls_label_stack = pfe[pref_order](node, dst_prefix, &trace_rc, &next_node);
+        mpls_label_stack = pfe[pref_order](node, dst_prefix, &mpls_label_stack_data,
+                                           &trace_rc, &next_node);
         
         if(mpls_label_stack){
             transient_mpls_pfe_engine(next_node, mpls_label_stack, &next_node);
@@ -1586,13 +1840,9 @@ ping(char *node_name, char *dst_prefix){
              * 1. PHP router ended tunnel Or labelled Dest reached - mpls_label_stack will be empty
              * 2. Tunnel abrubtly ended - mpls_label_stack will not be empty*/
 
-            if(IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack)){
+            if(!IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack)){
                 /* Auto Done : :D :
-                 * Get the prefix from mpls_label_stack and feed it to Ist pref order to next_node*/
-                free_mpls_label_stack(mpls_label_stack);
-            }
-            else{
-                free_mpls_label_stack(mpls_label_stack);
+                 * If empty, feed the prefix to Ist pref order to next_node*/
                 return -1;    
             }
         }
@@ -1620,40 +1870,6 @@ ping(char *node_name, char *dst_prefix){
     return 0;
 }
 
-mpls_label_stack_t *
-get_new_mpls_label_stack(){
-
-        mpls_label_stack_t *mpls_stack = calloc(1, sizeof(mpls_label_stack_t));
-            mpls_stack->stack = get_new_stack();
-                return mpls_stack;
-}
-
-void
-free_mpls_label_stack(mpls_label_stack_t *mpls_label_stack){
-
-        free_stack(mpls_label_stack->stack);
-            free(mpls_label_stack);
-}
-
-void
-PUSH_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack, mpls_label_t label){
-
-       push(mpls_label_stack->stack, (void *)label);
-}
-
-mpls_label_t
-POP_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack){
-
-        return (mpls_label_t)pop(mpls_label_stack->stack);
-}
-
-void
-SWAP_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack, mpls_label_t label){
-
-        POP_MPLS_LABEL(mpls_label_stack);
-            PUSH_MPLS_LABEL(mpls_label_stack, label);
-}
-
 char *
 get_str_stackops(MPLS_STACK_OP stackop){
 
@@ -39,6 +39,8 @@
 #include "bitsop.h"
 #include <time.h>
 #include <stddef.h> /*For NULL*/
+#include <assert.h>
+#include <string.h>
 
 typedef struct routes_ routes_t;
 typedef struct edge_end_ edge_end_t;
@@ -88,49 +90,52 @@ typedef enum {
     POP
 } MPLS_STACK_OP;
 
-/*MPLS stack*/
-typedef struct stack stack_t;
-
+/*MPLS stack of traced packet, fixed capacity value type so that
+ * it lives on the stack of forwarding code*/
 typedef struct _mpls_label_stack{
-        stack_t *stack;
+        int top;    /*index of top label, -1 if empty*/
+        mpls_label_t label[MPLS_LABEL_STACK_MAX_DEPTH];
 } mpls_label_stack_t;
 
-mpls_label_stack_t *
-get_new_mpls_label_stack();
+static inline void
+init_mpls_label_stack(mpls_label_stack_t *mpls_label_stack){
 
-void
-free_mpls_label_stack(mpls_label_stack_t *mpls_label_stack);
+    mpls_label_stack->top = -1;
+}
 
-void
-PUSH_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack, mpls_label_t label);
+#define GET_MPLS_LABEL_STACK_TOP(mpls_label_stack_t_ptr)        \
+    ((mpls_label_stack_t_ptr)->label[(mpls_label_stack_t_ptr)->top])
 
-mpls_label_t
-POP_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack);
+#define IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack_t_ptr)       \
+    ((mpls_label_stack_t_ptr)->top < 0)
 
-void
-SWAP_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack, mpls_label_t label);
+static inline void
+PUSH_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack, mpls_label_t label){
 
+    assert(mpls_label_stack->top < MPLS_LABEL_STACK_MAX_DEPTH - 1);
+    mpls_label_stack->label[++mpls_label_stack->top] = label;
+}
 
-#define GET_MPLS_LABEL_STACK_TOP(mpls_label_stack_t_ptr)        \
-    ((mpls_label_t)getTopElem(mpls_label_stack_t_ptr->stack))
+static inline mpls_label_t
+POP_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack){
 
-#define IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack_t_ptr)       \
-    isStackEmpty(mpls_label_stack_t_ptr->stack)
+    return mpls_label_stack->label[mpls_label_stack->top--];
+}
+
+static inline void
+SWAP_MPLS_LABEL(mpls_label_stack_t *mpls_label_stack, mpls_label_t label){
+
+    mpls_label_stack->label[mpls_label_stack->top] = label;
+}
 
 /*MPLS data plane*/
 
-/*inet.3 nexthop*/
-struct inet_3_nh_t{
-    mpls_label_t mpls_label_out[MPLS_STACK_OP_LIMIT_MAX];
-    MPLS_STACK_OP stack_op[MPLS_STACK_OP_LIMIT_MAX];    
-};
+/*One label stack operation of nexthop*/
+typedef struct mpls_label_op_{
 
-/*mpls.0 nexthop*/
-struct mpls_0_nh_t{
-    //mpls_label_t mpls_label_in;
-    mpls_label_t mpls_label_out[MPLS_STACK_OP_LIMIT_MAX];
-    MPLS_STACK_OP stack_op[MPLS_STACK_OP_LIMIT_MAX];
-} ;
+    mpls_label_t label;
+    unsigned char stack_op; /*MPLS_STACK_OP*/
+} mpls_label_op_t;
 
 typedef struct internal_un_nh_t_{
 
@@ -138,14 +143,9 @@ typedef struct internal_un_nh_t_{
     PROTOCOL protocol;  /*protocol which installed this nexthop*/
     edge_end_t *oif;        /*use it only for intf name*/
     node_t *nh_node;        /*This member should be removed*/
-    char gw_prefix[PREFIX_LEN + 1];
-
-    union u_t{
-        struct inet_3_nh_t inet3_nh;
-        struct mpls_0_nh_t mpls0_nh;
-    }nh; 
-
-    //union u_t nh;
+    /*Gateway IPv4 address in network byte order, 0 if none. It is
+     * formatted only for display, see get_un_next_hop_gateway_pfx()*/
+    unsigned int gw_ip;
 
     /* Bit 0 is used to identify whether the nexthop is primary
      * or backup nexthop. Same can also be identified using NULL check
@@ -163,7 +163,7 @@ typedef struct internal_un_nh_t_{
     #define SPRING_TRANSIT_NH   7 /*Supported*/
 
     FLAG flags;
-    unsigned int ref_count; /*How many routes using this as Nexthop*/
+    unsigned int ref_count; /*How many routing entries using this as Nexthop*/
 
     /*A primary nexthop can have backups. Below fields represent
      * backup nexthop for this primary nexthop.*/ 
@@ -179,10 +179,35 @@ typedef struct internal_un_nh_t_{
     unsigned int root_metric;
     unsigned int dest_metric;
     time_t last_refresh_time;
-    glthread_t glthread;
+    /*UCMP : share of route's traffic in buckets, relative to other
+     * primary nexthops of the route. 1 for equal cost multipath*/
+    unsigned int ucmp_weight;
+
+    /*MPLS label stack operations in order of execution on packet,
+     * label_ops[0] is the top operation*/
+    unsigned char n_label_ops;
+    mpls_label_op_t label_ops[MPLS_STACK_OP_LIMIT_MAX];
+
+    /*Nexthop pool of the RIB*/
+    unsigned int hash;
+    struct internal_un_nh_t_ *pool_next;
 } internal_un_nh_t;
 
-GLTHREAD_TO_STRUCT(glthread_to_unified_nh, internal_un_nh_t, glthread, glthreadptr);
+/*Nexthops installed in a RIB are interned in RIB's nexthop pool and
+ * shared by all routing entries, routing entry holds nexthops by reference*/
+typedef struct rt_un_nh_ref_{
+
+    internal_un_nh_t *nexthop;
+    glthread_t glthread;
+} rt_un_nh_ref_t;
+
+GLTHREAD_TO_STRUCT(glthread_to_rt_un_nh_ref, rt_un_nh_ref_t, glthread, glthreadptr);
+
+static inline internal_un_nh_t *
+glthread_to_unified_nh(glthread_t *glthreadptr){
+
+    return glthread_to_rt_un_nh_ref(glthreadptr)->nexthop;
+}
 
 static inline char *
 get_str_nexthop_type(char flags){
@@ -211,14 +236,20 @@ get_str_nexthop_type(char flags){
     return "UNKNOWN";
 }
 
+typedef struct nh_group_ nh_group_t;
+
 typedef struct rt_un_entry_{
 
     rt_key_t rt_key;
     glthread_t nh_list_head;
+    /*Nexthop group of the route this entry is installed from, shared
+     * with other entries. NULL if entry is not derived from a route*/
+    nh_group_t *nhg;
     FLAG flags; /*Flags for this routing entry*/
     LEVEL level;
     time_t last_refresh_time;
     glthread_t glthread;
+    struct rt_un_entry_ *hash_next; /*hash bucket chain of rib index*/
 } rt_un_entry_t;
 
 GLTHREAD_TO_STRUCT(glthread_to_rt_un_entry, rt_un_entry_t, glthread, glthreadptr);
@@ -258,12 +289,32 @@ GET_FIRST_BACKUP_NH(rt_un_entry_t *rt_un_entry, FLAG nh_type,
 }
 
 typedef struct internal_nh_t_ internal_nh_t;
+typedef struct rib_clog_ rib_clog_t;
+
+/*Must be power of 2*/
+#define RIB_NH_POOL_SIZE    1024
+
+typedef struct rt_un_nh_pool_{
+
+    unsigned int count; /*No of distinct nexthops*/
+    unsigned int refs;  /*No of nexthops held by routing entries*/
+    internal_un_nh_t *bucket[RIB_NH_POOL_SIZE];
+} rt_un_nh_pool_t;
+
+#define RIB_INDEX_INIT_SIZE 64 /*Must be power of 2*/
 
 typedef struct rt_un_table_{
 
     unsigned int count;
     glthread_t head; /*List of nexthops - primary and backups both*/
+    /*Index of entries on route key, prefix/mask for inet.0 and inet.3,
+     * incoming label for mpls.0*/
+    unsigned int hash_size; /*Power of 2*/
+    rt_un_entry_t **bucket;
     char *rib_name;
+    rib_type_t rib_type;
+    rib_clog_t *clog; /*Change log of this table for FIB consumers*/
+    rt_un_nh_pool_t nh_pool;
     /*CRUD*/
     boolean (*rt_un_route_install_nexthop)(struct rt_un_table_ *, rt_key_t *, LEVEL , internal_un_nh_t *);
     boolean (*rt_un_route_install)(struct rt_un_table_ *, rt_un_entry_t *);
@@ -277,11 +328,28 @@ rt_un_table_t *
 init_rib(rib_type_t rib);
 
 int
-free_rt_un_entry(rt_un_entry_t *rt_un_entry);
+free_rt_un_entry(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry);
+
+/*Returns the pooled copy of nexthop, referenced once more. nexthop
+ * itself remains owned by caller*/
+internal_un_nh_t *
+rib_un_nh_pool_intern(rt_un_table_t *rib, internal_un_nh_t *nexthop);
+
+void
+rib_un_nh_pool_release(rt_un_table_t *rib, internal_un_nh_t *nexthop);
 
 internal_un_nh_t *
 lookup_clone_next_hop(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry, internal_un_nh_t *nexthop);
 
+/*Entry of rt_key, if any, starts referencing nhg*/
+void
+rt_un_entry_set_nh_group(rt_un_table_t *rib, rt_key_t *rt_key, nh_group_t *nhg);
+
+/*TRUE if router can forward over nexthop of entry : link of nexthop is
+ * up and PIC has not bypassed it in nexthop group of entry*/
+boolean
+rt_un_entry_is_nh_usable(rt_un_entry_t *rt_un_entry, internal_un_nh_t *nexthop);
+
 #define UN_RTENTRY_PFX_MATCH(rt_un_entry_t_ptr, rt_key_ptr) \
     (strncmp(RT_ENTRY_PFX(rt_key_ptr), RT_ENTRY_PFX(&rt_un_entry->rt_key), PREFIX_LEN) == 0 &&    \
             RT_ENTRY_MASK(rt_key) == RT_ENTRY_MASK(&rt_un_entry->rt_key))
@@ -302,7 +370,10 @@ node_t *
 get_un_next_hop_node(internal_un_nh_t *nh);
 
 char *
-get_un_next_hop_gateway_pfx(internal_un_nh_t *nh);
+get_un_next_hop_gateway_pfx(internal_un_nh_t *nh, char *gw_prefix);
+
+boolean
+is_un_next_hop_gw_pfx_equal(internal_un_nh_t *nh, char *pfx);
 
 char *
 get_un_next_hop_oif_name(internal_un_nh_t *nh);
@@ -344,6 +415,8 @@ inet_3_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto,
 internal_un_nh_t *
 mpls_0_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto);
 
+/*Install fns intern a copy of nexthop in RIB's nexthop pool, nexthop
+ * remains owned by the caller whether or not it was installed*/
 boolean
 mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level,
         internal_un_nh_t *nexthop);
@@ -356,9 +429,6 @@ boolean
 inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level,
         internal_un_nh_t *nexthop);
 
-int 
-get_stack_top_index(internal_un_nh_t *nh);
-
 int 
 ping(char *node_name, char *dst_prefix);
 
@@ -368,28 +438,34 @@ get_longest_prefix_match2(rt_un_table_t *rib, char *prefix);
 static inline MPLS_STACK_OP
 get_internal_un_nh_stack_top_operation(internal_un_nh_t *nxthop){
 
-    int i = MPLS_STACK_OP_LIMIT_MAX -1;
-    for(;i >= 0; i--){
-        if(nxthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-            nxthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-            continue;
-        return nxthop->nh.inet3_nh.stack_op[i];
-    }
-    return STACK_OPS_UNKNOWN;
+    return nxthop->n_label_ops ? nxthop->label_ops[0].stack_op : STACK_OPS_UNKNOWN;
 }
 
 static inline mpls_label_t
 get_internal_un_nh_stack_top_label(internal_un_nh_t *nxthop){
 
-    
-    int i = MPLS_STACK_OP_LIMIT_MAX -1;
-    for(;i >= 0; i--){
-        if(nxthop->nh.inet3_nh.mpls_label_out[i] == 0 &&
-            nxthop->nh.inet3_nh.stack_op[i] == STACK_OPS_UNKNOWN)
-            continue;
-        return nxthop->nh.inet3_nh.mpls_label_out[i];
-    }
-    return 0;
+    return nxthop->n_label_ops ? nxthop->label_ops[0].label : 0;
+}
+
+/*Appends the operation to be executed after the ones already added*/
+static inline void
+add_internal_un_nh_label_op(internal_un_nh_t *nxthop, MPLS_STACK_OP stack_op,
+                            mpls_label_t label){
+
+    assert(nxthop->n_label_ops < MPLS_STACK_OP_LIMIT_MAX);
+    nxthop->label_ops[nxthop->n_label_ops].label = label;
+    nxthop->label_ops[nxthop->n_label_ops].stack_op = stack_op;
+    nxthop->n_label_ops++;
+}
+
+/*Replaces the label ops of nexthop with a single operation*/
+static inline void
+set_internal_un_nh_label_op(internal_un_nh_t *nxthop, MPLS_STACK_OP stack_op,
+                            mpls_label_t label){
+
+    memset(nxthop->label_ops, 0, sizeof(nxthop->label_ops));
+    nxthop->n_label_ops = 0;
+    add_internal_un_nh_label_op(nxthop, stack_op, label);
 }
 
 char *
@@ -0,0 +1,826 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  fib_check.c
+ *
+ *    Description:  This file implements the FIB consistency checker
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "fib_check.h"
+#include "instance.h"
+#include "spfutil.h"
+
+extern instance_t *instance;
+
+#define FIB_CHECK_NH_TYPE_MASK(nh_type)   (1U << (nh_type))
+#define FIB_CHECK_ANY_NH_MASK             0xFEU   /*All types, bit 0 is PRIMARY_NH*/
+
+/*DFS colors*/
+#define FIB_CHECK_WHITE     0   /*not visited*/
+#define FIB_CHECK_GRAY      1   /*on DFS stack*/
+#define FIB_CHECK_BLACK     2   /*done*/
+
+/*How the router forwards the destination*/
+typedef enum{
+
+    FIB_CHECK_NODE_UNRESOLVED,
+    FIB_CHECK_NODE_NO_ROUTE,
+    FIB_CHECK_NODE_LOCAL,
+    FIB_CHECK_NODE_ALL_NH_DOWN,
+    FIB_CHECK_NODE_FORWARD
+} fib_check_node_state_t;
+
+typedef struct fib_check_dst_{
+
+    char prefix[PREFIX_LEN + 1];
+    char mask;
+} fib_check_dst_t;
+
+typedef struct fib_check_work_{
+
+    node_t **nodes;         /*sorted, node index is position in this array*/
+    unsigned int n_nodes;
+    fib_check_dst_t *dsts;
+    unsigned int n_dsts;
+    unsigned int next;      /*next dst to be picked by worker*/
+} fib_check_work_t;
+
+/*Per worker nexthop graph of one destination, vertices are routers*/
+typedef struct fib_check_worker_{
+
+    fib_check_work_t *work;
+    fib_check_result_t result;
+    unsigned char *state;
+    unsigned char *color;
+    unsigned char *dead_end_reported;
+    unsigned int *n_succ;
+    unsigned int *succ;         /*MAX_NXT_HOPS per vertex*/
+    unsigned int *dfs_stack;
+    unsigned int *dfs_next;     /*next successor to explore, per vertex*/
+    unsigned int *dfs_pos;      /*position of vertex on dfs_stack*/
+} fib_check_worker_t;
+
+/*Graph of all mpls.0 entries of all routers, vertex is (router, incoming label)*/
+typedef struct fib_check_lfib_{
+
+    unsigned int n_vertices;
+    node_t **v_node;
+    mpls_label_t *v_label;
+    rt_un_entry_t **v_entry;
+    unsigned char *v_dead;      /*all nexthops down*/
+    unsigned int *node_base;    /*vertices of router i are node_base[i] .. node_base[i+1]-1*/
+    unsigned int *n_succ;
+    unsigned int *succ;         /*MAX_NXT_HOPS per vertex*/
+} fib_check_lfib_t;
+
+static int
+fib_check_node_comparison_fn(const void *p1, const void *p2){
+
+    node_t *n1 = *(node_t **)p1, *n2 = *(node_t **)p2;
+    if(n1 < n2) return -1;
+    if(n1 > n2) return 1;
+    return 0;
+}
+
+static unsigned int
+fib_check_node_index(fib_check_work_t *work, node_t *node){
+
+    node_t **res = bsearch(&node, work->nodes, work->n_nodes,
+                    sizeof(node_t *), fib_check_node_comparison_fn);
+    assert(res);
+    return (unsigned int)(res - work->nodes);
+}
+
+static inline boolean
+fib_check_is_pseudonode(node_t *node){
+
+    return (node->node_type[LEVEL1] == PSEUDONODE ||
+            node->node_type[LEVEL2] == PSEUDONODE) ? TRUE : FALSE;
+}
+
+/*Nexthops the router forwards over : all primaries whose link is up, else
+ * first backup whose link is up. Returns the no of nexthops of nh types
+ * the route has, usable or not*/
+static unsigned int
+fib_check_get_usable_nexthops(rt_un_entry_t *rt_un_entry, unsigned int nh_type_mask,
+                              internal_un_nh_t **usable, unsigned int *n_usable){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nexthop = NULL,
+                     *backup_nh = NULL;
+    unsigned int n_nexthops = 0;
+
+    *n_usable = 0;
+
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+
+        nexthop = glthread_to_unified_nh(curr);
+        if(!((unsigned char)nexthop->flags & nh_type_mask))
+            continue;
+        n_nexthops++;
+        if(!rt_un_entry_is_nh_usable(rt_un_entry, nexthop))
+            continue;
+        if(!IS_BIT_SET(nexthop->flags, PRIMARY_NH)){
+            if(!backup_nh) backup_nh = nexthop;
+            continue;
+        }
+        if(*n_usable < MAX_NXT_HOPS)
+            usable[(*n_usable)++] = nexthop;
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+
+    if(!*n_usable && backup_nh)
+        usable[(*n_usable)++] = backup_nh;
+    return n_nexthops;
+}
+
+/*Top label of packet after nexthop executes its ops on a packet whose
+ * label stack is in_label (none if 0). Returns FALSE if packet leaves the
+ * nexthop unlabelled or ops cannot be executed*/
+static boolean
+fib_check_get_out_label(internal_un_nh_t *nexthop, mpls_label_t in_label,
+                        mpls_label_t *out_label){
+
+    unsigned int i = 0;
+    mpls_label_stack_t mpls_label_stack;
+
+    init_mpls_label_stack(&mpls_label_stack);
+    if(in_label)
+        PUSH_MPLS_LABEL(&mpls_label_stack, in_label);
+
+    for(i = 0; i < nexthop->n_label_ops; i++){
+        switch(nexthop->label_ops[i].stack_op){
+            case PUSH:
+                if(mpls_label_stack.top >= MPLS_LABEL_STACK_MAX_DEPTH - 1)
+                    return FALSE;
+                PUSH_MPLS_LABEL(&mpls_label_stack, nexthop->label_ops[i].label);
+                break;
+            case POP:
+                if(IS_MPLS_LABEL_STACK_EMPTY(&mpls_label_stack))
+                    return FALSE;
+                POP_MPLS_LABEL(&mpls_label_stack);
+                break;
+            case SWAP:
+                if(IS_MPLS_LABEL_STACK_EMPTY(&mpls_label_stack))
+                    return FALSE;
+                SWAP_MPLS_LABEL(&mpls_label_stack, nexthop->label_ops[i].label);
+                break;
+            default:
+                return FALSE;
+        }
+    }
+    if(IS_MPLS_LABEL_STACK_EMPTY(&mpls_label_stack))
+        return FALSE;
+    *out_label = GET_MPLS_LABEL_STACK_TOP(&mpls_label_stack);
+    return TRUE;
+}
+
+static fib_check_violation_t *
+fib_check_add_report(fib_check_result_t *result, fib_check_violation_type_t type,
+                     rib_type_t rib_type, unsigned int seq_no){
+
+    fib_check_violation_t *report = NULL;
+
+    if(result->n_reports == FIB_CHECK_MAX_REPORTS)
+        return NULL;
+    report = &result->reports[result->n_reports++];
+    memset(report, 0, sizeof(fib_check_violation_t));
+    report->type = type;
+    report->rib_type = rib_type;
+    report->seq_no = seq_no;
+    return report;
+}
+
+/*Nexthop graph of destination*/
+
+static void
+fib_check_resolve_node(fib_check_worker_t *worker, unsigned int v, fib_check_dst_t *dst){
+
+    unsigned int i = 0, j = 0, n_usable = 0, n_nexthops = 0, succ = 0;
+    internal_un_nh_t *usable[MAX_NXT_HOPS];
+    node_t *node = worker->work->nodes[v];
+    rt_un_entry_t *rt_un_entry = NULL;
+
+    worker->n_succ[v] = 0;
+    rt_un_entry = get_longest_prefix_match2(node->spf_info.rib[INET_0], dst->prefix);
+    if(!rt_un_entry){
+        worker->state[v] = FIB_CHECK_NODE_NO_ROUTE;
+        return;
+    }
+
+    n_nexthops = fib_check_get_usable_nexthops(rt_un_entry,
+                    FIB_CHECK_NH_TYPE_MASK(IPV4_NH), usable, &n_usable);
+    if(!n_nexthops){
+        worker->state[v] = FIB_CHECK_NODE_LOCAL;
+        return;
+    }
+    if(!n_usable){
+        worker->state[v] = FIB_CHECK_NODE_ALL_NH_DOWN;
+        return;
+    }
+
+    worker->state[v] = FIB_CHECK_NODE_FORWARD;
+    for(i = 0; i < n_usable; i++){
+        if(!usable[i]->nh_node)
+            continue;
+        succ = fib_check_node_index(worker->work, usable[i]->nh_node);
+        for(j = 0; j < worker->n_succ[v]; j++){
+            if(worker->succ[v * MAX_NXT_HOPS + j] == succ) break;
+        }
+        if(j == worker->n_succ[v])
+            worker->succ[v * MAX_NXT_HOPS + worker->n_succ[v]++] = succ;
+    }
+}
+
+static void
+fib_check_report_dead_end(fib_check_worker_t *worker, unsigned int dst_index,
+                          int from, unsigned int v){
+
+    fib_check_violation_t *report = NULL;
+    fib_check_dst_t *dst = &worker->work->dsts[dst_index];
+
+    if(worker->dead_end_reported[v])
+        return;
+    worker->dead_end_reported[v] = 1;
+    worker->result.n_dead_ends++;
+
+    report = fib_check_add_report(&worker->result, FIB_CHECK_DEAD_END, INET_0,
+                dst_index);
+    if(!report)
+        return;
+    strncpy(report->prefix, dst->prefix, PREFIX_LEN);
+    report->mask = dst->mask;
+    if(from >= 0)
+        report->nodes[report->n_nodes++] = worker->work->nodes[from];
+    report->nodes[report->n_nodes++] = worker->work->nodes[v];
+}
+
+static void
+fib_check_report_loop(fib_check_worker_t *worker, unsigned int dst_index,
+                      unsigned int sp, unsigned int v){
+
+    unsigned int i = 0;
+    fib_check_violation_t *report = NULL;
+    fib_check_dst_t *dst = &worker->work->dsts[dst_index];
+
+    worker->result.n_loops++;
+    report = fib_check_add_report(&worker->result, FIB_CHECK_LOOP, INET_0,
+                dst_index);
+    if(!report)
+        return;
+    strncpy(report->prefix, dst->prefix, PREFIX_LEN);
+    report->mask = dst->mask;
+    for(i = worker->dfs_pos[v]; i < sp && report->n_nodes < FIB_CHECK_MAX_PATH - 1; i++)
+        report->nodes[report->n_nodes++] = worker->work->nodes[worker->dfs_stack[i]];
+    report->nodes[report->n_nodes++] = worker->work->nodes[v];
+}
+
+/*One DFS over nexthop graph of destination, every router is resolved
+ * and explored once whatever the no of routers forwarding through it*/
+static void
+fib_check_dst(fib_check_worker_t *worker, unsigned int dst_index){
+
+    unsigned int n_nodes = worker->work->n_nodes,
+                 root = 0, u = 0, v = 0, sp = 0;
+    fib_check_dst_t *dst = &worker->work->dsts[dst_index];
+
+    memset(worker->state, FIB_CHECK_NODE_UNRESOLVED, n_nodes);
+    memset(worker->color, FIB_CHECK_WHITE, n_nodes);
+    memset(worker->dead_end_reported, 0, n_nodes);
+
+    for(root = 0; root < n_nodes; root++){
+
+        if(worker->color[root] != FIB_CHECK_WHITE ||
+            fib_check_is_pseudonode(worker->work->nodes[root]))
+            continue;
+
+        fib_check_resolve_node(worker, root, dst);
+        if(worker->state[root] != FIB_CHECK_NODE_FORWARD){
+            /*Router which has no route is not a dead end unless some
+             * router forwards the destination to it, router whose nexthops
+             * are all down is reported below if no router does*/
+            worker->color[root] = FIB_CHECK_BLACK;
+            continue;
+        }
+
+        sp = 0;
+        worker->color[root] = FIB_CHECK_GRAY;
+        worker->dfs_next[root] = 0;
+        worker->dfs_pos[root] = sp;
+        worker->dfs_stack[sp++] = root;
+
+        while(sp){
+            u = worker->dfs_stack[sp - 1];
+            if(worker->dfs_next[u] == worker->n_succ[u]){
+                worker->color[u] = FIB_CHECK_BLACK;
+                sp--;
+                continue;
+            }
+            v = worker->succ[u * MAX_NXT_HOPS + worker->dfs_next[u]++];
+
+            if(worker->color[v] == FIB_CHECK_GRAY){
+                fib_check_report_loop(worker, dst_index, sp, v);
+                continue;
+            }
+            if(worker->color[v] == FIB_CHECK_BLACK){
+                if(worker->state[v] == FIB_CHECK_NODE_NO_ROUTE ||
+                    worker->state[v] == FIB_CHECK_NODE_ALL_NH_DOWN)
+                    fib_check_report_dead_end(worker, dst_index, u, v);
+                continue;
+            }
+
+            fib_check_resolve_node(worker, v, dst);
+            if(worker->state[v] != FIB_CHECK_NODE_FORWARD){
+                if(worker->state[v] != FIB_CHECK_NODE_LOCAL)
+                    fib_check_report_dead_end(worker, dst_index, u, v);
+                worker->color[v] = FIB_CHECK_BLACK;
+                continue;
+            }
+            worker->color[v] = FIB_CHECK_GRAY;
+            worker->dfs_next[v] = 0;
+            worker->dfs_pos[v] = sp;
+            worker->dfs_stack[sp++] = v;
+        }
+    }
+
+    for(v = 0; v < n_nodes; v++){
+        if(worker->state[v] == FIB_CHECK_NODE_ALL_NH_DOWN)
+            fib_check_report_dead_end(worker, dst_index, -1, v);
+    }
+}
+
+static void *
+fib_check_worker_fn(void *arg){
+
+    fib_check_worker_t *worker = arg;
+    fib_check_work_t *work = worker->work;
+    unsigned int i = 0;
+
+    while(1){
+        i = __atomic_fetch_add(&work->next, 1, __ATOMIC_RELAXED);
+        if(i >= work->n_dsts)
+            break;
+        fib_check_dst(worker, i);
+    }
+    return NULL;
+}
+
+static int
+fib_check_dst_comparison_fn(const void *p1, const void *p2){
+
+    fib_check_dst_t *dst1 = (fib_check_dst_t *)p1,
+                    *dst2 = (fib_check_dst_t *)p2;
+    int rc = strncmp(dst1->prefix, dst2->prefix, PREFIX_LEN);
+
+    if(rc) return rc;
+    return (int)dst1->mask - (int)dst2->mask;
+}
+
+/*Unique prefixes of inet.0 tables of all routers*/
+static void
+fib_check_collect_dsts(fib_check_work_t *work){
+
+    unsigned int i = 0, j = 0, size = 64;
+    glthread_t *curr = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    rt_un_table_t *rib = NULL;
+
+    work->dsts = calloc(size, sizeof(fib_check_dst_t));
+    for(i = 0; i < work->n_nodes; i++){
+        if(fib_check_is_pseudonode(work->nodes[i]))
+            continue;
+        rib = work->nodes[i]->spf_info.rib[INET_0];
+        ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+            rt_un_entry = glthread_to_rt_un_entry(curr);
+            if(work->n_dsts == size){
+                size <<= 1;
+                work->dsts = realloc(work->dsts, size * sizeof(fib_check_dst_t));
+            }
+            memset(&work->dsts[work->n_dsts], 0, sizeof(fib_check_dst_t));
+            strncpy(work->dsts[work->n_dsts].prefix,
+                    RT_ENTRY_PFX(&rt_un_entry->rt_key), PREFIX_LEN);
+            work->dsts[work->n_dsts].mask = RT_ENTRY_MASK(&rt_un_entry->rt_key);
+            work->n_dsts++;
+        } ITERATE_GLTHREAD_END(&rib->head, curr);
+    }
+
+    if(!work->n_dsts)
+        return;
+    qsort(work->dsts, work->n_dsts, sizeof(fib_check_dst_t), fib_check_dst_comparison_fn);
+    for(i = 1, j = 0; i < work->n_dsts; i++){
+        if(fib_check_dst_comparison_fn(&work->dsts[i], &work->dsts[j]) == 0)
+            continue;
+        work->dsts[++j] = work->dsts[i];
+    }
+    work->n_dsts = j + 1;
+}
+
+/*Label graph*/
+
+static int
+fib_check_label_comparison_fn(const void *p1, const void *p2){
+
+    rt_un_entry_t *e1 = *(rt_un_entry_t **)p1,
+                  *e2 = *(rt_un_entry_t **)p2;
+
+    if(RT_ENTRY_LABEL(&e1->rt_key) < RT_ENTRY_LABEL(&e2->rt_key)) return -1;
+    if(RT_ENTRY_LABEL(&e1->rt_key) > RT_ENTRY_LABEL(&e2->rt_key)) return 1;
+    return 0;
+}
+
+/*Returns the vertex of label in mpls.0 of router, n_vertices if not found*/
+static unsigned int
+fib_check_lfib_lookup(fib_check_lfib_t *lfib, unsigned int node_index,
+                      mpls_label_t label){
+
+    unsigned int lo = lfib->node_base[node_index],
+                 hi = lfib->node_base[node_index + 1], mid = 0;
+
+    while(lo < hi){
+        mid = lo + ((hi - lo) >> 1);
+        if(lfib->v_label[mid] == label)
+            return mid;
+        if(lfib->v_label[mid] < label)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lfib->n_vertices;
+}
+
+static void
+fib_check_build_lfib(fib_check_work_t *work, fib_check_lfib_t *lfib){
+
+    unsigned int i = 0, n = 0, size = 64;
+    glthread_t *curr = NULL;
+    rt_un_table_t *rib = NULL;
+
+    memset(lfib, 0, sizeof(fib_check_lfib_t));
+    lfib->node_base = calloc(work->n_nodes + 1, sizeof(unsigned int));
+    lfib->v_entry = calloc(size, sizeof(rt_un_entry_t *));
+
+    for(i = 0; i < work->n_nodes; i++){
+        lfib->node_base[i] = n;
+        if(fib_check_is_pseudonode(work->nodes[i]))
+            continue;
+        rib = work->nodes[i]->spf_info.rib[MPLS_0];
+        ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+            if(n == size){
+                size <<= 1;
+                lfib->v_entry = realloc(lfib->v_entry, size * sizeof(rt_un_entry_t *));
+            }
+            lfib->v_entry[n++] = glthread_to_rt_un_entry(curr);
+        } ITERATE_GLTHREAD_END(&rib->head, curr);
+        qsort(&lfib->v_entry[lfib->node_base[i]], n - lfib->node_base[i],
+                sizeof(rt_un_entry_t *), fib_check_label_comparison_fn);
+    }
+    lfib->node_base[work->n_nodes] = n;
+    lfib->n_vertices = n;
+
+    lfib->v_node = calloc(n ? n : 1, sizeof(node_t *));
+    lfib->v_label = calloc(n ? n : 1, sizeof(mpls_label_t));
+    lfib->v_dead = calloc(n ? n : 1, sizeof(unsigned char));
+    lfib->n_succ = calloc(n ? n : 1, sizeof(unsigned int));
+    lfib->succ = calloc(n ? n * MAX_NXT_HOPS : 1, sizeof(unsigned int));
+
+    for(i = 0; i < work->n_nodes; i++){
+        for(n = lfib->node_base[i]; n < lfib->node_base[i + 1]; n++){
+            lfib->v_node[n] = work->nodes[i];
+            lfib->v_label[n] = RT_ENTRY_LABEL(&lfib->v_entry[n]->rt_key);
+        }
+    }
+}
+
+static void
+fib_check_free_lfib(fib_check_lfib_t *lfib){
+
+    free(lfib->node_base);
+    free(lfib->v_entry);
+    free(lfib->v_node);
+    free(lfib->v_label);
+    free(lfib->v_dead);
+    free(lfib->n_succ);
+    free(lfib->succ);
+}
+
+static void
+fib_check_report_lfib_dead_end(fib_check_result_t *result, rib_type_t rib_type,
+                               unsigned int seq_no, rt_un_entry_t *rt_un_entry,
+                               node_t *from, mpls_label_t in_label,
+                               node_t *to, mpls_label_t out_label){
+
+    fib_check_violation_t *report = NULL;
+
+    report = fib_check_add_report(result, FIB_CHECK_DEAD_END, rib_type, seq_no);
+    if(!report)
+        return;
+    if(rib_type == INET_3){
+        strncpy(report->prefix, RT_ENTRY_PFX(&rt_un_entry->rt_key), PREFIX_LEN);
+        report->mask = RT_ENTRY_MASK(&rt_un_entry->rt_key);
+    }
+    report->nodes[0] = from;
+    report->labels[0] = in_label;
+    report->nodes[1] = to;
+    report->labels[1] = out_label;
+    report->n_nodes = 2;
+}
+
+/*Resolve the edges of every label graph vertex and of every LSP ingress,
+ * labels which are not bound at the next router, or whose nexthops are all
+ * down there, are dead ends*/
+static void
+fib_check_lfib_edges(fib_check_work_t *work, fib_check_lfib_t *lfib,
+                     fib_check_result_t *result, unsigned int seq_base){
+
+    unsigned int i = 0, j = 0, k = 0, n_usable = 0, to = 0, target = 0;
+    internal_un_nh_t *usable[MAX_NXT_HOPS];
+    mpls_label_t out_label = 0;
+    glthread_t *curr = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    node_t *node = NULL;
+
+    for(i = 0; i < lfib->n_vertices; i++){
+        if(fib_check_get_usable_nexthops(lfib->v_entry[i], FIB_CHECK_ANY_NH_MASK,
+                usable, &n_usable) && !n_usable)
+            lfib->v_dead[i] = 1;
+    }
+
+    for(i = 0; i < lfib->n_vertices; i++){
+        fib_check_get_usable_nexthops(lfib->v_entry[i], FIB_CHECK_ANY_NH_MASK,
+                usable, &n_usable);
+        node = lfib->v_node[i];
+        for(j = 0; j < n_usable; j++){
+            if(!fib_check_get_out_label(usable[j], lfib->v_label[i], &out_label))
+                continue;
+            to = fib_check_node_index(work,
+                    usable[j]->oif && usable[j]->nh_node ? usable[j]->nh_node : node);
+            target = fib_check_lfib_lookup(lfib, to, out_label);
+            if(target == lfib->n_vertices || lfib->v_dead[target]){
+                result->n_lfib_dead_ends++;
+                fib_check_report_lfib_dead_end(result, MPLS_0, seq_base + i,
+                        lfib->v_entry[i], node, lfib->v_label[i],
+                        work->nodes[to], out_label);
+                continue;
+            }
+            for(k = 0; k < lfib->n_succ[i]; k++){
+                if(lfib->succ[i * MAX_NXT_HOPS + k] == target) break;
+            }
+            if(k == lfib->n_succ[i])
+                lfib->succ[i * MAX_NXT_HOPS + lfib->n_succ[i]++] = target;
+        }
+    }
+
+    /*LSP ingress : label pushed must be bound at the next router*/
+    for(i = 0; i < work->n_nodes; i++){
+        node = work->nodes[i];
+        if(fib_check_is_pseudonode(node))
+            continue;
+        ITERATE_GLTHREAD_BEGIN(&node->spf_info.rib[INET_3]->head, curr){
+            rt_un_entry = glthread_to_rt_un_entry(curr);
+            fib_check_get_usable_nexthops(rt_un_entry, FIB_CHECK_ANY_NH_MASK,
+                    usable, &n_usable);
+            for(j = 0; j < n_usable; j++){
+                if(!usable[j]->nh_node ||
+                    !fib_check_get_out_label(usable[j], 0, &out_label))
+                    continue;
+                to = fib_check_node_index(work, usable[j]->nh_node);
+                target = fib_check_lfib_lookup(lfib, to, out_label);
+                if(target != lfib->n_vertices && !lfib->v_dead[target])
+                    continue;
+                result->n_lfib_dead_ends++;
+                fib_check_report_lfib_dead_end(result, INET_3,
+                        seq_base + lfib->n_vertices + i, rt_un_entry,
+                        node, 0, usable[j]->nh_node, out_label);
+            }
+        } ITERATE_GLTHREAD_END(&node->spf_info.rib[INET_3]->head, curr);
+    }
+}
+
+static void
+fib_check_lfib_loops(fib_check_lfib_t *lfib, fib_check_result_t *result,
+                     unsigned int seq_base){
+
+    unsigned int n = lfib->n_vertices,
+                 root = 0, u = 0, v = 0, sp = 0, i = 0;
+    unsigned char *color = calloc(n ? n : 1, sizeof(unsigned char));
+    unsigned int *dfs_stack = calloc(n ? n : 1, sizeof(unsigned int)),
+                 *dfs_next = calloc(n ? n : 1, sizeof(unsigned int)),
+                 *dfs_pos = calloc(n ? n : 1, sizeof(unsigned int));
+    fib_check_violation_t *report = NULL;
+
+    for(root = 0; root < n; root++){
+
+        if(color[root] != FIB_CHECK_WHITE)
+            continue;
+
+        sp = 0;
+        color[root] = FIB_CHECK_GRAY;
+        dfs_pos[root] = sp;
+        dfs_stack[sp++] = root;
+
+        while(sp){
+            u = dfs_stack[sp - 1];
+            if(dfs_next[u] == lfib->n_succ[u]){
+                color[u] = FIB_CHECK_BLACK;
+                sp--;
+                continue;
+            }
+            v = lfib->succ[u * MAX_NXT_HOPS + dfs_next[u]++];
+            if(color[v] == FIB_CHECK_BLACK)
+                continue;
+            if(color[v] == FIB_CHECK_GRAY){
+                result->n_lfib_loops++;
+                report = fib_check_add_report(result, FIB_CHECK_LOOP, MPLS_0,
+                            seq_base + v);
+                if(!report)
+                    continue;
+                for(i = dfs_pos[v]; i < sp && report->n_nodes < FIB_CHECK_MAX_PATH - 1; i++){
+                    report->nodes[report->n_nodes] = lfib->v_node[dfs_stack[i]];
+                    report->labels[report->n_nodes++] = lfib->v_label[dfs_stack[i]];
+                }
+                report->nodes[report->n_nodes] = lfib->v_node[v];
+                report->labels[report->n_nodes++] = lfib->v_label[v];
+                continue;
+            }
+            color[v] = FIB_CHECK_GRAY;
+            dfs_pos[v] = sp;
+            dfs_stack[sp++] = v;
+        }
+    }
+
+    free(color);
+    free(dfs_stack);
+    free(dfs_next);
+    free(dfs_pos);
+}
+
+static int
+fib_check_report_comparison_fn(const void *p1, const void *p2){
+
+    fib_check_violation_t *r1 = (fib_check_violation_t *)p1,
+                          *r2 = (fib_check_violation_t *)p2;
+
+    if(r1->seq_no < r2->seq_no) return -1;
+    if(r1->seq_no > r2->seq_no) return 1;
+    return 0;
+}
+
+static void
+fib_check_merge_result(fib_check_result_t *result, fib_check_result_t *partial){
+
+    unsigned int i = 0;
+
+    result->n_loops += partial->n_loops;
+    result->n_dead_ends += partial->n_dead_ends;
+    for(i = 0; i < partial->n_reports && result->n_reports < FIB_CHECK_MAX_REPORTS; i++)
+        result->reports[result->n_reports++] = partial->reports[i];
+}
+
+void
+fib_check_run(instance_t *instance, fib_check_result_t *result){
+
+    unsigned int i = 0, n_workers = 0, n_nodes = 0;
+    singly_ll_node_t *list_node = NULL;
+    pthread_t threads[FIB_CHECK_MAX_WORKERS];
+    boolean worker_spawned[FIB_CHECK_MAX_WORKERS];
+    fib_check_worker_t *workers = NULL;
+    fib_check_work_t work;
+    fib_check_lfib_t lfib;
+    fib_check_result_t *partial = NULL;
+    unsigned long long start_time = get_time_usec();
+
+    memset(result, 0, sizeof(fib_check_result_t));
+    memset(&work, 0, sizeof(fib_check_work_t));
+
+    n_nodes = GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list);
+    if(!n_nodes)
+        return;
+
+    work.nodes = calloc(n_nodes, sizeof(node_t *));
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        work.nodes[work.n_nodes++] = list_node->data;
+    } ITERATE_LIST_END;
+    qsort(work.nodes, work.n_nodes, sizeof(node_t *), fib_check_node_comparison_fn);
+
+    fib_check_collect_dsts(&work);
+    result->n_prefixes = work.n_dsts;
+
+    /*Nexthop graphs of destinations, in parallel*/
+    n_workers = get_worker_count(work.n_dsts, FIB_CHECK_MAX_WORKERS);
+    workers = calloc(n_workers, sizeof(fib_check_worker_t));
+
+    for(i = 0; i < n_workers; i++){
+        workers[i].work = &work;
+        workers[i].state = calloc(n_nodes, sizeof(unsigned char));
+        workers[i].color = calloc(n_nodes, sizeof(unsigned char));
+        workers[i].dead_end_reported = calloc(n_nodes, sizeof(unsigned char));
+        workers[i].n_succ = calloc(n_nodes, sizeof(unsigned int));
+        workers[i].succ = calloc(n_nodes * MAX_NXT_HOPS, sizeof(unsigned int));
+        workers[i].dfs_stack = calloc(n_nodes, sizeof(unsigned int));
+        workers[i].dfs_next = calloc(n_nodes, sizeof(unsigned int));
+        workers[i].dfs_pos = calloc(n_nodes, sizeof(unsigned int));
+    }
+
+    for(i = 0; i < n_workers; i++){
+        worker_spawned[i] = FALSE;
+        if(n_workers > 1)
+            worker_spawned[i] = (pthread_create(&threads[i], NULL,
+                                    fib_check_worker_fn, &workers[i]) == 0);
+        if(!worker_spawned[i])
+            fib_check_worker_fn(&workers[i]);
+    }
+
+    /*Label graph is checked meanwhile, it is shared by all labels*/
+    partial = calloc(1, sizeof(fib_check_result_t));
+    fib_check_build_lfib(&work, &lfib);
+    result->n_lfib_entries = lfib.n_vertices;
+    fib_check_lfib_edges(&work, &lfib, partial, work.n_dsts);
+    fib_check_lfib_loops(&lfib, partial, work.n_dsts + lfib.n_vertices + work.n_nodes);
+    result->n_lfib_loops = partial->n_lfib_loops;
+    result->n_lfib_dead_ends = partial->n_lfib_dead_ends;
+    fib_check_free_lfib(&lfib);
+
+    for(i = 0; i < n_workers; i++){
+        if(worker_spawned[i])
+            pthread_join(threads[i], NULL);
+        fib_check_merge_result(result, &workers[i].result);
+        free(workers[i].state);
+        free(workers[i].color);
+        free(workers[i].dead_end_reported);
+        free(workers[i].n_succ);
+        free(workers[i].succ);
+        free(workers[i].dfs_stack);
+        free(workers[i].dfs_next);
+        free(workers[i].dfs_pos);
+    }
+    /*Reports of label graph come after those of destinations*/
+    qsort(result->reports, result->n_reports, sizeof(fib_check_violation_t),
+            fib_check_report_comparison_fn);
+    for(i = 0; i < partial->n_reports && result->n_reports < FIB_CHECK_MAX_REPORTS; i++)
+        result->reports[result->n_reports++] = partial->reports[i];
+
+    free(partial);
+    free(workers);
+    free(work.dsts);
+    free(work.nodes);
+    result->usec = get_time_usec() - start_time;
+}
+
+void
+print_fib_check_result(fib_check_result_t *result){
+
+    unsigned int i = 0, j = 0;
+    fib_check_violation_t *report = NULL;
+
+    printf("FIB check : prefixes = %u, loops = %u, dead ends = %u, "
+           "LFIB entries = %u, LFIB loops = %u, LFIB dead ends = %u, time = %llu usec\n",
+           result->n_prefixes, result->n_loops, result->n_dead_ends,
+           result->n_lfib_entries, result->n_lfib_loops, result->n_lfib_dead_ends,
+           result->usec);
+
+    for(i = 0; i < result->n_reports; i++){
+        report = &result->reports[i];
+        printf("\t%-9s ", report->type == FIB_CHECK_LOOP ? "LOOP" : "DEAD END");
+        switch(report->rib_type){
+            case INET_0:
+                printf("inet.0 %s/%d : ", report->prefix, report->mask);
+                for(j = 0; j < report->n_nodes; j++)
+                    printf("%s%s", j ? " -> " : "", report->nodes[j]->node_name);
+                break;
+            case INET_3:
+                printf("inet.3 %s/%d : %s -> %s(%u)", report->prefix, report->mask,
+                        report->nodes[0]->node_name, report->nodes[1]->node_name,
+                        report->labels[1]);
+                break;
+            case MPLS_0:
+                printf("mpls.0 : ");
+                for(j = 0; j < report->n_nodes; j++)
+                    printf("%s%s(%u)", j ? " -> " : "", report->nodes[j]->node_name,
+                            report->labels[j]);
+                break;
+            default:
+                ;
+        }
+        printf("\n");
+    }
+    if(result->n_reports < FIB_CHECK_VIOLATIONS(result))
+        printf("\t... %u more\n", FIB_CHECK_VIOLATIONS(result) - result->n_reports);
+}
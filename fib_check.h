@@ -0,0 +1,87 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  fib_check.h
+ *
+ *    Description:  This file declares the FIB consistency checker. For every
+ *                  destination prefix installed in the network, checker builds the
+ *                  nexthop graph of all routers from their inet.0 tables, and for
+ *                  the labels it builds one graph of all mpls.0 entries of all
+ *                  routers. Forwarding loops and dead ends (packet forwarded to a
+ *                  router which cannot forward it further) are found by one depth
+ *                  first traversal of each graph.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __FIB_CHECK__
+#define __FIB_CHECK__
+
+#include "data_plane.h"
+
+typedef struct instance_ instance_t;
+
+#define FIB_CHECK_MAX_WORKERS   16
+/*Max no of violations reported in detail, all are counted*/
+#define FIB_CHECK_MAX_REPORTS   32
+/*Max no of routers listed for one violation*/
+#define FIB_CHECK_MAX_PATH      16
+
+typedef enum{
+
+    FIB_CHECK_LOOP,
+    FIB_CHECK_DEAD_END
+} fib_check_violation_type_t;
+
+typedef struct fib_check_violation_{
+
+    fib_check_violation_type_t type;
+    rib_type_t rib_type;            /*INET_0 or MPLS_0*/
+    unsigned int seq_no;            /*for stable order of reports*/
+    char prefix[PREFIX_LEN + 1];    /*INET_0 only*/
+    char mask;
+    /*Loop : routers of the cycle. Dead end : router which forwarded the
+     * packet followed by router which dropped it*/
+    unsigned int n_nodes;
+    node_t *nodes[FIB_CHECK_MAX_PATH];
+    mpls_label_t labels[FIB_CHECK_MAX_PATH]; /*MPLS_0 only, incoming labels*/
+} fib_check_violation_t;
+
+typedef struct fib_check_result_{
+
+    unsigned int n_prefixes;
+    unsigned int n_loops;
+    unsigned int n_dead_ends;
+    unsigned int n_lfib_entries;
+    unsigned int n_lfib_loops;
+    unsigned int n_lfib_dead_ends;
+    unsigned int n_reports;
+    fib_check_violation_t reports[FIB_CHECK_MAX_REPORTS];
+    unsigned long long usec;
+} fib_check_result_t;
+
+#define FIB_CHECK_VIOLATIONS(fib_check_result_ptr)                                  \
+    ((fib_check_result_ptr)->n_loops + (fib_check_result_ptr)->n_dead_ends +        \
+     (fib_check_result_ptr)->n_lfib_loops + (fib_check_result_ptr)->n_lfib_dead_ends)
+
+/*Check the inet.0, inet.3 and mpls.0 tables of all routers*/
+void
+fib_check_run(instance_t *instance, fib_check_result_t *result);
+
+void
+print_fib_check_result(fib_check_result_t *result);
+
+#endif /* __FIB_CHECK__ */
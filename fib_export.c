@@ -0,0 +1,483 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  fib_export.c
+ *
+ *    Description:  This file implements the FIB memory accounting and the compact
+ *                  binary export of FIBs of all routers
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "fib_export.h"
+#include "instance.h"
+#include "rib_changelog.h"
+#include "spfutil.h"
+
+/*Memory accounting*/
+
+void
+fib_mem_account_rib(rt_un_table_t *rib, fib_mem_stats_t *stats){
+
+    unsigned int i = 0;
+    glthread_t *curr = NULL, *curr1 = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    internal_un_nh_t *nexthop = NULL;
+    unsigned int n_label_stacks = 0;
+
+    memset(stats, 0, sizeof(fib_mem_stats_t));
+
+    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+        rt_un_entry = glthread_to_rt_un_entry(curr);
+        stats->n_entries++;
+        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+            stats->n_nh_refs++;
+        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+    } ITERATE_GLTHREAD_END(&rib->head, curr);
+
+    for(i = 0; i < RIB_NH_POOL_SIZE; i++){
+        for(nexthop = rib->nh_pool.bucket[i]; nexthop; nexthop = nexthop->pool_next){
+            stats->n_unique_nh++;
+            stats->label_depth[nexthop->n_label_ops]++;
+            if(nexthop->n_label_ops)
+                n_label_stacks++;
+        }
+    }
+
+    stats->entry_bytes  = (unsigned long long)stats->n_entries * sizeof(rt_un_entry_t);
+    stats->nh_ref_bytes = (unsigned long long)stats->n_nh_refs * sizeof(rt_un_nh_ref_t);
+    stats->nh_bytes     = (unsigned long long)stats->n_unique_nh * sizeof(internal_un_nh_t);
+    stats->table_bytes  = sizeof(rt_un_table_t) + rib_clog_bytes(rib);
+    stats->total_bytes  = stats->entry_bytes + stats->nh_ref_bytes +
+                          stats->nh_bytes + stats->table_bytes;
+
+    stats->compact_bytes = (unsigned long long)stats->n_entries * sizeof(fib_export_route_t) +
+                           (unsigned long long)stats->n_nh_refs * sizeof(uint32_t) +
+                           (unsigned long long)stats->n_unique_nh * sizeof(fib_export_nh_t) +
+                           (unsigned long long)n_label_stacks * sizeof(fib_export_label_stack_t);
+}
+
+static void
+print_fib_mem_stats(char *name, fib_mem_stats_t *stats){
+
+    unsigned int i = 0;
+
+    printf("\t%-7s : entries = %u, nexthops = %u, unique nexthops = %u, label depth = ",
+            name, stats->n_entries, stats->n_nh_refs, stats->n_unique_nh);
+    for(i = 0; i <= MPLS_STACK_OP_LIMIT_MAX; i++)
+        printf("%s%u", i ? "/" : "", stats->label_depth[i]);
+    printf("\n\t          bytes = %llu (entries %llu, nexthop refs %llu, nexthops %llu, fixed %llu), compact = %llu\n",
+            stats->total_bytes, stats->entry_bytes, stats->nh_ref_bytes,
+            stats->nh_bytes, stats->table_bytes, stats->compact_bytes);
+}
+
+void
+show_fib_memory(node_t *node){
+
+    rib_type_t rib_type;
+    unsigned int i = 0;
+    fib_mem_stats_t stats, total;
+
+    memset(&total, 0, sizeof(fib_mem_stats_t));
+
+    printf("Node : %s FIB memory (label depth : unique nexthops with 0/1/../%u label ops)\n",
+            node->node_name, MPLS_STACK_OP_LIMIT_MAX);
+
+    for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++){
+        fib_mem_account_rib(node->spf_info.rib[rib_type], &stats);
+        print_fib_mem_stats(node->spf_info.rib[rib_type]->rib_name, &stats);
+
+        total.n_entries     += stats.n_entries;
+        total.n_nh_refs     += stats.n_nh_refs;
+        total.n_unique_nh   += stats.n_unique_nh;
+        for(i = 0; i <= MPLS_STACK_OP_LIMIT_MAX; i++)
+            total.label_depth[i] += stats.label_depth[i];
+        total.entry_bytes   += stats.entry_bytes;
+        total.nh_ref_bytes  += stats.nh_ref_bytes;
+        total.nh_bytes      += stats.nh_bytes;
+        total.table_bytes   += stats.table_bytes;
+        total.total_bytes   += stats.total_bytes;
+        total.compact_bytes += stats.compact_bytes;
+    }
+    print_fib_mem_stats("Total", &total);
+}
+
+/*Export*/
+
+/*Growable array of fixed size records, optionally interning records
+ * by content in an open addressing hash table*/
+typedef struct fib_export_table_{
+
+    char *recs;
+    unsigned int rec_size;
+    unsigned int count;
+    unsigned int size;
+    unsigned int *slots;    /*record index + 1, 0 if empty*/
+    unsigned int n_slots;   /*power of 2, kept at least twice the count*/
+} fib_export_table_t;
+
+static void
+fib_export_table_init(fib_export_table_t *table, unsigned int rec_size,
+                      boolean intern){
+
+    memset(table, 0, sizeof(fib_export_table_t));
+    table->rec_size = rec_size;
+    table->size = 64;
+    table->recs = calloc(table->size, rec_size);
+    if(intern){
+        table->n_slots = 128;
+        table->slots = calloc(table->n_slots, sizeof(unsigned int));
+    }
+}
+
+static void
+fib_export_table_free(fib_export_table_t *table){
+
+    free(table->recs);
+    free(table->slots);
+}
+
+static void *
+fib_export_table_rec(fib_export_table_t *table, unsigned int index){
+
+    return table->recs + (size_t)index * table->rec_size;
+}
+
+static unsigned int
+fib_export_table_add(fib_export_table_t *table, void *rec){
+
+    if(table->count == table->size){
+        table->size <<= 1;
+        table->recs = realloc(table->recs, (size_t)table->size * table->rec_size);
+    }
+    memcpy(fib_export_table_rec(table, table->count), rec, table->rec_size);
+    return table->count++;
+}
+
+static void
+fib_export_table_rehash(fib_export_table_t *table){
+
+    unsigned int i = 0, slot = 0;
+
+    free(table->slots);
+    table->n_slots <<= 1;
+    table->slots = calloc(table->n_slots, sizeof(unsigned int));
+    for(i = 0; i < table->count; i++){
+        slot = hash_code(fib_export_table_rec(table, i), table->rec_size) &
+                (table->n_slots - 1);
+        while(table->slots[slot])
+            slot = (slot + 1) & (table->n_slots - 1);
+        table->slots[slot] = i + 1;
+    }
+}
+
+/*Returns the index of record with same content, added if not present.
+ * Records must be zeroed before filling so that padding compares equal*/
+static unsigned int
+fib_export_table_intern(fib_export_table_t *table, void *rec){
+
+    unsigned int slot = hash_code(rec, table->rec_size) & (table->n_slots - 1);
+
+    while(table->slots[slot]){
+        if(memcmp(fib_export_table_rec(table, table->slots[slot] - 1), rec,
+                table->rec_size) == 0)
+            return table->slots[slot] - 1;
+        slot = (slot + 1) & (table->n_slots - 1);
+    }
+    table->slots[slot] = fib_export_table_add(table, rec) + 1;
+    if(table->count * 2 > table->n_slots)
+        fib_export_table_rehash(table);
+    return table->count - 1;
+}
+
+typedef struct fib_export_ctxt_{
+
+    node_t **nodes;         /*sorted by name, node index is position in this array*/
+    unsigned int n_nodes;
+    fib_export_table_t sections[FIB_EXPORT_SECTION_MAX];
+} fib_export_ctxt_t;
+
+static int
+fib_export_node_name_comparison_fn(const void *p1, const void *p2){
+
+    node_t *n1 = *(node_t **)p1, *n2 = *(node_t **)p2;
+    return strncmp(n1->node_name, n2->node_name, NODE_NAME_SIZE);
+}
+
+static uint32_t
+fib_export_node_index(fib_export_ctxt_t *ctxt, node_t *node){
+
+    node_t **res = NULL;
+
+    /*Node names are unique*/
+    if(!node)
+        return FIB_EXPORT_INVALID;
+    res = bsearch(&node, ctxt->nodes, ctxt->n_nodes,
+            sizeof(node_t *), fib_export_node_name_comparison_fn);
+    return res ? (uint32_t)(res - ctxt->nodes) : FIB_EXPORT_INVALID;
+}
+
+static uint32_t
+fib_export_ipv4(char *prefix){
+
+    struct in_addr addr;
+
+    if(!prefix[0] || inet_pton(AF_INET, prefix, &addr) != 1)
+        return 0;
+    return ntohl(addr.s_addr);
+}
+
+static rib_type_t fib_export_sort_rib_type;
+
+static int
+fib_export_route_comparison_fn(const void *p1, const void *p2){
+
+    rt_un_entry_t *e1 = *(rt_un_entry_t **)p1,
+                  *e2 = *(rt_un_entry_t **)p2;
+    uint32_t key1 = 0, key2 = 0;
+
+    if(fib_export_sort_rib_type == MPLS_0){
+        key1 = RT_ENTRY_LABEL(&e1->rt_key);
+        key2 = RT_ENTRY_LABEL(&e2->rt_key);
+    }
+    else{
+        key1 = fib_export_ipv4(RT_ENTRY_PFX(&e1->rt_key));
+        key2 = fib_export_ipv4(RT_ENTRY_PFX(&e2->rt_key));
+    }
+    if(key1 != key2)
+        return key1 < key2 ? -1 : 1;
+    return (int)RT_ENTRY_MASK(&e1->rt_key) - (int)RT_ENTRY_MASK(&e2->rt_key);
+}
+
+static uint32_t
+fib_export_nexthop(fib_export_ctxt_t *ctxt, internal_un_nh_t *nexthop){
+
+    unsigned int i = 0;
+    fib_export_nh_t nh_rec;
+    fib_export_label_stack_t label_stack_rec;
+
+    memset(&nh_rec, 0, sizeof(fib_export_nh_t));
+    if(nexthop->oif)
+        strncpy(nh_rec.oif_name, nexthop->oif->intf_name, IF_NAME_SIZE - 1);
+    nh_rec.gw = ntohl(nexthop->gw_ip);
+    nh_rec.nh_node = fib_export_node_index(ctxt, nexthop->nh_node);
+    nh_rec.label_stack = FIB_EXPORT_INVALID;
+    nh_rec.flags = (uint8_t)nexthop->flags;
+    nh_rec.protocol = (uint8_t)nexthop->protocol;
+    nh_rec.lfa_type = (uint8_t)nexthop->lfa_type;
+    nh_rec.ucmp_weight = (uint8_t)nexthop->ucmp_weight;
+
+    if(nexthop->n_label_ops){
+        memset(&label_stack_rec, 0, sizeof(fib_export_label_stack_t));
+        label_stack_rec.n_ops = nexthop->n_label_ops;
+        for(i = 0; i < nexthop->n_label_ops; i++){
+            label_stack_rec.stack_op[i] = nexthop->label_ops[i].stack_op;
+            label_stack_rec.label[i] = nexthop->label_ops[i].label;
+        }
+        nh_rec.label_stack = fib_export_table_intern(
+                &ctxt->sections[FIB_EXPORT_SECTION_LABEL_STACKS], &label_stack_rec);
+    }
+    return fib_export_table_intern(&ctxt->sections[FIB_EXPORT_SECTION_NEXTHOPS], &nh_rec);
+}
+
+static void
+fib_export_rib(fib_export_ctxt_t *ctxt, rt_un_table_t *rib,
+               fib_export_range_t *range){
+
+    unsigned int i = 0, n = 0;
+    uint32_t nh_index = 0;
+    glthread_t *curr = NULL;
+    rt_un_entry_t **entries = NULL;
+    fib_export_route_t route_rec;
+    fib_export_table_t *routes = &ctxt->sections[FIB_EXPORT_SECTION_ROUTES],
+                       *nh_lists = &ctxt->sections[FIB_EXPORT_SECTION_NH_LISTS];
+
+    range->start = routes->count;
+    range->count = 0;
+
+    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+        n++;
+    } ITERATE_GLTHREAD_END(&rib->head, curr);
+    if(!n)
+        return;
+
+    entries = calloc(n, sizeof(rt_un_entry_t *));
+    n = 0;
+    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+        entries[n++] = glthread_to_rt_un_entry(curr);
+    } ITERATE_GLTHREAD_END(&rib->head, curr);
+
+    fib_export_sort_rib_type = rib->rib_type;
+    qsort(entries, n, sizeof(rt_un_entry_t *), fib_export_route_comparison_fn);
+
+    for(i = 0; i < n; i++){
+        memset(&route_rec, 0, sizeof(fib_export_route_t));
+        if(rib->rib_type == MPLS_0){
+            route_rec.key = RT_ENTRY_LABEL(&entries[i]->rt_key);
+        }
+        else{
+            route_rec.key = fib_export_ipv4(RT_ENTRY_PFX(&entries[i]->rt_key));
+            route_rec.mask = RT_ENTRY_MASK(&entries[i]->rt_key);
+        }
+        route_rec.level = entries[i]->level;
+        route_rec.nh_list = nh_lists->count;
+
+        ITERATE_GLTHREAD_BEGIN(&entries[i]->nh_list_head, curr){
+            nh_index = fib_export_nexthop(ctxt, glthread_to_unified_nh(curr));
+            fib_export_table_add(nh_lists, &nh_index);
+            route_rec.n_nh++;
+        } ITERATE_GLTHREAD_END(&entries[i]->nh_list_head, curr);
+
+        fib_export_table_add(routes, &route_rec);
+    }
+    range->count = n;
+    free(entries);
+}
+
+static int
+fib_export_write(fib_export_ctxt_t *ctxt, const char *file_name,
+                 unsigned long long *file_bytes){
+
+    FILE *fp = NULL;
+    unsigned int i = 0;
+    uint64_t offset = 0;
+    size_t len = 0;
+    fib_export_hdr_t hdr;
+    static const char pad[FIB_EXPORT_ALIGN];
+
+    memset(&hdr, 0, sizeof(fib_export_hdr_t));
+    hdr.magic = FIB_EXPORT_MAGIC;
+    hdr.version = FIB_EXPORT_VERSION;
+    hdr.hdr_size = sizeof(fib_export_hdr_t);
+    hdr.n_sections = FIB_EXPORT_SECTION_MAX;
+
+    offset = sizeof(fib_export_hdr_t);
+    for(i = 0; i < FIB_EXPORT_SECTION_MAX; i++){
+        offset = (offset + FIB_EXPORT_ALIGN - 1) & ~(uint64_t)(FIB_EXPORT_ALIGN - 1);
+        hdr.section[i].offset = offset;
+        hdr.section[i].count = ctxt->sections[i].count;
+        hdr.section[i].rec_size = ctxt->sections[i].rec_size;
+        offset += (uint64_t)ctxt->sections[i].count * ctxt->sections[i].rec_size;
+    }
+
+    fp = fopen(file_name, "wb");
+    if(!fp){
+        printf("%s() : Error : could not open file %s\n", __FUNCTION__, file_name);
+        return -1;
+    }
+
+    offset = 0;
+    if(fwrite(&hdr, sizeof(fib_export_hdr_t), 1, fp) != 1)
+        goto write_error;
+    offset = sizeof(fib_export_hdr_t);
+
+    for(i = 0; i < FIB_EXPORT_SECTION_MAX; i++){
+        if(hdr.section[i].offset > offset){
+            len = hdr.section[i].offset - offset;
+            if(fwrite(pad, 1, len, fp) != len)
+                goto write_error;
+            offset += len;
+        }
+        len = (size_t)ctxt->sections[i].count * ctxt->sections[i].rec_size;
+        if(len && fwrite(ctxt->sections[i].recs, 1, len, fp) != len)
+            goto write_error;
+        offset += len;
+    }
+
+    if(fclose(fp) != 0){
+        printf("%s() : Error : could not write file %s\n", __FUNCTION__, file_name);
+        return -1;
+    }
+    *file_bytes = offset;
+    return 0;
+
+    write_error:
+    printf("%s() : Error : could not write file %s\n", __FUNCTION__, file_name);
+    fclose(fp);
+    return -1;
+}
+
+int
+fib_export_to_file(instance_t *instance, const char *file_name,
+                   fib_export_stats_t *stats){
+
+    int rc = 0;
+    unsigned int i = 0;
+    rib_type_t rib_type;
+    node_t *node = NULL;
+    singly_ll_node_t *list_node = NULL;
+    fib_export_ctxt_t ctxt;
+    fib_export_node_t node_rec;
+    unsigned long long start_time = get_time_usec();
+
+    memset(stats, 0, sizeof(fib_export_stats_t));
+    memset(&ctxt, 0, sizeof(fib_export_ctxt_t));
+
+    fib_export_table_init(&ctxt.sections[FIB_EXPORT_SECTION_NODES], sizeof(fib_export_node_t), FALSE);
+    fib_export_table_init(&ctxt.sections[FIB_EXPORT_SECTION_ROUTES], sizeof(fib_export_route_t), FALSE);
+    fib_export_table_init(&ctxt.sections[FIB_EXPORT_SECTION_NH_LISTS], sizeof(uint32_t), FALSE);
+    fib_export_table_init(&ctxt.sections[FIB_EXPORT_SECTION_NEXTHOPS], sizeof(fib_export_nh_t), TRUE);
+    fib_export_table_init(&ctxt.sections[FIB_EXPORT_SECTION_LABEL_STACKS], sizeof(fib_export_label_stack_t), TRUE);
+
+    /*Pseudonodes do not forward, they are not exported*/
+    ctxt.nodes = calloc(GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list) + 1,
+                        sizeof(node_t *));
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        if(node->node_type[LEVEL1] == PSEUDONODE ||
+            node->node_type[LEVEL2] == PSEUDONODE)
+            continue;
+        ctxt.nodes[ctxt.n_nodes++] = node;
+    } ITERATE_LIST_END;
+    qsort(ctxt.nodes, ctxt.n_nodes, sizeof(node_t *), fib_export_node_name_comparison_fn);
+
+    for(i = 0; i < ctxt.n_nodes; i++){
+        node = ctxt.nodes[i];
+        memset(&node_rec, 0, sizeof(fib_export_node_t));
+        strncpy(node_rec.node_name, node->node_name, NODE_NAME_SIZE - 1);
+        node_rec.router_id = fib_export_ipv4(node->router_id);
+        for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++)
+            fib_export_rib(&ctxt, node->spf_info.rib[rib_type], &node_rec.rib[rib_type]);
+        fib_export_table_add(&ctxt.sections[FIB_EXPORT_SECTION_NODES], &node_rec);
+    }
+
+    rc = fib_export_write(&ctxt, file_name, &stats->file_bytes);
+
+    stats->n_nodes = ctxt.sections[FIB_EXPORT_SECTION_NODES].count;
+    stats->n_routes = ctxt.sections[FIB_EXPORT_SECTION_ROUTES].count;
+    stats->n_nh_refs = ctxt.sections[FIB_EXPORT_SECTION_NH_LISTS].count;
+    stats->n_nexthops = ctxt.sections[FIB_EXPORT_SECTION_NEXTHOPS].count;
+    stats->n_label_stacks = ctxt.sections[FIB_EXPORT_SECTION_LABEL_STACKS].count;
+
+    for(i = 0; i < FIB_EXPORT_SECTION_MAX; i++)
+        fib_export_table_free(&ctxt.sections[i]);
+    free(ctxt.nodes);
+    stats->usec = get_time_usec() - start_time;
+    return rc;
+}
+
+void
+print_fib_export_stats(const char *file_name, fib_export_stats_t *stats){
+
+    printf("FIB export %s : nodes = %u, routes = %u, nexthop refs = %u, "
+           "unique nexthops = %u, label stacks = %u, bytes = %llu, time = %llu usec\n",
+           file_name, stats->n_nodes, stats->n_routes, stats->n_nh_refs,
+           stats->n_nexthops, stats->n_label_stacks, stats->file_bytes, stats->usec);
+}
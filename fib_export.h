@@ -0,0 +1,158 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  fib_export.h
+ *
+ *    Description:  This file declares the FIB memory accounting and the compact
+ *                  binary export of inet.0, inet.3 and mpls.0 tables of all routers.
+ *                  Export file is a header followed by sections of fixed size records,
+ *                  so that it can be mmap'ed and indexed in place by external tools.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __FIB_EXPORT__
+#define __FIB_EXPORT__
+
+#include <stdint.h>
+#include "data_plane.h"
+
+typedef struct instance_ instance_t;
+
+/*Memory accounting*/
+
+typedef struct fib_mem_stats_{
+
+    unsigned int n_entries;
+    unsigned int n_nh_refs;         /*nexthops held by routing entries*/
+    unsigned int n_unique_nh;       /*distinct nexthops in nexthop pool*/
+    /*Unique nexthops by no of label stack operations*/
+    unsigned int label_depth[MPLS_STACK_OP_LIMIT_MAX + 1];
+    unsigned long long entry_bytes;
+    unsigned long long nh_ref_bytes;
+    unsigned long long nh_bytes;
+    unsigned long long table_bytes; /*fixed : table, nexthop pool buckets, change log*/
+    unsigned long long total_bytes;
+    unsigned long long compact_bytes; /*same table in export format, before
+                                         nexthops are shared across routers*/
+} fib_mem_stats_t;
+
+void
+fib_mem_account_rib(rt_un_table_t *rib, fib_mem_stats_t *stats);
+
+void
+show_fib_memory(node_t *node);
+
+/*Export format, all fields are in host byte order, magic tells the
+ * byte order of file*/
+
+#define FIB_EXPORT_MAGIC        0x58424946  /*"FIBX"*/
+#define FIB_EXPORT_VERSION      1
+#define FIB_EXPORT_INVALID      0xFFFFFFFFU
+#define FIB_EXPORT_ALIGN        8
+
+typedef enum{
+
+    FIB_EXPORT_SECTION_NODES,
+    FIB_EXPORT_SECTION_ROUTES,
+    FIB_EXPORT_SECTION_NH_LISTS,    /*uint32_t index into NEXTHOPS per route nexthop*/
+    FIB_EXPORT_SECTION_NEXTHOPS,
+    FIB_EXPORT_SECTION_LABEL_STACKS,
+    FIB_EXPORT_SECTION_MAX
+} fib_export_section_type_t;
+
+typedef struct fib_export_section_{
+
+    uint64_t offset;    /*from start of file, FIB_EXPORT_ALIGN aligned*/
+    uint32_t count;
+    uint32_t rec_size;
+} fib_export_section_t;
+
+typedef struct fib_export_hdr_{
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t hdr_size;
+    uint32_t n_sections;
+    fib_export_section_t section[FIB_EXPORT_SECTION_MAX];
+} fib_export_hdr_t;
+
+typedef struct fib_export_range_{
+
+    uint32_t start;
+    uint32_t count;
+} fib_export_range_t;
+
+/*Nodes are sorted by name*/
+typedef struct fib_export_node_{
+
+    char node_name[NODE_NAME_SIZE];
+    uint32_t router_id;
+    /*Routes of the node in ROUTES, per rib_type_t*/
+    fib_export_range_t rib[RIB_COUNT];
+} fib_export_node_t;
+
+/*Routes of a RIB are sorted by key, then by mask*/
+typedef struct fib_export_route_{
+
+    uint32_t key;       /*ipv4 prefix, incoming label for mpls.0*/
+    uint8_t mask;       /*0 for mpls.0*/
+    uint8_t level;
+    uint16_t n_nh;
+    uint32_t nh_list;   /*index of first nexthop of route in NH_LISTS*/
+} fib_export_route_t;
+
+/*Nexthops are unique across all routers and RIBs*/
+typedef struct fib_export_nh_{
+
+    char oif_name[IF_NAME_SIZE];    /*empty for local nexthop*/
+    uint32_t gw;
+    uint32_t nh_node;       /*index in NODES or FIB_EXPORT_INVALID*/
+    uint32_t label_stack;   /*index in LABEL_STACKS or FIB_EXPORT_INVALID*/
+    uint8_t flags;          /*PRIMARY_NH and nexthop type bits*/
+    uint8_t protocol;       /*PROTOCOL*/
+    uint8_t lfa_type;       /*lfa_type_t*/
+    uint8_t ucmp_weight;    /*UCMP buckets, 0 if nexthop carries no weight*/
+} fib_export_nh_t;
+
+/*Label stack operations in order of execution on packet, unique*/
+typedef struct fib_export_label_stack_{
+
+    uint8_t n_ops;
+    uint8_t stack_op[MPLS_STACK_OP_LIMIT_MAX];  /*MPLS_STACK_OP*/
+    uint32_t label[MPLS_STACK_OP_LIMIT_MAX];
+} fib_export_label_stack_t;
+
+typedef struct fib_export_stats_{
+
+    unsigned int n_nodes;
+    unsigned int n_routes;
+    unsigned int n_nh_refs;
+    unsigned int n_nexthops;
+    unsigned int n_label_stacks;
+    unsigned long long file_bytes;
+    unsigned long long usec;
+} fib_export_stats_t;
+
+/*Returns 0 on success, -1 if file could not be written*/
+int
+fib_export_to_file(instance_t *instance, const char *file_name,
+                   fib_export_stats_t *stats);
+
+void
+print_fib_export_stats(const char *file_name, fib_export_stats_t *stats);
+
+#endif /* __FIB_EXPORT__ */
@@ -0,0 +1,677 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  flex_algo.c
+ *
+ *    Description:  This file implements the Flexible Algorithm SPF. For a computing
+ *                  node, topology of the level is indexed once into a read only
+ *                  adjacency array. Every algorithm then compiles its constraints
+ *                  into a bit mask of usable links over this index and runs its
+ *                  Dijkstra with private state only, in a thread of its own.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "flex_algo.h"
+#include "instance.h"
+#include "spfutil.h"
+#include "data_plane.h"
+
+extern instance_t *instance;
+
+/*Read only index of the topology of a level, shared by all algorithms*/
+typedef struct flex_algo_adj_{
+
+    edge_t *edge;
+    unsigned int nbr;       /*index of nbr node*/
+} flex_algo_adj_t;
+
+typedef struct flex_algo_topo_{
+
+    node_t *root;
+    unsigned int root_index;
+    LEVEL level;
+    unsigned int n_nodes;
+    node_t **nodes;             /*sorted by address*/
+    unsigned int *adj_offset;   /*adjacencies of node i are [adj_offset[i], adj_offset[i+1])*/
+    unsigned int n_adj;
+    flex_algo_adj_t *adj;
+} flex_algo_topo_t;
+
+/*First hop of the path upto a node, as indices*/
+typedef struct flex_algo_hop_{
+
+    unsigned int adj;       /*root's adjacency*/
+    unsigned int gw;        /*index of gateway node*/
+} flex_algo_hop_t;
+
+typedef struct flex_algo_heap_entry_{
+
+    unsigned long long metric;
+    unsigned int node;
+} flex_algo_heap_entry_t;
+
+/*Private state of one algorithm SPF run*/
+typedef struct flex_algo_run_{
+
+    flex_algo_topo_t *topo;
+    flex_algo_def_t *fad;
+    bit_array_t edge_mask;
+    unsigned long long *metric;
+    unsigned int *n_hops;
+    flex_algo_hop_t *hops;      /*MAX_NXT_HOPS per node*/
+    char *done;
+    flex_algo_heap_entry_t *heap;
+    unsigned int heap_size;
+    /*Output*/
+    unsigned int n_routes;
+    flex_algo_route_t *routes;
+} flex_algo_run_t;
+
+flex_algo_def_t *
+flex_algo_get_def(node_t *node, unsigned char algo){
+
+    unsigned int i = 0;
+    flex_algo_db_t *db = node->flex_algo_db;
+
+    if(!db) return NULL;
+
+    for(i = 0; i < db->n_fad; i++){
+        if(db->fad[i].algo == algo)
+            return &db->fad[i];
+        if(db->fad[i].algo > algo)
+            break;
+    }
+    return NULL;
+}
+
+flex_algo_def_t *
+flex_algo_add_def(node_t *node, unsigned char algo){
+
+    unsigned int i = 0;
+    flex_algo_def_t *fad = NULL;
+    flex_algo_db_t *db = NULL;
+
+    if((fad = flex_algo_get_def(node, algo)))
+        return fad;
+
+    if(!node->flex_algo_db)
+        node->flex_algo_db = calloc(1, sizeof(flex_algo_db_t));
+
+    db = node->flex_algo_db;
+
+    if(db->n_fad == FLEX_ALGO_MAX_DEFS){
+        printf("Error : node %s already participates in %u flex algos\n",
+                node->node_name, FLEX_ALGO_MAX_DEFS);
+        return NULL;
+    }
+
+    for(i = db->n_fad; i > 0 && db->fad[i - 1].algo > algo; i--)
+        db->fad[i] = db->fad[i - 1];
+
+    fad = &db->fad[i];
+    memset(fad, 0, sizeof(flex_algo_def_t));
+    fad->algo = algo;
+    fad->metric_type = FLEX_ALGO_METRIC_IGP;
+    db->n_fad++;
+    return fad;
+}
+
+void
+flex_algo_delete_def(node_t *node, unsigned char algo){
+
+    unsigned int i = 0;
+    LEVEL level_it;
+    flex_algo_def_t *fad = flex_algo_get_def(node, algo);
+    flex_algo_db_t *db = node->flex_algo_db;
+
+    if(!fad){
+        printf("Error : node %s do not participate in flex algo %u\n",
+                node->node_name, algo);
+        return;
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(fad->routes[level_it])
+            free(fad->routes[level_it]);
+    }
+
+    for(i = fad - db->fad; i + 1 < db->n_fad; i++)
+        db->fad[i] = db->fad[i + 1];
+    db->n_fad--;
+
+    if(db->n_fad == 0){
+        free(db);
+        node->flex_algo_db = NULL;
+    }
+}
+
+static int
+flex_algo_node_ptr_comparison_fn(const void *p1, const void *p2){
+
+    node_t *node1 = *(node_t **)p1,
+           *node2 = *(node_t **)p2;
+
+    if(node1 < node2) return -1;
+    if(node1 > node2) return 1;
+    return 0;
+}
+
+static unsigned int
+flex_algo_node_index(flex_algo_topo_t *topo, node_t *node){
+
+    node_t **res = bsearch(&node, topo->nodes, topo->n_nodes,
+                    sizeof(node_t *), flex_algo_node_ptr_comparison_fn);
+
+    return res ? (unsigned int)(res - topo->nodes) : topo->n_nodes;
+}
+
+/*Only the unicast links are part of algorithm topologies, forwarding
+ * adjacencies are not*/
+#define FLEX_ALGO_IS_EDGE_USABLE(edge_ptr, _level)                        \
+    ((edge_ptr)->status && (edge_ptr)->etype == UNICAST &&                \
+     IS_LEVEL_SET((edge_ptr)->level, _level))
+
+static void
+flex_algo_build_topo(flex_algo_topo_t *topo, node_t *root, LEVEL level){
+
+    unsigned int i = 0, j = 0,
+                 n_adj = 0, nbr = 0;
+    singly_ll_node_t *list_node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+    node_t *node = NULL;
+
+    memset(topo, 0, sizeof(flex_algo_topo_t));
+    topo->root = root;
+    topo->level = level;
+    topo->n_nodes = GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list);
+    topo->nodes = calloc(topo->n_nodes, sizeof(node_t *));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        topo->nodes[i++] = list_node->data;
+    } ITERATE_LIST_END;
+
+    qsort(topo->nodes, topo->n_nodes, sizeof(node_t *),
+            flex_algo_node_ptr_comparison_fn);
+
+    /*Pass 1 : count, Pass 2 : fill*/
+    for(i = 0; i < topo->n_nodes; i++){
+        node = topo->nodes[i];
+        for(j = 0; j < MAX_NODE_INTF_SLOTS; j++){
+            edge_end = node->edges[j];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+            if(FLEX_ALGO_IS_EDGE_USABLE(edge, level))
+                n_adj++;
+        }
+    }
+
+    topo->adj_offset = calloc(topo->n_nodes + 1, sizeof(unsigned int));
+    topo->adj = calloc(n_adj ? n_adj : 1, sizeof(flex_algo_adj_t));
+
+    for(i = 0; i < topo->n_nodes; i++){
+        node = topo->nodes[i];
+        topo->adj_offset[i] = topo->n_adj;
+        for(j = 0; j < MAX_NODE_INTF_SLOTS; j++){
+            edge_end = node->edges[j];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+            if(!FLEX_ALGO_IS_EDGE_USABLE(edge, level))
+                continue;
+            nbr = flex_algo_node_index(topo, edge->to.node);
+            if(nbr == topo->n_nodes)
+                continue;
+            topo->adj[topo->n_adj].edge = edge;
+            topo->adj[topo->n_adj].nbr = nbr;
+            topo->n_adj++;
+        }
+    }
+    topo->adj_offset[topo->n_nodes] = topo->n_adj;
+    topo->root_index = flex_algo_node_index(topo, root);
+}
+
+static void
+flex_algo_free_topo(flex_algo_topo_t *topo){
+
+    free(topo->nodes);
+    free(topo->adj_offset);
+    free(topo->adj);
+}
+
+static boolean
+flex_algo_is_node_participating(node_t *node, LEVEL level, unsigned char algo){
+
+    /*Pseudonodes do not advertise anything, they are part of every
+     * algorithm in which the LAN routers participate*/
+    if(node->node_type[level] == PSEUDONODE)
+        return TRUE;
+    return flex_algo_get_def(node, algo) ? TRUE : FALSE;
+}
+
+static unsigned int
+flex_algo_link_metric(flex_algo_topo_t *topo, flex_algo_def_t *fad,
+                      unsigned int src, edge_t *edge){
+
+    if(fad->metric_type == FLEX_ALGO_METRIC_IGP ||
+        topo->nodes[src]->node_type[topo->level] == PSEUDONODE)
+        return edge->metric[topo->level];
+    return edge->te_metric;
+}
+
+/*Compile the algorithm constraints into the bit mask of usable links*/
+static void
+flex_algo_compile_edge_mask(flex_algo_run_t *run){
+
+    unsigned int i = 0, adj = 0;
+    flex_algo_topo_t *topo = run->topo;
+    flex_algo_def_t *fad = run->fad;
+    char *participating = calloc(topo->n_nodes, sizeof(char));
+    edge_t *edge = NULL;
+
+    init_bit_array(&run->edge_mask, topo->n_adj ? topo->n_adj : 1);
+
+    for(i = 0; i < topo->n_nodes; i++)
+        participating[i] = flex_algo_is_node_participating(topo->nodes[i], topo->level, fad->algo);
+
+    for(i = 0; i < topo->n_nodes; i++){
+        if(!participating[i])
+            continue;
+        for(adj = topo->adj_offset[i]; adj < topo->adj_offset[i + 1]; adj++){
+            edge = topo->adj[adj].edge;
+            if(!participating[topo->adj[adj].nbr])
+                continue;
+            /*Links of pseudonode carry no attributes*/
+            if(topo->nodes[i]->node_type[topo->level] != PSEUDONODE){
+                if(edge->affinity & fad->exclude_any)
+                    continue;
+                if(fad->include_any && !(edge->affinity & fad->include_any))
+                    continue;
+                if((edge->affinity & fad->include_all) != fad->include_all)
+                    continue;
+                if(fad->metric_type == FLEX_ALGO_METRIC_TE && !edge->te_metric)
+                    continue;
+            }
+            set_bit(&run->edge_mask, adj);
+        }
+    }
+    free(participating);
+}
+
+static void
+flex_algo_heap_push(flex_algo_run_t *run, unsigned long long metric, unsigned int node){
+
+    unsigned int i = run->heap_size++, parent = 0;
+    flex_algo_heap_entry_t entry = {metric, node};
+
+    while(i){
+        parent = (i - 1) >> 1;
+        if(run->heap[parent].metric <= metric)
+            break;
+        run->heap[i] = run->heap[parent];
+        i = parent;
+    }
+    run->heap[i] = entry;
+}
+
+static flex_algo_heap_entry_t
+flex_algo_heap_pop(flex_algo_run_t *run){
+
+    flex_algo_heap_entry_t top = run->heap[0],
+                           last = run->heap[--run->heap_size];
+    unsigned int i = 0, child = 0;
+
+    while((child = (i << 1) + 1) < run->heap_size){
+        if(child + 1 < run->heap_size &&
+            run->heap[child + 1].metric < run->heap[child].metric)
+            child++;
+        if(last.metric <= run->heap[child].metric)
+            break;
+        run->heap[i] = run->heap[child];
+        i = child;
+    }
+    run->heap[i] = last;
+    return top;
+}
+
+static void
+flex_algo_add_hop(flex_algo_run_t *run, unsigned int node,
+                  unsigned int adj, unsigned int gw){
+
+    unsigned int i = 0;
+    flex_algo_hop_t *hops = &run->hops[node * MAX_NXT_HOPS];
+
+    for(i = 0; i < run->n_hops[node]; i++){
+        if(hops[i].adj == adj && hops[i].gw == gw)
+            return;
+    }
+    if(run->n_hops[node] == MAX_NXT_HOPS)
+        return;
+    hops[run->n_hops[node]].adj = adj;
+    hops[run->n_hops[node]].gw = gw;
+    run->n_hops[node]++;
+}
+
+/*First hops of nbr when reached through node over adjacency adj*/
+static void
+flex_algo_inherit_hops(flex_algo_run_t *run, unsigned int node,
+                       unsigned int adj, unsigned int nbr){
+
+    unsigned int i = 0;
+    flex_algo_topo_t *topo = run->topo;
+    flex_algo_hop_t *hops = &run->hops[node * MAX_NXT_HOPS];
+
+    if(node == topo->root_index){
+        flex_algo_add_hop(run, nbr, adj, nbr);
+        return;
+    }
+
+    for(i = 0; i < run->n_hops[node]; i++){
+        /*node is a PN directly attached to root, real gateway is
+         * the router beyond PN*/
+        if(hops[i].gw == node &&
+            topo->nodes[node]->node_type[topo->level] == PSEUDONODE)
+            flex_algo_add_hop(run, nbr, hops[i].adj, nbr);
+        else
+            flex_algo_add_hop(run, nbr, hops[i].adj, hops[i].gw);
+    }
+}
+
+static void
+flex_algo_dijkstra(flex_algo_run_t *run){
+
+    unsigned int i = 0, adj = 0, nbr = 0;
+    unsigned long long metric = 0;
+    flex_algo_heap_entry_t top;
+    flex_algo_topo_t *topo = run->topo;
+    node_t *node = NULL;
+
+    for(i = 0; i < topo->n_nodes; i++)
+        run->metric[i] = INFINITE_METRIC;
+
+    run->metric[topo->root_index] = 0;
+    flex_algo_heap_push(run, 0, topo->root_index);
+
+    while(run->heap_size){
+        top = flex_algo_heap_pop(run);
+        if(run->done[top.node] || top.metric != run->metric[top.node])
+            continue;
+        run->done[top.node] = 1;
+        node = topo->nodes[top.node];
+
+        /*Overloaded routers are not used for transit*/
+        if(top.node != topo->root_index && IS_OVERLOADED(node, topo->level))
+            continue;
+
+        for(adj = topo->adj_offset[top.node]; adj < topo->adj_offset[top.node + 1]; adj++){
+            if(!is_bit_set(&run->edge_mask, adj))
+                continue;
+            nbr = topo->adj[adj].nbr;
+            if(run->done[nbr])
+                continue;
+            metric = top.metric + flex_algo_link_metric(topo, run->fad,
+                        top.node, topo->adj[adj].edge);
+            if(metric >= INFINITE_METRIC || metric > run->metric[nbr])
+                continue;
+            if(metric < run->metric[nbr]){
+                run->metric[nbr] = metric;
+                run->n_hops[nbr] = 0;
+                flex_algo_heap_push(run, metric, nbr);
+            }
+            /*ECMP*/
+            flex_algo_inherit_hops(run, top.node, adj, nbr);
+        }
+    }
+}
+
+static void
+flex_algo_build_routes(flex_algo_run_t *run){
+
+    unsigned int i = 0, j = 0, sid_index = 0;
+    flex_algo_topo_t *topo = run->topo;
+    node_t *root = topo->root, *dest = NULL, *gw = NULL;
+    flex_algo_def_t *dest_fad = NULL;
+    flex_algo_route_t *route = NULL;
+    flex_algo_hop_t *hop = NULL;
+    boolean sr_capable = is_node_spring_enabled(root, topo->level) && root->srgb;
+
+    run->routes = calloc(topo->n_nodes, sizeof(flex_algo_route_t));
+
+    for(i = 0; i < topo->n_nodes; i++){
+        dest = topo->nodes[i];
+        if(i == topo->root_index || !run->done[i] || !run->n_hops[i] ||
+            dest->node_type[topo->level] == PSEUDONODE)
+            continue;
+
+        route = &run->routes[run->n_routes++];
+        route->dest = dest;
+        route->metric = (unsigned int)run->metric[i];
+
+        /*Algorithm label of dest is taken from its own node SID in algo*/
+        dest_fad = flex_algo_get_def(dest, run->fad->algo);
+        sid_index = dest_fad ? dest_fad->node_sid.sid.sid : 0;
+        if(sr_capable && dest_fad && dest_fad->node_sid_set &&
+            sid_index < root->srgb->range)
+            route->mpls_label_in = get_label_from_srgb_index(root->srgb, sid_index);
+
+        for(j = 0; j < run->n_hops[i]; j++){
+            hop = &run->hops[i * MAX_NXT_HOPS + j];
+            gw = topo->nodes[hop->gw];
+            route->nh[j].oif = &topo->adj[hop->adj].edge->from;
+            route->nh[j].gw_node = gw;
+            if(!route->mpls_label_in)
+                continue;
+            if(gw == dest && !IS_BIT_SET(dest_fad->node_sid.flags, NO_PHP_P_FLAG)){
+                route->nh[j].stack_op = POP;
+            }
+            else if(is_node_spring_enabled(gw, topo->level) && gw->srgb &&
+                sid_index < gw->srgb->range){
+                route->nh[j].stack_op = SWAP;
+                route->nh[j].mpls_label_out = get_label_from_srgb_index(gw->srgb, sid_index);
+            }
+        }
+        route->nh_count = run->n_hops[i];
+    }
+}
+
+static void *
+flex_algo_spf_thread_fn(void *arg){
+
+    flex_algo_run_t *run = arg;
+    flex_algo_topo_t *topo = run->topo;
+
+    run->metric = calloc(topo->n_nodes, sizeof(unsigned long long));
+    run->n_hops = calloc(topo->n_nodes, sizeof(unsigned int));
+    run->hops = calloc(topo->n_nodes * MAX_NXT_HOPS, sizeof(flex_algo_hop_t));
+    run->done = calloc(topo->n_nodes, sizeof(char));
+    /*Every push is preceded by a strict metric improvement over an adjacency*/
+    run->heap = calloc(topo->n_adj + 1, sizeof(flex_algo_heap_entry_t));
+
+    flex_algo_compile_edge_mask(run);
+    flex_algo_dijkstra(run);
+    flex_algo_build_routes(run);
+
+    free(run->metric);
+    free(run->n_hops);
+    free(run->hops);
+    free(run->done);
+    free(run->heap);
+    return NULL;
+}
+
+void
+flex_algo_compute(node_t *spf_root, LEVEL level){
+
+    unsigned int i = 0, n_fad = 0;
+    flex_algo_topo_t topo;
+    flex_algo_run_t *runs = NULL;
+    flex_algo_def_t *fad = NULL;
+    pthread_t *threads = NULL;
+    char *spawned = NULL;
+
+    if(!spf_root->flex_algo_db)
+        return;
+
+    n_fad = spf_root->flex_algo_db->n_fad;
+    flex_algo_build_topo(&topo, spf_root, level);
+
+    runs = calloc(n_fad, sizeof(flex_algo_run_t));
+    threads = calloc(n_fad, sizeof(pthread_t));
+    spawned = calloc(n_fad, sizeof(char));
+
+    /*Topology index is read only from here on, algorithm runs touch
+     * nothing but their own flex_algo_run_t*/
+    for(i = 0; i < n_fad; i++){
+        runs[i].topo = &topo;
+        runs[i].fad = &spf_root->flex_algo_db->fad[i];
+        if(n_fad > 1 && pthread_create(&threads[i], NULL,
+                    flex_algo_spf_thread_fn, &runs[i]) == 0)
+            spawned[i] = 1;
+        else
+            flex_algo_spf_thread_fn(&runs[i]);
+    }
+
+    for(i = 0; i < n_fad; i++){
+        if(spawned[i])
+            pthread_join(threads[i], NULL);
+        fad = runs[i].fad;
+        if(fad->routes[level])
+            free(fad->routes[level]);
+        fad->routes[level] = runs[i].routes;
+        fad->n_routes[level] = runs[i].n_routes;
+        fad->n_links[level] = BIT_ARRAY_SET_COUNT(&runs[i].edge_mask);
+        free_bit_array(&runs[i].edge_mask);
+    }
+
+    free(runs);
+    free(threads);
+    free(spawned);
+    flex_algo_free_topo(&topo);
+}
+
+void
+flex_algo_recompute_all(instance_t *instance){
+
+    LEVEL level_it;
+    node_t *node = NULL;
+    singly_ll_node_t *list_node = NULL;
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        if(!node->flex_algo_db)
+            continue;
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            /*Level in which node never ran SPF*/
+            if(!node->spf_info.spf_level_info[level_it].version)
+                continue;
+            flex_algo_compute(node, level_it);
+        }
+    } ITERATE_LIST_END;
+}
+
+static char *
+get_str_flex_algo_metric_type(flex_algo_metric_type_t metric_type){
+
+    switch(metric_type){
+        case FLEX_ALGO_METRIC_IGP:
+            return "igp";
+        case FLEX_ALGO_METRIC_TE:
+            return "te";
+        default:
+            return "unknown";
+    }
+}
+
+static void
+show_flex_algo_def(node_t *node, flex_algo_def_t *fad){
+
+    unsigned int i = 0, j = 0;
+    LEVEL level_it;
+    flex_algo_route_t *route = NULL;
+    flex_algo_nh_t *nh = NULL;
+
+    printf("Flex-Algo %u : metric-type %s, exclude-any 0x%08x, include-any 0x%08x, include-all 0x%08x\n",
+            fad->algo, get_str_flex_algo_metric_type(fad->metric_type),
+            fad->exclude_any, fad->include_any, fad->include_all);
+
+    if(fad->node_sid_set)
+        printf("\tNode SID index : %u\n", fad->node_sid.sid.sid);
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(!node->spf_info.spf_level_info[level_it].version)
+            continue;
+        printf("\t%s : constrained topology links : %u, routes : %u\n",
+                get_str_level(level_it), fad->n_links[level_it], fad->n_routes[level_it]);
+        if(!fad->n_routes[level_it])
+            continue;
+        printf("\t%-16s %-10s %-10s %-16s %-16s %-10s %s\n", "Destination", "Metric",
+                "InLabel", "Gateway", "Oif", "OutLabel", "Action");
+        for(i = 0; i < fad->n_routes[level_it]; i++){
+            route = &fad->routes[level_it][i];
+            for(j = 0; j < route->nh_count; j++){
+                nh = &route->nh[j];
+                if(j == 0)
+                    printf("\t%-16s %-10u ", route->dest->node_name, route->metric);
+                else
+                    printf("\t%-16s %-10s ", "", "");
+                if(route->mpls_label_in && j == 0)
+                    printf("%-10u ", route->mpls_label_in);
+                else
+                    printf("%-10s ", "-");
+                printf("%-16s %-16s ", nh->gw_node->router_id, nh->oif->intf_name);
+                if(nh->stack_op == STACK_OPS_UNKNOWN)
+                    printf("%-10s %s\n", "-", "-");
+                else if(nh->stack_op == POP)
+                    printf("%-10s %s\n", "-", get_str_stackops(nh->stack_op));
+                else
+                    printf("%-10u %s\n", nh->mpls_label_out, get_str_stackops(nh->stack_op));
+            }
+        }
+    }
+}
+
+void
+show_flex_algo(node_t *node, unsigned char algo){
+
+    unsigned int i = 0;
+    flex_algo_def_t *fad = NULL;
+
+    if(!node->flex_algo_db){
+        printf("node %s do not participate in any flex algo\n", node->node_name);
+        return;
+    }
+
+    if(algo){
+        fad = flex_algo_get_def(node, algo);
+        if(!fad){
+            printf("node %s do not participate in flex algo %u\n", node->node_name, algo);
+            return;
+        }
+        show_flex_algo_def(node, fad);
+        return;
+    }
+
+    for(i = 0; i < node->flex_algo_db->n_fad; i++)
+        show_flex_algo_def(node, &node->flex_algo_db->fad[i]);
+}
@@ -0,0 +1,119 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  flex_algo.h
+ *
+ *    Description:  This file declares the Flexible Algorithm (algo 128-255) support.
+ *                  Every flex algo definition (FAD) describes a metric type and
+ *                  affinity constraints, the algorithm SPF runs over the constrained
+ *                  topology i.e. the links satisfying the constraints between
+ *                  participating routers only. Topology is never copied, all the
+ *                  algorithms of a computing node share one read only index of the
+ *                  topology and each algorithm owns a bit mask of usable links over
+ *                  it, so algorithm SPF runs proceed concurrently.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __FLEX_ALGO__
+#define __FLEX_ALGO__
+
+#include "instanceconst.h"
+#include "igp_sr_ext.h"
+
+typedef struct _node_t node_t;
+typedef struct edge_end_ edge_end_t;
+typedef struct instance_ instance_t;
+
+#define FLEX_ALGO_MIN           128
+#define FLEX_ALGO_MAX           255
+/*Max no of flex algos a router can participate in*/
+#define FLEX_ALGO_MAX_DEFS      16
+/*Affinities are bit positions in edge_t->affinity*/
+#define FLEX_ALGO_MAX_AFFINITY  32
+
+typedef enum{
+
+    FLEX_ALGO_METRIC_IGP,
+    /*Links without TE metric are excluded from the algorithm topology*/
+    FLEX_ALGO_METRIC_TE
+} flex_algo_metric_type_t;
+
+typedef struct flex_algo_nh_{
+
+    edge_end_t *oif;
+    node_t *gw_node;
+    mpls_label_t mpls_label_out;
+    unsigned char stack_op;     /*MPLS_STACK_OP, STACK_OPS_UNKNOWN if no algo label*/
+} flex_algo_nh_t;
+
+typedef struct flex_algo_route_{
+
+    node_t *dest;
+    unsigned int metric;
+    mpls_label_t mpls_label_in; /*0 if dest has no node SID for algo*/
+    unsigned int nh_count;
+    flex_algo_nh_t nh[MAX_NXT_HOPS];
+} flex_algo_route_t;
+
+typedef struct flex_algo_def_{
+
+    unsigned char algo;
+    flex_algo_metric_type_t metric_type;
+    /*Link is usable if it has none of exclude_any bits, atleast
+     * one of include_any bits (if any) and all of include_all bits*/
+    unsigned int exclude_any;
+    unsigned int include_any;
+    unsigned int include_all;
+    /*Node SID of this router in the algorithm, algorithm field is algo*/
+    boolean node_sid_set;
+    prefix_sid_subtlv_t node_sid;
+    /*Result of last algorithm SPF run on this router*/
+    unsigned int n_links[MAX_LEVEL];   /*No of links in constrained topology*/
+    unsigned int n_routes[MAX_LEVEL];
+    flex_algo_route_t *routes[MAX_LEVEL];
+} flex_algo_def_t;
+
+typedef struct flex_algo_db_{
+
+    unsigned int n_fad;
+    flex_algo_def_t fad[FLEX_ALGO_MAX_DEFS]; /*sorted by algo*/
+} flex_algo_db_t;
+
+flex_algo_def_t *
+flex_algo_get_def(node_t *node, unsigned char algo);
+
+/*Returns the existing definition if router already participates in algo*/
+flex_algo_def_t *
+flex_algo_add_def(node_t *node, unsigned char algo);
+
+void
+flex_algo_delete_def(node_t *node, unsigned char algo);
+
+/*Run the SPF of all the algorithms the spf_root participates in*/
+void
+flex_algo_compute(node_t *spf_root, LEVEL level);
+
+/*Flex algo definitions, participation or link attributes changed,
+ * rerun algorithm SPFs on all routers. Regular SPF is not affected*/
+void
+flex_algo_recompute_all(instance_t *instance);
+
+/*algo 0 - show all algorithms*/
+void
+show_flex_algo(node_t *node, unsigned char algo);
+
+#endif /* __FLEX_ALGO__ */
@@ -0,0 +1,820 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  fwd_sim.c
+ *
+ *    Description:  This file implements the batch forwarding simulator
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "fwd_sim.h"
+#include "instance.h"
+#include "spfutil.h"
+#include "data_plane.h"
+
+extern instance_t *instance;
+
+#define FWD_SIM_NH_TYPE_MASK(nh_type)   (1U << (nh_type))
+/*Nexthops of mpls.0 are of unique type per incoming label*/
+#define FWD_SIM_MPLS_NH_MASK                                                    \
+    (FWD_SIM_NH_TYPE_MASK(LDP_TRANSIT_NH)    | FWD_SIM_NH_TYPE_MASK(SPRING_TRANSIT_NH) | \
+     FWD_SIM_NH_TYPE_MASK(RSVP_TRANSIT_NH)   | FWD_SIM_NH_TYPE_MASK(IPV4_LDP_NH)       | \
+     FWD_SIM_NH_TYPE_MASK(IPV4_SPRING_NH)    | FWD_SIM_NH_TYPE_MASK(IPV4_RSVP_NH)      | \
+     FWD_SIM_NH_TYPE_MASK(IPV4_NH))
+
+typedef struct fwd_sim_work_{
+
+    fwd_sim_matrix_t *matrix;
+    node_t **nodes;         /*sorted, node index is position in this array*/
+    unsigned int n_nodes;
+    unsigned int next;      /*next dst column to be picked by worker*/
+} fwd_sim_work_t;
+
+/*Paths of a pair are enumerated by forwarding its packet again and again,
+ * taking a different choice at routers which spray the traffic each time*/
+typedef struct fwd_sim_load_ctxt_{
+
+    unsigned int depth;     /*spraying routers crossed by the packet so far*/
+    unsigned char choice[FWD_SIM_MAX_BRANCHES];
+    unsigned char n_choices[FWD_SIM_MAX_BRANCHES];
+    double share;
+    fwd_sim_load_path_t *path;
+} fwd_sim_load_ctxt_t;
+
+typedef struct fwd_sim_worker_{
+
+    fwd_sim_work_t *work;
+    fwd_sim_stats_t stats;
+    /*LPM results of the dst column being forwarded, per node. All pairs
+     * of a column are forwarded together so that a node does LPM of the
+     * dst only once, whatever the no of sources whose packet cross it*/
+    rt_un_entry_t **lpm[INET_3 + 1];
+    unsigned char *lpm_done[INET_3 + 1];
+    /*Unlabelled packet visiting a node twice is in a loop*/
+    unsigned int *visit_stamp;
+    unsigned int stamp;
+    fwd_sim_load_ctxt_t *load;  /*NULL unless load distribution is computed*/
+} fwd_sim_worker_t;
+
+static int
+fwd_sim_node_comparison_fn(const void *p1, const void *p2){
+
+    node_t *n1 = *(node_t **)p1, *n2 = *(node_t **)p2;
+    if(n1 < n2) return -1;
+    if(n1 > n2) return 1;
+    return 0;
+}
+
+static unsigned int
+fwd_sim_node_index(fwd_sim_work_t *work, node_t *node){
+
+    node_t **res = bsearch(&node, work->nodes, work->n_nodes,
+                    sizeof(node_t *), fwd_sim_node_comparison_fn);
+    assert(res);
+    return (unsigned int)(res - work->nodes);
+}
+
+/*FNV-1a over node name*/
+static inline unsigned int
+fwd_sim_hash_node(unsigned int hash, node_t *node){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < NODE_NAME_SIZE && node->node_name[i]; i++){
+        hash ^= (unsigned char)node->node_name[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/*Nexthops installed by protocols other than IGP carry no weight*/
+#define FWD_SIM_NH_WEIGHT(nexthop)  \
+    ((nexthop)->ucmp_weight ? (nexthop)->ucmp_weight : 1)
+
+/*Nexthop the packet takes, first usable primary, else first
+ * usable backup. *no_nexthop is set if route has no nexthop of
+ * nh_type at all i.e. route is local. When load distribution is computed,
+ * primary of current choice of load ctxt is taken instead of first one*/
+static internal_un_nh_t *
+fwd_sim_select_nh(rt_un_entry_t *rt_un_entry, unsigned int nh_type_mask,
+                  boolean *no_nexthop, fwd_sim_load_ctxt_t *load){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nexthop = NULL,
+                     *prim_nh = NULL,
+                     *backup_nh = NULL;
+    unsigned int n_prim = 0, total_weight = 0, choice = 0;
+
+    *no_nexthop = TRUE;
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+
+        nexthop = glthread_to_unified_nh(curr);
+        if(!((unsigned char)nexthop->flags & nh_type_mask))
+            continue;
+        *no_nexthop = FALSE;
+        if(!rt_un_entry_is_nh_usable(rt_un_entry, nexthop))
+            continue;
+        if(IS_BIT_SET(nexthop->flags, PRIMARY_NH)){
+            /*ECMP members left take over the failed one*/
+            if(!prim_nh) prim_nh = nexthop;
+            n_prim++;
+            total_weight += FWD_SIM_NH_WEIGHT(nexthop);
+        }
+        else if(!backup_nh)
+            backup_nh = nexthop;
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+
+    if(!load || n_prim < 2 || load->depth >= FWD_SIM_MAX_BRANCHES)
+        return prim_nh ? prim_nh : backup_nh;
+
+    /*Router sprays the traffic over up primaries*/
+    choice = load->choice[load->depth];
+    load->n_choices[load->depth++] = (unsigned char)n_prim;
+
+    n_prim = 0;
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+
+        nexthop = glthread_to_unified_nh(curr);
+        if(!((unsigned char)nexthop->flags & nh_type_mask) ||
+            !IS_BIT_SET(nexthop->flags, PRIMARY_NH) ||
+            !rt_un_entry_is_nh_usable(rt_un_entry, nexthop))
+            continue;
+        if(n_prim++ != choice)
+            continue;
+        load->share = load->share * FWD_SIM_NH_WEIGHT(nexthop) / total_weight;
+        return nexthop;
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+
+    assert(0);
+    return NULL;
+}
+
+static rt_un_entry_t *
+fwd_sim_lpm(fwd_sim_worker_t *worker, node_t *node, unsigned int node_index,
+            rib_type_t rib_type, char *dst){
+
+    if(!worker->lpm_done[rib_type][node_index]){
+        worker->lpm[rib_type][node_index] =
+            get_longest_prefix_match2(node->spf_info.rib[rib_type], dst);
+        worker->lpm_done[rib_type][node_index] = 1;
+    }
+    return worker->lpm[rib_type][node_index];
+}
+
+/*Returns FALSE if ops cannot be executed on the stack*/
+static boolean
+fwd_sim_execute_label_ops(internal_un_nh_t *nexthop,
+                          mpls_label_stack_t *mpls_label_stack){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < nexthop->n_label_ops; i++){
+        switch(nexthop->label_ops[i].stack_op){
+            case PUSH:
+                if(mpls_label_stack->top >= MPLS_LABEL_STACK_MAX_DEPTH - 1)
+                    return FALSE;
+                PUSH_MPLS_LABEL(mpls_label_stack, nexthop->label_ops[i].label);
+                break;
+            case POP:
+                if(IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack))
+                    return FALSE;
+                POP_MPLS_LABEL(mpls_label_stack);
+                break;
+            case SWAP:
+                if(IS_MPLS_LABEL_STACK_EMPTY(mpls_label_stack))
+                    return FALSE;
+                SWAP_MPLS_LABEL(mpls_label_stack, nexthop->label_ops[i].label);
+                break;
+            default:
+                return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*Same preference as ping : SPRING, LDP, RSVP tunnels, else plain IP*/
+static internal_un_nh_t *
+fwd_sim_ingress_lsp_nh(fwd_sim_worker_t *worker, node_t *node,
+                       unsigned int node_index, char *dst){
+
+    static const char lsp_nh_types[] = {IPV4_SPRING_NH, IPV4_LDP_NH, IPV4_RSVP_NH};
+    unsigned int i = 0;
+    boolean no_nexthop = FALSE;
+    internal_un_nh_t *nexthop = NULL;
+    rt_un_entry_t *rt_un_entry = fwd_sim_lpm(worker, node, node_index, INET_3, dst);
+
+    if(!rt_un_entry)
+        return NULL;
+
+    for(i = 0; i < sizeof(lsp_nh_types); i++){
+        nexthop = fwd_sim_select_nh(rt_un_entry,
+                    FWD_SIM_NH_TYPE_MASK(lsp_nh_types[i]), &no_nexthop, worker->load);
+        if(nexthop)
+            return nexthop;
+    }
+    return NULL;
+}
+
+static inline void
+fwd_sim_load_record_node(fwd_sim_load_ctxt_t *load, node_t *node,
+                         edge_end_t *oif){
+
+    fwd_sim_load_path_t *path = load->path;
+
+    if(path->n_nodes < FWD_SIM_MAX_PATH_NODES){
+        path->nodes[path->n_nodes] = node;
+        path->oif[path->n_nodes] = oif;
+    }
+    path->n_nodes++;
+}
+
+#define FWD_SIM_HOP(nexthop)                                \
+    do{                                                     \
+        node = (nexthop)->nh_node;                          \
+        hops++;                                             \
+        hash = fwd_sim_hash_node(hash, node);               \
+        if(worker->load)                                    \
+            fwd_sim_load_record_node(worker->load, node,    \
+                                     (nexthop)->oif);       \
+    } while(0)
+
+static void
+fwd_sim_forward(fwd_sim_worker_t *worker, node_t *src, char *dst,
+                fwd_sim_result_t *result){
+
+    node_t *node = src;
+    unsigned int hops = 0, node_index = 0;
+    unsigned int hash = fwd_sim_hash_node(2166136261U, src);
+    boolean no_nexthop = FALSE;
+    internal_un_nh_t *nexthop = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    mpls_label_stack_t mpls_label_stack;
+    rt_key_t rt_key;
+
+    if(++worker->stamp == 0){
+        memset(worker->visit_stamp, 0, worker->work->n_nodes * sizeof(unsigned int));
+        worker->stamp = 1;
+    }
+
+    result->rc = FWD_SIM_BLACKHOLE;
+    if(worker->load)
+        fwd_sim_load_record_node(worker->load, src, NULL);
+
+    while(1){
+
+        /*Packet is unlabelled at node*/
+        node_index = fwd_sim_node_index(worker->work, node);
+        if(worker->visit_stamp[node_index] == worker->stamp ||
+            hops >= FWD_SIM_MAX_HOPS){
+            result->rc = FWD_SIM_LOOP;
+            break;
+        }
+        worker->visit_stamp[node_index] = worker->stamp;
+
+        nexthop = fwd_sim_ingress_lsp_nh(worker, node, node_index, dst);
+
+        if(!nexthop){
+            rt_un_entry = fwd_sim_lpm(worker, node, node_index, INET_0, dst);
+            if(!rt_un_entry)
+                break;
+            nexthop = fwd_sim_select_nh(rt_un_entry,
+                        FWD_SIM_NH_TYPE_MASK(IPV4_NH), &no_nexthop, worker->load);
+            if(!nexthop){
+                if(no_nexthop)
+                    result->rc = FWD_SIM_DELIVERED;
+                break;
+            }
+            FWD_SIM_HOP(nexthop);
+            continue;
+        }
+
+        /*Packet enters the LSP*/
+        init_mpls_label_stack(&mpls_label_stack);
+        if(!fwd_sim_execute_label_ops(nexthop, &mpls_label_stack))
+            break;
+        FWD_SIM_HOP(nexthop);
+
+        while(!IS_MPLS_LABEL_STACK_EMPTY(&mpls_label_stack)){
+            if(hops >= FWD_SIM_MAX_HOPS){
+                result->rc = FWD_SIM_LOOP;
+                goto done;
+            }
+            rt_key.u.label = GET_MPLS_LABEL_STACK_TOP(&mpls_label_stack);
+            rt_un_entry = node->spf_info.rib[MPLS_0]->rt_un_route_lookup(
+                            node->spf_info.rib[MPLS_0], &rt_key);
+            if(!rt_un_entry)
+                goto done;
+            nexthop = fwd_sim_select_nh(rt_un_entry, FWD_SIM_MPLS_NH_MASK,
+                        &no_nexthop, worker->load);
+            if(!nexthop ||
+                !fwd_sim_execute_label_ops(nexthop, &mpls_label_stack))
+                goto done;
+            /*Egress LSR consumes the label and looks up the rest of packet*/
+            if(nexthop->oif)
+                FWD_SIM_HOP(nexthop);
+        }
+    }
+
+    done:
+    result->hops = hops > FWD_SIM_MAX_HOPS ? FWD_SIM_MAX_HOPS : hops;
+    result->path_hash = hash;
+    result->last_node = node;
+}
+
+static void
+fwd_sim_forward_column(fwd_sim_worker_t *worker, unsigned int dst_index){
+
+    unsigned int i = 0;
+    fwd_sim_matrix_t *matrix = worker->work->matrix;
+    fwd_sim_result_t *result = NULL;
+
+    memset(worker->lpm_done[INET_0], 0, worker->work->n_nodes);
+    memset(worker->lpm_done[INET_3], 0, worker->work->n_nodes);
+
+    for(i = 0; i < matrix->n_src; i++){
+        result = &matrix->result[i * matrix->n_dst + dst_index];
+        fwd_sim_forward(worker, matrix->src[i], matrix->dst[dst_index], result);
+        switch(result->rc){
+            case FWD_SIM_DELIVERED:
+                worker->stats.n_delivered++;
+                worker->stats.total_hops += result->hops;
+                break;
+            case FWD_SIM_BLACKHOLE:
+                worker->stats.n_blackhole++;
+                break;
+            case FWD_SIM_LOOP:
+                worker->stats.n_loop++;
+                break;
+            default:
+                ;
+        }
+    }
+}
+
+static void *
+fwd_sim_worker_fn(void *arg){
+
+    fwd_sim_worker_t *worker = arg;
+    fwd_sim_work_t *work = worker->work;
+    unsigned int i = 0;
+
+    while(1){
+        i = __atomic_fetch_add(&work->next, 1, __ATOMIC_RELAXED);
+        if(i >= work->matrix->n_dst)
+            break;
+        fwd_sim_forward_column(worker, i);
+    }
+    return NULL;
+}
+
+static void
+fwd_sim_work_init(instance_t *instance, fwd_sim_work_t *work,
+                  fwd_sim_matrix_t *matrix){
+
+    singly_ll_node_t *list_node = NULL;
+
+    memset(work, 0, sizeof(fwd_sim_work_t));
+    work->matrix = matrix;
+    work->nodes = calloc(GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list),
+                        sizeof(node_t *));
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        work->nodes[work->n_nodes++] = list_node->data;
+    } ITERATE_LIST_END;
+    qsort(work->nodes, work->n_nodes, sizeof(node_t *), fwd_sim_node_comparison_fn);
+}
+
+static void
+fwd_sim_worker_init(fwd_sim_worker_t *worker, fwd_sim_work_t *work){
+
+    memset(worker, 0, sizeof(fwd_sim_worker_t));
+    worker->work = work;
+    worker->lpm[INET_0] = calloc(work->n_nodes, sizeof(rt_un_entry_t *));
+    worker->lpm[INET_3] = calloc(work->n_nodes, sizeof(rt_un_entry_t *));
+    worker->lpm_done[INET_0] = calloc(work->n_nodes, sizeof(unsigned char));
+    worker->lpm_done[INET_3] = calloc(work->n_nodes, sizeof(unsigned char));
+    worker->visit_stamp = calloc(work->n_nodes, sizeof(unsigned int));
+}
+
+static void
+fwd_sim_worker_free(fwd_sim_worker_t *worker){
+
+    free(worker->lpm[INET_0]);
+    free(worker->lpm[INET_3]);
+    free(worker->lpm_done[INET_0]);
+    free(worker->lpm_done[INET_3]);
+    free(worker->visit_stamp);
+}
+
+void
+fwd_sim_run(instance_t *instance, fwd_sim_matrix_t *matrix){
+
+    unsigned int i = 0, n_workers = 0;
+    pthread_t threads[FWD_SIM_MAX_WORKERS];
+    boolean worker_spawned[FWD_SIM_MAX_WORKERS];
+    fwd_sim_worker_t workers[FWD_SIM_MAX_WORKERS];
+    fwd_sim_work_t work;
+    fwd_sim_stats_t *stats = &matrix->stats;
+    unsigned long long start_time = get_time_usec();
+
+    memset(stats, 0, sizeof(fwd_sim_stats_t));
+
+    stats->n_pairs = matrix->n_src * matrix->n_dst;
+    if(!stats->n_pairs)
+        return;
+
+    fwd_sim_work_init(instance, &work, matrix);
+
+    n_workers = get_worker_count(matrix->n_dst, FWD_SIM_MAX_WORKERS);
+
+    for(i = 0; i < n_workers; i++)
+        fwd_sim_worker_init(&workers[i], &work);
+
+    for(i = 0; i < n_workers; i++){
+        worker_spawned[i] = FALSE;
+        if(n_workers > 1)
+            worker_spawned[i] = (pthread_create(&threads[i], NULL,
+                                    fwd_sim_worker_fn, &workers[i]) == 0);
+        if(!worker_spawned[i])
+            fwd_sim_worker_fn(&workers[i]);
+    }
+
+    for(i = 0; i < n_workers; i++){
+        if(worker_spawned[i])
+            pthread_join(threads[i], NULL);
+        stats->n_delivered += workers[i].stats.n_delivered;
+        stats->n_blackhole += workers[i].stats.n_blackhole;
+        stats->n_loop      += workers[i].stats.n_loop;
+        stats->total_hops  += workers[i].stats.total_hops;
+        fwd_sim_worker_free(&workers[i]);
+    }
+
+    free(work.nodes);
+    stats->usec = get_time_usec() - start_time;
+}
+
+void
+fwd_sim_frr_run(instance_t *instance, edge_t *failed_edge,
+                fwd_sim_matrix_t *base, fwd_sim_matrix_t *frr,
+                fwd_sim_frr_stats_t *frr_stats){
+
+    unsigned int i = 0, stretch = 0;
+    char status = failed_edge->status,
+         inv_status = 0;
+    fwd_sim_result_t *base_result = NULL,
+                     *frr_result = NULL;
+    unsigned long long start_time = get_time_usec();
+
+    assert(base->n_src == frr->n_src && base->n_dst == frr->n_dst);
+    memset(frr_stats, 0, sizeof(fwd_sim_frr_stats_t));
+
+    fwd_sim_run(instance, base);
+
+    /*Fail both directions of the link. Control plane is not notified, RIBs
+     * stay as installed and forwarding falls back on backups wherever
+     * primary is over the failed link*/
+    failed_edge->status = 0;
+    if(failed_edge->inv_edge){
+        inv_status = failed_edge->inv_edge->status;
+        failed_edge->inv_edge->status = 0;
+    }
+    fwd_sim_run(instance, frr);
+    failed_edge->status = status;
+    if(failed_edge->inv_edge)
+        failed_edge->inv_edge->status = inv_status;
+
+    for(i = 0; i < base->n_src * base->n_dst; i++){
+
+        base_result = &base->result[i];
+        frr_result = &frr->result[i];
+
+        if(base_result->rc != FWD_SIM_DELIVERED)
+            continue;
+        frr_stats->n_pairs++;
+
+        if(frr_result->rc == FWD_SIM_DELIVERED &&
+            frr_result->hops == base_result->hops &&
+            frr_result->path_hash == base_result->path_hash)
+            continue;
+        frr_stats->n_affected++;
+
+        switch(frr_result->rc){
+            case FWD_SIM_DELIVERED:
+                frr_stats->n_protected++;
+                frr_stats->base_hops += base_result->hops;
+                frr_stats->frr_hops += frr_result->hops;
+                stretch = frr_result->hops > base_result->hops ?
+                          frr_result->hops - base_result->hops : 0;
+                if(stretch > frr_stats->max_stretch)
+                    frr_stats->max_stretch = stretch;
+                break;
+            case FWD_SIM_BLACKHOLE:
+                frr_stats->n_blackhole++;
+                break;
+            case FWD_SIM_LOOP:
+                frr_stats->n_micro_loop++;
+                break;
+            default:
+                ;
+        }
+    }
+    frr_stats->usec = get_time_usec() - start_time;
+}
+
+/*Enumerate the paths of pair in load->src, load->dst. Listed paths are
+ * kept sorted by share, largest first*/
+static void
+fwd_sim_load_pair(fwd_sim_worker_t *worker, fwd_sim_load_t *load){
+
+    unsigned int k = 0;
+    fwd_sim_load_ctxt_t ctxt;
+    fwd_sim_load_path_t path;
+
+    memset(&ctxt, 0, sizeof(fwd_sim_load_ctxt_t));
+    worker->load = &ctxt;
+    load->n_paths = 0;
+    load->n_listed = 0;
+
+    while(load->n_paths < FWD_SIM_MAX_LOAD_ENUM){
+
+        memset(&path, 0, sizeof(fwd_sim_load_path_t));
+        ctxt.depth = 0;
+        ctxt.share = 1;
+        ctxt.path = &path;
+        fwd_sim_forward(worker, load->src, load->dst, &path.result);
+        path.share = ctxt.share;
+        load->n_paths++;
+
+        /*Insert into listed paths, smallest share is dropped if full*/
+        for(k = load->n_listed; k > 0; k--){
+            if(load->paths[k - 1].share >= path.share)
+                break;
+        }
+        if(k < FWD_SIM_MAX_LOAD_PATHS){
+            if(load->n_listed < FWD_SIM_MAX_LOAD_PATHS)
+                load->n_listed++;
+            memmove(&load->paths[k + 1], &load->paths[k],
+                    (load->n_listed - 1 - k) * sizeof(fwd_sim_load_path_t));
+            memcpy(&load->paths[k], &path, sizeof(fwd_sim_load_path_t));
+        }
+
+        /*Next path : next choice at the last spraying router which has
+         * choices left, first choice at all routers after it*/
+        for(k = ctxt.depth; k > 0; k--){
+            if(ctxt.choice[k - 1] + 1 < ctxt.n_choices[k - 1])
+                break;
+        }
+        if(!k)
+            break;
+        ctxt.choice[k - 1]++;
+        memset(&ctxt.choice[k], 0, FWD_SIM_MAX_BRANCHES - k);
+    }
+    worker->load = NULL;
+}
+
+void
+fwd_sim_load_run(instance_t *instance, fwd_sim_matrix_t *matrix,
+                 fwd_sim_load_stats_t *load_stats){
+
+    unsigned int i = 0, j = 0;
+    fwd_sim_work_t work;
+    fwd_sim_worker_t worker;
+    fwd_sim_load_t *load = NULL;
+    unsigned long long start_time = get_time_usec();
+
+    memset(load_stats, 0, sizeof(fwd_sim_load_stats_t));
+    load_stats->n_pairs = matrix->n_src * matrix->n_dst;
+    if(!load_stats->n_pairs)
+        return;
+
+    fwd_sim_work_init(instance, &work, matrix);
+    fwd_sim_worker_init(&worker, &work);
+    load = calloc(1, sizeof(fwd_sim_load_t));
+
+    for(j = 0; j < matrix->n_dst; j++){
+
+        memset(worker.lpm_done[INET_0], 0, work.n_nodes);
+        memset(worker.lpm_done[INET_3], 0, work.n_nodes);
+
+        for(i = 0; i < matrix->n_src; i++){
+
+            load->src = matrix->src[i];
+            load->dst = matrix->dst[j];
+            fwd_sim_load_pair(&worker, load);
+
+            load_stats->n_paths += load->n_paths;
+            if(load->n_paths > load_stats->max_paths)
+                load_stats->max_paths = load->n_paths;
+            if(load->n_paths < 2)
+                continue;
+            load_stats->n_multipath++;
+            print_fwd_sim_load(load);
+        }
+    }
+
+    free(load);
+    fwd_sim_worker_free(&worker);
+    free(work.nodes);
+    load_stats->usec = get_time_usec() - start_time;
+}
+
+void
+fwd_sim_init_all_pairs(instance_t *instance, fwd_sim_matrix_t *matrix){
+
+    singly_ll_node_t *list_node = NULL;
+    node_t *node = NULL;
+    unsigned int n_nodes = GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list);
+
+    memset(matrix, 0, sizeof(fwd_sim_matrix_t));
+    matrix->src = calloc(n_nodes ? n_nodes : 1, sizeof(node_t *));
+    matrix->dst = calloc(n_nodes ? n_nodes : 1, PREFIX_LEN + 1);
+    matrix->dst_node = calloc(n_nodes ? n_nodes : 1, sizeof(node_t *));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        if(node->node_type[LEVEL1] == PSEUDONODE ||
+            node->node_type[LEVEL2] == PSEUDONODE)
+            continue;
+        matrix->src[matrix->n_src++] = node;
+        strncpy(matrix->dst[matrix->n_dst], node->router_id, PREFIX_LEN);
+        matrix->dst_node[matrix->n_dst++] = node;
+    } ITERATE_LIST_END;
+
+    matrix->result = calloc(n_nodes ? n_nodes * n_nodes : 1, sizeof(fwd_sim_result_t));
+}
+
+void
+fwd_sim_free_matrix(fwd_sim_matrix_t *matrix){
+
+    free(matrix->src);
+    free(matrix->dst);
+    free(matrix->dst_node);
+    free(matrix->result);
+    memset(matrix, 0, sizeof(fwd_sim_matrix_t));
+}
+
+void
+print_fwd_sim_stats(fwd_sim_stats_t *stats){
+
+    printf("Forwarding simulation : pairs = %u, delivered = %u, blackholes = %u, "
+           "loops = %u, avg hops = %llu.%02llu, time = %llu usec, pairs/sec = %llu\n",
+           stats->n_pairs, stats->n_delivered, stats->n_blackhole, stats->n_loop,
+           stats->n_delivered ? stats->total_hops / stats->n_delivered : 0,
+           stats->n_delivered ? ((stats->total_hops * 100) / stats->n_delivered) % 100 : 0,
+           stats->usec,
+           stats->usec ? (stats->n_pairs * 1000000ULL)/stats->usec : stats->n_pairs);
+}
+
+static char *
+get_str_fwd_sim_rc(fwd_sim_rc_t rc){
+
+    switch(rc){
+        case FWD_SIM_DELIVERED:
+            return "DELIVERED";
+        case FWD_SIM_BLACKHOLE:
+            return "BLACKHOLE";
+        case FWD_SIM_LOOP:
+            return "LOOP";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void
+print_fwd_sim_load(fwd_sim_load_t *load){
+
+    unsigned int i = 0, j = 0;
+    double listed_share = 0;
+    fwd_sim_load_path_t *path = NULL;
+
+    printf("\t%-8s -> %-16s : paths = %u%s\n", load->src->node_name, load->dst,
+            load->n_paths, load->n_paths >= FWD_SIM_MAX_LOAD_ENUM ? "+" : "");
+
+    for(i = 0; i < load->n_listed; i++){
+        path = &load->paths[i];
+        listed_share += path->share;
+        printf("\t\t%6.2f%%  %-9s ", path->share * 100,
+                get_str_fwd_sim_rc(path->result.rc));
+        for(j = 0; j < path->n_nodes && j < FWD_SIM_MAX_PATH_NODES; j++){
+            if(j)
+                printf(" -%s->", path->oif[j] ? path->oif[j]->intf_name : "");
+            printf(" %s", path->nodes[j]->node_name);
+        }
+        if(path->n_nodes > FWD_SIM_MAX_PATH_NODES)
+            printf(" ...");
+        printf("\n");
+    }
+    if(load->n_paths > load->n_listed)
+        printf("\t\t%6.2f%%  %u other paths\n", (1 - listed_share) * 100,
+                load->n_paths - load->n_listed);
+}
+
+void
+print_fwd_sim_load_stats(fwd_sim_load_stats_t *load_stats){
+
+    printf("Load distribution : pairs = %u, multipath pairs = %u, paths = %u, "
+           "max paths of a pair = %u, time = %llu usec\n",
+           load_stats->n_pairs, load_stats->n_multipath, load_stats->n_paths,
+           load_stats->max_paths, load_stats->usec);
+}
+
+void
+print_fwd_sim_matrix(fwd_sim_matrix_t *matrix, boolean detail){
+
+    unsigned int i = 0, j = 0;
+    fwd_sim_result_t *result = NULL;
+
+    print_fwd_sim_stats(&matrix->stats);
+
+    if(detail){
+        for(i = 0; i < matrix->n_src; i++){
+            for(j = 0; j < matrix->n_dst; j++){
+                result = &matrix->result[i * matrix->n_dst + j];
+                printf("\t%-8s -> %-16s : %-9s hops = %-3u path = 0x%08x at %s\n",
+                        matrix->src[i]->node_name, matrix->dst[j],
+                        get_str_fwd_sim_rc(result->rc), result->hops,
+                        result->path_hash, result->last_node->node_name);
+            }
+        }
+        return;
+    }
+
+    /*hop count if delivered, BH - blackhole, LP - loop*/
+    printf("\t%-8s", "src\\dst");
+    for(j = 0; j < matrix->n_dst; j++)
+        printf("%-6.5s", matrix->dst_node[j]->node_name);
+    printf("\n");
+
+    for(i = 0; i < matrix->n_src; i++){
+        printf("\t%-8s", matrix->src[i]->node_name);
+        for(j = 0; j < matrix->n_dst; j++){
+            result = &matrix->result[i * matrix->n_dst + j];
+            if(result->rc == FWD_SIM_DELIVERED)
+                printf("%-6u", result->hops);
+            else
+                printf("%-6s", result->rc == FWD_SIM_LOOP ? "LP" : "BH");
+        }
+        printf("\n");
+    }
+}
+
+void
+print_fwd_sim_frr(edge_t *failed_edge, fwd_sim_matrix_t *base,
+                  fwd_sim_matrix_t *frr, fwd_sim_frr_stats_t *frr_stats,
+                  boolean detail){
+
+    unsigned int i = 0, j = 0;
+    unsigned long long stretch = 0;
+    fwd_sim_result_t *base_result = NULL,
+                     *frr_result = NULL;
+
+    /*Hop count of protected pairs after failure relative to before, in %*/
+    stretch = frr_stats->base_hops ?
+              (frr_stats->frr_hops * 100) / frr_stats->base_hops : 100;
+
+    printf("FRR simulation : link %s(%s) -> %s down, pairs = %u, affected = %u, "
+           "protected = %u, blackholes = %u, micro-loops = %u, stretch = %llu.%02llu, "
+           "max extra hops = %u, time = %llu usec\n",
+           failed_edge->from.node->node_name, failed_edge->from.intf_name,
+           failed_edge->to.node->node_name,
+           frr_stats->n_pairs, frr_stats->n_affected, frr_stats->n_protected,
+           frr_stats->n_blackhole, frr_stats->n_micro_loop,
+           stretch / 100, stretch % 100, frr_stats->max_stretch, frr_stats->usec);
+
+    if(!detail)
+        return;
+
+    for(i = 0; i < base->n_src; i++){
+        for(j = 0; j < base->n_dst; j++){
+            base_result = &base->result[i * base->n_dst + j];
+            frr_result = &frr->result[i * base->n_dst + j];
+            if(base_result->rc != FWD_SIM_DELIVERED)
+                continue;
+            if(frr_result->rc == FWD_SIM_DELIVERED &&
+                frr_result->hops == base_result->hops &&
+                frr_result->path_hash == base_result->path_hash)
+                continue;
+            printf("\t%-8s -> %-16s : %-9s hops = %u -> %u at %s\n",
+                    base->src[i]->node_name, base->dst[j],
+                    get_str_fwd_sim_rc(frr_result->rc), base_result->hops,
+                    frr_result->hops, frr_result->last_node->node_name);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  fwd_sim.h
+ *
+ *    Description:  This file declares the batch forwarding simulator. Unlike ping
+ *                  which traces one destination and prints every hop, simulator
+ *                  walks a matrix of (source node, destination prefix) pairs through
+ *                  inet.0/inet.3/mpls.0 tables of the routers silently, and records
+ *                  per pair the outcome, hop count and a hash of the path taken.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __FWD_SIM__
+#define __FWD_SIM__
+
+#include "instanceconst.h"
+
+typedef struct _node_t node_t;
+typedef struct _edge_t edge_t;
+typedef struct edge_end_ edge_end_t;
+typedef struct instance_ instance_t;
+
+#define FWD_SIM_MAX_WORKERS     16
+/*TTL of simulated packet, labelled loops are detected by TTL expiry*/
+#define FWD_SIM_MAX_HOPS        255
+
+typedef enum{
+
+    FWD_SIM_DELIVERED,
+    FWD_SIM_BLACKHOLE,      /*no route, no label binding or all nexthops down*/
+    FWD_SIM_LOOP
+} fwd_sim_rc_t;
+
+typedef struct fwd_sim_result_{
+
+    unsigned char rc;       /*fwd_sim_rc_t*/
+    unsigned char hops;
+    unsigned int path_hash; /*hash of names of nodes traversed*/
+    node_t *last_node;      /*node where packet was delivered or dropped*/
+} fwd_sim_result_t;
+
+typedef struct fwd_sim_stats_{
+
+    unsigned int n_pairs;
+    unsigned int n_delivered;
+    unsigned int n_blackhole;
+    unsigned int n_loop;
+    unsigned long long total_hops;  /*of delivered pairs*/
+    unsigned long long usec;
+} fwd_sim_stats_t;
+
+/*Reachability matrix, result of pair (src i, dst j) is result[i * n_dst + j]*/
+typedef struct fwd_sim_matrix_{
+
+    unsigned int n_src;
+    node_t **src;
+    unsigned int n_dst;
+    char (*dst)[PREFIX_LEN + 1];
+    node_t **dst_node;      /*node owning the dst prefix, for display*/
+    fwd_sim_result_t *result;
+    fwd_sim_stats_t stats;
+} fwd_sim_matrix_t;
+
+/*Outcome of pairs delivered before a link failure, when forwarded over
+ * the RIBs as installed i.e. before IGP re-converges, routers whose primary
+ * nexthop is over the failed link switch to the backup installed*/
+typedef struct fwd_sim_frr_stats_{
+
+    unsigned int n_pairs;           /*delivered before failure*/
+    unsigned int n_affected;        /*path or outcome changed by failure*/
+    unsigned int n_protected;       /*affected, still delivered*/
+    unsigned int n_blackhole;
+    unsigned int n_micro_loop;
+    unsigned long long base_hops;   /*of protected pairs, before failure*/
+    unsigned long long frr_hops;    /*of protected pairs, after failure*/
+    unsigned int max_stretch;       /*max extra hops of a protected pair*/
+    unsigned long long usec;
+} fwd_sim_frr_stats_t;
+
+/*Load distribution : traffic of a pair is sprayed by every router over its
+ * primary nexthops which are up, in proportion of their UCMP weights*/
+#define FWD_SIM_MAX_LOAD_PATHS  16  /*paths listed per pair*/
+#define FWD_SIM_MAX_LOAD_ENUM   1024 /*paths enumerated per pair*/
+#define FWD_SIM_MAX_BRANCHES    32  /*spraying routers recorded per path*/
+#define FWD_SIM_MAX_PATH_NODES  32  /*routers recorded per path*/
+
+typedef struct fwd_sim_load_path_{
+
+    double share;           /*of the traffic of pair*/
+    fwd_sim_result_t result;
+    unsigned int n_nodes;   /*atmost FWD_SIM_MAX_PATH_NODES are recorded*/
+    node_t *nodes[FWD_SIM_MAX_PATH_NODES];
+    /*oif[i] is the interface of nodes[i - 1] towards nodes[i], parallel
+     * links make different paths over same routers*/
+    edge_end_t *oif[FWD_SIM_MAX_PATH_NODES];
+} fwd_sim_load_path_t;
+
+typedef struct fwd_sim_load_{
+
+    node_t *src;
+    char *dst;
+    unsigned int n_paths;   /*enumerated*/
+    unsigned int n_listed;
+    fwd_sim_load_path_t paths[FWD_SIM_MAX_LOAD_PATHS]; /*largest share first*/
+} fwd_sim_load_t;
+
+typedef struct fwd_sim_load_stats_{
+
+    unsigned int n_pairs;
+    unsigned int n_multipath;       /*pairs whose traffic is split*/
+    unsigned int n_paths;
+    unsigned int max_paths;
+    unsigned long long usec;
+} fwd_sim_load_stats_t;
+
+/*All routers as sources, loopbacks of all routers as destinations*/
+void
+fwd_sim_init_all_pairs(instance_t *instance, fwd_sim_matrix_t *matrix);
+
+void
+fwd_sim_free_matrix(fwd_sim_matrix_t *matrix);
+
+/*Forward all the pairs of matrix over the RIBs currently installed*/
+void
+fwd_sim_run(instance_t *instance, fwd_sim_matrix_t *matrix);
+
+/*Forward all pairs of base with failed_edge up and all pairs of frr with
+ * it down. base and frr must be initialized with same pairs*/
+void
+fwd_sim_frr_run(instance_t *instance, edge_t *failed_edge,
+                fwd_sim_matrix_t *base, fwd_sim_matrix_t *frr,
+                fwd_sim_frr_stats_t *frr_stats);
+
+/*Per path load distribution of all pairs of matrix. Pairs are forwarded
+ * one by one and those whose traffic takes more than one path are printed,
+ * paths of all pairs are not retained*/
+void
+fwd_sim_load_run(instance_t *instance, fwd_sim_matrix_t *matrix,
+                 fwd_sim_load_stats_t *load_stats);
+
+void
+print_fwd_sim_stats(fwd_sim_stats_t *stats);
+
+void
+print_fwd_sim_load(fwd_sim_load_t *load);
+
+void
+print_fwd_sim_load_stats(fwd_sim_load_stats_t *load_stats);
+
+void
+print_fwd_sim_matrix(fwd_sim_matrix_t *matrix, boolean detail);
+
+void
+print_fwd_sim_frr(edge_t *failed_edge, fwd_sim_matrix_t *base,
+                  fwd_sim_matrix_t *frr, fwd_sim_frr_stats_t *frr_stats,
+                  boolean detail);
+
+#endif /* __FWD_SIM__ */
@@ -60,6 +60,14 @@ init_srgb_defaults(srgb_t *srgb){
     srgb->first_sid.length = 0;
     srgb->first_sid.sid = SRGB_FIRST_DEFAULT_SID;
     init_bit_array(&srgb->index_array, srgb->range);
+    srgb_update_version(srgb);
+}
+
+void
+srgb_update_version(srgb_t *srgb){
+
+    static unsigned int srgb_version = 0;
+    srgb->version = ++srgb_version;
 }
 
 mpls_label_t
@@ -67,7 +75,7 @@ get_available_srgb_label(srgb_t *srgb){
 
    unsigned int index = 0;
    index = get_next_available_bit(SRGB_INDEX_ARRAY(srgb));
-   if(index == 0xFFFFFFFF)
+   if(index == BIT_ARRAY_NO_BIT)
        return index;
    return srgb->first_sid.sid + index;
 }
@@ -77,6 +85,7 @@ mark_srgb_index_in_use(srgb_t *srgb, unsigned int index){
 
     assert(index >= 0 && index < srgb->range);
     set_bit(SRGB_INDEX_ARRAY(srgb), index);
+    srgb_update_version(srgb);
 }
 
 
@@ -85,6 +94,7 @@ mark_srgb_index_not_in_use(srgb_t *srgb, unsigned int index){
 
     assert(index >= 0 && index < srgb->range);
     unset_bit(SRGB_INDEX_ARRAY(srgb) , index);
+    srgb_update_version(srgb);
 }
 
 boolean
@@ -95,6 +105,60 @@ is_srgb_index_in_use(srgb_t *srgb, unsigned int index){
         FALSE:TRUE;
 }
 
+/*Reserves n_indexes contiguous indexes, returns the first label of the
+ * block, 0xFFFFFFFF if no such block is available*/
+mpls_label_t
+get_available_srgb_label_range(srgb_t *srgb, unsigned int n_indexes){
+
+    unsigned int index = 0;
+    index = get_next_available_bit_range(SRGB_INDEX_ARRAY(srgb), n_indexes);
+    if(index == BIT_ARRAY_NO_BIT)
+        return index;
+    set_bit_range(SRGB_INDEX_ARRAY(srgb), index, n_indexes);
+    srgb_update_version(srgb);
+    return srgb->first_sid.sid + index;
+}
+
+void
+mark_srgb_index_range_in_use(srgb_t *srgb, unsigned int index, 
+                             unsigned int n_indexes){
+
+    assert(n_indexes && index < srgb->range && 
+           n_indexes <= srgb->range - index);
+    set_bit_range(SRGB_INDEX_ARRAY(srgb), index, n_indexes);
+    srgb_update_version(srgb);
+}
+
+void
+mark_srgb_index_range_not_in_use(srgb_t *srgb, unsigned int index, 
+                                 unsigned int n_indexes){
+
+    assert(n_indexes && index < srgb->range && 
+           n_indexes <= srgb->range - index);
+    unset_bit_range(SRGB_INDEX_ARRAY(srgb), index, n_indexes);
+    srgb_update_version(srgb);
+}
+
+boolean
+is_srgb_index_range_free(srgb_t *srgb, unsigned int index, 
+                         unsigned int n_indexes){
+
+    if(!n_indexes || index >= srgb->range || 
+        n_indexes > srgb->range - index)
+        return FALSE;
+    return is_bit_range_free(SRGB_INDEX_ARRAY(srgb), index, n_indexes) ?
+        TRUE:FALSE;
+}
+
+/*Indexes below the new range retain their in-use state*/
+void
+resize_srgb(srgb_t *srgb, unsigned int range){
+
+    srgb->range = range;
+    resize_bit_array(SRGB_INDEX_ARRAY(srgb), range);
+    srgb_update_version(srgb);
+}
+
 mpls_label_t 
 get_label_from_srgb_index(srgb_t *srgb, unsigned int index){
 
@@ -141,7 +205,7 @@ spring_disable_cleanup(node_t *node){
     LEVEL level_it;
     prefix_sid_subtlv_t *prefix_sid = NULL;
     
-    free((SRGB_INDEX_ARRAY(node->srgb))->array);
+    free_bit_array(SRGB_INDEX_ARRAY(node->srgb));
     free(node->srgb);
     node->use_spring_backups = FALSE;
 
@@ -212,6 +276,141 @@ get_node_segment_prefix_sid(node_t *node, LEVEL level){
     return NULL;
 }
 
+/*
++-------------------------------------------------+
+|SR label stack cache                             |
++-------------------------------------------------+
+*/
+
+sr_label_cache_t *
+init_sr_label_cache(){
+
+    sr_label_cache_t *cache = calloc(1, sizeof(sr_label_cache_t));
+    cache->n_buckets = SR_LBL_CACHE_INIT_SIZE;
+    cache->bucket = calloc(cache->n_buckets, sizeof(sr_label_cache_entry_t *));
+    return cache;
+}
+
+static unsigned int
+sr_label_cache_hash(unsigned int prefix_sid_index, node_t *nh_node, 
+                    node_t *rlfa, boolean is_originator, LEVEL level){
+
+    struct{
+        void *nh_node;
+        void *rlfa;
+        unsigned int prefix_sid_index;
+        unsigned int is_originator;
+        unsigned int level;
+    } key;
+
+    memset(&key, 0, sizeof(key));
+    key.nh_node = nh_node;
+    key.rlfa = rlfa;
+    key.prefix_sid_index = prefix_sid_index;
+    key.is_originator = is_originator;
+    key.level = level;
+    return hash_code(&key, sizeof(key));
+}
+
+static void
+sr_label_cache_grow(sr_label_cache_t *cache){
+
+    unsigned int i = 0, n_buckets = cache->n_buckets << 1, bucket = 0;
+    sr_label_cache_entry_t **new_bucket = calloc(n_buckets, sizeof(sr_label_cache_entry_t *)),
+                           *entry = NULL, *next = NULL;
+
+    for(i = 0; i < cache->n_buckets; i++){
+        for(entry = cache->bucket[i]; entry; entry = next){
+            next = entry->next;
+            bucket = sr_label_cache_hash(entry->prefix_sid_index, entry->nh_node, 
+                        entry->rlfa, entry->is_originator, entry->level) & (n_buckets - 1);
+            entry->next = new_bucket[bucket];
+            new_bucket[bucket] = entry;
+        }
+    }
+    free(cache->bucket);
+    cache->bucket = new_bucket;
+    cache->n_buckets = n_buckets;
+}
+
+/*Returns the entry for the key, creating it if needed. hit is set if
+ * entry's labels are still valid, else caller must (re)compute them*/
+static sr_label_cache_entry_t *
+sr_label_cache_get(sr_label_cache_t *cache, unsigned int prefix_sid_index, 
+                   node_t *nh_node, node_t *rlfa, boolean is_originator, 
+                   LEVEL level, boolean *hit){
+
+    unsigned int bucket = 0,
+                 srgb_version[2];
+    sr_label_cache_entry_t *entry = NULL;
+
+    srgb_version[0] = nh_node->srgb ? nh_node->srgb->version : 0;
+    srgb_version[1] = (rlfa && rlfa->srgb) ? rlfa->srgb->version : 0;
+
+    bucket = sr_label_cache_hash(prefix_sid_index, nh_node, rlfa, 
+                is_originator, level) & (cache->n_buckets - 1);
+
+    for(entry = cache->bucket[bucket]; entry; entry = entry->next){
+        if(entry->prefix_sid_index == prefix_sid_index &&
+           entry->nh_node == nh_node && entry->rlfa == rlfa &&
+           entry->is_originator == is_originator && entry->level == level)
+            break;
+    }
+
+    if(!entry){
+        if(cache->count >= (cache->n_buckets << 1)){
+            sr_label_cache_grow(cache);
+            bucket = sr_label_cache_hash(prefix_sid_index, nh_node, rlfa, 
+                        is_originator, level) & (cache->n_buckets - 1);
+        }
+        entry = calloc(1, sizeof(sr_label_cache_entry_t));
+        entry->prefix_sid_index = prefix_sid_index;
+        entry->nh_node = nh_node;
+        entry->rlfa = rlfa;
+        entry->is_originator = is_originator;
+        entry->level = level;
+        entry->next = cache->bucket[bucket];
+        cache->bucket[bucket] = entry;
+        cache->count++;
+        *hit = FALSE;
+    }
+    else{
+        *hit = (entry->srgb_version[0] == srgb_version[0] &&
+                entry->srgb_version[1] == srgb_version[1]) ? TRUE : FALSE;
+    }
+
+    entry->srgb_version[0] = srgb_version[0];
+    entry->srgb_version[1] = srgb_version[1];
+    entry->spf_gen = cache->spf_gen;
+    return entry;
+}
+
+void
+sr_label_cache_new_run(sr_label_cache_t *cache){
+
+    cache->spf_gen++;
+}
+
+void
+sr_label_cache_purge(sr_label_cache_t *cache, LEVEL level){
+
+    unsigned int i = 0;
+    sr_label_cache_entry_t **pp = NULL, *entry = NULL;
+
+    for(i = 0; i < cache->n_buckets; i++){
+        pp = &cache->bucket[i];
+        while((entry = *pp)){
+            if(entry->level == level && entry->spf_gen != cache->spf_gen){
+                *pp = entry->next;
+                free(entry);
+                cache->count--;
+                continue;
+            }
+            pp = &entry->next;
+        }
+    }
+}
+
 /*There should not be such thing : Convert RSVP tunnel to
  * SR tunnels*/
 static void
@@ -229,6 +428,8 @@ springify_rlfa_nexthop(node_t *spf_root,
 
     prefix_sid_subtlv_t *rlfa_node_prefix_sid = NULL;
     mpls_label_t mpls_label = 0;
+    boolean is_originator = FALSE, hit = FALSE;
+    sr_label_cache_entry_t *cache_entry = NULL;
     
     if(!is_node_spring_enabled(nxthop->proxy_nbr, route->level)) {
 #ifdef __ENABLE_TRACE__        
@@ -258,20 +459,34 @@ springify_rlfa_nexthop(node_t *spf_root,
      2. lookup RLFA router id node segment index in nxthop->node->srgb, and perform SWAP 
      */
 
-    /*Op 2*/ /*Remember this operation is being done on PLR and RLFA needs to be installed in inet.3 and mpls.0  table
-     only as LDP tunnel or SR tunnel*/
-    rlfa_node_prefix_sid = get_node_segment_prefix_sid(nxthop->rlfa, route->level);
-    mpls_label = get_label_from_srgb_index(nxthop->proxy_nbr->srgb, rlfa_node_prefix_sid->sid.sid);
-    nxthop->mpls_label_out[0] = mpls_label;
-    nxthop->stack_op[0] = PUSH;
+    is_originator = is_node_best_prefix_originator(nxthop->rlfa, route);
+    cache_entry = sr_label_cache_get(spf_root->spf_info.sr_lbl_cache, prefix_sid_index,
+                    nxthop->proxy_nbr, nxthop->rlfa, is_originator, route->level, &hit);
+
+    if(!hit){
+        /*Op 2*/ /*Remember this operation is being done on PLR and RLFA needs to be installed in inet.3 and mpls.0  table
+         only as LDP tunnel or SR tunnel*/
+        rlfa_node_prefix_sid = get_node_segment_prefix_sid(nxthop->rlfa, route->level);
+        mpls_label = get_label_from_srgb_index(nxthop->proxy_nbr->srgb, rlfa_node_prefix_sid->sid.sid);
+        cache_entry->mpls_label_out[0] = mpls_label;
+        cache_entry->stack_op[0] = PUSH;
+
+        /*Op 1*/
+        /*If RLFA is also the Destination, then this operation is not required*/
+        if(!is_originator){
+            mpls_label = get_label_from_srgb_index(nxthop->rlfa->srgb, prefix_sid_index); 
+            cache_entry->mpls_label_out[1] = mpls_label;
+            cache_entry->stack_op[1] = PUSH;
+        }
+    }
 
-    /*Op 1*/
-    /*If RLFA is also the Destination, then this operation is not required*/
-    if(!is_node_best_prefix_originator(nxthop->rlfa, route)){
+    nxthop->mpls_label_out[0] = cache_entry->mpls_label_out[0];
+    nxthop->stack_op[0] = cache_entry->stack_op[0];
+
+    if(!is_originator){
         
-        mpls_label = get_label_from_srgb_index(nxthop->rlfa->srgb, prefix_sid_index); 
-        nxthop->mpls_label_out[1] = mpls_label;
-        nxthop->stack_op[1] = PUSH;
+        nxthop->mpls_label_out[1] = cache_entry->mpls_label_out[1];
+        nxthop->stack_op[1] = cache_entry->stack_op[1];
 
 #ifdef __ENABLE_TRACE__        
         sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u\t%s:%u, oif : %s, gw : %s, nexthop : %s", 
@@ -304,6 +519,8 @@ springify_ipv4_nexthop(node_t *spf_root,
     MPLS_STACK_OP stack_op = STACK_OPS_UNKNOWN;
     prefix_sid_subtlv_t *prefix_sid = NULL;
     unsigned int outgoing_label = 0;
+    boolean is_originator = FALSE, hit = FALSE;
+    sr_label_cache_entry_t *cache_entry = NULL;
    
     if(!is_node_spring_enabled(nxthop->node, route->level)) {
 #ifdef __ENABLE_TRACE__        
@@ -322,8 +539,16 @@ springify_ipv4_nexthop(node_t *spf_root,
     trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 
+    is_originator = is_node_best_prefix_originator(nxthop->node, route);
+    cache_entry = sr_label_cache_get(spf_root->spf_info.sr_lbl_cache, prefix_sid_index,
+                    nxthop->node, NULL, is_originator, route->level, &hit);
+
+    if(hit){
+        stack_op = cache_entry->stack_op[0];
+        outgoing_label = cache_entry->mpls_label_out[0];
+    }
     /*caluclate the SPRING Nexthop related information first*/
-    if(is_node_best_prefix_originator(nxthop->node, route)){
+    else if(is_originator){
         /*Check if node advertised PHP service*/
         prefix_sid = prefix_sid_search(nxthop->node, route->level, prefix_sid_index);
         assert(prefix_sid);
@@ -342,6 +567,10 @@ springify_ipv4_nexthop(node_t *spf_root,
         outgoing_label = get_label_from_srgb_index(nxthop->node->srgb, prefix_sid_index);
         assert(outgoing_label);
     }
+
+    cache_entry->mpls_label_out[0] = outgoing_label;
+    cache_entry->stack_op[0] = stack_op;
+
     /*Now compare the SPring related information*/
     /*populate the SPRING related information only*/
     nxthop->mpls_label_out[0] = outgoing_label;
@@ -395,33 +624,32 @@ springify_unicast_route(node_t *spf_root, routes_t *route){
 #endif
     }
 
+    /*Labels are written into nexthops*/
+    ROUTE_NHG_WRITABLE(route);
+
     /*Now Do primary next hops*/
-    ITERATE_LIST_BEGIN(route->primary_nh_list[IPNH], list_node){
-        nxthop = list_node->data;
+    ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, IPNH), nxthop){
         springify_ipv4_nexthop(spf_root, nxthop, route, dst_prefix_sid);        
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_NH_END;
     
-    ITERATE_LIST_BEGIN(route->primary_nh_list[LSPNH], list_node){
-        nxthop = list_node->data;
+    ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, LSPNH), nxthop){
         if(is_internal_backup_nexthop_rsvp(nxthop))
             springify_rsvp_nexthop(spf_root, nxthop, route, dst_prefix_sid);
         else
             springify_rlfa_nexthop(spf_root, nxthop, route, dst_prefix_sid);
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_NH_END;
 
     /*Now do backups*/
-    ITERATE_LIST_BEGIN(route->backup_nh_list[IPNH], list_node){
-        nxthop = list_node->data;
+    ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, IPNH), nxthop){
         springify_ipv4_nexthop(spf_root, nxthop, route, dst_prefix_sid);        
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_NH_END;
     
-    ITERATE_LIST_BEGIN(route->backup_nh_list[LSPNH], list_node){
-        nxthop = list_node->data;
+    ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, LSPNH), nxthop){
         if(is_internal_backup_nexthop_rsvp(nxthop))
             springify_rsvp_nexthop(spf_root, nxthop, route, dst_prefix_sid);
         else
             springify_rlfa_nexthop(spf_root, nxthop, route, dst_prefix_sid);
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_NH_END;
 }
 
 void
@@ -94,6 +94,9 @@ typedef struct _sr_capability_subtlv{
    range contains the number of SRGB elements*/
    /*Out of RFC  :Bits to track the index allocation*/
    bit_array_t index_array;
+   /*Out of RFC : changes whenever the block or the SIDs allocated from
+    * it change, unique across all SRGBs*/
+   unsigned int version;
 } sr_capability_subtlv_t;
 
 typedef sr_capability_subtlv_t srgb_t;
@@ -116,6 +119,28 @@ mark_srgb_index_not_in_use(srgb_t *srgb, unsigned int index);
 boolean
 is_srgb_index_in_use(srgb_t *srgb, unsigned int index);
 
+/*Range APIs, used to reserve index blocks for SRMS ranges and SRLB*/
+mpls_label_t
+get_available_srgb_label_range(srgb_t *srgb, unsigned int n_indexes);
+
+void
+mark_srgb_index_range_in_use(srgb_t *srgb, unsigned int index, 
+                             unsigned int n_indexes);
+
+void
+mark_srgb_index_range_not_in_use(srgb_t *srgb, unsigned int index, 
+                                 unsigned int n_indexes);
+
+boolean
+is_srgb_index_range_free(srgb_t *srgb, unsigned int index, 
+                         unsigned int n_indexes);
+
+void
+resize_srgb(srgb_t *srgb, unsigned int range);
+
+void
+srgb_update_version(srgb_t *srgb);
+
 mpls_label_t
 get_label_from_srgb_index(srgb_t *srgb, unsigned int index);
 
@@ -208,6 +233,7 @@ typedef struct _router_cap_tlv{
 #define LOCAL_SIGNIFICANCE_L_FLAG 2
 
 typedef struct _sr_mapping_entry_t sr_mapping_entry_t;
+typedef struct sr_conflict_entry_ sr_conflict_entry_t;
 
 typedef enum{
     SID_ACTIVE,
@@ -238,6 +264,7 @@ typedef struct _prefix_sid_subtlv_t{
      * sr_mapping_entry_t data structure for all prefixes advertised 
      * with SID. It is not a part of subtlv.*/
     prefix_t *prefix; /*back pointer to owning prefix*/
+    sr_conflict_entry_t *conflict_entry; /*see conflct_res.h*/
 } prefix_sid_subtlv_t;
 
 GLTHREAD_TO_STRUCT(glthread_to_prefix_sid, prefix_sid_subtlv_t, glthread, glthreadptr);
@@ -298,7 +325,7 @@ struct _sr_mapping_entry_t{
     char max_pfx_len;   /*32 for IPV4 and 128 for IPV6*/
     unsigned int si;    /*Initial sid value*/
     unsigned int se;    /*End sid value*/
-    BYTE range_value;   /*range value , always 1 for IGP*/
+    unsigned short range_value;   /*range value , always 1 for IGP, upto 65535 for SRMS*/
     BYTE topology;      /*0 for IPV4, 2 for IPV6*/
     BYTE algorithm;     /*SHORTEST_PATH_FIRST = 0, STRICT_SHORTEST_PATH = 1*/
 } ;
@@ -378,6 +405,49 @@ typedef struct spf_info_ spf_info_t;
 void
 update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level);
 
+/*SR label stack cache. Outgoing labels of a SPRING nexthop depend only
+ * on the destination prefix SID index, the nexthop (and RLFA) node, whether
+ * that node originates the destination, and the SRGBs of these nodes.
+ * Cached per computing node, and re-used across SPF runs as long as
+ * the SRGB versions recorded in the entry are current*/
+
+/*Must be power of 2*/
+#define SR_LBL_CACHE_INIT_SIZE  256
+
+typedef struct sr_label_cache_entry_{
+
+    /*Key*/
+    unsigned int prefix_sid_index;
+    node_t *nh_node;        /*IPV4 nexthop node, or proxy nbr of RLFA*/
+    node_t *rlfa;           /*NULL for IPV4 nexthops*/
+    boolean is_originator;  /*nh_node (rlfa for RLFA nexthops) is the best originator*/
+    LEVEL level;
+    /*SRGB versions of nh_node and rlfa the labels were computed from*/
+    unsigned int srgb_version[2];
+    unsigned int spf_gen;   /*Last SPF run the entry was used in*/
+    mpls_label_t mpls_label_out[2];
+    unsigned char stack_op[2]; /*MPLS_STACK_OP*/
+    struct sr_label_cache_entry_ *next;
+} sr_label_cache_entry_t;
+
+typedef struct sr_label_cache_{
+
+    unsigned int n_buckets;
+    unsigned int count;
+    unsigned int spf_gen;
+    sr_label_cache_entry_t **bucket;
+} sr_label_cache_t;
+
+sr_label_cache_t *
+init_sr_label_cache();
+
+/*Delete entries of level not used since the last sr_label_cache_new_run()*/
+void
+sr_label_cache_purge(sr_label_cache_t *cache, LEVEL level);
+
+void
+sr_label_cache_new_run(sr_label_cache_t *cache);
+
 void
 spring_disable_cleanup(node_t *node);
 
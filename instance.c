@@ -38,6 +38,8 @@
 #include "spfutil.h"
 #include "spftrace.h"
 #include "spf_candidate_tree.h"
+#include "nh_group.h"
+#include "routes.h"
 
 extern instance_t *instance;
 
@@ -75,16 +77,11 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
         node->node_type[level] = NON_PSEUDONODE;
         node->pn_intf[level] = NULL;
 
-        node->local_prefix_list[level] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->local_prefix_list[level] , 
-                get_prefix_comparison_fn());
-        
-        singly_ll_set_order_comparison_fn(node->local_prefix_list[level] , 
-                get_prefix_order_comparison_fn());
+        node->local_prefix_store[level] = init_prefix_store();
 
         router_id_pfx = create_new_prefix(node->router_id, 32, level);
         router_id_pfx->hosting_node = node;
-        add_new_prefix_in_list(GET_NODE_PREFIX_LIST(node, level), router_id_pfx, 0);
+        prefix_store_add(GET_NODE_PREFIX_STORE(node, level), router_id_pfx, 0);
 
         node->spf_run_result[level] = init_singly_ll();
         singly_ll_set_comparison_fn(node->spf_run_result[level], spf_run_result_comparison_fn);
@@ -117,11 +114,15 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
 
         node->spf_info.deferred_routes_list[rt_type] = init_singly_ll();
         singly_ll_set_comparison_fn(node->spf_info.deferred_routes_list[rt_type], route_search_comparison_fn);
+
+        node->spf_info.route_index[rt_type] = init_route_index();
     }
 
     node->spf_info.rib[INET_0] = init_rib(INET_0);
     node->spf_info.rib[INET_3] = init_rib(INET_3);
     node->spf_info.rib[MPLS_0] = init_rib(MPLS_0);
+    node->spf_info.nhg_table = init_nh_group_table();
+    node->spf_info.sr_lbl_cache = init_sr_label_cache();
 
     node->attached = 1; /*By default attached bit is enabled*/
     node->traversing_bit = 0;
@@ -254,7 +255,7 @@ attach_edge_end_prefix_on_node(node_t *node, edge_end_t *edge_end){
         clone_prefix = create_new_prefix(prefix->prefix, prefix->mask, LEVEL_UNKNOWN);
         memcpy(clone_prefix, prefix, sizeof(prefix_t));
         clone_prefix->level = level_it;
-        add_prefix_to_prefix_list(GET_NODE_PREFIX_LIST(node, level_it), clone_prefix, 0);
+        add_prefix_to_prefix_store(GET_NODE_PREFIX_STORE(node, level_it), clone_prefix, 0);
     }
 }
 
@@ -360,7 +361,7 @@ mark_node_pseudonode(node_t *node, LEVEL level){
         if(get_edge_direction(node, edge) == OUTGOING){ 
             edge->metric[level] = 0;
             if(edge_end->prefix[level]){
-                singly_ll_delete_node_by_data_ptr(GET_NODE_PREFIX_LIST(node, level), 
+                prefix_store_remove(GET_NODE_PREFIX_STORE(node, level), 
                         edge_end->prefix[level]);
                 edge_end->prefix[level]->ref_count--;
             }
@@ -471,7 +472,7 @@ attach_prefix_on_node(node_t *node,
     trace(instance->traceopts, SPF_PREFIX_BIT);
 #endif
 
-    if(add_prefix_to_prefix_list(GET_NODE_PREFIX_LIST(node, level), _prefix, 0))
+    if(add_prefix_to_prefix_store(GET_NODE_PREFIX_STORE(node, level), _prefix, 0))
         return _prefix;
 
     free_prefix(_prefix);
@@ -488,12 +489,7 @@ deattach_prefix_on_node(node_t *node,
     assert(prefix);
     assert(level == LEVEL1 || level == LEVEL2);
 
-    common_pfx_key_t key;
-    memset(&key, 0, sizeof(common_pfx_key_t));
-    strncpy(key.u.prefix.prefix, prefix, strlen(prefix));
-    key.u.prefix.mask = mask;
-    
-    prefix_t *_prefix = singly_ll_search_by_key(GET_NODE_PREFIX_LIST(node, level), &key);
+    prefix_t *_prefix = prefix_store_lookup(GET_NODE_PREFIX_STORE(node, level), prefix, mask);
     if(!_prefix)
         return;
 
@@ -502,7 +498,7 @@ deattach_prefix_on_node(node_t *node,
         node->node_name, prefix, mask, _prefix->metric); 
     trace(instance->traceopts, SPF_PREFIX_BIT);
 #endif
-    singly_ll_remove_node_by_dataptr(GET_NODE_PREFIX_LIST(node, level), _prefix);
+    prefix_store_remove(GET_NODE_PREFIX_STORE(node, level), _prefix);
     free_prefix(_prefix);
     _prefix = NULL;
 }
@@ -511,16 +507,9 @@ prefix_t *
 node_local_prefix_search(node_t *node, LEVEL level, 
                         char *_prefix, char mask){
 
-    common_pfx_key_t key;
-    memset(&key, 0, sizeof(common_pfx_key_t));
-    strncpy(key.u.prefix.prefix, _prefix, strlen(_prefix));
-    key.u.prefix.mask = mask;
-
     assert(level == LEVEL1 || level == LEVEL2);
     
-    ll_t *prefix_list = GET_NODE_PREFIX_LIST(node, level);
-
-    return (prefix_t *)singly_ll_search_by_key(prefix_list, &key);
+    return prefix_store_lookup(GET_NODE_PREFIX_STORE(node, level), _prefix, mask);
 }
 
 
@@ -46,6 +46,9 @@
 #include "rsvp.h"
 #include "Tree/candidate_tree.h"
 #include "spring_adjsid.h"
+#include "leak_policy.h"
+#include "srms.h"
+#include "flex_algo.h"
 
 
 typedef struct edge_end_ edge_end_t;
@@ -75,7 +78,7 @@ typedef struct _node_t{
     /*Fields to handle pseudonode case*/
     edge_end_t *pn_intf[MAX_LEVEL];
 
-    ll_t *local_prefix_list[MAX_LEVEL];
+    prefix_store_t *local_prefix_store[MAX_LEVEL];
     ll_t *self_spf_result[MAX_LEVEL];                       /*Used for LFA and RLFA computation*/ 
     /*For SPF computation only*/ 
     ll_t *spf_run_result[MAX_LEVEL];                        /*List of nodes of instance which contain result of SPF skeleton run*/
@@ -112,11 +115,17 @@ typedef struct _node_t{
                  am_i_mapping_server:1;
 
     /*Mapping Server local policy database*/
-    glthread_t srms_lcl_policy_db; /*Advertised in al levels - pg349*/
+    srms_lcl_policy_db_t srms_lcl_policy_db; /*Advertised in al levels - pg349*/
 
     /*Mapping client prefix-sid Mapping db*/
-    ll_t *active_mapping_policy[MAX_LEVEL];
-    ll_t *backup_mapping_policy[MAX_LEVEL];
+    srms_mapping_db_t active_mapping_policy[MAX_LEVEL];
+    srms_mapping_db_t backup_mapping_policy[MAX_LEVEL];
+
+    /*Route leaking policies, indexed by the level routes are leaked from*/
+    leak_policy_t *leak_policy[MAX_LEVEL];
+
+    /*Flex algos this router participates in, NULL if none*/
+    flex_algo_db_t *flex_algo_db;
 
 } node_t;
 
@@ -162,6 +171,9 @@ typedef struct _edge_t{
     rsvp_tunnel_t *fa;      /*Forwarding adjacency*/
     char status;            /* 0 down, 1 up*/
     float bandwidth; /*bandwidth for WECMP in GIG*/
+    unsigned int affinity;  /*Admin groups (flex algo affinities) of the link, bit per group*/
+    unsigned int te_metric; /*0 if not configured*/
+    unsigned int rsvp_reserved_bw; /*Mbps reserved by RSVP LSPs placed over the link*/
 } edge_t;
 
 typedef struct instance_{
@@ -172,6 +184,10 @@ typedef struct instance_{
     /*SR mapping server. We support only one mapping
      * server per topology*/
     node_t *mapping_server;
+    /*Backup nexthops are stored on destination nodes and hence shared
+     * by all spf roots. Root whose backups are currently stored, NULL
+     * if cleared*/
+    node_t *backup_owner[MAX_LEVEL];
 } instance_t;
 
 node_t *
@@ -248,7 +264,7 @@ inverse_topology(instance_t *instance, LEVEL level);
 
 /* Macros */
 
-#define GET_NODE_PREFIX_LIST(node_ptr, level)   (node_ptr->local_prefix_list[level])
+#define GET_NODE_PREFIX_STORE(node_ptr, level)  (node_ptr->local_prefix_store[level])
 
 #define GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end_ptr)   \
     (edge_t *)((char *)edge_end_ptr - (unsigned int)&(((edge_t *)0)->from))
@@ -44,8 +44,11 @@
 #define INFINITE_METRIC         (0xFE000000)
 #define LINK_DEFAULT_METRIC     10
 #define DEFAULT_LINK_BW         1 /*1GIG*/
+#define UCMP_MAX_BUCKETS        64 /*Max total weight of UCMP nexthops of a route*/
+#define UCMP_BUCKET_TOLERANCE   0.005 /*Share of traffic*/
 #define STRING_REASON_LEN       256
 #define MPLS_STACK_OP_LIMIT_MAX 3
+#define MPLS_LABEL_STACK_MAX_DEPTH 16 /*labels a traced packet can carry*/
 #define TOPOLOGY_NAME_SIZE      32
 #define MAC_LEN                 6
 #define ZERO_IP                 "0.0.0.0"
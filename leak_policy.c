@@ -0,0 +1,442 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  leak_policy.c
+ *
+ *    Description:  This file implements the policy based route leaking between levels
+ *                  on L1L2 routers.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "leak_policy.h"
+#include "instance.h"
+#include "routes.h"
+#include "advert.h"
+#include "spfutil.h"
+#include "bitsop.h"
+
+extern instance_t *instance;
+
+/*Guard against policies of different levels leaking back and forth*/
+#define LEAK_POLICY_MAX_FLUSH_ROUNDS    16
+
+static LEVEL
+leak_policy_to_level(leak_policy_t *policy){
+
+    return policy->from_level == LEVEL1 ? LEVEL2 : LEVEL1;
+}
+
+static unsigned int
+leak_policy_bin_prefix(char *prefix){
+
+    unsigned int bin_prefix = 0;
+
+    if(inet_pton(AF_INET, prefix, &bin_prefix) != 1)
+        return 0;
+    return ntohl(bin_prefix);
+}
+
+static leak_trie_node_t *
+leak_trie_new_node(){
+
+    return calloc(1, sizeof(leak_trie_node_t));
+}
+
+static void
+leak_trie_free(leak_trie_node_t *trie_node){
+
+    if(!trie_node)
+        return;
+    leak_trie_free(trie_node->child[0]);
+    leak_trie_free(trie_node->child[1]);
+    free(trie_node);
+}
+
+static void
+leak_trie_insert(leak_trie_node_t *trie, leak_policy_rule_t *rule){
+
+    unsigned int depth = 0, bit = 0;
+    leak_trie_node_t *trie_node = trie;
+    leak_policy_rule_t **link = NULL;
+
+    for(; depth < rule->mask; depth++){
+        bit = (rule->bin_prefix >> (31 - depth)) & 1;
+        if(!trie_node->child[bit])
+            trie_node->child[bit] = leak_trie_new_node();
+        trie_node = trie_node->child[bit];
+    }
+
+    for(link = &trie_node->rules; *link && (*link)->seq_no < rule->seq_no;
+        link = &(*link)->trie_next);
+    rule->trie_next = *link;
+    *link = rule;
+}
+
+/*Rules are matched in the order of their seq no, first matching rule
+ * decides. Only the rules on the path of the route prefix in trie can match*/
+static leak_policy_rule_t *
+leak_trie_match(leak_trie_node_t *trie, unsigned int bin_prefix, 
+                unsigned char mask, unsigned int metric){
+
+    unsigned int depth = 0;
+    leak_trie_node_t *trie_node = trie;
+    leak_policy_rule_t *rule = NULL,
+                       *best_rule = NULL;
+
+    while(trie_node){
+
+        for(rule = trie_node->rules; rule; rule = rule->trie_next){
+            if(best_rule && rule->seq_no > best_rule->seq_no)
+                break;
+            if(mask <= rule->le && metric <= rule->metric_max){
+                best_rule = rule;
+                break;
+            }
+        }
+
+        if(depth == mask)
+            break;
+        trie_node = trie_node->child[(bin_prefix >> (31 - depth)) & 1];
+        depth++;
+    }
+    return best_rule;
+}
+
+/*Rebuild the trie from rules, rules array is never modified while trie
+ * is in use*/
+static void
+leak_policy_compile(leak_policy_t *policy){
+
+    unsigned int i = 0;
+
+    leak_trie_free(policy->trie);
+    policy->trie = leak_trie_new_node();
+
+    for(i = 0; i < policy->n_rules; i++){
+        policy->rules[i].trie_next = NULL;
+        leak_trie_insert(policy->trie, &policy->rules[i]);
+    }
+}
+
+static leak_policy_t *
+get_leak_policy(node_t *node, LEVEL from_level){
+
+    leak_policy_t *policy = node->leak_policy[from_level];
+
+    if(policy)
+        return policy;
+
+    policy = calloc(1, sizeof(leak_policy_t));
+    policy->node = node;
+    policy->from_level = from_level;
+    policy->trie = leak_trie_new_node();
+    node->leak_policy[from_level] = policy;
+    return policy;
+}
+
+static void
+leak_policy_add_pending(leak_policy_t *policy, char *prefix, unsigned char mask){
+
+    common_pfx_key_t *key = NULL;
+
+    if(policy->n_pending == policy->pending_size){
+        policy->pending_size = policy->pending_size ? policy->pending_size << 1 : 64;
+        policy->pending = realloc(policy->pending, 
+                            policy->pending_size * sizeof(common_pfx_key_t));
+    }
+
+    key = &policy->pending[policy->n_pending++];
+    memset(key, 0, sizeof(common_pfx_key_t));
+    strncpy(key->u.prefix.prefix, prefix, PREFIX_LEN);
+    key->u.prefix.mask = mask;
+}
+
+void
+leak_policy_add_rule(node_t *node, LEVEL from_level, 
+                     leak_policy_rule_t *rule){
+
+    unsigned int i = 0;
+    leak_policy_t *policy = get_leak_policy(node, from_level);
+    leak_policy_rule_t *new_rule = NULL;
+
+    for(i = 0; i < policy->n_rules; i++){
+        if(policy->rules[i].seq_no >= rule->seq_no)
+            break;
+    }
+
+    if(i == policy->n_rules || policy->rules[i].seq_no != rule->seq_no){
+        policy->rules = realloc(policy->rules, 
+                            (policy->n_rules + 1) * sizeof(leak_policy_rule_t));
+        memmove(&policy->rules[i + 1], &policy->rules[i], 
+                (policy->n_rules - i) * sizeof(leak_policy_rule_t));
+        policy->n_rules++;
+    }
+
+    new_rule = &policy->rules[i];
+    memcpy(new_rule, rule, sizeof(leak_policy_rule_t));
+    new_rule->prefix[PREFIX_LEN] = '\0';
+    if(new_rule->le < new_rule->mask)
+        new_rule->le = new_rule->mask;
+    new_rule->bin_prefix = leak_policy_bin_prefix(new_rule->prefix);
+    if(new_rule->mask < 32)
+        new_rule->bin_prefix &= ~(0xFFFFFFFFU >> new_rule->mask);
+
+    leak_policy_compile(policy);
+    leak_policy_evaluate(node, from_level);
+}
+
+void
+leak_policy_delete_rule(node_t *node, LEVEL from_level, 
+                        unsigned int seq_no){
+
+    unsigned int i = 0;
+    leak_policy_t *policy = node->leak_policy[from_level];
+
+    if(!policy)
+        return;
+
+    for(i = 0; i < policy->n_rules; i++){
+        if(policy->rules[i].seq_no == seq_no)
+            break;
+    }
+
+    if(i == policy->n_rules){
+        printf("%s() : Error : Node %s has no %s leak policy rule with seq %u\n",
+                __FUNCTION__, node->node_name, get_str_level(from_level), seq_no);
+        return;
+    }
+
+    memmove(&policy->rules[i], &policy->rules[i + 1], 
+            (policy->n_rules - i - 1) * sizeof(leak_policy_rule_t));
+    policy->n_rules--;
+
+    leak_policy_compile(policy);
+    leak_policy_evaluate(node, from_level);
+}
+
+/* Single pass over routes of the level, prefixes permitted by the policy
+ * are added to or refreshed in the other level, leaked prefixes no longer
+ * permitted are withdrawn. Prefixes configured locally on the other level
+ * are never touched*/
+void
+leak_policy_evaluate(node_t *node, LEVEL level){
+
+    int i = 0;
+    unsigned int metric = 0;
+    FLAG prefix_flags = 0;
+    LEVEL to_level = LEVEL_UNKNOWN;
+    leak_policy_t *policy = node->leak_policy[level];
+    leak_policy_rule_t *rule = NULL;
+    prefix_store_t *store = NULL;
+    prefix_t *prefix = NULL;
+    routes_t *route = NULL;
+    singly_ll_node_t *list_node = NULL;
+
+    if(!policy)
+        return;
+
+    to_level = leak_policy_to_level(policy);
+    store = GET_NODE_PREFIX_STORE(node, to_level);
+
+    policy->generation++;
+    if(!policy->generation)
+        policy->generation++;
+
+    /*Only L1L2 routers leak*/
+    if(node->spf_info.spff_multi_area){
+
+        ITERATE_LIST_BEGIN(node->spf_info.routes_list[UNICAST_T], list_node){
+
+            route = list_node->data;
+            if(route->level != level)
+                continue;
+
+            /*RFC 5302 : prefixes with Up/Down bit set must not be leaked into L2*/
+            if(to_level == LEVEL2 && IS_BIT_SET(route->flags, PREFIX_DOWNBIT_FLAG))
+                continue;
+
+            metric = IS_BIT_SET(route->flags, PREFIX_EXTERNABIT_FLAG) ?
+                        route->ext_metric : route->spf_metric;
+
+            rule = leak_trie_match(policy->trie, 
+                        leak_policy_bin_prefix(route->rt_key.u.prefix.prefix), 
+                        route->rt_key.u.prefix.mask, metric);
+
+            if(!rule || rule->action == LEAK_POLICY_DENY)
+                continue;
+
+            prefix_flags = route->flags;
+            if(to_level == LEVEL1)
+                SET_BIT(prefix_flags, PREFIX_DOWNBIT_FLAG);
+
+            prefix = prefix_store_lookup(store, route->rt_key.u.prefix.prefix, 
+                        route->rt_key.u.prefix.mask);
+
+            if(prefix){
+                if(!prefix->leak_gen)
+                    continue;
+                prefix->leak_gen = policy->generation;
+                if(prefix->metric == metric && prefix->prefix_flags == prefix_flags)
+                    continue;
+                prefix->metric = metric;
+                prefix->prefix_flags = prefix_flags;
+                set_prefix_preference(prefix);
+                prefix_store_reorder(store, prefix);
+                leak_policy_add_pending(policy, prefix->prefix, prefix->mask);
+                continue;
+            }
+
+            prefix = attach_prefix_on_node(node, route->rt_key.u.prefix.prefix, 
+                        route->rt_key.u.prefix.mask, to_level, metric, prefix_flags);
+            if(!prefix)
+                continue;
+            prefix->leak_gen = policy->generation;
+            policy->n_leaked++;
+            leak_policy_add_pending(policy, prefix->prefix, prefix->mask);
+
+        } ITERATE_LIST_END;
+    }
+
+    /*Withdraw, walk backwards since deattaching shifts the store array*/
+    for(i = (int)PREFIX_STORE_COUNT(store) - 1; i >= 0; i--){
+
+        prefix = store->prefixes[i];
+        if(!prefix->leak_gen || prefix->leak_gen == policy->generation)
+            continue;
+
+        leak_policy_add_pending(policy, prefix->prefix, prefix->mask);
+        policy->n_leaked--;
+        deattach_prefix_on_node(node, prefix->prefix, prefix->mask, to_level);
+    }
+
+#ifdef __ENABLE_TRACE__    
+    sprintf(instance->traceopts->b, "Node : %s : %s -> %s leak policy evaluated, leaked = %u, changed = %u", 
+            node->node_name, get_str_level(level), get_str_level(to_level), 
+            policy->n_leaked, policy->n_pending);
+    trace(instance->traceopts, SPF_PREFIX_BIT);
+#endif
+
+    if(policy->n_pending)
+        leak_policy_flush_pending(instance);
+}
+
+void
+leak_policy_flush_pending(instance_t *instance){
+
+    static boolean flushing = FALSE;
+
+    unsigned int round = 0,
+                 n_prefixes = 0;
+    boolean pending = FALSE;
+    LEVEL level;
+    node_t *node = NULL;
+    leak_policy_t *policy = NULL;
+    common_pfx_key_t *prefixes = NULL;
+    singly_ll_node_t *list_node = NULL;
+    tlv128_ip_reach_bulk_t ad_msg;
+    dist_info_hdr_t dist_info_hdr;
+
+    if(flushing || is_lsp_distribution_in_progress())
+        return;
+
+    flushing = TRUE;
+
+    do{
+        pending = FALSE;
+        ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+
+            node = list_node->data;
+            for(level = LEVEL1; level < MAX_LEVEL; level++){
+
+                policy = node->leak_policy[level];
+                if(!policy || !policy->n_pending)
+                    continue;
+
+                pending = TRUE;
+                /*Distribution may evaluate this policy again*/
+                prefixes = policy->pending;
+                n_prefixes = policy->n_pending;
+                policy->pending = NULL;
+                policy->n_pending = 0;
+                policy->pending_size = 0;
+
+                memset(&ad_msg, 0, sizeof(tlv128_ip_reach_bulk_t));
+                ad_msg.prefixes = prefixes;
+                ad_msg.n_prefixes = n_prefixes;
+                ad_msg.hosting_node = node;
+
+                memset(&dist_info_hdr, 0, sizeof(dist_info_hdr_t));
+                dist_info_hdr.lsp_generator = node;
+                dist_info_hdr.info_dist_level = leak_policy_to_level(policy);
+                dist_info_hdr.add_or_remove = AD_CONFIG_UPDATED;
+                dist_info_hdr.advert_id = TLV128_BULK;
+                dist_info_hdr.info_data = (char *)&ad_msg;
+                generate_lsp(instance, node, lsp_distribution_routine, &dist_info_hdr);
+                free(prefixes);
+            }
+        } ITERATE_LIST_END;
+    } while(pending && ++round < LEAK_POLICY_MAX_FLUSH_ROUNDS);
+
+    if(pending)
+        printf("%s() : Error : leak policies did not converge after %u rounds\n", 
+                __FUNCTION__, LEAK_POLICY_MAX_FLUSH_ROUNDS);
+
+    flushing = FALSE;
+}
+
+void
+show_leak_policy(node_t *node){
+
+    unsigned int i = 0;
+    LEVEL level;
+    leak_policy_t *policy = NULL;
+    leak_policy_rule_t *rule = NULL;
+    prefix_t *prefix = NULL;
+
+    printf("Node : %s leak policies, L1L2 router : %s\n", node->node_name,
+            node->spf_info.spff_multi_area ? "Yes" : "No");
+
+    for(level = LEVEL1; level < MAX_LEVEL; level++){
+
+        policy = node->leak_policy[level];
+        if(!policy)
+            continue;
+
+        printf("\t%s -> %s : rules = %u, leaked prefixes = %u\n", get_str_level(level), 
+                get_str_level(leak_policy_to_level(policy)), policy->n_rules, policy->n_leaked);
+
+        for(i = 0; i < policy->n_rules; i++){
+            rule = &policy->rules[i];
+            printf("\t\tseq %-5u %s/%u upto %u", rule->seq_no, rule->prefix, 
+                    rule->mask, rule->le);
+            if(rule->metric_max != LEAK_POLICY_ANY_METRIC)
+                printf(" metric <= %u", rule->metric_max);
+            printf(" %s\n", rule->action == LEAK_POLICY_PERMIT ? "permit" : "deny");
+        }
+
+        ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(node, leak_policy_to_level(policy)), prefix){
+            if(!prefix->leak_gen)
+                continue;
+            printf("\t\tleaked : %s/%u metric %u%s\n", prefix->prefix, prefix->mask, prefix->metric,
+                    IS_BIT_SET(prefix->prefix_flags, PREFIX_DOWNBIT_FLAG) ? " (Down)" : "");
+        } ITERATE_PREFIX_STORE_END;
+    }
+}
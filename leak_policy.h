@@ -0,0 +1,103 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  leak_policy.h
+ *
+ *    Description:  This file declares the route leaking policy of L1L2 routers. Rules
+ *                  of a policy are compiled into a binary prefix trie. After every
+ *                  route build of the source level, all routes of that level are
+ *                  matched against the trie in one pass, and the resulting set of
+ *                  leaked prefixes is applied to the other level as a diff.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __LEAK_POLICY__
+#define __LEAK_POLICY__
+
+#include "instanceconst.h"
+#include "prefix.h"
+
+typedef struct _node_t node_t;
+typedef struct instance_ instance_t;
+
+/*metric_max of rules which do not match on metric*/
+#define LEAK_POLICY_ANY_METRIC  0xFFFFFFFF
+
+typedef enum{
+
+    LEAK_POLICY_DENY,
+    LEAK_POLICY_PERMIT
+} leak_policy_action_t;
+
+typedef struct leak_policy_rule_{
+
+    unsigned int seq_no;
+    char prefix[PREFIX_LEN + 1];
+    unsigned char mask;
+    unsigned char le;           /*Matches routes with mask in [mask, le]*/
+    unsigned int metric_max;    /*Matches routes with metric <= metric_max*/
+    leak_policy_action_t action;
+    /*Compiled*/
+    unsigned int bin_prefix;
+    struct leak_policy_rule_ *trie_next; /*Rules ending on same trie node, in seq order*/
+} leak_policy_rule_t;
+
+typedef struct leak_trie_node_{
+
+    struct leak_trie_node_ *child[2];
+    leak_policy_rule_t *rules;
+} leak_trie_node_t;
+
+typedef struct leak_policy_{
+
+    node_t *node;
+    LEVEL from_level;
+    unsigned int n_rules;
+    leak_policy_rule_t *rules;  /*Array sorted by seq_no*/
+    leak_trie_node_t *trie;
+    /*Bumped on every evaluation, leaked prefixes not refreshed by an
+     * evaluation are withdrawn*/
+    unsigned int generation;
+    unsigned int n_leaked;
+    /*Changed prefixes of the other level, yet to be advertised*/
+    unsigned int n_pending;
+    unsigned int pending_size;
+    common_pfx_key_t *pending;
+} leak_policy_t;
+
+/*Add a new rule or replace the rule with same seq no*/
+void
+leak_policy_add_rule(node_t *node, LEVEL from_level, 
+                     leak_policy_rule_t *rule);
+
+void
+leak_policy_delete_rule(node_t *node, LEVEL from_level, 
+                        unsigned int seq_no);
+
+/*Called after routes of level are built on node*/
+void
+leak_policy_evaluate(node_t *node, LEVEL level);
+
+/*Advertise the leaked prefix diffs of all nodes. No-op while an LSP
+ * distribution is in progress, it is called again once it is over*/
+void
+leak_policy_flush_pending(instance_t *instance);
+
+void
+show_leak_policy(node_t *node);
+
+#endif /* __LEAK_POLICY__ */
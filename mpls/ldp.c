@@ -30,9 +30,13 @@
  * =====================================================================================
  */
 
+#include <pthread.h>
 #include "ldp.h"
 #include "instance.h"
 #include "spfutil.h"
+#include "spftrace.h"
+
+extern instance_t *instance;
 
 void
 enable_ldp(node_t *node){
@@ -41,6 +45,9 @@ enable_ldp(node_t *node){
         return;
 
     node->ldp_config.is_enabled = TRUE;
+    node->ldp_config.label_mgr = init_mpls_label_mgr("LDP");
+    mpls_label_mgr_add_block(node->ldp_config.label_mgr, LDP_LABEL_RANGE_MIN,
+            LDP_LABEL_RANGE_MAX - LDP_LABEL_RANGE_MIN);
 }
 
 void
@@ -50,6 +57,8 @@ disable_ldp(node_t *node){
         return;
 
     node->ldp_config.is_enabled = FALSE;
+    free_mpls_label_mgr(node->ldp_config.label_mgr);
+    node->ldp_config.label_mgr = NULL;
 }
 
 void
@@ -64,49 +73,35 @@ show_mpls_ldp_label_local_bindings(node_t *node){
     printf("\tPrefix/msk          Lcl Label\n");
     printf("\t================================\n");
 
-    singly_ll_node_t *list_node = NULL;
     LEVEL level_it;
     prefix_t *prefix = NULL;
     char str_prefix_with_mask[PREFIX_LEN_WITH_MASK + 1];
     
     for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(node, level_it), list_node){
-            prefix = list_node->data;
+        ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(node, level_it), prefix){
             memset(str_prefix_with_mask, 0, PREFIX_LEN_WITH_MASK + 1);
             apply_mask2(prefix->prefix, prefix->mask, str_prefix_with_mask);
             printf("\t%-22s %u\n", str_prefix_with_mask, 
                 get_ldp_label_binding(node, prefix->prefix, prefix->mask));
-        } ITERATE_LIST_END;
+        } ITERATE_PREFIX_STORE_END;
     }
+    show_mpls_label_mgr(node->ldp_config.label_mgr);
 }
 
-static char buff[NODE_NAME_SIZE + PREFIX_LEN_WITH_MASK];
-
 mpls_label_t
 get_ldp_label_binding(node_t *down_stream_node, 
                                         char *prefix, char mask){
-    /*To simulate the LDP label distrubution in the network, we will 
-     * use heuristics. Each router uses this heuristics to generate
-     * LDP labels for all prefixes in the network*/
-
-    /*The label generated should be locally unique. This heuristics do not
-     * guarantees this but the probablity of collision is almost zero*/
+    /*To simulate the LDP label distrubution in the network, downstream
+     * node binds a local label to the FEC the first time it is asked
+     * for it (downstream unsolicited in effect). Binding is kept till 
+     * LDP is disabled on the node, so labels are unique and stable*/
 
     if(down_stream_node->ldp_config.is_enabled == FALSE){
         return 0;
     }
 
-    memset(buff, 0 , sizeof(buff));
-    apply_mask2(prefix, mask, buff);
-    
-    strncpy(buff + PREFIX_LEN_WITH_MASK, down_stream_node->node_name, NODE_NAME_SIZE);
-    buff[NODE_NAME_SIZE + PREFIX_LEN_WITH_MASK - 1] = '\0';
-    
-    mpls_label_t label = hash_code(buff, sizeof(buff));
-    label = label % (LDP_LABEL_RANGE_MAX - LDP_LABEL_RANGE_MIN);
-    label += LDP_LABEL_RANGE_MIN;
-
-    return label;
+    return mpls_label_mgr_get_fec_label(down_stream_node->ldp_config.label_mgr,
+                prefix, mask);
 }
 
 int
@@ -196,7 +191,7 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
         if(nh_type == IPV4_LDP_NH){
             /*No action needed, there is already LDP nexthop installed locally towards egress LSR*/
             next_node = nexthop->nh_node;
-            outgoing_ldp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+            outgoing_ldp_label = get_internal_un_nh_stack_top_label(nexthop);
             goto NEXT_NODE;
         }
         else if(nh_type == IPV4_NH){
@@ -218,8 +213,7 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
             }
 
             new_nexthop->protocol = LDP_PROTO;
-            new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_ldp_label;
-            new_nexthop->nh.inet3_nh.stack_op[0] = PUSH;
+            set_internal_un_nh_label_op(new_nexthop, PUSH, outgoing_ldp_label);
             new_nexthop->flags = 0;
             SET_BIT(new_nexthop->flags, PRIMARY_NH);
             SET_BIT(new_nexthop->flags, IPV4_LDP_NH);
@@ -231,7 +225,6 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
             new_nexthop->root_metric = 0;
             new_nexthop->dest_metric = 0;
             time(&new_nexthop->last_refresh_time);
-            init_glthread(&new_nexthop->glthread);
 
             /*Now install it in inet.3 table*/
             rc = inet_3_rt_un_route_install_nexthop(inet_3_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -242,6 +235,7 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
             }
         }
         next_node = new_nexthop->nh_node;
+        free_un_nexthop(new_nexthop);
     }
     else{
         /*Request LDP label from proxy_nbr for edgress_lsr_rtr_id*/
@@ -256,7 +250,7 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
 
         ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
             nexthop = glthread_to_unified_nh(curr);
-            if(nexthop->oif == oif && !strncpy(nexthop->gw_prefix, gw_ip, PREFIX_LEN) && 
+            if(nexthop->oif == oif && is_un_next_hop_gw_pfx_equal(nexthop, gw_ip) && 
                     nexthop->protocol == LDP_PROTO){
                 assert(nexthop->nh_node == proxy_nbr);
                 is_exist = TRUE;
@@ -266,7 +260,7 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
 
         if(is_exist){
             next_node = nexthop->nh_node;
-            outgoing_ldp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+            outgoing_ldp_label = get_internal_un_nh_stack_top_label(nexthop);
             goto NEXT_NODE;
         }
 
@@ -282,9 +276,8 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
         new_nexthop->protocol = LDP_PROTO; 
         new_nexthop->oif = oif;
         new_nexthop->nh_node = proxy_nbr;
-        strncpy(new_nexthop->gw_prefix, gw_ip, PREFIX_LEN);
-        new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_ldp_label;
-        new_nexthop->nh.inet3_nh.stack_op[0] = PUSH; 
+        set_un_next_hop_gw_pfx(new_nexthop, gw_ip);
+        set_internal_un_nh_label_op(new_nexthop, PUSH, outgoing_ldp_label);
         SET_BIT(new_nexthop->flags, PRIMARY_NH);
         SET_BIT(new_nexthop->flags, IPV4_LDP_NH);
         new_nexthop->ref_count = 0; 
@@ -296,7 +289,6 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
         new_nexthop->root_metric = 0;
         new_nexthop->dest_metric = 0;
         time(&new_nexthop->last_refresh_time);
-        init_glthread(&new_nexthop->glthread);
 
         /*Now install it in inet.3 table*/
         rc = inet_3_rt_un_route_install_nexthop(inet_3_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -306,6 +298,7 @@ create_targeted_ldp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
             return -1;
         }
         next_node = new_nexthop->nh_node;
+        free_un_nexthop(new_nexthop);
     }
 
 NEXT_NODE:
@@ -353,8 +346,7 @@ NEXT_NODE:
             }
 
             new_nexthop->protocol = LDP_PROTO;
-            new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_ldp_label;
-            new_nexthop->nh.inet3_nh.stack_op[0] = SWAP;
+            set_internal_un_nh_label_op(new_nexthop, SWAP, outgoing_ldp_label);
             new_nexthop->flags = 0;
             SET_BIT(new_nexthop->flags, PRIMARY_NH);
             SET_BIT(new_nexthop->flags, LDP_TRANSIT_NH);
@@ -366,7 +358,6 @@ NEXT_NODE:
             new_nexthop->root_metric = 0;
             new_nexthop->dest_metric = 0;
             time(&new_nexthop->last_refresh_time);
-            init_glthread(&new_nexthop->glthread);
 
             /*Now install it in inet.3 table*/
             rc = mpls_0_rt_un_route_install_nexthop(mpls_0_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -377,6 +368,7 @@ NEXT_NODE:
                 return -1;
             }
             next_node = new_nexthop->nh_node;
+            free_un_nexthop(new_nexthop);
         }
         else{
             nexthop = GET_FIRST_NH(rt_un_entry, LDP_TRANSIT_NH, PRIMARY_NH);
@@ -414,8 +406,7 @@ NEXT_NODE:
                 }
 
                 new_nexthop->protocol = LDP_PROTO;
-                new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_ldp_label;
-                new_nexthop->nh.inet3_nh.stack_op[0] = SWAP;
+                set_internal_un_nh_label_op(new_nexthop, SWAP, outgoing_ldp_label);
                 new_nexthop->flags = 0;
                 SET_BIT(new_nexthop->flags, PRIMARY_NH);
                 SET_BIT(new_nexthop->flags, LDP_TRANSIT_NH);
@@ -427,7 +418,6 @@ NEXT_NODE:
                 new_nexthop->root_metric = 0;
                 new_nexthop->dest_metric = 0;
                 time(&new_nexthop->last_refresh_time);
-                init_glthread(&new_nexthop->glthread);
 
                 /*Now install it in mpls.0 table*/
                 rc = mpls_0_rt_un_route_install_nexthop(mpls_0_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -438,11 +428,12 @@ NEXT_NODE:
                 }
 
                 next_node = new_nexthop->nh_node;
+                free_un_nexthop(new_nexthop);
             }
             else{
                 printf("LDP transit nexthop already exists on node %s for %s/32\n", 
                     next_node->node_name, edgress_lsr_rtr_id);
-                outgoing_ldp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+                outgoing_ldp_label = get_internal_un_nh_stack_top_label(nexthop);
                 next_node = nexthop->nh_node;
             }
         }
@@ -457,8 +448,7 @@ NEXT_NODE:
 
         new_nexthop = malloc_un_nexthop();  
         new_nexthop->protocol = LDP_PROTO;
-        new_nexthop->nh.inet3_nh.mpls_label_out[0] = 0;
-        new_nexthop->nh.inet3_nh.stack_op[0] = POP;
+        set_internal_un_nh_label_op(new_nexthop, POP, 0);
         new_nexthop->flags = 0;
         SET_BIT(new_nexthop->flags, PRIMARY_NH);
         SET_BIT(new_nexthop->flags, LDP_TRANSIT_NH);
@@ -470,7 +460,6 @@ NEXT_NODE:
         new_nexthop->root_metric = 0;
         new_nexthop->dest_metric = 0;
         time(&new_nexthop->last_refresh_time);
-        init_glthread(&new_nexthop->glthread);
 
         /*Now install it in inet.3 table*/
         rc = mpls_0_rt_un_route_install_nexthop(mpls_0_rib, &inet_key, LEVEL1/*dont matter*/, new_nexthop);
@@ -483,6 +472,7 @@ NEXT_NODE:
         }
         printf("Installed transit LDP nexthop for route %s on node %s\n", edgress_lsr_rtr_id, 
             next_node->node_name);
+        free_un_nexthop(new_nexthop);
     }
     else{
         printf("LDP local route already exists on egress lsr node %s for route %s/32\n", 
@@ -490,3 +480,274 @@ NEXT_NODE:
     }
     return 0;
 }
+
+/*LDP FEC binding distribution*/
+
+typedef struct ldp_dist_work_{
+
+    node_t **nodes;     /*LDP enabled nodes*/
+    unsigned int n_nodes;
+    unsigned int next;  /*next node index to be picked by worker*/
+    void (*node_fn)(node_t *, ldp_dist_stats_t *);
+} ldp_dist_work_t;
+
+typedef struct ldp_dist_worker_{
+
+    ldp_dist_work_t *work;
+    ldp_dist_stats_t stats;
+} ldp_dist_worker_t;
+
+/*Phase 1 : node binds local label to all FECs of its inet.0 table. Node 
+ * writes only its own label manager*/
+static void
+ldp_dist_bind_node_fecs(node_t *node, ldp_dist_stats_t *stats){
+
+    glthread_t *curr = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    rt_un_table_t *inet_0_rib = node->spf_info.rib[INET_0];
+
+    ITERATE_GLTHREAD_BEGIN(&inet_0_rib->head, curr){
+
+        rt_un_entry = glthread_to_rt_un_entry(curr);
+        if(mpls_label_mgr_get_fec_label(node->ldp_config.label_mgr,
+                    RT_ENTRY_PFX(&rt_un_entry->rt_key), 
+                    RT_ENTRY_MASK(&rt_un_entry->rt_key)))
+            stats->n_fecs++;
+    } ITERATE_GLTHREAD_END(&inet_0_rib->head, curr);
+}
+
+static void
+ldp_dist_fill_nexthop(internal_un_nh_t *nexthop, mpls_label_t label_out, 
+                      MPLS_STACK_OP stack_op, char nh_type){
+
+    nexthop->protocol = LDP_PROTO;
+    set_internal_un_nh_label_op(nexthop, stack_op, label_out);
+    nexthop->flags = 0;
+    SET_BIT(nexthop->flags, PRIMARY_NH);
+    SET_BIT(nexthop->flags, nh_type);
+    nexthop->lfa_type = NO_LFA;
+    nexthop->protected_link = NULL;
+    nexthop->root_metric = 0;
+    nexthop->dest_metric = 0;
+    time(&nexthop->last_refresh_time);
+}
+
+/*Install nexthop unless the route already has it. Returns TRUE if installed*/
+static boolean
+ldp_dist_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, 
+                         LEVEL level, internal_un_nh_t *nexthop){
+
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+
+    if(rt_un_entry && rt_un_entry->level == level &&
+        lookup_clone_next_hop(rib, rt_un_entry, nexthop))
+        return FALSE;
+
+    return rib->rt_un_route_install_nexthop(rib, rt_key, level, nexthop);
+}
+
+/*Phase 2 : node installs LDP routes for all FECs of its inet.0 table using
+ * label bindings of its IGP nexthops. Label managers of other nodes are only read*/
+static void
+ldp_dist_install_node_fecs(node_t *node, ldp_dist_stats_t *stats){
+
+    glthread_t *curr = NULL,
+               *curr1 = NULL;
+
+    rt_un_entry_t *rt_un_entry = NULL;
+    internal_un_nh_t *nexthop = NULL,
+                     *ldp_nexthop = NULL;
+
+    mpls_label_t incoming_ldp_label = 0,
+                 outgoing_ldp_label = 0;
+
+    rt_key_t mpls_key;
+    char *prefix = NULL;
+    char mask = 0;
+    boolean is_local = FALSE;
+
+    rt_un_table_t *inet_0_rib = node->spf_info.rib[INET_0],
+                  *inet_3_rib = node->spf_info.rib[INET_3],
+                  *mpls_0_rib = node->spf_info.rib[MPLS_0];
+
+    ldp_nexthop = malloc_un_nexthop();
+
+    ITERATE_GLTHREAD_BEGIN(&inet_0_rib->head, curr){
+
+        rt_un_entry = glthread_to_rt_un_entry(curr);
+        prefix = RT_ENTRY_PFX(&rt_un_entry->rt_key);
+        mask = RT_ENTRY_MASK(&rt_un_entry->rt_key);
+
+        incoming_ldp_label = mpls_label_mgr_lookup_fec_label(
+                node->ldp_config.label_mgr, prefix, mask);
+        if(!incoming_ldp_label)
+            continue;
+
+        memcpy(&mpls_key, &rt_un_entry->rt_key, sizeof(rt_key_t));
+        RT_ENTRY_LABEL(&mpls_key) = incoming_ldp_label;
+
+        is_local = TRUE;
+        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+
+            nexthop = glthread_to_unified_nh(curr1);
+            if(!IS_BIT_SET(nexthop->flags, PRIMARY_NH) ||
+                !IS_BIT_SET(nexthop->flags, IPV4_NH))
+                continue;
+
+            is_local = FALSE;
+
+            if(!nexthop->nh_node)
+                continue;
+
+            memcpy(ldp_nexthop, nexthop, sizeof(internal_un_nh_t));
+
+            /*Nbr is not LDP speaker, LSP ends here. Label advertised by
+             * this node is popped and packet is forwarded unlabelled*/
+            if(nexthop->nh_node->ldp_config.is_enabled == FALSE){
+                ldp_dist_fill_nexthop(ldp_nexthop, 0, POP, LDP_TRANSIT_NH);
+                if(ldp_dist_install_nexthop(mpls_0_rib, &mpls_key, 
+                            rt_un_entry->level, ldp_nexthop))
+                    stats->n_mpls0_nh++;
+                continue;
+            }
+
+            /*LDP nbr has no binding for this FEC, no LSP through it*/
+            outgoing_ldp_label = mpls_label_mgr_lookup_fec_label(
+                    nexthop->nh_node->ldp_config.label_mgr, prefix, mask);
+            if(!outgoing_ldp_label)
+                continue;
+
+            /*Ingress LSR route*/
+            ldp_dist_fill_nexthop(ldp_nexthop, outgoing_ldp_label, PUSH, IPV4_LDP_NH);
+            if(ldp_dist_install_nexthop(inet_3_rib, &rt_un_entry->rt_key, 
+                        rt_un_entry->level, ldp_nexthop))
+                stats->n_inet3_nh++;
+
+            /*Transit LSR route*/
+            ldp_dist_fill_nexthop(ldp_nexthop, outgoing_ldp_label, SWAP, LDP_TRANSIT_NH);
+            if(ldp_dist_install_nexthop(mpls_0_rib, &mpls_key, 
+                        rt_un_entry->level, ldp_nexthop))
+                stats->n_mpls0_nh++;
+        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+
+        /*LSPs ride on the IGP nexthops, PIC repairs them along with the IGP route*/
+        rt_un_entry_set_nh_group(inet_3_rib, &rt_un_entry->rt_key, rt_un_entry->nhg);
+        rt_un_entry_set_nh_group(mpls_0_rib, &mpls_key, rt_un_entry->nhg);
+
+        if(!is_local)
+            continue;
+
+        /*Egress LSR route*/
+        memset(ldp_nexthop, 0, sizeof(internal_un_nh_t));
+        ldp_dist_fill_nexthop(ldp_nexthop, 0, POP, LDP_TRANSIT_NH);
+        if(ldp_dist_install_nexthop(mpls_0_rib, &mpls_key, 
+                    rt_un_entry->level, ldp_nexthop))
+            stats->n_mpls0_nh++;
+
+    } ITERATE_GLTHREAD_END(&inet_0_rib->head, curr);
+
+    free_un_nexthop(ldp_nexthop);
+}
+
+static void *
+ldp_dist_worker_fn(void *arg){
+
+    ldp_dist_worker_t *worker = arg;
+    ldp_dist_work_t *work = worker->work;
+    unsigned int i = 0;
+
+    while(1){
+        i = __atomic_fetch_add(&work->next, 1, __ATOMIC_RELAXED);
+        if(i >= work->n_nodes)
+            break;
+        work->node_fn(work->nodes[i], &worker->stats);
+    }
+    return NULL;
+}
+
+/*Runs node_fn on all nodes of work, join of workers is the barrier
+ * between the phases*/
+static void
+ldp_dist_run_phase(ldp_dist_work_t *work, unsigned int n_workers, 
+                   ldp_dist_stats_t *stats){
+
+    unsigned int i = 0;
+    pthread_t threads[LDP_DIST_MAX_WORKERS];
+    boolean worker_spawned[LDP_DIST_MAX_WORKERS];
+    ldp_dist_worker_t workers[LDP_DIST_MAX_WORKERS];
+
+    memset(workers, 0, sizeof(workers));
+    work->next = 0;
+
+    for(i = 0; i < n_workers; i++){
+        workers[i].work = work;
+        worker_spawned[i] = FALSE;
+        if(n_workers > 1)
+            worker_spawned[i] = (pthread_create(&threads[i], NULL, 
+                                    ldp_dist_worker_fn, &workers[i]) == 0);
+        if(!worker_spawned[i])
+            ldp_dist_worker_fn(&workers[i]);
+    }
+
+    for(i = 0; i < n_workers; i++){
+        if(worker_spawned[i])
+            pthread_join(threads[i], NULL);
+        stats->n_fecs      += workers[i].stats.n_fecs;
+        stats->n_inet3_nh  += workers[i].stats.n_inet3_nh;
+        stats->n_mpls0_nh  += workers[i].stats.n_mpls0_nh;
+    }
+}
+
+void
+ldp_distribute_fec_bindings(instance_t *instance, ldp_dist_stats_t *stats){
+
+    singly_ll_node_t *list_node = NULL;
+    node_t *node = NULL;
+    ldp_dist_work_t work;
+    unsigned int n_workers = 0;
+    unsigned long long start_time = 0;
+
+    memset(stats, 0, sizeof(ldp_dist_stats_t));
+    memset(&work, 0, sizeof(ldp_dist_work_t));
+
+    work.nodes = calloc(GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list), 
+                        sizeof(node_t *));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        if(node->ldp_config.is_enabled == FALSE)
+            continue;
+        work.nodes[work.n_nodes++] = node;
+    } ITERATE_LIST_END;
+
+    stats->n_nodes = work.n_nodes;
+    if(!work.n_nodes){
+        free(work.nodes);
+        return;
+    }
+
+    start_time = get_time_usec();
+    /*Workers install into RIBs, which share the trace buffer*/
+    n_workers = instance->traceopts->enable == TR_TRUE ? 1 :
+        get_worker_count(work.n_nodes, LDP_DIST_MAX_WORKERS);
+
+    /*All nodes must have bound their labels before any node
+     * looks up the bindings of its nexthops*/
+    work.node_fn = ldp_dist_bind_node_fecs;
+    ldp_dist_run_phase(&work, n_workers, stats);
+
+    work.node_fn = ldp_dist_install_node_fecs;
+    ldp_dist_run_phase(&work, n_workers, stats);
+
+    stats->usec = get_time_usec() - start_time;
+    free(work.nodes);
+}
+
+void
+print_ldp_dist_stats(ldp_dist_stats_t *stats){
+
+    printf("LDP distribution : nodes = %u, FECs = %u, inet.3 nexthops = %u, "
+           "mpls.0 nexthops = %u, time = %llu usec, bindings/sec = %llu\n",
+            stats->n_nodes, stats->n_fecs, stats->n_inet3_nh, stats->n_mpls0_nh,
+            stats->usec, stats->usec ? (stats->n_fecs * 1000000ULL)/stats->usec : stats->n_fecs);
+}
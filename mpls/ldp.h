@@ -34,6 +34,7 @@
 #define __LDP__
 
 #include "instanceconst.h"
+#include "mpls_label_mgr.h"
 
 #define LDP_LABEL_RANGE_MIN     100000
 #define LDP_LABEL_RANGE_MAX     300000
@@ -44,6 +45,7 @@ typedef struct edge_end_ edge_end_t;
 typedef struct _ldp_config_{
     
     boolean is_enabled; /*Is LDP enabled on the node*/
+    mpls_label_mgr_t *label_mgr; /*Local FEC label bindings*/
 } ldp_config_t;
 
 void
@@ -56,6 +58,31 @@ mpls_label_t
 get_ldp_label_binding(node_t *down_stream_node,
         char *prefix, char mask);
 
+typedef struct instance_ instance_t;
+
+/*Max no of threads LDP distribution runs on*/
+#define LDP_DIST_MAX_WORKERS    16
+
+typedef struct ldp_dist_stats_{
+
+    unsigned int n_nodes;       /*LDP enabled nodes*/
+    unsigned int n_fecs;        /*FEC label bindings, summed over nodes*/
+    unsigned int n_inet3_nh;    /*ingress nexthops installed in inet.3*/
+    unsigned int n_mpls0_nh;    /*transit/egress nexthops installed in mpls.0*/
+    unsigned long long usec;
+} ldp_dist_stats_t;
+
+/*Simulates LDP convergence once all nodes have run SPF. Every LDP
+ * enabled node binds a label to every FEC of its inet.0 table, then
+ * installs LDP ingress (inet.3) and transit (mpls.0) entries for all 
+ * FECs using the bindings of its IGP nexthops. Nodes are processed in
+ * parallel*/
+void
+ldp_distribute_fec_bindings(instance_t *instance, ldp_dist_stats_t *stats);
+
+void
+print_ldp_dist_stats(ldp_dist_stats_t *stats);
+
 int
 create_targeted_ldp_tunnel(node_t *ingress_lsr, 
                            char *edgress_lsr_rtr_id,
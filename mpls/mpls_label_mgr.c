@@ -30,4 +30,238 @@
  * =====================================================================================
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
 #include "mpls_label_mgr.h"
+
+static unsigned int
+mpls_fec_key(char *prefix, char mask){
+
+    unsigned int bin_prefix = 0;
+
+    if(inet_pton(AF_INET, prefix, &bin_prefix) != 1)
+        return 0;
+    bin_prefix = ntohl(bin_prefix);
+    if((unsigned char)mask < 32)
+        bin_prefix &= ~(0xFFFFFFFFU >> (unsigned char)mask);
+    return bin_prefix;
+}
+
+static inline unsigned int
+mpls_fec_hash(mpls_label_mgr_t *label_mgr, unsigned int bin_prefix,
+              unsigned char mask){
+
+    return ((bin_prefix ^ mask) * 2654435761U) & (label_mgr->n_buckets - 1);
+}
+
+mpls_label_mgr_t *
+init_mpls_label_mgr(char *name){
+
+    mpls_label_mgr_t *label_mgr = calloc(1, sizeof(mpls_label_mgr_t));
+    label_mgr->name = name;
+    label_mgr->n_buckets = MPLS_LBL_MGR_INIT_BUCKETS;
+    label_mgr->bucket = calloc(label_mgr->n_buckets, sizeof(mpls_fec_binding_t *));
+    return label_mgr;
+}
+
+void
+free_mpls_label_mgr(mpls_label_mgr_t *label_mgr){
+
+    unsigned int i = 0;
+    mpls_fec_binding_t *binding = NULL, 
+                       *next = NULL;
+
+    for(i = 0; i < label_mgr->n_buckets; i++){
+        for(binding = label_mgr->bucket[i]; binding; binding = next){
+            next = binding->next;
+            free(binding);
+        }
+    }
+    for(i = 0; i < label_mgr->n_blocks; i++)
+        free_bit_array(&label_mgr->blocks[i].in_use);
+    free(label_mgr->bucket);
+    free(label_mgr);
+}
+
+int
+mpls_label_mgr_add_block(mpls_label_mgr_t *label_mgr,
+                         mpls_label_t first_label, unsigned int size){
+
+    unsigned int i = 0;
+    mpls_label_block_t *block = NULL;
+
+    if(!size || label_mgr->n_blocks == MPLS_LBL_MGR_MAX_BLOCKS)
+        return -1;
+
+    for(i = 0; i < label_mgr->n_blocks; i++){
+        block = &label_mgr->blocks[i];
+        if(first_label < block->first_label + block->size &&
+            block->first_label < first_label + size)
+            return -1;
+    }
+
+    block = &label_mgr->blocks[label_mgr->n_blocks++];
+    block->first_label = first_label;
+    block->size = size;
+    init_bit_array(&block->in_use, size);
+    return 0;
+}
+
+static mpls_label_block_t *
+mpls_label_mgr_get_block(mpls_label_mgr_t *label_mgr, mpls_label_t label){
+
+    unsigned int i = 0;
+    mpls_label_block_t *block = NULL;
+
+    for(i = 0; i < label_mgr->n_blocks; i++){
+        block = &label_mgr->blocks[i];
+        if(label >= block->first_label &&
+            label < block->first_label + block->size)
+            return block;
+    }
+    return NULL;
+}
+
+mpls_label_t
+mpls_label_mgr_alloc_label(mpls_label_mgr_t *label_mgr){
+
+    unsigned int i = 0, index = 0;
+    mpls_label_block_t *block = NULL;
+
+    for(i = 0; i < label_mgr->n_blocks; i++){
+        block = &label_mgr->blocks[i];
+        index = get_next_available_bit(&block->in_use);
+        if(index == BIT_ARRAY_NO_BIT)
+            continue;
+        set_bit(&block->in_use, index);
+        return block->first_label + index;
+    }
+    return 0;
+}
+
+void
+mpls_label_mgr_free_label(mpls_label_mgr_t *label_mgr, mpls_label_t label){
+
+    mpls_label_block_t *block = mpls_label_mgr_get_block(label_mgr, label);
+
+    if(!block){
+        printf("Error : label %u do not belong to %s label space\n",
+                label, label_mgr->name);
+        return;
+    }
+    unset_bit(&block->in_use, label - block->first_label);
+}
+
+static void
+mpls_label_mgr_rehash(mpls_label_mgr_t *label_mgr){
+
+    unsigned int i = 0, old_n_buckets = label_mgr->n_buckets;
+    mpls_fec_binding_t **old_bucket = label_mgr->bucket,
+                       *binding = NULL, *next = NULL;
+    unsigned int hash = 0;
+
+    label_mgr->n_buckets <<= 1;
+    label_mgr->bucket = calloc(label_mgr->n_buckets, sizeof(mpls_fec_binding_t *));
+
+    for(i = 0; i < old_n_buckets; i++){
+        for(binding = old_bucket[i]; binding; binding = next){
+            next = binding->next;
+            hash = mpls_fec_hash(label_mgr, binding->bin_prefix, binding->mask);
+            binding->next = label_mgr->bucket[hash];
+            label_mgr->bucket[hash] = binding;
+        }
+    }
+    free(old_bucket);
+}
+
+static mpls_fec_binding_t **
+mpls_label_mgr_fec_slot(mpls_label_mgr_t *label_mgr, unsigned int bin_prefix,
+                        unsigned char mask){
+
+    mpls_fec_binding_t **slot = 
+        &label_mgr->bucket[mpls_fec_hash(label_mgr, bin_prefix, mask)];
+
+    for(; *slot; slot = &(*slot)->next){
+        if((*slot)->bin_prefix == bin_prefix && (*slot)->mask == mask)
+            break;
+    }
+    return slot;
+}
+
+mpls_label_t
+mpls_label_mgr_lookup_fec_label(mpls_label_mgr_t *label_mgr,
+                                char *prefix, char mask){
+
+    mpls_fec_binding_t **slot = mpls_label_mgr_fec_slot(label_mgr,
+                                    mpls_fec_key(prefix, mask), mask);
+
+    return *slot ? (*slot)->label : 0;
+}
+
+mpls_label_t
+mpls_label_mgr_get_fec_label(mpls_label_mgr_t *label_mgr,
+                             char *prefix, char mask){
+
+    unsigned int bin_prefix = mpls_fec_key(prefix, mask);
+    mpls_fec_binding_t **slot = mpls_label_mgr_fec_slot(label_mgr,
+                                    bin_prefix, mask),
+                       *binding = NULL;
+    mpls_label_t label = 0;
+
+    if(*slot)
+        return (*slot)->label;
+
+    label = mpls_label_mgr_alloc_label(label_mgr);
+    if(!label){
+        printf("Error : %s label space exhausted\n", label_mgr->name);
+        return 0;
+    }
+
+    binding = calloc(1, sizeof(mpls_fec_binding_t));
+    binding->bin_prefix = bin_prefix;
+    binding->mask = mask;
+    binding->label = label;
+    binding->next = *slot;
+    *slot = binding;
+    label_mgr->n_bindings++;
+
+    if(label_mgr->n_bindings >= (label_mgr->n_buckets << 1))
+        mpls_label_mgr_rehash(label_mgr);
+    return label;
+}
+
+void
+mpls_label_mgr_release_fec_label(mpls_label_mgr_t *label_mgr,
+                                 char *prefix, char mask){
+
+    mpls_fec_binding_t **slot = mpls_label_mgr_fec_slot(label_mgr,
+                                    mpls_fec_key(prefix, mask), mask),
+                       *binding = *slot;
+
+    if(!binding)
+        return;
+
+    *slot = binding->next;
+    mpls_label_mgr_free_label(label_mgr, binding->label);
+    free(binding);
+    label_mgr->n_bindings--;
+}
+
+void
+show_mpls_label_mgr(mpls_label_mgr_t *label_mgr){
+
+    unsigned int i = 0;
+    mpls_label_block_t *block = NULL;
+
+    printf("\t%s Label Manager : FEC bindings : %u\n", 
+            label_mgr->name, label_mgr->n_bindings);
+    for(i = 0; i < label_mgr->n_blocks; i++){
+        block = &label_mgr->blocks[i];
+        printf("\t\tLabel Block [%u, %u] : in use : %u, available : %u\n",
+                block->first_label, block->first_label + block->size - 1,
+                BIT_ARRAY_SET_COUNT(&block->in_use),
+                block->size - BIT_ARRAY_SET_COUNT(&block->in_use));
+    }
+}
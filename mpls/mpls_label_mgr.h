@@ -3,7 +3,11 @@
  *
  *       Filename:  mpls_label_mgr.h
  *
- *    Description:  This file defines the functionality of MPLs Label Lanager
+ *    Description:  This file defines the functionality of MPLs Label Lanager.
+ *                  Every node owns a label manager per label distribution protocol.
+ *                  Labels are allocated out of label blocks tracked by free bitmaps,
+ *                  and FEC to label bindings are kept in a hash table so that a FEC
+ *                  keeps its label until it is released.
  *
  *        Version:  1.0
  *        Created:  Monday 03 September 2018 06:39:56  IST
@@ -33,6 +37,74 @@
 #ifndef __MPLS_LBL_MGR__
 #define __MPLS_LBL_MGR__
 
+#include "instanceconst.h"
+#include "bitarr.h"
 
+#define MPLS_LBL_MGR_MAX_BLOCKS     4
+/*Must be power of 2*/
+#define MPLS_LBL_MGR_INIT_BUCKETS   256
+
+typedef struct mpls_label_block_{
+
+    mpls_label_t first_label;
+    unsigned int size;
+    bit_array_t in_use;     /*bit i set if first_label + i is allocated*/
+} mpls_label_block_t;
+
+typedef struct mpls_fec_binding_{
+
+    unsigned int bin_prefix;    /*masked, host order*/
+    unsigned char mask;
+    mpls_label_t label;
+    struct mpls_fec_binding_ *next;
+} mpls_fec_binding_t;
+
+typedef struct mpls_label_mgr_{
+
+    char *name;
+    unsigned int n_blocks;
+    mpls_label_block_t blocks[MPLS_LBL_MGR_MAX_BLOCKS];
+    /*FEC to label bindings*/
+    unsigned int n_bindings;
+    unsigned int n_buckets;
+    mpls_fec_binding_t **bucket;
+} mpls_label_mgr_t;
+
+mpls_label_mgr_t *
+init_mpls_label_mgr(char *name);
+
+void
+free_mpls_label_mgr(mpls_label_mgr_t *label_mgr);
+
+/*Returns -1 if the block overlaps an existing block or no more
+ * blocks can be added*/
+int
+mpls_label_mgr_add_block(mpls_label_mgr_t *label_mgr, 
+                         mpls_label_t first_label, unsigned int size);
+
+/*Returns 0 if label space is exhausted*/
+mpls_label_t
+mpls_label_mgr_alloc_label(mpls_label_mgr_t *label_mgr);
+
+void
+mpls_label_mgr_free_label(mpls_label_mgr_t *label_mgr, mpls_label_t label);
+
+/*Returns the label bound to FEC prefix/mask, binding a new label if 
+ * FEC is not bound yet. Returns 0 if label space is exhausted*/
+mpls_label_t
+mpls_label_mgr_get_fec_label(mpls_label_mgr_t *label_mgr, 
+                             char *prefix, char mask);
+
+/*Returns the label bound to FEC, 0 if FEC is not bound*/
+mpls_label_t
+mpls_label_mgr_lookup_fec_label(mpls_label_mgr_t *label_mgr,
+                                char *prefix, char mask);
+
+void
+mpls_label_mgr_release_fec_label(mpls_label_mgr_t *label_mgr,
+                                 char *prefix, char mask);
+
+void
+show_mpls_label_mgr(mpls_label_mgr_t *label_mgr);
 
 #endif /* __MPLS_LBL_MGR__ */
@@ -64,19 +64,17 @@ show_mpls_rsvp_label_local_bindings(node_t *node){
     printf("\tPrefix/msk          Lcl Label\n");
     printf("\t================================\n");
 
-    singly_ll_node_t *list_node = NULL;
     LEVEL level_it;
     prefix_t *prefix = NULL;
     char str_prefix_with_mask[PREFIX_LEN_WITH_MASK + 1];
     
     for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(node, level_it), list_node){
-            prefix = list_node->data;
+        ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(node, level_it), prefix){
             memset(str_prefix_with_mask, 0, PREFIX_LEN_WITH_MASK + 1);
             apply_mask2(prefix->prefix, prefix->mask, str_prefix_with_mask);
             printf("\t%-22s %u\n", str_prefix_with_mask, 
                 get_rsvp_label_binding(node, prefix->prefix, prefix->mask));
-        } ITERATE_LIST_END;
+        } ITERATE_PREFIX_STORE_END;
     }
 }
 
@@ -127,6 +125,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
     rt_un_entry_t *rt_un_entry = NULL;
     internal_un_nh_t *nexthop = NULL,
                      *new_nexthop = NULL;
+    char gw_prefix[PREFIX_LEN + 1];
 
     inet_0_rib = ingress_lsr->spf_info.rib[INET_0];
     inet_3_rib = ingress_lsr->spf_info.rib[INET_3];
@@ -198,10 +197,10 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
         if(nh_type == IPV4_RSVP_NH){
             /*No action needed, there is already RSVP nexthop installed locally towards egress LSR*/
             next_node = nexthop->nh_node;
-            outgoing_rsvp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+            outgoing_rsvp_label = get_internal_un_nh_stack_top_label(nexthop);
             rsvp_tunnel_data->physical_oif = nexthop->oif;
-            strncpy(rsvp_tunnel_data->gateway, nexthop->gw_prefix, PREFIX_LEN);
-            rsvp_tunnel_data->rsvp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+            strncpy(rsvp_tunnel_data->gateway, get_un_next_hop_gateway_pfx(nexthop, gw_prefix), PREFIX_LEN);
+            rsvp_tunnel_data->rsvp_label = get_internal_un_nh_stack_top_label(nexthop);
             goto NEXT_NODE;
         }
         else if(nh_type == IPV4_NH){
@@ -223,8 +222,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
             }
 
             new_nexthop->protocol = RSVP_PROTO;
-            new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_rsvp_label;
-            new_nexthop->nh.inet3_nh.stack_op[0] = PUSH;
+            set_internal_un_nh_label_op(new_nexthop, PUSH, outgoing_rsvp_label);
             new_nexthop->flags = 0;
             SET_BIT(new_nexthop->flags, PRIMARY_NH);
             SET_BIT(new_nexthop->flags, IPV4_RSVP_NH);
@@ -236,12 +234,11 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
             new_nexthop->root_metric = 0;
             new_nexthop->dest_metric = 0;
             time(&new_nexthop->last_refresh_time);
-            init_glthread(&new_nexthop->glthread);
             
             /*collect RSVP data*/
             rsvp_tunnel_data->physical_oif = new_nexthop->oif;
-            strncpy(rsvp_tunnel_data->gateway, new_nexthop->gw_prefix, PREFIX_LEN);
-            rsvp_tunnel_data->rsvp_label = new_nexthop->nh.inet3_nh.mpls_label_out[0];
+            strncpy(rsvp_tunnel_data->gateway, get_un_next_hop_gateway_pfx(new_nexthop, gw_prefix), PREFIX_LEN);
+            rsvp_tunnel_data->rsvp_label = get_internal_un_nh_stack_top_label(new_nexthop);
 
             /*Now install it in inet.3 table*/
             rc = inet_3_rt_un_route_install_nexthop(inet_3_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -252,6 +249,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
             }
         }
         next_node = new_nexthop->nh_node;
+        free_un_nexthop(new_nexthop);
     }
     else{
         /*Request RSVP label from proxy_nbr for edgress_lsr_rtr_id*/
@@ -266,7 +264,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
 
         ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
             nexthop = glthread_to_unified_nh(curr);
-            if(nexthop->oif == oif && !strncpy(nexthop->gw_prefix, gw_ip, PREFIX_LEN) &&
+            if(nexthop->oif == oif && is_un_next_hop_gw_pfx_equal(nexthop, gw_ip) &&
                     nexthop->protocol == RSVP_PROTO){
                 assert(nexthop->nh_node == proxy_nbr);
                 is_exist = TRUE;
@@ -276,12 +274,12 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
 
         if(is_exist){
             next_node = nexthop->nh_node;
-            outgoing_rsvp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+            outgoing_rsvp_label = get_internal_un_nh_stack_top_label(nexthop);
 
             /*collect RSVP data*/
             rsvp_tunnel_data->physical_oif = nexthop->oif;
-            strncpy(rsvp_tunnel_data->gateway, nexthop->gw_prefix, PREFIX_LEN);
-            rsvp_tunnel_data->rsvp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+            strncpy(rsvp_tunnel_data->gateway, get_un_next_hop_gateway_pfx(nexthop, gw_prefix), PREFIX_LEN);
+            rsvp_tunnel_data->rsvp_label = get_internal_un_nh_stack_top_label(nexthop);
             goto NEXT_NODE;
         }
 
@@ -297,9 +295,8 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
         new_nexthop->protocol = RSVP_PROTO;
         new_nexthop->oif = oif;
         new_nexthop->nh_node = proxy_nbr;
-        strncpy(new_nexthop->gw_prefix, gw_ip, PREFIX_LEN);
-        new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_rsvp_label;
-        new_nexthop->nh.inet3_nh.stack_op[0] = PUSH;
+        set_un_next_hop_gw_pfx(new_nexthop, gw_ip);
+        set_internal_un_nh_label_op(new_nexthop, PUSH, outgoing_rsvp_label);
         SET_BIT(new_nexthop->flags, PRIMARY_NH);
         SET_BIT(new_nexthop->flags, IPV4_RSVP_NH);
         new_nexthop->ref_count = 0;
@@ -311,12 +308,11 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
         new_nexthop->root_metric = 0;
         new_nexthop->dest_metric = 0;
         time(&new_nexthop->last_refresh_time);
-        init_glthread(&new_nexthop->glthread);
             
         /*collect RSVP data*/
         rsvp_tunnel_data->physical_oif = new_nexthop->oif;
-        strncpy(rsvp_tunnel_data->gateway, new_nexthop->gw_prefix, PREFIX_LEN);
-        rsvp_tunnel_data->rsvp_label = new_nexthop->nh.inet3_nh.mpls_label_out[0];
+        strncpy(rsvp_tunnel_data->gateway, get_un_next_hop_gateway_pfx(new_nexthop, gw_prefix), PREFIX_LEN);
+        rsvp_tunnel_data->rsvp_label = get_internal_un_nh_stack_top_label(new_nexthop);
 
         /*Now install it in inet.3 table*/
         rc = inet_3_rt_un_route_install_nexthop(inet_3_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -326,6 +322,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
             return -1;
         }
         next_node = new_nexthop->nh_node;
+        free_un_nexthop(new_nexthop);
     }
 
 NEXT_NODE:
@@ -373,8 +370,7 @@ NEXT_NODE:
             }
 
             new_nexthop->protocol = RSVP_PROTO;
-            new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_rsvp_label;
-            new_nexthop->nh.inet3_nh.stack_op[0] = SWAP;
+            set_internal_un_nh_label_op(new_nexthop, SWAP, outgoing_rsvp_label);
             new_nexthop->flags = 0;
             SET_BIT(new_nexthop->flags, PRIMARY_NH);
             SET_BIT(new_nexthop->flags, RSVP_TRANSIT_NH);
@@ -386,11 +382,10 @@ NEXT_NODE:
             new_nexthop->root_metric = 0;
             new_nexthop->dest_metric = 0;
             time(&new_nexthop->last_refresh_time);
-            init_glthread(&new_nexthop->glthread);
             
             /*collect RSVP data*/
             rsvp_tunnel_data->physical_oif = new_nexthop->oif;
-            strncpy(rsvp_tunnel_data->gateway, new_nexthop->gw_prefix, PREFIX_LEN);
+            strncpy(rsvp_tunnel_data->gateway, get_un_next_hop_gateway_pfx(new_nexthop, gw_prefix), PREFIX_LEN);
 
             /*Now install it in inet.3 table*/
             rc = mpls_0_rt_un_route_install_nexthop(mpls_0_rib, &inet_key, rt_un_entry->level, new_nexthop);
@@ -401,6 +396,7 @@ NEXT_NODE:
                 return -1;
             }
             next_node = new_nexthop->nh_node;
+            free_un_nexthop(new_nexthop);
         }
         else{
             nexthop = GET_FIRST_NH(rt_un_entry, RSVP_TRANSIT_NH, PRIMARY_NH);
@@ -438,8 +434,7 @@ NEXT_NODE:
                 }
 
                 new_nexthop->protocol = RSVP_PROTO;
-                new_nexthop->nh.inet3_nh.mpls_label_out[0] = outgoing_rsvp_label;
-                new_nexthop->nh.inet3_nh.stack_op[0] = SWAP;
+                set_internal_un_nh_label_op(new_nexthop, SWAP, outgoing_rsvp_label);
                 new_nexthop->flags = 0;
                 SET_BIT(new_nexthop->flags, PRIMARY_NH);
                 SET_BIT(new_nexthop->flags, RSVP_TRANSIT_NH);
@@ -451,7 +446,6 @@ NEXT_NODE:
                 new_nexthop->root_metric = 0;
                 new_nexthop->dest_metric = 0;
                 time(&new_nexthop->last_refresh_time);
-                init_glthread(&new_nexthop->glthread);
 
 
                 /*Now install it in mpls.0 table*/
@@ -463,11 +457,12 @@ NEXT_NODE:
                 }
 
                 next_node = new_nexthop->nh_node;
+                free_un_nexthop(new_nexthop);
             }
             else{
                 printf("RSVP transit nexthop already exists on node %s for %s/32\n",
                         next_node->node_name, edgress_lsr_rtr_id);
-                outgoing_rsvp_label = nexthop->nh.inet3_nh.mpls_label_out[0];
+                outgoing_rsvp_label = get_internal_un_nh_stack_top_label(nexthop);
                 next_node = nexthop->nh_node;
             }
         }
@@ -482,8 +477,7 @@ NEXT_NODE:
 
         new_nexthop = malloc_un_nexthop();
         new_nexthop->protocol = RSVP_PROTO;
-        new_nexthop->nh.inet3_nh.mpls_label_out[0] = 0;
-        new_nexthop->nh.inet3_nh.stack_op[0] = POP;
+        set_internal_un_nh_label_op(new_nexthop, POP, 0);
         new_nexthop->flags = 0;
         SET_BIT(new_nexthop->flags, PRIMARY_NH);
         SET_BIT(new_nexthop->flags, RSVP_TRANSIT_NH);
@@ -495,7 +489,6 @@ NEXT_NODE:
         new_nexthop->root_metric = 0;
         new_nexthop->dest_metric = 0;
         time(&new_nexthop->last_refresh_time);
-        init_glthread(&new_nexthop->glthread);
 
         /*Now install it in inet.3 table*/
         rc = mpls_0_rt_un_route_install_nexthop(mpls_0_rib, &inet_key, LEVEL1/*dont matter*/, new_nexthop);
@@ -507,6 +500,7 @@ NEXT_NODE:
         }
         printf("Installed transit RSVP nexthop for route %s on node %s\n", edgress_lsr_rtr_id,
                 next_node->node_name);
+        free_un_nexthop(new_nexthop);
     }
     else{
         printf("RSVP local route already exists on egress lsr node %s for route %s/32\n",
@@ -521,18 +515,81 @@ init_rsvp_config(rsvp_config_t *rsvp_config){
 
     rsvp_config->is_enabled = FALSE;
     init_glthread(&rsvp_config->lspdb);
+    rsvp_config->n_lsps = 0;
+    rsvp_config->n_buckets = 0;
+    rsvp_config->name_bucket = NULL;
+    rsvp_config->egress_bucket = NULL;
+    rsvp_config->oif_bucket = NULL;
+}
+
+/*FNV-1a*/
+static unsigned int
+rsvp_lsp_name_hash(char *lsp_name){
+
+    unsigned int i = 0, hash = 2166136261U;
+
+    for(i = 0; i < RSVP_LSP_NAME_SIZE && lsp_name[i]; i++){
+        hash ^= (unsigned char)lsp_name[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static void
+rsvp_lspdb_link_lsp(rsvp_config_t *rsvp_config, rsvp_tunnel_t *rsvp_tunnel){
+
+    unsigned int bucket = rsvp_tunnel->name_hash & (rsvp_config->n_buckets - 1);
+
+    rsvp_tunnel->name_next = rsvp_config->name_bucket[bucket];
+    rsvp_config->name_bucket[bucket] = rsvp_tunnel;
+
+    rsvp_tunnel->indexed_egress_lsr = rsvp_tunnel->egress_lsr;
+    bucket = rsvp_lspdb_ptr_hash(rsvp_config, rsvp_tunnel->indexed_egress_lsr);
+    rsvp_tunnel->egress_next = rsvp_config->egress_bucket[bucket];
+    rsvp_config->egress_bucket[bucket] = rsvp_tunnel;
+
+    rsvp_tunnel->indexed_oif = rsvp_tunnel->physical_oif;
+    bucket = rsvp_lspdb_ptr_hash(rsvp_config, rsvp_tunnel->indexed_oif);
+    rsvp_tunnel->oif_next = rsvp_config->oif_bucket[bucket];
+    rsvp_config->oif_bucket[bucket] = rsvp_tunnel;
 }
 
+/*Allocate the indices with n_buckets and link all LSPs of lspdb into them*/
+static void
+rsvp_lspdb_rehash(rsvp_config_t *rsvp_config, unsigned int n_buckets){
+
+    glthread_t *curr = NULL;
+
+    free(rsvp_config->name_bucket);
+    free(rsvp_config->egress_bucket);
+    free(rsvp_config->oif_bucket);
+    rsvp_config->n_buckets = n_buckets;
+    rsvp_config->name_bucket = calloc(n_buckets, sizeof(rsvp_tunnel_t *));
+    rsvp_config->egress_bucket = calloc(n_buckets, sizeof(rsvp_tunnel_t *));
+    rsvp_config->oif_bucket = calloc(n_buckets, sizeof(rsvp_tunnel_t *));
+
+    ITERATE_GLTHREAD_BEGIN(&rsvp_config->lspdb, curr){
+        rsvp_lspdb_link_lsp(rsvp_config, glthread_to_rsvp_tunnel(curr));
+    } ITERATE_GLTHREAD_END(&rsvp_config->lspdb, curr);
+}
 
 rsvp_tunnel_t *
 look_up_rsvp_tunnel(node_t *node, char *lsp_name){
 
-    glthread_t *curr = NULL;
-    ITERATE_GLTHREAD_BEGIN(&node->rsvp_config.lspdb, curr){
-        rsvp_tunnel_t *rsvpt = glthread_to_rsvp_tunnel(curr);
-        if(strncmp(rsvpt->lsp_name, lsp_name, RSVP_LSP_NAME_SIZE) == 0)
+    rsvp_config_t *rsvp_config = &node->rsvp_config;
+    rsvp_tunnel_t *rsvpt = NULL;
+    unsigned int hash = 0;
+
+    if(!rsvp_config->n_buckets)
+        return NULL;
+
+    hash = rsvp_lsp_name_hash(lsp_name);
+    for(rsvpt = rsvp_config->name_bucket[hash & (rsvp_config->n_buckets - 1)];
+        rsvpt; rsvpt = rsvpt->name_next){
+        if(rsvpt->name_hash == hash &&
+            strncmp(rsvpt->lsp_name, lsp_name, RSVP_LSP_NAME_SIZE) == 0)
             return rsvpt;
-    } ITERATE_GLTHREAD_END(&node->rsvp_config.lspdb, curr);
+    }
     return NULL;
 }
 
@@ -540,6 +597,8 @@ look_up_rsvp_tunnel(node_t *node, char *lsp_name){
 int
 add_new_rsvp_tunnel(node_t *node, rsvp_tunnel_t *rsvp_tunnel){
 
+  rsvp_config_t *rsvp_config = &node->rsvp_config;
+
   init_glthread(&rsvp_tunnel->glthread);
 
   rsvp_tunnel_t *rsvpt = look_up_rsvp_tunnel(node, rsvp_tunnel->lsp_name);
@@ -547,17 +606,81 @@ add_new_rsvp_tunnel(node_t *node, rsvp_tunnel_t *rsvp_tunnel){
     printf("Error : RSVP tunnel %s already exists\n", rsvp_tunnel->lsp_name);
     return -1;
   }
-  glthread_add_next(&node->rsvp_config.lspdb, &rsvp_tunnel->glthread);
+  rsvp_tunnel->name_hash = rsvp_lsp_name_hash(rsvp_tunnel->lsp_name);
+  glthread_add_next(&rsvp_config->lspdb, &rsvp_tunnel->glthread);
+  rsvp_config->n_lsps++;
+
+  /*Keep the chains short, rehash links the new LSP too*/
+  if(!rsvp_config->n_buckets)
+    rsvp_lspdb_rehash(rsvp_config, RSVP_LSPDB_INIT_BUCKETS);
+  else if(rsvp_config->n_lsps >= (rsvp_config->n_buckets << 1))
+    rsvp_lspdb_rehash(rsvp_config, rsvp_config->n_buckets << 1);
+  else
+    rsvp_lspdb_link_lsp(rsvp_config, rsvp_tunnel);
   return 0;
 }
 
+void
+rsvp_lspdb_reindex_lsp(node_t *node, rsvp_tunnel_t *rsvp_tunnel){
+
+    rsvp_config_t *rsvp_config = &node->rsvp_config;
+    rsvp_tunnel_t **pprev = NULL;
+    unsigned int bucket = 0;
+
+    if(!rsvp_config->n_buckets)
+        return;
+
+    if(rsvp_tunnel->indexed_egress_lsr != rsvp_tunnel->egress_lsr){
+        bucket = rsvp_lspdb_ptr_hash(rsvp_config, rsvp_tunnel->indexed_egress_lsr);
+        for(pprev = &rsvp_config->egress_bucket[bucket]; *pprev; pprev = &(*pprev)->egress_next){
+            if(*pprev != rsvp_tunnel) continue;
+            *pprev = rsvp_tunnel->egress_next;
+            break;
+        }
+        rsvp_tunnel->indexed_egress_lsr = rsvp_tunnel->egress_lsr;
+        bucket = rsvp_lspdb_ptr_hash(rsvp_config, rsvp_tunnel->indexed_egress_lsr);
+        rsvp_tunnel->egress_next = rsvp_config->egress_bucket[bucket];
+        rsvp_config->egress_bucket[bucket] = rsvp_tunnel;
+    }
+
+    if(rsvp_tunnel->indexed_oif != rsvp_tunnel->physical_oif){
+        bucket = rsvp_lspdb_ptr_hash(rsvp_config, rsvp_tunnel->indexed_oif);
+        for(pprev = &rsvp_config->oif_bucket[bucket]; *pprev; pprev = &(*pprev)->oif_next){
+            if(*pprev != rsvp_tunnel) continue;
+            *pprev = rsvp_tunnel->oif_next;
+            break;
+        }
+        rsvp_tunnel->indexed_oif = rsvp_tunnel->physical_oif;
+        bucket = rsvp_lspdb_ptr_hash(rsvp_config, rsvp_tunnel->indexed_oif);
+        rsvp_tunnel->oif_next = rsvp_config->oif_bucket[bucket];
+        rsvp_config->oif_bucket[bucket] = rsvp_tunnel;
+    }
+}
+
 void
 print_rsvp_tunnel_info(rsvp_tunnel_t *rsvp_tunnel){
 
+    unsigned int i = 0;
+
     printf("lsp name : %s\n", rsvp_tunnel->lsp_name);
     printf("oif = %s, gw : %s, egress_lsr : %s, label : %u\n", 
-        rsvp_tunnel->physical_oif->intf_name, rsvp_tunnel->gateway,
-        rsvp_tunnel->egress_lsr->node_name, rsvp_tunnel->rsvp_label);
+        rsvp_tunnel->physical_oif ? rsvp_tunnel->physical_oif->intf_name : "Nil",
+        rsvp_tunnel->gateway,
+        rsvp_tunnel->egress_lsr ? rsvp_tunnel->egress_lsr->node_name : "Nil",
+        rsvp_tunnel->rsvp_label);
+    printf("bandwidth : %u Mbps, exclude-any : 0x%x, include-any : 0x%x\n",
+        rsvp_tunnel->bandwidth, rsvp_tunnel->exclude_any, rsvp_tunnel->include_any);
+
+    if(!rsvp_tunnel->cspf_placed){
+        printf("CSPF : not placed\n");
+        return;
+    }
+    printf("CSPF : L%u, cost %u, ERO : ", rsvp_tunnel->cspf_level, rsvp_tunnel->cspf_cost);
+    for(i = 0; i < rsvp_tunnel->n_ero; i++){
+        printf("%s(%s) -> ", rsvp_tunnel->ero[i]->from.node->node_name,
+            rsvp_tunnel->ero[i]->from.intf_name);
+    }
+    printf("%s\n", rsvp_tunnel->ero[rsvp_tunnel->n_ero - 1]->to.node->node_name);
 }
 
 void
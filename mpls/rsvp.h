@@ -39,9 +39,14 @@
 #define RSVP_LABEL_RANGE_MIN     300000
 #define RSVP_LABEL_RANGE_MAX     500000
 #define RSVP_LSP_NAME_SIZE       32
+/*Max no of links in explicit route of an LSP*/
+#define RSVP_MAX_ERO_HOPS        32
+/*Initial no of buckets of LSP DB indices, must be power of 2*/
+#define RSVP_LSPDB_INIT_BUCKETS  16
 
 typedef struct _node_t node_t;
 typedef struct edge_end_ edge_end_t;
+typedef struct _edge_t edge_t;
 
 typedef struct rsvp_tunnel_{
 
@@ -50,6 +55,23 @@ typedef struct rsvp_tunnel_{
     char gateway[PREFIX_LEN];
     node_t *egress_lsr;
     mpls_label_t rsvp_label;
+    /*TE constraints*/
+    unsigned int bandwidth;     /*Mbps, 0 if not configured*/
+    unsigned int exclude_any;   /*affinity bits*/
+    unsigned int include_any;
+    /*Path computed by CSPF, bandwidth is reserved on all links of ERO*/
+    boolean cspf_placed;
+    LEVEL cspf_level;
+    unsigned int cspf_cost;
+    unsigned int n_ero;
+    edge_t *ero[RSVP_MAX_ERO_HOPS];
+    /*LSP DB indices, keys are the ones LSP is currently indexed with*/
+    unsigned int name_hash;
+    node_t *indexed_egress_lsr;
+    edge_end_t *indexed_oif;
+    struct rsvp_tunnel_ *name_next;     /*hash bucket chains*/
+    struct rsvp_tunnel_ *egress_next;
+    struct rsvp_tunnel_ *oif_next;
     glthread_t glthread;
 } rsvp_tunnel_t;
 
@@ -59,12 +81,53 @@ void
 print_rsvp_tunnel_info(rsvp_tunnel_t *rsvp_tunnel);
 
 
+/*LSP DB of ingress LSR. lspdb list keeps the LSPs in order of configuration,
+ * LSPs are hash indexed by name, and secondary indexed by egress LSR and by
+ * physical oif. All indices have same no of buckets, allocated on first LSP*/
 typedef struct _rsvp_config_{
     
     boolean is_enabled; /*Is RSVP enabled on the node*/
     glthread_t lspdb;
+    unsigned int n_lsps;
+    unsigned int n_buckets;
+    rsvp_tunnel_t **name_bucket;
+    rsvp_tunnel_t **egress_bucket;
+    rsvp_tunnel_t **oif_bucket;
 } rsvp_config_t;
 
+static inline unsigned int
+rsvp_lspdb_ptr_hash(rsvp_config_t *rsvp_config, void *ptr){
+
+    return ((unsigned int)((unsigned long)ptr >> 3) * 2654435761U) &
+            (rsvp_config->n_buckets - 1);
+}
+
+/*Iterate over the LSPs of ingress LSR going to egress LSR*/
+#define ITERATE_RSVP_LSP_BY_EGRESS_BEGIN(rsvp_config_ptr, egress_lsr_ptr, rsvp_tunnel_ptr)   \
+{                                                                                           \
+    rsvp_tunnel_t *_next_lsp = NULL;                                                        \
+    if((rsvp_config_ptr)->n_buckets){                                                       \
+        for(rsvp_tunnel_ptr = (rsvp_config_ptr)->egress_bucket[                             \
+                rsvp_lspdb_ptr_hash(rsvp_config_ptr, egress_lsr_ptr)];                      \
+            rsvp_tunnel_ptr; rsvp_tunnel_ptr = _next_lsp){                                  \
+            _next_lsp = rsvp_tunnel_ptr->egress_next;                                       \
+            if(rsvp_tunnel_ptr->indexed_egress_lsr != (egress_lsr_ptr)) continue;
+
+#define ITERATE_RSVP_LSP_BY_EGRESS_END   }}}
+
+/*Iterate over the LSPs of ingress LSR going out of physical oif*/
+#define ITERATE_RSVP_LSP_BY_OIF_BEGIN(rsvp_config_ptr, oif_ptr, rsvp_tunnel_ptr)             \
+{                                                                                           \
+    rsvp_tunnel_t *_next_lsp = NULL;                                                        \
+    if((rsvp_config_ptr)->n_buckets){                                                       \
+        for(rsvp_tunnel_ptr = (rsvp_config_ptr)->oif_bucket[                                \
+                rsvp_lspdb_ptr_hash(rsvp_config_ptr, oif_ptr)];                             \
+            rsvp_tunnel_ptr; rsvp_tunnel_ptr = _next_lsp){                                  \
+            _next_lsp = rsvp_tunnel_ptr->oif_next;                                          \
+            if(rsvp_tunnel_ptr->indexed_oif != (oif_ptr)) continue;
+
+#define ITERATE_RSVP_LSP_BY_OIF_END   }}}
+
 void
 init_rsvp_config(rsvp_config_t *rsvp_config);
 
@@ -88,6 +151,10 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr, /*Ingress LSR*/
 int
 add_new_rsvp_tunnel(node_t *node, rsvp_tunnel_t *rsvp_tunnel);
 
+/*Egress LSR or physical oif of LSP changed, move it in secondary indices*/
+void
+rsvp_lspdb_reindex_lsp(node_t *node, rsvp_tunnel_t *rsvp_tunnel);
+
 rsvp_tunnel_t *
 look_up_rsvp_tunnel(node_t *node, char *lsp_name);
 
@@ -0,0 +1,673 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rsvp_cspf.c
+ *
+ *    Description:  This file implements the constrained SPF (CSPF) for RSVP-TE LSPs
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include "rsvp_cspf.h"
+#include "instance.h"
+#include "spfutil.h"
+
+extern instance_t *instance;
+
+typedef struct rsvp_cspf_adj_{
+
+    edge_t *edge;
+    unsigned int nbr;       /*index of nbr node*/
+} rsvp_cspf_adj_t;
+
+typedef struct rsvp_cspf_heap_entry_{
+
+    unsigned long long metric;
+    unsigned int node;
+} rsvp_cspf_heap_entry_t;
+
+/*Index of the TE topology of a level, built once and shared by all
+ * the LSPs placed in a batch. Reservations are not part of the index,
+ * they are read from links as LSPs get placed*/
+typedef struct rsvp_cspf_topo_{
+
+    boolean is_built;
+    LEVEL level;
+    unsigned int n_nodes;
+    node_t **nodes;             /*sorted by address*/
+    unsigned int *adj_offset;   /*adjacencies of node i are [adj_offset[i], adj_offset[i+1])*/
+    unsigned int n_adj;
+    rsvp_cspf_adj_t *adj;
+    /*State of CSPF run, reused by all runs over the topology*/
+    unsigned long long *metric;
+    unsigned int *pred;         /*adjacency via which node is reached*/
+    unsigned int *pred_node;    /*node from which node is reached*/
+    char *done;
+    rsvp_cspf_heap_entry_t *heap;
+    unsigned int heap_size;
+} rsvp_cspf_topo_t;
+
+/*LSP to be placed in a batch*/
+typedef struct rsvp_cspf_lsp_ref_{
+
+    node_t *ingress_lsr;
+    rsvp_tunnel_t *rsvp_tunnel;
+    unsigned int seq_no;        /*order of configuration*/
+} rsvp_cspf_lsp_ref_t;
+
+/*Path computed by CSPF, not yet reserved*/
+typedef struct rsvp_cspf_path_{
+
+    LEVEL level;
+    unsigned int cost;
+    unsigned int n_ero;
+    edge_t *ero[RSVP_MAX_ERO_HOPS];
+} rsvp_cspf_path_t;
+
+/*Pseudonodes do not run RSVP, they are transit for LSPs of LAN routers*/
+#define RSVP_CSPF_IS_NODE_TE(node_ptr, _level)                           \
+    ((node_ptr)->node_type[_level] == PSEUDONODE ||                      \
+     (node_ptr)->rsvp_config.is_enabled)
+
+/*Only unicast links are TE links, forwarding adjacencies are not*/
+#define RSVP_CSPF_IS_EDGE_USABLE(edge_ptr, _level)                       \
+    ((edge_ptr)->status && (edge_ptr)->etype == UNICAST &&               \
+     IS_LEVEL_SET((edge_ptr)->level, _level) &&                          \
+     RSVP_CSPF_IS_NODE_TE((edge_ptr)->from.node, _level) &&              \
+     RSVP_CSPF_IS_NODE_TE((edge_ptr)->to.node, _level))
+
+/*edge_t->bandwidth is in GIG*/
+static unsigned int
+rsvp_cspf_link_capacity(edge_t *edge){
+
+    return (unsigned int)(edge->bandwidth * 1000);
+}
+
+static int
+rsvp_cspf_node_ptr_comparison_fn(const void *p1, const void *p2){
+
+    node_t *node1 = *(node_t **)p1,
+           *node2 = *(node_t **)p2;
+
+    if(node1 < node2) return -1;
+    if(node1 > node2) return 1;
+    return 0;
+}
+
+static unsigned int
+rsvp_cspf_node_index(rsvp_cspf_topo_t *topo, node_t *node){
+
+    node_t **res = bsearch(&node, topo->nodes, topo->n_nodes,
+                    sizeof(node_t *), rsvp_cspf_node_ptr_comparison_fn);
+
+    return res ? (unsigned int)(res - topo->nodes) : topo->n_nodes;
+}
+
+static void
+rsvp_cspf_build_topo(rsvp_cspf_topo_t *topo, LEVEL level){
+
+    unsigned int i = 0, j = 0,
+                 n_adj = 0, nbr = 0;
+    singly_ll_node_t *list_node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+    node_t *node = NULL;
+
+    memset(topo, 0, sizeof(rsvp_cspf_topo_t));
+    topo->is_built = TRUE;
+    topo->level = level;
+    topo->n_nodes = GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list);
+    topo->nodes = calloc(topo->n_nodes ? topo->n_nodes : 1, sizeof(node_t *));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        topo->nodes[i++] = list_node->data;
+    } ITERATE_LIST_END;
+
+    qsort(topo->nodes, topo->n_nodes, sizeof(node_t *),
+            rsvp_cspf_node_ptr_comparison_fn);
+
+    /*Pass 1 : count, Pass 2 : fill*/
+    for(i = 0; i < topo->n_nodes; i++){
+        node = topo->nodes[i];
+        for(j = 0; j < MAX_NODE_INTF_SLOTS; j++){
+            edge_end = node->edges[j];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+            if(RSVP_CSPF_IS_EDGE_USABLE(edge, level))
+                n_adj++;
+        }
+    }
+
+    topo->adj_offset = calloc(topo->n_nodes + 1, sizeof(unsigned int));
+    topo->adj = calloc(n_adj ? n_adj : 1, sizeof(rsvp_cspf_adj_t));
+
+    for(i = 0; i < topo->n_nodes; i++){
+        node = topo->nodes[i];
+        topo->adj_offset[i] = topo->n_adj;
+        for(j = 0; j < MAX_NODE_INTF_SLOTS; j++){
+            edge_end = node->edges[j];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+            if(!RSVP_CSPF_IS_EDGE_USABLE(edge, level))
+                continue;
+            nbr = rsvp_cspf_node_index(topo, edge->to.node);
+            if(nbr == topo->n_nodes)
+                continue;
+            topo->adj[topo->n_adj].edge = edge;
+            topo->adj[topo->n_adj].nbr = nbr;
+            topo->n_adj++;
+        }
+    }
+    topo->adj_offset[topo->n_nodes] = topo->n_adj;
+
+    topo->metric = calloc(topo->n_nodes ? topo->n_nodes : 1, sizeof(unsigned long long));
+    topo->pred = calloc(topo->n_nodes ? topo->n_nodes : 1, sizeof(unsigned int));
+    topo->pred_node = calloc(topo->n_nodes ? topo->n_nodes : 1, sizeof(unsigned int));
+    topo->done = calloc(topo->n_nodes ? topo->n_nodes : 1, sizeof(char));
+    /*Lazy deletion, one heap entry per relaxation at the most*/
+    topo->heap = calloc(topo->n_adj + 1, sizeof(rsvp_cspf_heap_entry_t));
+}
+
+static void
+rsvp_cspf_free_topo(rsvp_cspf_topo_t *topo){
+
+    if(!topo->is_built)
+        return;
+    free(topo->nodes);
+    free(topo->adj_offset);
+    free(topo->adj);
+    free(topo->metric);
+    free(topo->pred);
+    free(topo->pred_node);
+    free(topo->done);
+    free(topo->heap);
+    memset(topo, 0, sizeof(rsvp_cspf_topo_t));
+}
+
+static boolean
+rsvp_cspf_is_link_eligible(rsvp_cspf_topo_t *topo, unsigned int src,
+                           edge_t *edge, rsvp_tunnel_t *rsvp_tunnel){
+
+    if((unsigned long long)edge->rsvp_reserved_bw + rsvp_tunnel->bandwidth >
+            rsvp_cspf_link_capacity(edge))
+        return FALSE;
+
+    /*Links of pseudonode carry no attributes*/
+    if(topo->nodes[src]->node_type[topo->level] == PSEUDONODE)
+        return TRUE;
+
+    if(edge->affinity & rsvp_tunnel->exclude_any)
+        return FALSE;
+    if(rsvp_tunnel->include_any && !(edge->affinity & rsvp_tunnel->include_any))
+        return FALSE;
+    return TRUE;
+}
+
+static unsigned int
+rsvp_cspf_link_metric(rsvp_cspf_topo_t *topo, unsigned int src, edge_t *edge){
+
+    if(edge->te_metric &&
+        topo->nodes[src]->node_type[topo->level] != PSEUDONODE)
+        return edge->te_metric;
+    return edge->metric[topo->level];
+}
+
+static void
+rsvp_cspf_heap_push(rsvp_cspf_topo_t *topo, unsigned long long metric, unsigned int node){
+
+    unsigned int i = topo->heap_size++, parent = 0;
+    rsvp_cspf_heap_entry_t entry = {metric, node};
+
+    while(i){
+        parent = (i - 1) >> 1;
+        if(topo->heap[parent].metric <= metric)
+            break;
+        topo->heap[i] = topo->heap[parent];
+        i = parent;
+    }
+    topo->heap[i] = entry;
+}
+
+static rsvp_cspf_heap_entry_t
+rsvp_cspf_heap_pop(rsvp_cspf_topo_t *topo){
+
+    rsvp_cspf_heap_entry_t top = topo->heap[0],
+                           last = topo->heap[--topo->heap_size];
+    unsigned int i = 0, child = 0;
+
+    while((child = (i << 1) + 1) < topo->heap_size){
+        if(child + 1 < topo->heap_size &&
+            topo->heap[child + 1].metric < topo->heap[child].metric)
+            child++;
+        if(last.metric <= topo->heap[child].metric)
+            break;
+        topo->heap[i] = topo->heap[child];
+        i = child;
+    }
+    topo->heap[i] = last;
+    return top;
+}
+
+/*Dijkstra from src which stops as soon as dst is settled. Returns TRUE
+ * if dst is reachable over the links eligible for the LSP*/
+static boolean
+rsvp_cspf_dijkstra(rsvp_cspf_topo_t *topo, unsigned int src,
+                   unsigned int dst, rsvp_tunnel_t *rsvp_tunnel){
+
+    unsigned int i = 0, adj = 0, nbr = 0;
+    unsigned long long metric = 0;
+    rsvp_cspf_heap_entry_t top;
+    node_t *node = NULL;
+    edge_t *edge = NULL;
+
+    for(i = 0; i < topo->n_nodes; i++){
+        topo->metric[i] = INFINITE_METRIC;
+        topo->done[i] = 0;
+    }
+    topo->heap_size = 0;
+
+    topo->metric[src] = 0;
+    rsvp_cspf_heap_push(topo, 0, src);
+
+    while(topo->heap_size){
+        top = rsvp_cspf_heap_pop(topo);
+        if(topo->done[top.node] || top.metric != topo->metric[top.node])
+            continue;
+        topo->done[top.node] = 1;
+        if(top.node == dst)
+            return TRUE;
+        node = topo->nodes[top.node];
+
+        /*Overloaded routers are not used for transit*/
+        if(top.node != src && IS_OVERLOADED(node, topo->level))
+            continue;
+
+        for(adj = topo->adj_offset[top.node]; adj < topo->adj_offset[top.node + 1]; adj++){
+            nbr = topo->adj[adj].nbr;
+            if(topo->done[nbr])
+                continue;
+            edge = topo->adj[adj].edge;
+            if(!rsvp_cspf_is_link_eligible(topo, top.node, edge, rsvp_tunnel))
+                continue;
+            metric = top.metric + rsvp_cspf_link_metric(topo, top.node, edge);
+            if(metric >= INFINITE_METRIC || metric >= topo->metric[nbr])
+                continue;
+            topo->metric[nbr] = metric;
+            topo->pred[nbr] = adj;
+            topo->pred_node[nbr] = top.node;
+            rsvp_cspf_heap_push(topo, metric, nbr);
+        }
+    }
+    return FALSE;
+}
+
+static rsvp_cspf_topo_t *
+rsvp_cspf_get_topo(rsvp_cspf_topo_t *topos, LEVEL level){
+
+    if(!topos[level].is_built)
+        rsvp_cspf_build_topo(&topos[level], level);
+    return &topos[level];
+}
+
+/*Compute the path of LSP, level 1 topology is preferred*/
+static boolean
+rsvp_cspf_compute(rsvp_cspf_topo_t *topos, node_t *ingress_lsr,
+                  rsvp_tunnel_t *rsvp_tunnel, rsvp_cspf_path_t *path){
+
+    LEVEL level_it;
+    rsvp_cspf_topo_t *topo = NULL;
+    unsigned int src = 0, dst = 0,
+                 node = 0, n_ero = 0;
+
+    if(!rsvp_tunnel->egress_lsr || ingress_lsr == rsvp_tunnel->egress_lsr)
+        return FALSE;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        topo = rsvp_cspf_get_topo(topos, level_it);
+        src = rsvp_cspf_node_index(topo, ingress_lsr);
+        dst = rsvp_cspf_node_index(topo, rsvp_tunnel->egress_lsr);
+        if(src == topo->n_nodes || dst == topo->n_nodes)
+            continue;
+        if(!rsvp_cspf_dijkstra(topo, src, dst, rsvp_tunnel))
+            continue;
+
+        /*No of links in the path*/
+        n_ero = 0;
+        for(node = dst; node != src; node = topo->pred_node[node])
+            n_ero++;
+
+        if(n_ero > RSVP_MAX_ERO_HOPS){
+            printf("Error : LSP %s path has %u hops, max supported is %u\n",
+                rsvp_tunnel->lsp_name, n_ero, RSVP_MAX_ERO_HOPS);
+            continue;
+        }
+
+        path->level = level_it;
+        path->cost = (unsigned int)topo->metric[dst];
+        path->n_ero = n_ero;
+        for(node = dst; node != src; node = topo->pred_node[node])
+            path->ero[--n_ero] = topo->adj[topo->pred[node]].edge;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+rsvp_cspf_reserve(rsvp_tunnel_t *rsvp_tunnel){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < rsvp_tunnel->n_ero; i++)
+        rsvp_tunnel->ero[i]->rsvp_reserved_bw += rsvp_tunnel->bandwidth;
+}
+
+/*Reserve bandwidth over the path and record it as the ERO of LSP. The
+ * signalled state (oif, gateway, label) is left as RSVP installed it*/
+static void
+rsvp_cspf_commit(rsvp_tunnel_t *rsvp_tunnel, rsvp_cspf_path_t *path){
+
+    rsvp_tunnel->cspf_placed = TRUE;
+    rsvp_tunnel->cspf_level = path->level;
+    rsvp_tunnel->cspf_cost = path->cost;
+    rsvp_tunnel->n_ero = path->n_ero;
+    memcpy(rsvp_tunnel->ero, path->ero, path->n_ero * sizeof(edge_t *));
+    rsvp_cspf_reserve(rsvp_tunnel);
+}
+
+void
+rsvp_cspf_release_lsp(rsvp_tunnel_t *rsvp_tunnel){
+
+    unsigned int i = 0;
+    edge_t *edge = NULL;
+
+    for(i = 0; i < rsvp_tunnel->n_ero; i++){
+        edge = rsvp_tunnel->ero[i];
+        edge->rsvp_reserved_bw = edge->rsvp_reserved_bw > rsvp_tunnel->bandwidth ?
+                edge->rsvp_reserved_bw - rsvp_tunnel->bandwidth : 0;
+    }
+    rsvp_tunnel->cspf_placed = FALSE;
+    rsvp_tunnel->cspf_cost = 0;
+    rsvp_tunnel->n_ero = 0;
+}
+
+boolean
+rsvp_cspf_place_lsp(node_t *ingress_lsr, rsvp_tunnel_t *rsvp_tunnel){
+
+    LEVEL level_it;
+    boolean rc = FALSE;
+    rsvp_cspf_path_t path;
+    rsvp_cspf_topo_t topos[MAX_LEVEL];
+
+    memset(topos, 0, sizeof(topos));
+    rsvp_cspf_release_lsp(rsvp_tunnel);
+
+    rc = rsvp_cspf_compute(topos, ingress_lsr, rsvp_tunnel, &path);
+    if(rc)
+        rsvp_cspf_commit(rsvp_tunnel, &path);
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++)
+        rsvp_cspf_free_topo(&topos[level_it]);
+    return rc;
+}
+
+static int
+rsvp_cspf_lsp_ref_bw_comparison_fn(const void *p1, const void *p2){
+
+    rsvp_cspf_lsp_ref_t *ref1 = (rsvp_cspf_lsp_ref_t *)p1,
+                        *ref2 = (rsvp_cspf_lsp_ref_t *)p2;
+
+    if(ref1->rsvp_tunnel->bandwidth > ref2->rsvp_tunnel->bandwidth) return -1;
+    if(ref1->rsvp_tunnel->bandwidth < ref2->rsvp_tunnel->bandwidth) return 1;
+    /*Keep configuration order among equal LSPs*/
+    if(ref1->seq_no < ref2->seq_no) return -1;
+    if(ref1->seq_no > ref2->seq_no) return 1;
+    return 0;
+}
+
+/*Returns the array of all the LSPs in the network in given order*/
+static rsvp_cspf_lsp_ref_t *
+rsvp_cspf_collect_lsps(instance_t *instance, rsvp_cspf_order_t order,
+                       unsigned int *n_lsps){
+
+    singly_ll_node_t *list_node = NULL;
+    glthread_t *curr = NULL;
+    node_t *node = NULL;
+    unsigned int n = 0, size = 64;
+    rsvp_cspf_lsp_ref_t *lsps = calloc(size, sizeof(rsvp_cspf_lsp_ref_t));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        ITERATE_GLTHREAD_BEGIN(&node->rsvp_config.lspdb, curr){
+            if(n == size){
+                size <<= 1;
+                lsps = realloc(lsps, size * sizeof(rsvp_cspf_lsp_ref_t));
+            }
+            lsps[n].ingress_lsr = node;
+            lsps[n].rsvp_tunnel = glthread_to_rsvp_tunnel(curr);
+            lsps[n].seq_no = n;
+            n++;
+        } ITERATE_GLTHREAD_END(&node->rsvp_config.lspdb, curr);
+    } ITERATE_LIST_END;
+
+    if(order == RSVP_CSPF_ORDER_BW_DESC)
+        qsort(lsps, n, sizeof(rsvp_cspf_lsp_ref_t), rsvp_cspf_lsp_ref_bw_comparison_fn);
+
+    *n_lsps = n;
+    return lsps;
+}
+
+void
+rsvp_cspf_place_all(instance_t *instance, rsvp_cspf_order_t order,
+                    rsvp_cspf_stats_t *stats){
+
+    unsigned int i = 0, j = 0, n_lsps = 0;
+    singly_ll_node_t *list_node = NULL;
+    node_t *node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+    rsvp_cspf_lsp_ref_t *lsps = NULL;
+    rsvp_cspf_topo_t topos[MAX_LEVEL];
+    rsvp_cspf_path_t path;
+    LEVEL level_it;
+    unsigned long long start_time = get_time_usec();
+
+    memset(stats, 0, sizeof(rsvp_cspf_stats_t));
+    memset(topos, 0, sizeof(topos));
+
+    lsps = rsvp_cspf_collect_lsps(instance, order, &n_lsps);
+    stats->n_lsps = n_lsps;
+    if(!n_lsps){
+        free(lsps);
+        return;
+    }
+
+    /*Start from clean reservations*/
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        for(j = 0; j < MAX_NODE_INTF_SLOTS; j++){
+            edge_end = node->edges[j];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+            edge->rsvp_reserved_bw = 0;
+        }
+    } ITERATE_LIST_END;
+
+    for(i = 0; i < n_lsps; i++){
+        lsps[i].rsvp_tunnel->cspf_placed = FALSE;
+        lsps[i].rsvp_tunnel->n_ero = 0;
+    }
+
+    for(i = 0; i < n_lsps; i++){
+        if(rsvp_cspf_compute(topos, lsps[i].ingress_lsr, lsps[i].rsvp_tunnel, &path)){
+            rsvp_cspf_commit(lsps[i].rsvp_tunnel, &path);
+            stats->n_placed++;
+        }
+        else{
+            lsps[i].rsvp_tunnel->cspf_cost = 0;
+            stats->n_failed++;
+        }
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++)
+        rsvp_cspf_free_topo(&topos[level_it]);
+    free(lsps);
+    stats->usec = get_time_usec() - start_time;
+}
+
+static boolean
+rsvp_cspf_is_path_intact(rsvp_tunnel_t *rsvp_tunnel){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < rsvp_tunnel->n_ero; i++){
+        if(!RSVP_CSPF_IS_EDGE_USABLE(rsvp_tunnel->ero[i], rsvp_tunnel->cspf_level))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+void
+rsvp_cspf_reoptimize(instance_t *instance, rsvp_cspf_stats_t *stats){
+
+    unsigned int i = 0, n_lsps = 0;
+    rsvp_cspf_lsp_ref_t *lsps = NULL;
+    rsvp_tunnel_t *rsvp_tunnel = NULL;
+    rsvp_cspf_topo_t topos[MAX_LEVEL];
+    rsvp_cspf_path_t path, old_path;
+    LEVEL level_it;
+    unsigned long long start_time = get_time_usec();
+
+    memset(stats, 0, sizeof(rsvp_cspf_stats_t));
+    memset(topos, 0, sizeof(topos));
+
+    lsps = rsvp_cspf_collect_lsps(instance, RSVP_CSPF_ORDER_BW_DESC, &n_lsps);
+    stats->n_lsps = n_lsps;
+    if(!n_lsps){
+        free(lsps);
+        return;
+    }
+
+    /*Release broken paths first so that their bandwidth is available
+     * to the LSPs re-placed below*/
+    for(i = 0; i < n_lsps; i++){
+        rsvp_tunnel = lsps[i].rsvp_tunnel;
+        if(!rsvp_tunnel->cspf_placed || rsvp_cspf_is_path_intact(rsvp_tunnel))
+            continue;
+        rsvp_cspf_release_lsp(rsvp_tunnel);
+        stats->n_evicted++;
+    }
+
+    for(i = 0; i < n_lsps; i++){
+        rsvp_tunnel = lsps[i].rsvp_tunnel;
+        if(!rsvp_tunnel->cspf_placed){
+            if(rsvp_cspf_compute(topos, lsps[i].ingress_lsr, rsvp_tunnel, &path)){
+                rsvp_cspf_commit(rsvp_tunnel, &path);
+                stats->n_placed++;
+            }
+            else
+                stats->n_failed++;
+            continue;
+        }
+
+        /*LSP may reuse its own bandwidth on the new path (make before
+         * break with shared explicit reservation), LSP stays on the current
+         * path unless new path is strictly cheaper*/
+        old_path.level = rsvp_tunnel->cspf_level;
+        old_path.cost = rsvp_tunnel->cspf_cost;
+        old_path.n_ero = rsvp_tunnel->n_ero;
+        memcpy(old_path.ero, rsvp_tunnel->ero, rsvp_tunnel->n_ero * sizeof(edge_t *));
+
+        rsvp_cspf_release_lsp(rsvp_tunnel);
+        if(rsvp_cspf_compute(topos, lsps[i].ingress_lsr, rsvp_tunnel, &path) &&
+            path.cost < old_path.cost){
+            rsvp_cspf_commit(rsvp_tunnel, &path);
+            stats->n_moved++;
+        }
+        else
+            rsvp_cspf_commit(rsvp_tunnel, &old_path);
+        stats->n_placed++;
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++)
+        rsvp_cspf_free_topo(&topos[level_it]);
+    free(lsps);
+    stats->usec = get_time_usec() - start_time;
+}
+
+unsigned int
+rsvp_cspf_reroute_oif_lsps(node_t *ingress_lsr, edge_end_t *oif){
+
+    unsigned int n = 0;
+    rsvp_tunnel_t *rsvp_tunnel = NULL;
+    glthread_t *curr = NULL;
+
+    ITERATE_GLTHREAD_BEGIN(&ingress_lsr->rsvp_config.lspdb, curr){
+        rsvp_tunnel = glthread_to_rsvp_tunnel(curr);
+        if(!rsvp_tunnel->cspf_placed || &rsvp_tunnel->ero[0]->from != oif)
+            continue;
+        n++;
+        if(!rsvp_cspf_place_lsp(ingress_lsr, rsvp_tunnel))
+            printf("CSPF : No path for LSP %s\n", rsvp_tunnel->lsp_name);
+    } ITERATE_GLTHREAD_END(&ingress_lsr->rsvp_config.lspdb, curr);
+    return n;
+}
+
+void
+print_rsvp_cspf_stats(char *op, rsvp_cspf_stats_t *stats){
+
+    printf("RSVP CSPF %s : LSPs = %u, placed = %u, failed = %u, moved = %u, "
+           "evicted = %u, time = %llu usec, LSPs/sec = %llu\n",
+           op, stats->n_lsps, stats->n_placed, stats->n_failed, stats->n_moved,
+           stats->n_evicted, stats->usec,
+           stats->usec ? (stats->n_lsps * 1000000ULL)/stats->usec : stats->n_lsps);
+}
+
+void
+show_rsvp_te_links(node_t *node){
+
+    unsigned int i = 0;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+    unsigned int capacity = 0;
+
+    printf("Node : %s RSVP TE links (RSVP %s):\n", node->node_name,
+        node->rsvp_config.is_enabled ? "Enabled" : "Disabled");
+    printf("\t%-10s %-10s %-6s %-10s %-10s %-10s %-9s %s\n", "Interface", "Nbr",
+        "Status", "Capacity", "Reserved", "Available", "TE-Metric", "Affinity");
+
+    for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node->edges[i];
+        if(!edge_end) break;
+        if(edge_end->dirn != OUTGOING)
+            continue;
+        edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+        if(edge->etype != UNICAST)
+            continue;
+        capacity = rsvp_cspf_link_capacity(edge);
+        printf("\t%-10s %-10s %-6s %-10u %-10u %-10u %-9u 0x%x\n", edge_end->intf_name,
+            edge->to.node->node_name, edge->status ? "Up" : "Down", capacity,
+            edge->rsvp_reserved_bw,
+            capacity > edge->rsvp_reserved_bw ? capacity - edge->rsvp_reserved_bw : 0,
+            edge->te_metric, edge->affinity);
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rsvp_cspf.h
+ *
+ *    Description:  This file declares the constrained SPF (CSPF) for RSVP-TE LSPs.
+ *                  CSPF runs over the links which satisfy the bandwidth and affinity
+ *                  constraints of the LSP, and reserves the LSP bandwidth on all the
+ *                  links of the computed path (ERO). LSPs of the whole network can be
+ *                  placed in a batch over one index of the topology, and re-optimized
+ *                  incrementally.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __RSVP_CSPF__
+#define __RSVP_CSPF__
+
+#include "rsvp.h"
+
+typedef struct instance_ instance_t;
+
+/*Order in which batch placement signals the LSPs*/
+typedef enum{
+
+    RSVP_CSPF_ORDER_CONFIG,     /*order of configuration, per ingress LSR*/
+    /*Biggest LSPs first, reduces the no of LSPs which could not be placed
+     * because bandwidth got fragmented by smaller ones*/
+    RSVP_CSPF_ORDER_BW_DESC
+} rsvp_cspf_order_t;
+
+typedef struct rsvp_cspf_stats_{
+
+    unsigned int n_lsps;
+    unsigned int n_placed;
+    unsigned int n_failed;
+    unsigned int n_moved;       /*re-optimization : LSPs moved to a better path*/
+    unsigned int n_evicted;     /*re-optimization : LSPs whose path broke*/
+    unsigned long long usec;
+} rsvp_cspf_stats_t;
+
+/*Place the LSP on the shortest path satisfying its constraints, previous
+ * placement of LSP, if any, is released. Returns TRUE if placed*/
+boolean
+rsvp_cspf_place_lsp(node_t *ingress_lsr, rsvp_tunnel_t *rsvp_tunnel);
+
+/*Release the bandwidth reserved by LSP*/
+void
+rsvp_cspf_release_lsp(rsvp_tunnel_t *rsvp_tunnel);
+
+/*Release all reservations and place all LSPs of all RSVP enabled
+ * routers from scratch*/
+void
+rsvp_cspf_place_all(instance_t *instance, rsvp_cspf_order_t order,
+                    rsvp_cspf_stats_t *stats);
+
+/*Keep reservations, re-place LSPs whose path broke, retry LSPs which
+ * are not placed and move LSPs for which a cheaper path is available*/
+void
+rsvp_cspf_reoptimize(instance_t *instance, rsvp_cspf_stats_t *stats);
+
+/*Link of ingress LSR went down, re-place the LSPs whose ERO leaves out of it.
+ * Returns the no of LSPs affected*/
+unsigned int
+rsvp_cspf_reroute_oif_lsps(node_t *ingress_lsr, edge_end_t *oif);
+
+void
+print_rsvp_cspf_stats(char *op, rsvp_cspf_stats_t *stats);
+
+/*TE attributes and reservations of all the links of node*/
+void
+show_rsvp_te_links(node_t *node);
+
+#endif /* __RSVP_CSPF__ */
@@ -0,0 +1,539 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  nh_group.c
+ *
+ *    Description:  This file implements the shared nexthop groups used by routes
+ *                  and the Prefix Independant Convergence (PIC) on local link failure
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "instance.h"
+#include "routes.h"
+#include "nh_group.h"
+#include "spfutil.h"
+#include "spftrace.h"
+
+extern instance_t *instance;
+
+/*Groups and spill blocks are carved out of slabs and recycled through
+ * free lists. Route build workers and LDP workers create and release
+ * groups concurrently, one mutex guards the free lists, the reference
+ * counts and the group tables*/
+#define NH_GROUP_SLAB_SIZE          32
+#define ROUTE_NH_SPILL_SLAB_SIZE    32
+
+typedef union route_nh_spill_{
+    union route_nh_spill_ *next;
+    internal_nh_t nh[MAX_NXT_HOPS];
+} route_nh_spill_t;
+
+static route_nh_spill_t *route_nh_spill_free_list = NULL;
+static nh_group_t *nh_group_free_list = NULL;
+static pthread_mutex_t nh_group_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+internal_nh_t *
+route_nh_spill_malloc(){
+
+    unsigned int i = 0;
+    route_nh_spill_t *spill = NULL;
+
+    pthread_mutex_lock(&nh_group_mutex);
+    if(!route_nh_spill_free_list){
+        spill = calloc(ROUTE_NH_SPILL_SLAB_SIZE, sizeof(route_nh_spill_t));
+        for(i = 0; i < ROUTE_NH_SPILL_SLAB_SIZE; i++){
+            spill[i].next = route_nh_spill_free_list;
+            route_nh_spill_free_list = &spill[i];
+        }
+    }
+    spill = route_nh_spill_free_list;
+    route_nh_spill_free_list = spill->next;
+    pthread_mutex_unlock(&nh_group_mutex);
+    return spill->nh;
+}
+
+void
+route_nh_spill_free(internal_nh_t *nh){
+
+    route_nh_spill_t *spill = (route_nh_spill_t *)nh;
+
+    pthread_mutex_lock(&nh_group_mutex);
+    spill->next = route_nh_spill_free_list;
+    route_nh_spill_free_list = spill;
+    pthread_mutex_unlock(&nh_group_mutex);
+}
+
+nh_group_table_t *
+init_nh_group_table(){
+
+    return calloc(1, sizeof(nh_group_table_t));
+}
+
+nh_group_t *
+nh_group_new(){
+
+    unsigned int i = 0;
+    nh_group_t *nhg = NULL;
+
+    pthread_mutex_lock(&nh_group_mutex);
+    if(!nh_group_free_list){
+        nhg = calloc(NH_GROUP_SLAB_SIZE, sizeof(nh_group_t));
+        for(i = 0; i < NH_GROUP_SLAB_SIZE; i++){
+            nhg[i].next = nh_group_free_list;
+            nh_group_free_list = &nhg[i];
+        }
+    }
+    nhg = nh_group_free_list;
+    nh_group_free_list = nhg->next;
+    pthread_mutex_unlock(&nh_group_mutex);
+
+    memset(nhg, 0, sizeof(nh_group_t));
+    nhg->ref_count = 1;
+    return nhg;
+}
+
+static void
+nh_group_flush(nh_group_t *nhg){
+
+    nh_type_t nh;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        route_nh_array_flush(&nhg->primary[nh]);
+        route_nh_array_flush(&nhg->backup[nh]);
+    } ITERATE_NH_TYPE_END;
+}
+
+void
+nh_group_hold(nh_group_t *nhg){
+
+    pthread_mutex_lock(&nh_group_mutex);
+    nhg->ref_count++;
+    pthread_mutex_unlock(&nh_group_mutex);
+}
+
+void
+nh_group_release(nh_group_t *nhg){
+
+    nh_group_t **pp = NULL;
+    nh_group_table_t *table = nhg->table;
+
+    pthread_mutex_lock(&nh_group_mutex);
+    assert(nhg->ref_count);
+    nhg->ref_count--;
+    if(nhg->ref_count){
+        pthread_mutex_unlock(&nh_group_mutex);
+        return;
+    }
+
+    if(IS_BIT_SET(nhg->flags, NH_GROUP_INTERNED)){
+        pp = &table->bucket[nhg->hash & (NH_GROUP_HASH_SIZE - 1)];
+        for(; *pp != nhg; pp = &(*pp)->next)
+            assert(*pp);
+        *pp = nhg->next;
+        table->count--;
+    }
+    pthread_mutex_unlock(&nh_group_mutex);
+
+    nh_group_flush(nhg);
+    pthread_mutex_lock(&nh_group_mutex);
+    nhg->next = nh_group_free_list;
+    nh_group_free_list = nhg;
+    pthread_mutex_unlock(&nh_group_mutex);
+}
+
+static void
+route_nh_array_copy(route_nh_array_t *src, route_nh_array_t *dst){
+
+    dst->count = src->count;
+    if(src->spill){
+        dst->spill = route_nh_spill_malloc();
+        memcpy(dst->spill, src->spill, src->count * sizeof(internal_nh_t));
+        return;
+    }
+    memcpy(dst->inline_nh, src->inline_nh, sizeof(src->inline_nh));
+}
+
+nh_group_t *
+nh_group_unshare(nh_group_t **nhg_ptr){
+
+    nh_type_t nh;
+    nh_group_t *nhg = *nhg_ptr;
+
+    if(!IS_BIT_SET(nhg->flags, NH_GROUP_INTERNED) && nhg->ref_count == 1)
+        return nhg;
+
+    *nhg_ptr = nh_group_new();
+    ITERATE_NH_TYPE_BEGIN(nh){
+        route_nh_array_copy(&nhg->primary[nh], &(*nhg_ptr)->primary[nh]);
+        route_nh_array_copy(&nhg->backup[nh], &(*nhg_ptr)->backup[nh]);
+    } ITERATE_NH_TYPE_END;
+    nh_group_release(nhg);
+    return *nhg_ptr;
+}
+
+void
+nh_group_reset(nh_group_t **nhg_ptr){
+
+    if(!IS_BIT_SET((*nhg_ptr)->flags, NH_GROUP_INTERNED) &&
+        (*nhg_ptr)->ref_count == 1){
+        nh_group_flush(*nhg_ptr);
+        return;
+    }
+    nh_group_release(*nhg_ptr);
+    *nhg_ptr = nh_group_new();
+}
+
+static boolean
+nh_group_nh_equal(internal_nh_t *nh1, internal_nh_t *nh2){
+
+    if(!is_internal_nh_t_equal((*nh1), (*nh2)))
+        return FALSE;
+
+    if(nh1->proxy_nbr != nh2->proxy_nbr)
+        return FALSE;
+
+    if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
+        return FALSE;
+
+    if(memcmp(nh1->mpls_label_out, nh2->mpls_label_out, sizeof(nh1->mpls_label_out)))
+        return FALSE;
+
+    if(memcmp(nh1->stack_op, nh2->stack_op, sizeof(nh1->stack_op)))
+        return FALSE;
+
+    return TRUE;
+}
+
+static unsigned int
+nh_group_nh_hash(internal_nh_t *nh, unsigned int tag){
+
+    struct{
+        void *oif;
+        void *node;
+        void *protected_link;
+        void *proxy_nbr;
+        void *rlfa;
+        unsigned int root_metric;
+        unsigned int dest_metric;
+        unsigned int tag;
+        mpls_label_t mpls_label_out[MPLS_STACK_OP_LIMIT_MAX];
+    } key;
+
+    memset(&key, 0, sizeof(key));
+    key.oif = nh->oif;
+    key.node = nh->node;
+    key.protected_link = nh->protected_link;
+    key.proxy_nbr = nh->proxy_nbr;
+    key.rlfa = nh->rlfa;
+    key.root_metric = nh->root_metric;
+    key.dest_metric = nh->dest_metric;
+    key.tag = tag;
+    memcpy(key.mpls_label_out, nh->mpls_label_out, sizeof(key.mpls_label_out));
+
+    return hash_code(&key, sizeof(key)) ^
+           hash_code(nh->gw_prefix, strlen(nh->gw_prefix));
+}
+
+/*Order of nexthops in route lists depends on order in which ECMP
+ * destinations were processed, so group hash and comparison are kept
+ * independant of the order of members*/
+static unsigned int
+nh_group_hash(nh_group_t *nhg){
+
+    nh_type_t nh;
+    unsigned int hash = 0;
+    internal_nh_t *nxthop = NULL;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_ROUTE_NH_BEGIN(nhg->primary[nh], nxthop){
+            hash += nh_group_nh_hash(nxthop, (nh << 1));
+        } ITERATE_ROUTE_NH_END;
+        ITERATE_ROUTE_NH_BEGIN(nhg->backup[nh], nxthop){
+            hash += nh_group_nh_hash(nxthop, (nh << 1) | 1);
+        } ITERATE_ROUTE_NH_END;
+    } ITERATE_NH_TYPE_END;
+    return hash;
+}
+
+static int
+nh_array_lookup(route_nh_array_t *nh_array, internal_nh_t *nxthop){
+
+    unsigned int i = 0;
+    internal_nh_t *nhs = ROUTE_NH_ARRAY(nh_array);
+
+    for(; i < nh_array->count; i++){
+        if(nh_group_nh_equal(&nhs[i], nxthop))
+            return (int)i;
+    }
+    return -1;
+}
+
+static boolean
+nh_group_equal(nh_group_t *nhg1, nh_group_t *nhg2){
+
+    nh_type_t nh;
+    unsigned int i = 0;
+    int j = 0;
+    internal_nh_t *nhs = NULL;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        if(nhg1->primary[nh].count != nhg2->primary[nh].count ||
+           nhg1->backup[nh].count != nhg2->backup[nh].count)
+            return FALSE;
+    } ITERATE_NH_TYPE_END;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        nhs = ROUTE_NH_ARRAY(&nhg1->primary[nh]);
+        for(i = 0; i < nhg1->primary[nh].count; i++){
+            j = nh_array_lookup(&nhg2->primary[nh], &nhs[i]);
+            if(j < 0)
+                return FALSE;
+            /*Weighted groups are distinct if they split traffic differently*/
+            if(nhg1->primary_weight[nh][i] != nhg2->primary_weight[nh][j])
+                return FALSE;
+        }
+        nhs = ROUTE_NH_ARRAY(&nhg1->backup[nh]);
+        for(i = 0; i < nhg1->backup[nh].count; i++){
+            if(nh_array_lookup(&nhg2->backup[nh], &nhs[i]) < 0)
+                return FALSE;
+        }
+    } ITERATE_NH_TYPE_END;
+    return TRUE;
+}
+
+static void
+nh_group_set_weights(nh_group_t *nhg){
+
+    nh_type_t nh;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ucmp_nh_buckets(ROUTE_NH_ARRAY(&nhg->primary[nh]), nhg->primary[nh].count,
+                &nhg->primary_weight[nh][0]);
+    } ITERATE_NH_TYPE_END;
+}
+
+unsigned int
+nh_group_oif_bit(edge_end_t *oif){
+
+    unsigned int i = 0;
+
+    for(; i < MAX_NODE_INTF_SLOTS; i++){
+        if(oif->node->edges[i] == oif)
+            return 1 << i;
+    }
+    return 0;
+}
+
+/*Subset of failed_oifs which nhg uses as primary oifs*/
+static unsigned int
+nh_group_pic_failed_oifs(nh_group_t *nhg, unsigned int failed_oifs){
+
+    nh_type_t nh;
+    internal_nh_t *nxthop = NULL;
+    unsigned int oifs = 0;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_ROUTE_NH_BEGIN(nhg->primary[nh], nxthop){
+            oifs |= nh_group_oif_bit(nxthop->oif);
+        } ITERATE_ROUTE_NH_END;
+    } ITERATE_NH_TYPE_END;
+    return oifs & failed_oifs;
+}
+
+/*Route's private group is replaced by the interned group having the
+ * same nexthops, or becomes the interned one if there is none*/
+void
+nh_group_bind_route(spf_info_t *spf_info, routes_t *route){
+
+    unsigned int bucket = 0;
+    nh_group_t *nhg = NULL,
+               *new_nhg = route->nhg;
+    nh_group_table_t *table = spf_info->nhg_table;
+
+    /*Unchanged since last bind, local routes are not shared*/
+    if(IS_BIT_SET(new_nhg->flags, NH_GROUP_INTERNED) || is_route_local(route))
+        return;
+
+    nh_group_set_weights(new_nhg);
+    new_nhg->hash = nh_group_hash(new_nhg);
+    bucket = new_nhg->hash & (NH_GROUP_HASH_SIZE - 1);
+
+    pthread_mutex_lock(&nh_group_mutex);
+    for(nhg = table->bucket[bucket]; nhg; nhg = nhg->next){
+        if(nhg->hash != new_nhg->hash)
+            continue;
+        if(!nh_group_equal(nhg, new_nhg))
+            continue;
+        nhg->ref_count++;
+        pthread_mutex_unlock(&nh_group_mutex);
+        route->nhg = nhg;
+        nh_group_release(new_nhg);
+        return;
+    }
+
+    SET_BIT(new_nhg->flags, NH_GROUP_INTERNED);
+    /*Links which are PIC down stay bypassed in newly bound groups*/
+    new_nhg->pic_failed_oifs = table->pic_failed_oifs ?
+        nh_group_pic_failed_oifs(new_nhg, table->pic_failed_oifs) : 0;
+    new_nhg->table = table;
+    new_nhg->next = table->bucket[bucket];
+    table->bucket[bucket] = new_nhg;
+    table->count++;
+    pthread_mutex_unlock(&nh_group_mutex);
+}
+
+void
+nh_group_bind_routes(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type){
+
+    singly_ll_node_t *list_node = NULL;
+    routes_t *route = NULL;
+
+    ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
+
+        route = list_node->data;
+        if(route->level != level || route->install_state == RTE_STALE)
+            continue;
+        nh_group_bind_route(spf_info, route);
+    } ITERATE_LIST_END;
+}
+
+/*Routes and routing entries share the group, marking the group repairs
+ * all of them. Nexthops are left as computed, forwarding skips the ones
+ * out of failed links and falls back to surviving ECMP members or backups*/
+unsigned int
+nh_group_pic_link_down(node_t *node, edge_end_t *failed_link){
+
+    nh_group_t *nhg = NULL;
+    unsigned int n_groups = 0, n_refs = 0,
+                 failed_oif = nh_group_oif_bit(failed_link);
+    nh_group_table_t *table = node->spf_info.nhg_table;
+
+    if(!failed_oif)
+        return 0;
+
+    table->pic_failed_oifs |= failed_oif;
+
+    ITERATE_NH_GROUP_BEGIN(table, nhg){
+
+        if(!nh_group_pic_failed_oifs(nhg, failed_oif))
+            continue;
+
+        nhg->pic_failed_oifs |= failed_oif;
+        n_groups++;
+        n_refs += nhg->ref_count;
+    } ITERATE_NH_GROUP_END;
+
+#ifdef __ENABLE_TRACE__
+    sprintf(instance->traceopts->b, "Node : %s : PIC on link %s down, %u nexthop groups repaired, %u references",
+            node->node_name, failed_link->intf_name, n_groups, n_refs);
+    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+#endif
+    return n_groups;
+}
+
+void
+nh_group_pic_link_up(node_t *node, edge_end_t *link){
+
+    nh_group_t *nhg = NULL;
+    unsigned int oif = nh_group_oif_bit(link);
+    nh_group_table_t *table = node->spf_info.nhg_table;
+
+    if(!(table->pic_failed_oifs & oif))
+        return;
+
+    table->pic_failed_oifs &= ~oif;
+
+    ITERATE_NH_GROUP_BEGIN(table, nhg){
+        nhg->pic_failed_oifs &= ~oif;
+    } ITERATE_NH_GROUP_END;
+}
+
+/*weight is printed only if non-zero*/
+static void
+print_nh_group_member(nh_group_t *nhg, internal_nh_t *nxthop, unsigned int weight){
+
+    printf(" %-10s %-5s %-15s %-16s",
+            nxthop->oif->intf_name,
+            next_hop_type(*nxthop) == IPNH ? "IPNH" : "LSPNH",
+            next_hop_type(*nxthop) == IPNH ? nxthop->gw_prefix : "--",
+            nxthop->node ? nxthop->node->node_name :
+            nxthop->rlfa ? nxthop->rlfa->node_name : "--");
+    if(nxthop->protected_link)
+        printf(" protecting : %s -- %s", nxthop->protected_link->intf_name,
+                get_str_lfa_type(nxthop->lfa_type));
+    if(weight)
+        printf(" weight : %u", weight);
+    if(nh_group_is_oif_bypassed(nhg, nxthop->oif))
+        printf(" (bypassed)");
+    printf("\n");
+}
+
+void
+show_nh_groups(node_t *node){
+
+    nh_group_t *nhg = NULL;
+    nh_type_t nh;
+    unsigned int i = 0, n_refs = 0;
+    nh_group_table_t *table = node->spf_info.nhg_table;
+    boolean is_weighted = FALSE;
+    internal_nh_t *nhs = NULL;
+
+    printf("Node : %s, nexthop groups : %u\n", node->node_name, table->count);
+
+    ITERATE_NH_GROUP_BEGIN(table, nhg){
+
+        n_refs += nhg->ref_count;
+        is_weighted = FALSE;
+        ITERATE_NH_TYPE_BEGIN(nh){
+            for(i = 0; i < nhg->primary[nh].count; i++){
+                if(nhg->primary_weight[nh][i] > 1)
+                    is_weighted = TRUE;
+            }
+        } ITERATE_NH_TYPE_END;
+        printf("\tgroup 0x%08x, references = %u", nhg->hash, nhg->ref_count);
+        if(nhg->pic_failed_oifs){
+            printf(", PIC active, failed links :");
+            for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+                if(nhg->pic_failed_oifs & (1 << i))
+                    printf(" %s", node->edges[i]->intf_name);
+            }
+        }
+        printf("\n");
+        ITERATE_NH_TYPE_BEGIN(nh){
+            nhs = ROUTE_NH_ARRAY(&nhg->primary[nh]);
+            for(i = 0; i < nhg->primary[nh].count; i++){
+                printf("\t  primary");
+                print_nh_group_member(nhg, &nhs[i],
+                        is_weighted ? nhg->primary_weight[nh][i] : 0);
+            }
+        } ITERATE_NH_TYPE_END;
+        ITERATE_NH_TYPE_BEGIN(nh){
+            nhs = ROUTE_NH_ARRAY(&nhg->backup[nh]);
+            for(i = 0; i < nhg->backup[nh].count; i++){
+                printf("\t  backup ");
+                print_nh_group_member(nhg, &nhs[i], 0);
+            }
+        } ITERATE_NH_TYPE_END;
+    } ITERATE_NH_GROUP_END;
+
+    printf("Total references to groups : %u\n", n_refs);
+}
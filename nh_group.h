@@ -0,0 +1,224 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  nh_group.h
+ *
+ *    Description:  This file declares the shared nexthop groups. Routes which resolve
+ *                  to the same set of primary and backup nexthops point to one
+ *                  reference counted nexthop group, interned by its content. On a
+ *                  local link failure, backups are promoted once per group rather
+ *                  than once per route (Prefix Independant Convergence).
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __NH_GROUP__
+#define __NH_GROUP__
+
+#include <assert.h>
+#include <string.h>
+#include "instanceconst.h"
+#include "spfcomputation.h"
+
+typedef struct routes_ routes_t;
+typedef struct _node_t node_t;
+typedef struct edge_end_ edge_end_t;
+
+/*ECMP nexthop array. Most routes have a single nexthop which is kept
+ * inline, an array which needs more moves all of its nexthops to a
+ * spill block of MAX_NXT_HOPS carved from a slab*/
+#define ROUTE_NH_INLINE     1
+
+typedef struct route_nh_array_{
+
+    unsigned int count;
+    internal_nh_t *spill;
+    internal_nh_t inline_nh[ROUTE_NH_INLINE];
+} route_nh_array_t;
+
+#define ROUTE_NH_ARRAY(_nh_array_ptr)    \
+    ((_nh_array_ptr)->spill ? (_nh_array_ptr)->spill : (_nh_array_ptr)->inline_nh)
+
+internal_nh_t *
+route_nh_spill_malloc();
+
+void
+route_nh_spill_free(internal_nh_t *spill);
+
+/*Copies the nexthop at the front of nexthop array, nexthops are listed
+ * latest first. Labels are not copied, route nexthops are springified
+ * afresh*/
+static inline internal_nh_t *
+route_nh_array_add(route_nh_array_t *nh_array, internal_nh_t *nxthop){
+
+    internal_nh_t *nhs = NULL;
+
+    assert(nh_array->count < MAX_NXT_HOPS);
+    if(nh_array->count == ROUTE_NH_INLINE && !nh_array->spill){
+        nh_array->spill = route_nh_spill_malloc();
+        memcpy(nh_array->spill, nh_array->inline_nh, sizeof(nh_array->inline_nh));
+    }
+    nhs = ROUTE_NH_ARRAY(nh_array);
+    memmove(&nhs[1], &nhs[0], nh_array->count * sizeof(internal_nh_t));
+    nh_array->count++;
+    init_internal_nh_t(nhs[0]);
+    copy_internal_nh_t((*nxthop), nhs[0]);
+    return &nhs[0];
+}
+
+static inline void
+route_nh_array_delete(route_nh_array_t *nh_array, unsigned int index){
+
+    internal_nh_t *nhs = ROUTE_NH_ARRAY(nh_array);
+
+    assert(index < nh_array->count);
+    nh_array->count--;
+    if(index < nh_array->count){
+        memmove(&nhs[index], &nhs[index + 1],
+            (nh_array->count - index) * sizeof(internal_nh_t));
+    }
+}
+
+static inline void
+route_nh_array_flush(route_nh_array_t *nh_array){
+
+    if(nh_array->spill){
+        route_nh_spill_free(nh_array->spill);
+        nh_array->spill = NULL;
+    }
+    nh_array->count = 0;
+}
+
+static inline boolean
+route_nh_array_is_exist(route_nh_array_t *nh_array, internal_nh_t *nxthop){
+
+    unsigned int i = 0;
+    internal_nh_t *nhs = ROUTE_NH_ARRAY(nh_array);
+
+    for(; i < nh_array->count; i++){
+        if(is_internal_nh_t_equal(nhs[i], (*nxthop)))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+#define ITERATE_ROUTE_NH_BEGIN(_route_nh_array, _internal_nh_t_ptr)      \
+{                                                                        \
+    unsigned int _nh_index = 0;                                          \
+    route_nh_array_t *_nh_array = &(_route_nh_array);                    \
+    internal_nh_t *_nhs = ROUTE_NH_ARRAY(_nh_array);                     \
+    for(; _nh_index < _nh_array->count; _nh_index++){                    \
+        _internal_nh_t_ptr = &_nhs[_nh_index];
+
+#define ITERATE_ROUTE_NH_END    }}
+
+/*Must be power of 2*/
+#define NH_GROUP_HASH_SIZE  256
+
+typedef struct nh_group_table_ nh_group_table_t;
+
+/*Nexthops of a route. A route builds its nexthops in a group of its
+ * own, which is then interned : routes having the same nexthops share
+ * one group, and so do the routing entries installed from them. A
+ * shared group is read only, route copies it before modifying it*/
+typedef struct nh_group_{
+
+    unsigned int hash;
+    unsigned int ref_count; /*No of routes and routing entries pointing to this group*/
+    /*Group is in the table and may be shared*/
+    #define NH_GROUP_INTERNED       0
+    FLAG flags;
+    /*PIC : failed oifs, see nh_group_oif_bit(). Nexthops out of them are
+     * bypassed, forwarding falls back to surviving ECMP members or backups*/
+    unsigned int pic_failed_oifs;
+    route_nh_array_t primary[NH_MAX];
+    route_nh_array_t backup[NH_MAX];
+    /*UCMP buckets of primary nexthops, see ucmp_nh_buckets()*/
+    unsigned int primary_weight[NH_MAX][MAX_NXT_HOPS];
+    nh_group_table_t *table; /*back ptr to owning table*/
+    struct nh_group_ *next;  /*hash bucket chain*/
+} nh_group_t;
+
+struct nh_group_table_{
+
+    unsigned int count;
+    unsigned int pic_failed_oifs; /*Links of the node which are PIC down*/
+    nh_group_t *bucket[NH_GROUP_HASH_SIZE];
+};
+
+nh_group_table_t *
+init_nh_group_table();
+
+/*Empty group, private to the caller*/
+nh_group_t *
+nh_group_new();
+
+void
+nh_group_hold(nh_group_t *nhg);
+
+void
+nh_group_release(nh_group_t *nhg);
+
+/*Returns *nhg_ptr after replacing it with a private copy if it is shared*/
+nh_group_t *
+nh_group_unshare(nh_group_t **nhg_ptr);
+
+/*Replaces *nhg_ptr with an empty private group*/
+void
+nh_group_reset(nh_group_t **nhg_ptr);
+
+void
+nh_group_bind_route(spf_info_t *spf_info, routes_t *route);
+
+void
+nh_group_bind_routes(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type);
+
+/*Bit of oif in PIC failed oif sets, one per interface slot of its node*/
+unsigned int
+nh_group_oif_bit(edge_end_t *oif);
+
+/*PIC : Bypass failed_link in all groups which use it as primary oif.
+ * Returns the no of groups repaired*/
+unsigned int
+nh_group_pic_link_down(node_t *node, edge_end_t *failed_link);
+
+/*Undo PIC of link, links which are still down stay bypassed*/
+void
+nh_group_pic_link_up(node_t *node, edge_end_t *link);
+
+/*TRUE if forwarding over oif is bypassed by PIC in this group*/
+static inline boolean
+nh_group_is_oif_bypassed(nh_group_t *nhg, edge_end_t *oif){
+
+    return nhg && nhg->pic_failed_oifs &&
+           (nhg->pic_failed_oifs & nh_group_oif_bit(oif));
+}
+
+void
+show_nh_groups(node_t *node);
+
+#define ITERATE_NH_GROUP_BEGIN(nh_group_table_ptr, nhg_ptr)              \
+{                                                                        \
+    unsigned int _bucket = 0;                                            \
+    nh_group_t *_next_nhg = NULL;                                        \
+    for(; _bucket < NH_GROUP_HASH_SIZE; _bucket++){                      \
+        for(nhg_ptr = (nh_group_table_ptr)->bucket[_bucket];             \
+            nhg_ptr; nhg_ptr = _next_nhg){                               \
+            _next_nhg = nhg_ptr->next;
+
+#define ITERATE_NH_GROUP_END    }}}
+
+#endif /* __NH_GROUP__ */
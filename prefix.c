@@ -33,6 +33,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+#include <arpa/inet.h>
 #include "spfutil.h"
 #include "prefix.h"
 #include "LinkedListApi.h"
@@ -96,156 +98,80 @@ prefix_order_comparison_fn(void *_prefix1, void *_prefix2){
     return 0;
 }
 
-prefix_pref_data_t
-route_preference(FLAG route_flags, LEVEL level){
-
-/* Same preference 0*/
-    prefix_pref_data_t pref;
-
-    if(level == LEVEL1 &&
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) && 
-       !IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L1_INT_INT;
-            pref.pref_str = "L1_INT_INT";
-            return pref;
-    }
-
-    if(level == LEVEL1 &&
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) && 
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L1_EXT_INT;
-            pref.pref_str = "L1_EXT_INT";
-            return pref;
-    }
-
-/* Same preference 1*/
-    if(level == LEVEL2 &&
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) && 
-       !IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L2_INT_INT;
-            pref.pref_str = "L2_INT_INT";
-            return pref;
-    }
-
-    if(level == LEVEL2 &&
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&  
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-             pref.pref =  L2_EXT_INT;
-             pref.pref_str = "L2_EXT_INT";
-            return pref;
-    }
-
-    if(level == LEVEL2 && 
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref =  L1_L2_INT_INT;
-            pref.pref_str = "L1_L2_INT_INT";
-            return pref;
-    }
-
-    if(level == LEVEL2 && 
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref =  L1_L2_EXT_INT;
-            pref.pref_str = "L1_L2_EXT_INT";
-            return pref;
+/* RFC 5302/7775 preferences indexed by level and the preference bits of
+ * prefix flags : PREFIX_DOWNBIT_FLAG(bit 0), PREFIX_EXTERNABIT_FLAG(bit 1)
+ * and PREFIX_METRIC_TYPE_EXT(bit 2). Internal prefixes with external metric
+ * are meant to be ignored. Entries with NULL string are invalid combinations*/
+#define PREF_ENTRY(_pref)   {_pref, #_pref}
+#define PREF_INVALID        {ROUTE_UNKNOWN_PREFERENCE, NULL}
+
+static const prefix_pref_data_t 
+prefix_pref_table[MAX_LEVEL][PREFIX_PREF_FLAGS_MASK + 1] = {
+
+    /*LEVEL_UNKNOWN*/
+    {
+        PREF_INVALID,                            /* - - - */
+        PREF_INVALID,                            /* D - - */
+        PREF_INVALID,                            /* - E - */
+        PREF_INVALID,                            /* D E - */
+        PREF_ENTRY(ROUTE_UNKNOWN_PREFERENCE),    /* - - M */
+        PREF_ENTRY(ROUTE_UNKNOWN_PREFERENCE),    /* D - M */
+        PREF_INVALID,                            /* - E M */
+        PREF_INVALID                             /* D E M */
+    },
+    /*LEVEL1*/
+    {
+        PREF_ENTRY(L1_INT_INT),
+        PREF_ENTRY(L2_L1_INT_INT),
+        PREF_ENTRY(L1_EXT_INT),
+        PREF_ENTRY(L2_L1_EXT_INT),
+        PREF_ENTRY(ROUTE_UNKNOWN_PREFERENCE),
+        PREF_ENTRY(ROUTE_UNKNOWN_PREFERENCE),
+        PREF_ENTRY(L1_EXT_EXT),
+        PREF_ENTRY(L2_L1_EXT_EXT)
+    },
+    /*LEVEL2*/
+    {
+        PREF_ENTRY(L2_INT_INT),
+        PREF_INVALID,
+        PREF_ENTRY(L2_EXT_INT),
+        PREF_ENTRY(L2_L2_EXT_INT),               /* Up/Down bit is set but ignored as if it is unset*/
+        PREF_ENTRY(ROUTE_UNKNOWN_PREFERENCE),
+        PREF_ENTRY(ROUTE_UNKNOWN_PREFERENCE),
+        PREF_ENTRY(L2_EXT_EXT),
+        PREF_INVALID
     }
+};
 
+prefix_pref_data_t
+route_preference(FLAG route_flags, LEVEL level){
 
-    if(level == LEVEL2 &&
-       (IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) || 1) && /* Up/Down bit is set but ignored as if it is unset*/
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref =  L2_L2_EXT_INT;
-            pref.pref_str = "L2_L2_EXT_INT";
-            return pref;
-    }
+    const prefix_pref_data_t *pref = NULL;
 
-/* Same preference 2*/
-    if(level == LEVEL1 && 
-        IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref =  L2_L1_INT_INT;
-            pref.pref_str = "L2_L1_INT_INT";
-            return pref;
-    }
+    if(level >= MAX_LEVEL)
+        level = LEVEL_UNKNOWN;
 
-    if(level == LEVEL1 && 
-        IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L2_L1_EXT_INT;
-            pref.pref_str = "L2_L1_EXT_INT";
-            return pref;
-    }
-    
-    if(level == LEVEL1 &&
-        IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-       !IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L1_L1_EXT_INT;
-            pref.pref_str = "L1_L1_EXT_INT";
-            return pref;
-    }
+    pref = &prefix_pref_table[level][route_flags & PREFIX_PREF_FLAGS_MASK];
+    assert(pref->pref_str);
+    return *pref;
+}
 
-/* Same preference 3*/
-    if(level == LEVEL1 && 
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L1_EXT_EXT;
-            pref.pref_str = "L1_EXT_EXT";
-            return pref;
-    }
-    
-/* Same preference 4*/
-    if(level == LEVEL2 &&
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) && 
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L2_EXT_EXT;
-            pref.pref_str = "L2_EXT_EXT";
-            return pref;
-    }
+/*Compute the preference and the metric independant part of selection
+ * key of the prefix. Must be called whenever prefix flags, level or
+ * hosting node changes*/
+void
+set_prefix_preference(prefix_t *prefix){
 
-    if(level == LEVEL2 && 
-       !IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-             pref.pref = L1_L2_EXT_EXT;
-             pref.pref_str = "L1_L2_EXT_EXT";
-            return pref;
-    }
+    unsigned int router_id = 0;
 
-/* Same preference 5*/
-    if(level == LEVEL1 &&
-        IS_BIT_SET(route_flags, PREFIX_DOWNBIT_FLAG) && 
-        IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = L2_L1_EXT_EXT;
-            pref.pref_str = "L2_L1_EXT_EXT";
-            return pref;
-    }
+    prefix->pref = route_preference(prefix->prefix_flags, prefix->level).pref;
 
-/* Such a prefix is meant to be ignored*/
-    if(!IS_BIT_SET(route_flags, PREFIX_EXTERNABIT_FLAG) &&
-        IS_BIT_SET(route_flags, PREFIX_METRIC_TYPE_EXT)){
-            pref.pref = ROUTE_UNKNOWN_PREFERENCE;
-            pref.pref_str = "ROUTE_UNKNOWN_PREFERENCE";
-            return pref;
-    }
+    if(prefix->hosting_node && 
+        inet_pton(AF_INET, prefix->hosting_node->router_id, &router_id) == 1)
+        router_id = ntohl(router_id);
 
-    assert(0);
-    pref.pref = ROUTE_UNKNOWN_PREFERENCE;
-    pref.pref_str = "ROUTE_UNKNOWN_PREFERENCE";
-    return pref; /* Make compiler happy*/
+    prefix->selection_key = ((unsigned long long)prefix->pref << 56) | 
+                            (router_id & 0xFFFFFF);
 }
 
 void
@@ -314,6 +240,7 @@ leak_prefix(char *node_name, char *_prefix, char mask,
 
         if(from_level == LEVEL2 && to_level == LEVEL1)
             SET_BIT(leaked_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
+        set_prefix_preference(leaked_prefix);
 
 #ifdef __ENABLE_TRACE__        
         sprintf(instance->traceopts->b, "Node : %s : prefix %s/%u leaked from %s to %s", 
@@ -361,6 +288,7 @@ leak_prefix(char *node_name, char *_prefix, char mask,
 
         if(from_level == LEVEL2 && to_level == LEVEL1)
             SET_BIT(leaked_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
+        set_prefix_preference(leaked_prefix);
 
 #ifdef __ENABLE_TRACE__        
         sprintf(instance->traceopts->b, "Node : %s : prefix %s/%u leaked from %s to %s", 
@@ -375,111 +303,322 @@ leak_prefix(char *node_name, char *_prefix, char mask,
     return NULL;
 }
 
-void
-add_new_prefix_in_list(ll_t *prefix_list , prefix_t *prefix, 
-                unsigned int prefix_hosting_node_metric){
+FLAG
+is_prefix_byte_equal(prefix_t *prefix1, prefix_t *prefix2, 
+                    unsigned int prefix2_hosting_node_metric){
+
+    if(strncmp(prefix1->prefix, prefix2->prefix, PREFIX_LEN) == 0   &&
+        prefix1->mask == prefix2->mask                              &&
+        prefix1->metric == prefix2->metric + prefix2_hosting_node_metric                         &&
+        prefix1->hosting_node == prefix2->hosting_node)
+            return 1;
+    return 0;
+}
 
-    singly_ll_node_t *list_node_prev = NULL, 
-                     *list_node_next = NULL;
 
-    prefix_t *list_prefix = NULL;
+static unsigned int
+prefix_store_key(char *prefix){
 
-    /* empty list*/
-    if(is_singly_ll_empty(prefix_list)){
-        singly_ll_add_node_by_val(prefix_list, prefix);
-        return;
+    unsigned int bin_prefix = 0;
+
+    if(inet_pton(AF_INET, prefix, &bin_prefix) != 1)
+        return 0;
+    return ntohl(bin_prefix);
+}
+
+static inline unsigned int
+prefix_store_apply_mask(unsigned int bin_prefix, unsigned char mask){
+
+    return mask ? bin_prefix & (0xFFFFFFFFU << (32 - mask)) : 0;
+}
+
+/*Hashed on route key, see prefix_store_t*/
+static inline unsigned int
+prefix_store_hash(prefix_store_t *store, unsigned int bin_prefix, 
+                  unsigned char mask){
+
+    return ((prefix_store_apply_mask(bin_prefix, mask) ^ mask) * 2654435761U) &
+            (store->hash_size - 1);
+}
+
+static void
+prefix_store_rehash(prefix_store_t *store, unsigned int new_hash_size){
+
+    unsigned int i = 0, index = 0;
+    prefix_t *prefix = NULL;
+
+    free(store->bucket);
+    store->hash_size = new_hash_size;
+    store->bucket = calloc(new_hash_size, sizeof(prefix_t *));
+
+    for(i = 0; i < store->count; i++){
+        prefix = store->prefixes[i];
+        index = prefix_store_hash(store, prefix->bin_prefix, prefix->mask);
+        prefix->store_next = store->bucket[index];
+        store->bucket[index] = prefix;
     }
+}
 
-    /* Only one node*/
-    if(GET_NODE_COUNT_SINGLY_LL(prefix_list) == 1){
-        if(prefix->metric + prefix_hosting_node_metric < ((prefix_t *)(prefix_list->head->data))->metric){
-            singly_ll_add_node_by_val(prefix_list, prefix);
-        }
-        else{
-            singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-            prefix_list->head->next = new_node;
-            INC_NODE_COUNT_SINGLY_LL(prefix_list);
-        }
-        return;
+prefix_store_t *
+init_prefix_store(){
+
+    prefix_store_t *store = calloc(1, sizeof(prefix_store_t));
+    store->size = PREFIX_STORE_INIT_SIZE;
+    store->prefixes = calloc(store->size, sizeof(prefix_t *));
+    store->hash_size = PREFIX_STORE_INIT_SIZE;
+    store->bucket = calloc(store->hash_size, sizeof(prefix_t *));
+    return store;
+}
+
+static prefix_t *
+prefix_store_lookup_bin(prefix_store_t *store, unsigned int bin_prefix, 
+                        unsigned char mask){
+
+    prefix_t *store_prefix = 
+        store->bucket[prefix_store_hash(store, bin_prefix, mask)];
+
+    for(; store_prefix; store_prefix = store_prefix->store_next){
+        if(store_prefix->bin_prefix == bin_prefix &&
+           store_prefix->mask == mask)
+            return store_prefix;
     }
+    return NULL;
+}
 
-    /* If prefix need to be added as first node in a list*/
-    if(prefix->metric + prefix_hosting_node_metric < 
-                ((prefix_t *)(GET_HEAD_SINGLY_LL(prefix_list)->data))->metric){
+prefix_t *
+prefix_store_lookup(prefix_store_t *store, char *prefix, char mask){
 
-        singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-        new_node->next = GET_HEAD_SINGLY_LL(prefix_list);
-        prefix_list->head = new_node;
-        INC_NODE_COUNT_SINGLY_LL(prefix_list);
-        return;
+    return prefix_store_lookup_bin(store, prefix_store_key(prefix), 
+                                   (unsigned char)mask);
+}
+
+prefix_t *
+prefix_store_lookup_route_key(prefix_store_t *store, unsigned int key_addr,
+                              unsigned char mask, prefix_t *prev){
+
+    prefix_t *store_prefix = prev ? prev->store_next :
+        store->bucket[prefix_store_hash(store, key_addr, mask)];
+
+    for(; store_prefix; store_prefix = store_prefix->store_next){
+        if(store_prefix->mask == mask &&
+           prefix_store_apply_mask(store_prefix->bin_prefix, mask) == key_addr)
+            return store_prefix;
     }
+    return NULL;
+}
 
+/*Returns the index of first prefix in store having metric strictly
+ * greater than metric, so that equal metric prefixes keep insertion order*/
+static unsigned int
+prefix_store_upper_bound(prefix_store_t *store, unsigned int metric){
 
-    ITERATE_LIST_BEGIN(prefix_list, list_node_next){
+    unsigned int low = 0, high = store->count, mid = 0;
 
-        list_prefix = list_node_next->data;
-        if(!(prefix->metric + prefix_hosting_node_metric < list_prefix->metric)){ 
+    while(low < high){
+        mid = low + ((high - low) >> 1);
+        if(store->prefixes[mid]->metric > metric)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
 
-            list_node_prev = list_node_next;
-            continue;
-        }
+static void
+prefix_store_array_insert(prefix_store_t *store, prefix_t *prefix, 
+                          unsigned int metric){
 
-        singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-        new_node->next = list_node_next;
-        list_node_prev->next = new_node;
-        INC_NODE_COUNT_SINGLY_LL(prefix_list);
-        return;
+    unsigned int index = prefix_store_upper_bound(store, metric);
 
-    }ITERATE_LIST_END;
+    memmove(&store->prefixes[index + 1], &store->prefixes[index], 
+            (store->count - index) * sizeof(prefix_t *));
+    store->prefixes[index] = prefix;
+    store->count++;
+}
+
+static boolean
+prefix_store_array_remove(prefix_store_t *store, prefix_t *prefix){
 
-    /*Add in the end*/
-    singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-    list_node_prev->next = new_node;
-    INC_NODE_COUNT_SINGLY_LL(prefix_list);
+    unsigned int index = 0;
+
+    for(; index < store->count; index++){
+        if(store->prefixes[index] != prefix)
+            continue;
+        memmove(&store->prefixes[index], &store->prefixes[index + 1],
+                (store->count - index - 1) * sizeof(prefix_t *));
+        store->count--;
+        return TRUE;
+    }
+    return FALSE;
 }
 
 FLAG
-is_prefix_byte_equal(prefix_t *prefix1, prefix_t *prefix2, 
-                    unsigned int prefix2_hosting_node_metric){
+prefix_store_add(prefix_store_t *store, prefix_t *prefix, 
+                 unsigned int hosting_node_metric){
 
-    if(strncmp(prefix1->prefix, prefix2->prefix, PREFIX_LEN) == 0   &&
-        prefix1->mask == prefix2->mask                              &&
-        prefix1->metric == prefix2->metric + prefix2_hosting_node_metric                         &&
-        prefix1->hosting_node == prefix2->hosting_node)
-            return 1;
-    return 0;
+    unsigned int index = 0;
+
+    if(prefix_store_lookup(store, prefix->prefix, prefix->mask))
+        return 0;
+
+    if(store->count == store->size){
+        store->size <<= 1;
+        store->prefixes = realloc(store->prefixes, store->size * sizeof(prefix_t *));
+    }
+
+    prefix->bin_prefix = prefix_store_key(prefix->prefix);
+    set_prefix_preference(prefix);
+    prefix_store_array_insert(store, prefix, prefix->metric + hosting_node_metric);
+
+    if(store->count > store->hash_size){
+        /*rehash links the new prefix too*/
+        prefix_store_rehash(store, store->hash_size << 1);
+        return 1;
+    }
+
+    index = prefix_store_hash(store, prefix->bin_prefix, prefix->mask);
+    prefix->store_next = store->bucket[index];
+    store->bucket[index] = prefix;
+    return 1;
 }
 
+boolean
+prefix_store_remove(prefix_store_t *store, prefix_t *prefix){
+
+    prefix_t **link = NULL;
+
+    link = &store->bucket[prefix_store_hash(store, prefix->bin_prefix, prefix->mask)];
+    for(; *link; link = &(*link)->store_next){
+        if(*link != prefix)
+            continue;
+        *link = prefix->store_next;
+        prefix->store_next = NULL;
+        prefix_store_array_remove(store, prefix);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void
+prefix_store_reorder(prefix_store_t *store, prefix_t *prefix){
+
+    if(!prefix_store_array_remove(store, prefix))
+        return;
+    prefix_store_array_insert(store, prefix, prefix->metric);
+}
+
+typedef struct prefix_store_bulk_entry_{
+
+    prefix_t *prefix;
+    unsigned int seq_no;
+} prefix_store_bulk_entry_t;
+
+static int
+prefix_store_bulk_entry_cmp(const void *_entry1, const void *_entry2){
+
+    const prefix_store_bulk_entry_t *entry1 = _entry1,
+                                    *entry2 = _entry2;
+
+    if(entry1->prefix->metric != entry2->prefix->metric)
+        return entry1->prefix->metric < entry2->prefix->metric ? -1 : 1;
+    return entry1->seq_no < entry2->seq_no ? -1 : 1;
+}
+
+/*Batch version of prefix_store_add(). Store is grown and rehashed once,
+ * new prefixes are sorted among themselves and merged with the existing
+ * ones in one pass. Resulting order is same as adding prefixes one by one.
+ * Added prefixes are moved to the front of prefixes array in input order,
+ * rejected (duplicate) prefixes behind them are owned by the caller.
+ * Returns the no of prefixes added*/
+unsigned int
+prefix_store_bulk_add(prefix_store_t *store, prefix_t **prefixes, 
+                      unsigned int n_prefixes){
+
+    unsigned int i = 0, 
+                 index = 0,
+                 n_added = 0,
+                 new_size = 0;
+    int old_index = 0, 
+        new_index = 0, 
+        merge_index = 0;
+    prefix_t *prefix = NULL;
+    prefix_store_bulk_entry_t *entries = NULL;
+
+    if(!n_prefixes)
+        return 0;
+
+    new_size = store->size;
+    while(new_size < store->count + n_prefixes)
+        new_size <<= 1;
+    if(new_size != store->size){
+        store->size = new_size;
+        store->prefixes = realloc(store->prefixes, store->size * sizeof(prefix_t *));
+    }
+
+    new_size = store->hash_size;
+    while(new_size < store->count + n_prefixes)
+        new_size <<= 1;
+    if(new_size != store->hash_size)
+        prefix_store_rehash(store, new_size);
+
+    entries = calloc(n_prefixes, sizeof(prefix_store_bulk_entry_t));
+
+    for(i = 0; i < n_prefixes; i++){
+        prefix = prefixes[i];
+        prefix->bin_prefix = prefix_store_key(prefix->prefix);
+        set_prefix_preference(prefix);
+        if(prefix_store_lookup_bin(store, prefix->bin_prefix, prefix->mask))
+            continue;
+        index = prefix_store_hash(store, prefix->bin_prefix, prefix->mask);
+        prefix->store_next = store->bucket[index];
+        store->bucket[index] = prefix;
+        entries[n_added].prefix = prefix;
+        entries[n_added].seq_no = n_added;
+        prefixes[i] = prefixes[n_added];
+        prefixes[n_added++] = prefix;
+    }
+
+    qsort(entries, n_added, sizeof(prefix_store_bulk_entry_t), 
+          prefix_store_bulk_entry_cmp);
+
+    /*Merge from the tail, on equal metric already present prefix stays ahead*/
+    old_index = (int)store->count - 1;
+    new_index = (int)n_added - 1;
+    merge_index = (int)(store->count + n_added) - 1;
+
+    while(new_index >= 0){
+        if(old_index >= 0 && 
+            store->prefixes[old_index]->metric > entries[new_index].prefix->metric)
+            store->prefixes[merge_index--] = store->prefixes[old_index--];
+        else
+            store->prefixes[merge_index--] = entries[new_index--].prefix;
+    }
+
+    store->count += n_added;
+    free(entries);
+    return n_added;
+}
 
 /* Let us delegate all add logic to this fn*/
 /* Returns 1 if prefix added, 0 if rejected*/
 FLAG
-add_prefix_to_prefix_list(ll_t *prefix_list, 
-                          prefix_t *prefix, 
-                          unsigned int hosting_node_metric){
-
-    common_pfx_key_t key;
-    memset(&key, 0 , sizeof(common_pfx_key_t));
-    strncpy(key.u.prefix.prefix, prefix->prefix, PREFIX_LEN);
-    key.u.prefix.prefix[PREFIX_LEN] = '\0'; 
-    key.u.prefix.mask = prefix->mask;
-    assert(!singly_ll_search_by_key(prefix_list, &key));
-    add_new_prefix_in_list(prefix_list, prefix, hosting_node_metric);
-    return 1;
+add_prefix_to_prefix_store(prefix_store_t *store, 
+                           prefix_t *prefix, 
+                           unsigned int hosting_node_metric){
+
+    assert(!prefix_store_lookup(store, prefix->prefix, prefix->mask));
+    return prefix_store_add(store, prefix, hosting_node_metric);
 }
 
 void
-delete_prefix_from_prefix_list(ll_t *prefix_list, char *prefix, char mask){
+delete_prefix_from_prefix_store(prefix_store_t *store, char *prefix, char mask){
 
     prefix_t *old_prefix = NULL;
-    common_pfx_key_t key;
-    strncpy(key.u.prefix.prefix, prefix, PREFIX_LEN);
-    key.u.prefix.prefix[PREFIX_LEN] = '\0';
-    key.u.prefix.mask = mask;
-    old_prefix = singly_ll_search_by_key(prefix_list, &key);
+
+    old_prefix = prefix_store_lookup(store, prefix, mask);
     if(!old_prefix)
         return;
-    singly_ll_delete_node_by_data_ptr(prefix_list, old_prefix);
+    prefix_store_remove(store, old_prefix);
     free_prefix(old_prefix);
     old_prefix = NULL;
 }
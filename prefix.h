@@ -45,6 +45,8 @@
 #define PREFIX_DOWNBIT_FLAG         0/*0th bit*/
 #define PREFIX_EXTERNABIT_FLAG      1/*Ist bit*/
 #define PREFIX_METRIC_TYPE_EXT      2/*2nd bit*/
+/*Flags which decide the preference of prefix*/
+#define PREFIX_PREF_FLAGS_MASK      ((1 << PREFIX_DOWNBIT_FLAG) | (1 << PREFIX_EXTERNABIT_FLAG) | (1 << PREFIX_METRIC_TYPE_EXT))
 
 /* Preferences - RFC 5302 For TLV128/130. We also incorporate RFC 7775 for routes advertised by TLV
  * 135,235,236,237. Pls note that, RFC 5302 explicitely written for IPv4 takes complete care of RFC 
@@ -106,8 +108,77 @@ typedef struct prefix_{
     /*Extras*/
     /*LDP local label binding*/
     unsigned char ref_count; /*For internal use*/
+    /*Route selection, see set_prefix_preference()*/
+    unsigned char pref;                 /*prefix_preference_t*/
+    unsigned long long selection_key;   /*preference | 0 | hosting node id*/
+    /*Local prefix store, see prefix_store_t*/
+    unsigned int bin_prefix;        /*prefix in host byte order*/
+    struct prefix_ *store_next;     /*hash bucket chain*/
+    /*Non-zero if prefix is installed by leak policy, see leak_policy_t*/
+    unsigned int leak_gen;
 } prefix_t;
 
+/*Per node per level store of local prefixes. Prefixes are kept in a
+ * contiguous array sorted by metric (equal metric prefixes in the order
+ * of insertion) so that route building walks them without chasing list
+ * pointers. They are hashed on the route key i.e. binary prefix with mask
+ * applied, so that all prefixes of a route key are in one hash chain*/
+
+#define PREFIX_STORE_INIT_SIZE  16 /*Must be power of 2*/
+
+typedef struct prefix_store_{
+
+    unsigned int count;
+    unsigned int size;          /*Capacity of prefixes array*/
+    prefix_t **prefixes;        /*Sorted by metric*/
+    unsigned int hash_size;     /*Power of 2*/
+    prefix_t **bucket;
+} prefix_store_t;
+
+prefix_store_t *
+init_prefix_store();
+
+prefix_t *
+prefix_store_lookup(prefix_store_t *store, char *prefix, char mask);
+
+/*Returns the prefix next to prev (first if prev is NULL) in store whose
+ * route key is key_addr/mask. key_addr is in host byte order with mask
+ * already applied*/
+prefix_t *
+prefix_store_lookup_route_key(prefix_store_t *store, unsigned int key_addr,
+                              unsigned char mask, prefix_t *prev);
+
+/*Returns 1 if prefix added, 0 if a prefix with same key already exists*/
+FLAG
+prefix_store_add(prefix_store_t *store, prefix_t *prefix,
+                 unsigned int hosting_node_metric);
+
+/*Adds a batch of prefixes in one go. Added prefixes are moved to the front
+ * of prefixes array, duplicates behind them are left to the caller.
+ * Returns the no of prefixes added*/
+unsigned int
+prefix_store_bulk_add(prefix_store_t *store, prefix_t **prefixes,
+                      unsigned int n_prefixes);
+
+/*Unlinks the prefix from store, prefix is not freed. Returns FALSE if
+ * this very prefix is not present in the store*/
+boolean
+prefix_store_remove(prefix_store_t *store, prefix_t *prefix);
+
+/*Must be called after the metric of a prefix present in store is changed*/
+void
+prefix_store_reorder(prefix_store_t *store, prefix_t *prefix);
+
+#define PREFIX_STORE_COUNT(store_ptr)   ((store_ptr)->count)
+
+#define ITERATE_PREFIX_STORE_BEGIN(store_ptr, prefix_ptr)                   \
+{                                                                           \
+    unsigned int _pfx_index = 0;                                            \
+    for(; _pfx_index < (store_ptr)->count; _pfx_index++){                   \
+        prefix_ptr = (store_ptr)->prefixes[_pfx_index];
+
+#define ITERATE_PREFIX_STORE_END    }}
+
 FLAG
 is_prefix_byte_equal(prefix_t *prefix1, 
                      prefix_t *prefix2, 
@@ -160,23 +231,26 @@ prefix_t *
 leak_prefix(char *node_name, char *prefix, char mask, 
             LEVEL from_level, LEVEL to_level);
 
-/*We need prefix list management routines for route_t->like_prefix_list
- * and node_t->local_prefix_list*/
+/*Prefix management routines for node_t->local_prefix_store*/
 
 typedef struct routes_ routes_t;
 
 FLAG
-add_prefix_to_prefix_list(ll_t *prefix_list, prefix_t *prefix, unsigned int hosting_node_metric);
+add_prefix_to_prefix_store(prefix_store_t *store, prefix_t *prefix, unsigned int hosting_node_metric);
 
 void
-delete_prefix_from_prefix_list(ll_t *prefix_list, char *prefix, char mask);
+delete_prefix_from_prefix_store(prefix_store_t *store, char *prefix, char mask);
 
 prefix_pref_data_t
 route_preference(FLAG route_flags, LEVEL level);
 
 void
-add_new_prefix_in_list(ll_t *prefix_list , prefix_t *prefix,
-                unsigned int prefix_hosting_node_metric);
+set_prefix_preference(prefix_t *prefix);
+
+/*Selection key of a prefix among like prefixes of a route, lower is better :
+ * preference (8 bits) | metric to prefix (32 bits) | hosting node id (24 bits)*/
+#define PREFIX_SELECTION_KEY(prefix_ptr, _metric)   \
+    ((prefix_ptr)->selection_key | ((unsigned long long)(_metric) << 24))
 
 boolean
 is_node_best_prefix_originator(node_t *node, routes_t *route);
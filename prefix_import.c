@@ -0,0 +1,227 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  prefix_import.c
+ *
+ *    Description:  This file implements the bulk prefix import (redistribution) of
+ *                  a large external prefix table into ISIS.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <arpa/inet.h>
+#include "prefix_import.h"
+#include "instance.h"
+#include "advert.h"
+#include "spfutil.h"
+
+extern instance_t *instance;
+
+#define PREFIX_IMPORT_MAX_LINE_LEN  128
+
+/*Returns TRUE if line carried a valid prefix*/
+static boolean
+parse_import_line(char *line, char *prefix, unsigned char *mask, 
+                  unsigned int *metric){
+
+    unsigned int _mask = 0, 
+                 addr = 0;
+    int n_tokens = 0;
+
+    *metric = 0;
+    n_tokens = sscanf(line, "%15[0-9.]/%u %u", prefix, &_mask, metric);
+    if(n_tokens < 2)
+        n_tokens = sscanf(line, "%15[0-9.] %u %u", prefix, &_mask, metric);
+    if(n_tokens < 2)
+        return FALSE;
+
+    if(_mask > 32 || inet_pton(AF_INET, prefix, &addr) != 1)
+        return FALSE;
+
+    *mask = (unsigned char)_mask;
+    return TRUE;
+}
+
+unsigned int
+import_prefixes_from_buffer(node_t *node, LEVEL level, 
+                            const char *buf, size_t len, 
+                            prefix_import_stats_t *stats){
+
+    const char *line_start = buf, 
+               *line_end = NULL,
+               *buf_end = buf + len;
+    char line[PREFIX_IMPORT_MAX_LINE_LEN],
+         str_prefix[PREFIX_LEN + 1];
+    unsigned char mask = 0;
+    unsigned int i = 0,
+                 metric = 0,
+                 line_len = 0,
+                 n_prefixes = 0,
+                 size = 1024;
+    unsigned long long start_time = 0;
+    prefix_t *prefix = NULL,
+             **prefixes = NULL;
+    common_pfx_key_t *keys = NULL;
+    tlv128_ip_reach_bulk_t ad_msg;
+    dist_info_hdr_t dist_info_hdr;
+    struct rusage usage;
+
+    memset(stats, 0, sizeof(prefix_import_stats_t));
+    start_time = get_time_usec();
+    prefixes = calloc(size, sizeof(prefix_t *));
+
+    for(; line_start < buf_end; line_start = line_end + 1){
+
+        line_end = memchr(line_start, '\n', buf_end - line_start);
+        if(!line_end)
+            line_end = buf_end;
+
+        while(line_start < line_end && (*line_start == ' ' || *line_start == '\t'))
+            line_start++;
+        if(line_start == line_end || *line_start == '#' || *line_start == '\r')
+            continue;
+
+        stats->n_lines++;
+        line_len = line_end - line_start;
+        if(line_len >= PREFIX_IMPORT_MAX_LINE_LEN){
+            stats->n_invalid++;
+            continue;
+        }
+        memcpy(line, line_start, line_len);
+        line[line_len] = '\0';
+
+        memset(str_prefix, 0, sizeof(str_prefix));
+        if(!parse_import_line(line, str_prefix, &mask, &metric)){
+            stats->n_invalid++;
+            continue;
+        }
+
+        if(n_prefixes == size){
+            size <<= 1;
+            prefixes = realloc(prefixes, size * sizeof(prefix_t *));
+        }
+
+        prefix = create_new_prefix(str_prefix, mask, level);
+        prefix->metric = metric;
+        prefix->hosting_node = node;
+        SET_BIT(prefix->prefix_flags, PREFIX_EXTERNABIT_FLAG);
+        prefixes[n_prefixes++] = prefix;
+    }
+
+    stats->n_imported = prefix_store_bulk_add(GET_NODE_PREFIX_STORE(node, level), 
+                                              prefixes, n_prefixes);
+
+    stats->n_duplicate = n_prefixes - stats->n_imported;
+
+    /*Keys are needed only if receivers are going to run per prefix PRC*/
+    if(stats->n_imported <= PRC_MAX_PREFIXES){
+        keys = calloc(stats->n_imported, sizeof(common_pfx_key_t));
+        for(i = 0; i < stats->n_imported; i++){
+            strncpy(keys[i].u.prefix.prefix, prefixes[i]->prefix, PREFIX_LEN);
+            keys[i].u.prefix.mask = prefixes[i]->mask;
+        }
+    }
+
+    /*Duplicates are left to us by prefix store*/
+    for(i = stats->n_imported; i < n_prefixes; i++)
+        free_prefix(prefixes[i]);
+
+    free(prefixes);
+    stats->load_usec = get_time_usec() - start_time;
+
+#ifdef __ENABLE_TRACE__    
+    sprintf(instance->traceopts->b, "Node : %s : %u prefixes imported in %s, %u duplicates, %u invalid", 
+            node->node_name, stats->n_imported, get_str_level(level), 
+            stats->n_duplicate, stats->n_invalid);
+    trace(instance->traceopts, SPF_PREFIX_BIT);
+#endif
+
+    if(stats->n_imported){
+        start_time = get_time_usec();
+        memset(&ad_msg, 0, sizeof(tlv128_ip_reach_bulk_t));
+        ad_msg.prefixes = keys;
+        ad_msg.n_prefixes = stats->n_imported;
+        ad_msg.hosting_node = node;
+
+        memset(&dist_info_hdr, 0, sizeof(dist_info_hdr_t));
+        dist_info_hdr.lsp_generator = node;
+        dist_info_hdr.info_dist_level = level;
+        dist_info_hdr.add_or_remove = AD_CONFIG_ADDED;
+        dist_info_hdr.advert_id = TLV128_BULK;
+        dist_info_hdr.info_data = (char *)&ad_msg;
+        generate_lsp(instance, node, lsp_distribution_routine, &dist_info_hdr);
+        stats->prc_usec = get_time_usec() - start_time;
+    }
+
+    if(keys)
+        free(keys);
+
+    getrusage(RUSAGE_SELF, &usage);
+    stats->peak_rss_kb = usage.ru_maxrss;
+    return stats->n_imported;
+}
+
+unsigned int
+import_prefixes_from_file(node_t *node, LEVEL level, 
+                          const char *file_name, 
+                          prefix_import_stats_t *stats){
+
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long file_size = 0;
+    unsigned int n_imported = 0;
+
+    fp = fopen(file_name, "r");
+    if(!fp){
+        printf("%s() : Error : could not open file %s\n", __FUNCTION__, file_name);
+        return 0;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    buf = malloc(file_size > 0 ? file_size : 1);
+    if(file_size > 0 && fread(buf, 1, file_size, fp) != (size_t)file_size){
+        printf("%s() : Error : could not read file %s\n", __FUNCTION__, file_name);
+        free(buf);
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+
+    n_imported = import_prefixes_from_buffer(node, level, buf, 
+                    file_size > 0 ? file_size : 0, stats);
+    free(buf);
+    return n_imported;
+}
+
+void
+print_prefix_import_stats(node_t *node, LEVEL level, 
+                          prefix_import_stats_t *stats){
+
+    printf("Node : %s, %s prefix import :\n", node->node_name, get_str_level(level));
+    printf("\tLines : %u, Imported : %u, Duplicates : %u, Invalid : %u\n",
+            stats->n_lines, stats->n_imported, stats->n_duplicate, stats->n_invalid);
+    printf("\tLoad time : %llu.%03llu ms, PRC time : %llu.%03llu ms\n",
+            stats->load_usec / 1000, stats->load_usec % 1000,
+            stats->prc_usec / 1000, stats->prc_usec % 1000);
+    printf("\tPeak RSS : %ld KB\n", stats->peak_rss_kb);
+}
@@ -0,0 +1,64 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  prefix_import.h
+ *
+ *    Description:  This file declares the bulk prefix import API. A whole external
+ *                  table is redistributed into ISIS by a node in one transaction :
+ *                  prefixes are parsed, added to the node's prefix store in batch
+ *                  and advertised in a single LSP update, so that every router runs
+ *                  one PRC for the entire table.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __PREFIX_IMPORT__
+#define __PREFIX_IMPORT__
+
+#include <stddef.h>
+#include "instanceconst.h"
+
+typedef struct _node_t node_t;
+
+typedef struct prefix_import_stats_{
+
+    unsigned int n_lines;       /*Non-empty, non-comment lines*/
+    unsigned int n_imported;
+    unsigned int n_duplicate;   /*Already present on node, or repeated in input*/
+    unsigned int n_invalid;
+    unsigned long long load_usec;   /*Parsing + prefix store build*/
+    unsigned long long prc_usec;    /*LSP distribution + route calculation*/
+    long peak_rss_kb;
+} prefix_import_stats_t;
+
+/*Each line of buffer is "<prefix>/<mask> [metric]" or "<prefix> <mask> [metric]",
+ * empty lines and lines starting with '#' are ignored. Prefixes are
+ * redistributed as external prefixes. Returns the no of prefixes imported*/
+unsigned int
+import_prefixes_from_buffer(node_t *node, LEVEL level, 
+                            const char *buf, size_t len, 
+                            prefix_import_stats_t *stats);
+
+unsigned int
+import_prefixes_from_file(node_t *node, LEVEL level, 
+                          const char *file_name, 
+                          prefix_import_stats_t *stats);
+
+void
+print_prefix_import_stats(node_t *node, LEVEL level, 
+                          prefix_import_stats_t *stats);
+
+#endif /* __PREFIX_IMPORT__ */
@@ -0,0 +1,557 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rib_changelog.c
+ *
+ *    Description:  This file implements the RIB change log ring. Producer is the
+ *                  route installation code path, consumer is any FIB download
+ *                  simulator/thread. Ring is lock free, head is owned by producer
+ *                  and tail by consumer.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rib_changelog.h"
+#include "instance.h"
+
+/*Must be power of 2*/
+#define RIB_CLOG_JOURNAL_INIT_SIZE  64
+
+static rib_clog_ring_t *
+rib_clog_ring_malloc(unsigned int size, unsigned int start){
+
+    rib_clog_ring_t *ring = calloc(1, sizeof(rib_clog_ring_t));
+    ring->size = size;
+    ring->start = start;
+    ring->events = calloc(size, sizeof(rib_clog_event_t));
+    return ring;
+}
+
+rib_clog_t *
+init_rib_clog(){
+
+    rib_clog_t *clog = calloc(1, sizeof(rib_clog_t));
+    clog->prod_ring = rib_clog_ring_malloc(RIB_CLOG_RING_MIN_SIZE, 0);
+    clog->cons_ring = clog->prod_ring;
+    return clog;
+}
+
+/*No of events in producer's ring which consumer has not yet released.
+ * Events logged before producer moved to this ring are not in it*/
+static unsigned int
+rib_clog_ring_used(rib_clog_ring_t *ring, unsigned int head, unsigned int tail){
+
+    if((int)(tail - ring->start) < 0)
+        tail = ring->start;
+    return head - tail;
+}
+
+char *
+get_str_rib_clog_event(rib_clog_event_type_t event){
+
+    switch(event){
+        case RIB_CLOG_ROUTE_ADD:
+            return "ROUTE_ADD";
+        case RIB_CLOG_ROUTE_MODIFY:
+            return "ROUTE_MODIFY";
+        case RIB_CLOG_ROUTE_DELETE:
+            return "ROUTE_DELETE";
+        case RIB_CLOG_NH_ADD:
+            return "NH_ADD";
+        case RIB_CLOG_NH_DELETE:
+            return "NH_DELETE";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+static void
+rib_clog_snapshot_nh(rib_clog_nh_t *nh_snapshot, internal_un_nh_t *nh){
+
+    memset(nh_snapshot, 0, sizeof(rib_clog_nh_t));
+    if(nh->oif){
+        strncpy(nh_snapshot->oif_name, nh->oif->intf_name, IF_NAME_SIZE);
+        nh_snapshot->oif_name[IF_NAME_SIZE - 1] = '\0';
+    }
+    nh_snapshot->gw_ip = nh->gw_ip;
+    nh_snapshot->flags = nh->flags;
+    nh_snapshot->protocol = nh->protocol;
+    nh_snapshot->n_label_ops = nh->n_label_ops;
+    memcpy(nh_snapshot->label_ops, nh->label_ops, sizeof(nh->label_ops));
+}
+
+/*Producer side. Never blocks, if the consumer is lagging, event is
+ * dropped and accounted so that consumer can resync from the table*/
+static void
+rib_clog_push(rt_un_table_t *rib, rib_clog_event_type_t event,
+              rt_key_t *rt_key, LEVEL level, rib_clog_nh_t *nh){
+
+    rib_clog_t *clog = rib->clog;
+    rib_clog_ring_t *ring = clog->prod_ring;
+    rib_clog_event_t *clog_event = NULL;
+    unsigned int head = 0, tail = 0;
+
+    head = clog->head;
+    tail = __atomic_load_n(&clog->tail, __ATOMIC_ACQUIRE);
+    clog->seq_no++;
+
+    if(rib_clog_ring_used(ring, head, tail) == ring->size){
+        __atomic_add_fetch(&clog->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    clog_event = &ring->events[head & (ring->size - 1)];
+    clog_event->seq_no = clog->seq_no;
+    clog_event->event = event;
+    clog_event->rib_type = rib->rib_type;
+    clog_event->level = level;
+    memcpy(&clog_event->rt_key, rt_key, sizeof(rt_key_t));
+    if(nh)
+        memcpy(&clog_event->nh, nh, sizeof(rib_clog_nh_t));
+    else
+        memset(&clog_event->nh, 0, sizeof(rib_clog_nh_t));
+
+    /*Publish the slot only after it is completely written*/
+    __atomic_store_n(&clog->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void
+rib_clog_event(rt_un_table_t *rib, rib_clog_event_type_t event,
+               rt_key_t *rt_key, LEVEL level, internal_un_nh_t *nh){
+
+    rib_clog_nh_t nh_snapshot;
+
+    /*Within a transaction, net change is logged at commit*/
+    if(!rib->clog || rib->clog->txn)
+        return;
+
+    if(nh)
+        rib_clog_snapshot_nh(&nh_snapshot, nh);
+    rib_clog_push(rib, event, rt_key, level, nh ? &nh_snapshot : NULL);
+}
+
+/*Makes room for n_events more events. If producer's ring is short of
+ * room, producer moves to a new ring, pending events stay in the old one
+ * until consumer drains them*/
+static void
+rib_clog_reserve(rib_clog_t *clog, unsigned int n_events){
+
+    rib_clog_ring_t *ring = clog->prod_ring,
+                    *new_ring = NULL;
+    unsigned int head = clog->head,
+                 tail = __atomic_load_n(&clog->tail, __ATOMIC_ACQUIRE),
+                 size = ring->size;
+
+    if(rib_clog_ring_used(ring, head, tail) + n_events <= ring->size)
+        return;
+
+    while(size < n_events)
+        size <<= 1;
+
+    new_ring = rib_clog_ring_malloc(size, head);
+    /*Publish the new ring before any event is logged into it*/
+    __atomic_store_n(&ring->next, new_ring, __ATOMIC_RELEASE);
+    clog->prod_ring = new_ring;
+}
+
+static unsigned int
+rib_clog_key_hash(rt_un_table_t *rib, rt_key_t *rt_key){
+
+    unsigned int i = 0,
+                 hash = 2166136261U;
+    char *prefix = RT_ENTRY_PFX(rt_key);
+
+    if(rib->rib_type == MPLS_0)
+        return RT_ENTRY_LABEL(rt_key) * 2654435761U;
+
+    for(i = 0; i < PREFIX_LEN && prefix[i]; i++){
+        hash ^= (unsigned char)prefix[i];
+        hash *= 16777619U;
+    }
+    hash ^= (unsigned char)RT_ENTRY_MASK(rt_key);
+    hash *= 16777619U;
+    return hash;
+}
+
+static boolean
+rib_clog_key_equal(rt_un_table_t *rib, rt_key_t *rt_key1, rt_key_t *rt_key2){
+
+    if(rib->rib_type == MPLS_0)
+        return RT_ENTRY_LABEL(rt_key1) == RT_ENTRY_LABEL(rt_key2);
+    return strncmp(RT_ENTRY_PFX(rt_key1), RT_ENTRY_PFX(rt_key2), PREFIX_LEN) == 0 &&
+           RT_ENTRY_MASK(rt_key1) == RT_ENTRY_MASK(rt_key2);
+}
+
+static void
+rib_clog_journal_link(rt_un_table_t *rib, unsigned int index){
+
+    rib_clog_journal_t *journal = &rib->clog->journal;
+    rib_clog_preimage_t *preimage = &journal->preimages[index];
+    unsigned int bucket = 
+        rib_clog_key_hash(rib, &preimage->rt_key) & (journal->hash_size - 1);
+
+    preimage->hash_next = journal->bucket[bucket];
+    journal->bucket[bucket] = index + 1;
+}
+
+static void
+rib_clog_journal_rehash(rt_un_table_t *rib, unsigned int new_hash_size){
+
+    rib_clog_journal_t *journal = &rib->clog->journal;
+    unsigned int i = 0;
+
+    free(journal->bucket);
+    journal->hash_size = new_hash_size;
+    journal->bucket = calloc(new_hash_size, sizeof(unsigned int));
+    for(i = 0; i < journal->count; i++)
+        rib_clog_journal_link(rib, i);
+}
+
+static rib_clog_preimage_t *
+rib_clog_journal_lookup(rt_un_table_t *rib, rt_key_t *rt_key){
+
+    rib_clog_journal_t *journal = &rib->clog->journal;
+    rib_clog_preimage_t *preimage = NULL;
+    unsigned int index = 0;
+
+    if(!journal->hash_size)
+        return NULL;
+
+    index = journal->bucket[rib_clog_key_hash(rib, rt_key) & (journal->hash_size - 1)];
+    for(; index; index = preimage->hash_next){
+        preimage = &journal->preimages[index - 1];
+        if(rib_clog_key_equal(rib, &preimage->rt_key, rt_key))
+            return preimage;
+    }
+    return NULL;
+}
+
+void
+rib_clog_touch(rt_un_table_t *rib, rt_key_t *rt_key){
+
+    rib_clog_t *clog = rib->clog;
+    rib_clog_journal_t *journal = NULL;
+    rib_clog_preimage_t *preimage = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    glthread_t *curr = NULL;
+
+    if(!clog || !clog->txn)
+        return;
+
+    /*Only the state before first touch matters*/
+    if(rib_clog_journal_lookup(rib, rt_key))
+        return;
+
+    journal = &clog->journal;
+    if(journal->count == journal->size){
+        journal->size = journal->size ? journal->size << 1 : RIB_CLOG_JOURNAL_INIT_SIZE;
+        journal->preimages = realloc(journal->preimages, 
+                journal->size * sizeof(rib_clog_preimage_t));
+    }
+
+    preimage = &journal->preimages[journal->count];
+    memset(preimage, 0, sizeof(rib_clog_preimage_t));
+    memcpy(&preimage->rt_key, rt_key, sizeof(rt_key_t));
+
+    rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+    if(rt_un_entry){
+        preimage->existed = TRUE;
+        preimage->level = rt_un_entry->level;
+        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+            preimage->n_nh++;
+        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+        preimage->nh = calloc(preimage->n_nh ? preimage->n_nh : 1, sizeof(rib_clog_nh_t));
+        preimage->n_nh = 0;
+        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+            rib_clog_snapshot_nh(&preimage->nh[preimage->n_nh++],
+                                 glthread_to_unified_nh(curr));
+        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    }
+
+    journal->count++;
+    if(journal->count > journal->hash_size){
+        /*rehash links the new preimage too*/
+        rib_clog_journal_rehash(rib, journal->hash_size ? 
+                journal->hash_size << 1 : RIB_CLOG_JOURNAL_INIT_SIZE);
+        return;
+    }
+    rib_clog_journal_link(rib, journal->count - 1);
+}
+
+void
+rib_clog_begin(rt_un_table_t *rib){
+
+    if(rib->clog)
+        rib->clog->txn++;
+}
+
+static boolean
+rib_clog_nh_present(rib_clog_nh_t *nh, rib_clog_nh_t *nhs, unsigned int n_nh){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < n_nh; i++){
+        if(memcmp(nh, &nhs[i], sizeof(rib_clog_nh_t)) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static boolean
+rib_clog_entry_has_nh(rt_un_entry_t *rt_un_entry, rib_clog_nh_t *nh){
+
+    glthread_t *curr = NULL;
+    rib_clog_nh_t nh_snapshot;
+
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+        rib_clog_snapshot_nh(&nh_snapshot, glthread_to_unified_nh(curr));
+        if(memcmp(nh, &nh_snapshot, sizeof(rib_clog_nh_t)) == 0)
+            return TRUE;
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    return FALSE;
+}
+
+/*Logs the difference between preimage and current state of the entry*/
+static void
+rib_clog_log_net_change(rt_un_table_t *rib, rib_clog_preimage_t *preimage){
+
+    unsigned int i = 0;
+    glthread_t *curr = NULL;
+    rib_clog_nh_t nh_snapshot;
+    rt_un_entry_t *rt_un_entry = 
+        rib->rt_un_route_lookup(rib, &preimage->rt_key);
+
+    if(!rt_un_entry){
+        if(preimage->existed)
+            rib_clog_push(rib, RIB_CLOG_ROUTE_DELETE, &preimage->rt_key,
+                          preimage->level, NULL);
+        return;
+    }
+
+    if(!preimage->existed)
+        rib_clog_push(rib, RIB_CLOG_ROUTE_ADD, &rt_un_entry->rt_key,
+                      rt_un_entry->level, NULL);
+    else if(preimage->level != rt_un_entry->level)
+        rib_clog_push(rib, RIB_CLOG_ROUTE_MODIFY, &rt_un_entry->rt_key,
+                      rt_un_entry->level, NULL);
+
+    for(i = 0; i < preimage->n_nh; i++){
+        if(!rib_clog_entry_has_nh(rt_un_entry, &preimage->nh[i]))
+            rib_clog_push(rib, RIB_CLOG_NH_DELETE, &rt_un_entry->rt_key,
+                          rt_un_entry->level, &preimage->nh[i]);
+    }
+
+    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+        rib_clog_snapshot_nh(&nh_snapshot, glthread_to_unified_nh(curr));
+        if(!rib_clog_nh_present(&nh_snapshot, preimage->nh, preimage->n_nh))
+            rib_clog_push(rib, RIB_CLOG_NH_ADD, &rt_un_entry->rt_key,
+                          rt_un_entry->level, &nh_snapshot);
+    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+}
+
+void
+rib_clog_commit(rt_un_table_t *rib){
+
+    rib_clog_t *clog = rib->clog;
+    rib_clog_journal_t *journal = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    glthread_t *curr = NULL;
+    unsigned int i = 0, 
+                 n_events = 0;
+
+    if(!clog)
+        return;
+
+    assert(clog->txn);
+    if(--clog->txn)
+        return;
+
+    journal = &clog->journal;
+
+    /*Upper bound of events to be logged, so that the ring can be sized
+     * to hold the net change of whole table*/
+    for(i = 0; i < journal->count; i++){
+        n_events += 1 + journal->preimages[i].n_nh;
+        rt_un_entry = rib->rt_un_route_lookup(rib, &journal->preimages[i].rt_key);
+        if(!rt_un_entry)
+            continue;
+        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+            n_events++;
+        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    }
+    rib_clog_reserve(clog, n_events);
+
+    for(i = 0; i < journal->count; i++){
+        rib_clog_log_net_change(rib, &journal->preimages[i]);
+        free(journal->preimages[i].nh);
+    }
+
+    journal->count = 0;
+    if(journal->hash_size)
+        memset(journal->bucket, 0, journal->hash_size * sizeof(unsigned int));
+}
+
+void
+rib_clog_begin_node(node_t *node){
+
+    rib_type_t rib_type;
+
+    for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++)
+        rib_clog_begin(node->spf_info.rib[rib_type]);
+}
+
+void
+rib_clog_commit_node(node_t *node){
+
+    rib_type_t rib_type;
+
+    for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++)
+        rib_clog_commit(node->spf_info.rib[rib_type]);
+}
+
+/*Consumer side. Hands over upto max_batch events (0 = all pending) to
+ * consumer_fn in contiguous slices, and releases them back to the
+ * producer in one shot. Returns the no of events consumed*/
+unsigned int
+rib_clog_drain(rt_un_table_t *rib, unsigned int max_batch,
+               rib_clog_consumer_fn consumer_fn, void *arg){
+
+    rib_clog_t *clog = rib->clog;
+    rib_clog_ring_t *ring = NULL,
+                    *next_ring = NULL;
+    unsigned int head = 0, tail = 0,
+                 n_events = 0, index = 0,
+                 chunk = 0, count = 0;
+
+    if(!clog)
+        return 0;
+
+    tail = clog->tail;
+    head = __atomic_load_n(&clog->head, __ATOMIC_ACQUIRE);
+    n_events = head - tail;
+
+    if(max_batch && n_events > max_batch)
+        n_events = max_batch;
+
+    while(n_events){
+        ring = clog->cons_ring;
+        /*Next ring is published before head moves past its start, so it
+         * is visible here if any event read below head lies in it*/
+        next_ring = __atomic_load_n(&ring->next, __ATOMIC_ACQUIRE);
+        if(next_ring && tail == next_ring->start){
+            /*Producer has left this ring for good*/
+            clog->cons_ring = next_ring;
+            free(ring->events);
+            free(ring);
+            continue;
+        }
+        index = tail & (ring->size - 1);
+        chunk = ring->size - index;
+        if(next_ring && chunk > next_ring->start - tail)
+            chunk = next_ring->start - tail;
+        if(chunk > n_events)
+            chunk = n_events;
+        consumer_fn(&ring->events[index], chunk, arg);
+        tail += chunk;
+        n_events -= chunk;
+        count += chunk;
+    }
+
+    __atomic_store_n(&clog->tail, tail, __ATOMIC_RELEASE);
+    return count;
+}
+
+unsigned long long
+rib_clog_bytes(rt_un_table_t *rib){
+
+    rib_clog_t *clog = rib->clog;
+    if(!clog) return 0;
+    /*Rings which consumer has not yet released are not accounted*/
+    return sizeof(rib_clog_t) + sizeof(rib_clog_ring_t) +
+           (unsigned long long)clog->prod_ring->size * sizeof(rib_clog_event_t) +
+           (unsigned long long)clog->journal.size * sizeof(rib_clog_preimage_t) +
+           (unsigned long long)clog->journal.hash_size * sizeof(unsigned int);
+}
+
+unsigned int
+rib_clog_pending(rt_un_table_t *rib){
+
+    rib_clog_t *clog = rib->clog;
+    if(!clog) return 0;
+    return __atomic_load_n(&clog->head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&clog->tail, __ATOMIC_ACQUIRE);
+}
+
+/*Read and reset the dropped counter*/
+unsigned int
+rib_clog_dropped(rt_un_table_t *rib){
+
+    rib_clog_t *clog = rib->clog;
+    if(!clog) return 0;
+    return __atomic_exchange_n(&clog->dropped, 0, __ATOMIC_ACQ_REL);
+}
+
+static void
+print_rib_clog_events(rib_clog_event_t *events, unsigned int n_events, void *arg){
+
+    unsigned int i = 0;
+    rib_clog_event_t *clog_event = NULL;
+    char gw_prefix[PREFIX_LEN + 1];
+
+    for(i = 0; i < n_events; i++){
+        clog_event = &events[i];
+        printf("\t%-8llu %-13s L%u %s/%u", clog_event->seq_no,
+                get_str_rib_clog_event(clog_event->event), clog_event->level,
+                RT_ENTRY_PFX(&clog_event->rt_key), RT_ENTRY_MASK(&clog_event->rt_key));
+        if(clog_event->rib_type == MPLS_0)
+            printf("(%u)", RT_ENTRY_LABEL(&clog_event->rt_key));
+        if(clog_event->event == RIB_CLOG_NH_ADD ||
+           clog_event->event == RIB_CLOG_NH_DELETE){
+            gw_prefix[0] = '\0';
+            if(clog_event->nh.gw_ip)
+                inet_ntop(AF_INET, &clog_event->nh.gw_ip, gw_prefix, PREFIX_LEN + 1);
+            printf(" --> %s %s %s", clog_event->nh.oif_name, gw_prefix,
+                    get_str_nexthop_type(clog_event->nh.flags));
+            if(!IS_BIT_SET(clog_event->nh.flags, PRIMARY_NH))
+                printf(" (backup)");
+        }
+        printf("\n");
+    }
+}
+
+void
+show_rib_clog(node_t *node){
+
+    rib_type_t rib_type;
+    rt_un_table_t *rib = NULL;
+    unsigned int dropped = 0;
+
+    for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++){
+        rib = node->spf_info.rib[rib_type];
+        dropped = rib_clog_dropped(rib);
+        printf("%s : pending events = %u, dropped events = %u\n",
+                rib->rib_name, rib_clog_pending(rib), dropped);
+        rib_clog_drain(rib, 0, print_rib_clog_events, NULL);
+        if(dropped)
+            printf("\tWarning : change log overflowed, consumer must resync %s\n",
+                rib->rib_name);
+    }
+}
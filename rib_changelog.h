@@ -0,0 +1,168 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rib_changelog.h
+ *
+ *    Description:  This file declares the RIB change log. Every RIB (inet.0, inet.3,
+ *                  mpls.0) of every node records route/nexthop add, modify and delete
+ *                  events into a single-producer single-consumer ring which can be
+ *                  drained in batches by FIB download consumer.
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __RIB_CHANGELOG__
+#define __RIB_CHANGELOG__
+
+#include "data_plane.h"
+
+/*Initial ring size, producer moves to a larger ring to hold the net
+ * change of a whole transaction. Must be power of 2*/
+#define RIB_CLOG_RING_MIN_SIZE  512
+
+typedef enum{
+
+    RIB_CLOG_ROUTE_ADD,
+    RIB_CLOG_ROUTE_MODIFY,
+    RIB_CLOG_ROUTE_DELETE,
+    RIB_CLOG_NH_ADD,
+    RIB_CLOG_NH_DELETE
+} rib_clog_event_type_t;
+
+/*Snapshot of a nexthop. Consumer must not dereference RIB memory since
+ * it may be freed by then*/
+typedef struct rib_clog_nh_{
+
+    char oif_name[IF_NAME_SIZE];
+    unsigned int gw_ip; /*network byte order*/
+    FLAG flags;
+    PROTOCOL protocol;
+    unsigned char n_label_ops;
+    mpls_label_op_t label_ops[MPLS_STACK_OP_LIMIT_MAX];
+} rib_clog_nh_t;
+
+typedef struct rib_clog_event_{
+
+    unsigned long long seq_no;
+    rib_clog_event_type_t event;
+    rib_type_t rib_type;
+    LEVEL level;
+    rt_key_t rt_key;
+    rib_clog_nh_t nh; /*valid for RIB_CLOG_NH_ADD/DELETE only*/
+} rib_clog_event_t;
+
+/*State of a routing entry as it was before a transaction touched it*/
+typedef struct rib_clog_preimage_{
+
+    rt_key_t rt_key;
+    boolean existed;
+    LEVEL level;
+    unsigned int n_nh;
+    rib_clog_nh_t *nh;
+    unsigned int hash_next; /*index + 1 of next preimage in hash chain*/
+} rib_clog_preimage_t;
+
+/*Preimages of the entries touched by the transaction in progress, in
+ * the order they were first touched, and hashed on route key*/
+typedef struct rib_clog_journal_{
+
+    unsigned int count;
+    unsigned int size;
+    rib_clog_preimage_t *preimages;
+    unsigned int hash_size;     /*Power of 2*/
+    unsigned int *bucket;       /*index + 1 of first preimage in chain*/
+} rib_clog_journal_t;
+
+/*Producer never resizes a ring the consumer may be reading. It links a
+ * larger ring after the current one and logs into it from head onwards.
+ * Consumer moves to the next ring once it has drained upto its start,
+ * and only then frees the ring it left*/
+typedef struct rib_clog_ring_{
+
+    unsigned int size;          /*Power of 2*/
+    unsigned int start;         /*head at which producer moved to this ring*/
+    struct rib_clog_ring_ *next;
+    rib_clog_event_t *events;
+} rib_clog_ring_t;
+
+typedef struct rib_clog_{
+
+    /*Written by producer (SPF/route installation) only*/
+    unsigned long long seq_no;
+    unsigned int head;
+    /*Nesting depth of transactions. Within a transaction, RIB ops only
+     * record preimages, net changes are logged at commit*/
+    unsigned int txn;
+    rib_clog_journal_t journal;
+    rib_clog_ring_t *prod_ring;
+    /*Written by consumer only*/
+    unsigned int tail;
+    /* No of events dropped because ring was full. Consumer must
+     * resync by rescanning the table when it finds this non-zero*/
+    unsigned int dropped;
+    rib_clog_ring_t *cons_ring;
+} rib_clog_t;
+
+/*Consumer is handed contiguous slices of ring, no copy*/
+typedef void (*rib_clog_consumer_fn)(rib_clog_event_t *events,
+                unsigned int n_events, void *arg);
+
+rib_clog_t *
+init_rib_clog();
+
+void
+rib_clog_event(rt_un_table_t *rib, rib_clog_event_type_t event,
+               rt_key_t *rt_key, LEVEL level, internal_un_nh_t *nh);
+
+/*Must be called by every RIB op before it modifies the entry of rt_key*/
+void
+rib_clog_touch(rt_un_table_t *rib, rt_key_t *rt_key);
+
+/*Transactions may nest, only the outermost commit logs the changes. An
+ * entry flushed and reinstalled with the same nexthops logs nothing*/
+void
+rib_clog_begin(rt_un_table_t *rib);
+
+void
+rib_clog_commit(rt_un_table_t *rib);
+
+/*Transaction on all RIBs of node*/
+void
+rib_clog_begin_node(node_t *node);
+
+void
+rib_clog_commit_node(node_t *node);
+
+unsigned int
+rib_clog_drain(rt_un_table_t *rib, unsigned int max_batch,
+               rib_clog_consumer_fn consumer_fn, void *arg);
+
+unsigned int
+rib_clog_pending(rt_un_table_t *rib);
+
+unsigned int
+rib_clog_dropped(rt_un_table_t *rib);
+
+unsigned long long
+rib_clog_bytes(rt_un_table_t *rib);
+
+char *
+get_str_rib_clog_event(rib_clog_event_type_t event);
+
+void
+show_rib_clog(node_t *node);
+
+#endif /* __RIB_CHANGELOG__ */
@@ -81,6 +81,7 @@ init_back_up_computation(node_t *S, LEVEL level){
        } ITERATE_NH_TYPE_END;
    } ITERATE_LIST_END;
    clear_pq_nodes(S, level);
+   instance->backup_owner[level] = NULL;
 }
 
 /*It should work for both broadcast and non-broadcast links*/
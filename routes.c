@@ -30,6 +30,8 @@
  * =====================================================================================
  */
 
+#include <pthread.h>
+#include <arpa/inet.h>
 #include "spfutil.h"
 #include "routes.h"
 #include "bitsop.h"
@@ -37,6 +39,7 @@
 #include "spftrace.h"
 #include "igp_sr_ext.h"
 #include "sr_tlv_api.h"
+#include "rib_changelog.h"
 #include "no_warn.h"
 
 extern instance_t *instance;
@@ -68,20 +71,53 @@ is_destination_has_multiple_primary_nxthops(spf_result_t *D_res){
     return TRUE;
 }
 
+/*routes_t objects are carved out of slabs and recycled through a
+ * free list, SPF runs create and destroy a route per prefix, this
+ * keeps those off the malloc path*/
+#define ROUTE_SLAB_SIZE 32
+
+typedef struct route_slab_{
+    struct route_slab_ *next;
+    routes_t routes[ROUTE_SLAB_SIZE];
+} route_slab_t;
+
+static route_slab_t *route_slabs = NULL;
+static routes_t *route_free_list = NULL;
+/*Route build workers allocate routes concurrently*/
+static pthread_mutex_t route_slab_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+route_slab_grow(){
+
+    unsigned int i = 0;
+    route_slab_t *slab = calloc(1, sizeof(route_slab_t));
+
+    slab->next = route_slabs;
+    route_slabs = slab;
+    for(i = 0; i < ROUTE_SLAB_SIZE; i++){
+        slab->routes[i].slab_next = route_free_list;
+        route_free_list = &slab->routes[i];
+    }
+}
+
 routes_t *
 route_malloc(){
 
-    nh_type_t nh;
-    routes_t *route = calloc(1, sizeof(routes_t));
-    ITERATE_NH_TYPE_BEGIN(nh){
-        route->primary_nh_list[nh] = init_singly_ll();
-        singly_ll_set_comparison_fn(route->primary_nh_list[nh], instance_node_comparison_fn);
-        route->backup_nh_list[nh] = init_singly_ll();
-        singly_ll_set_comparison_fn(route->backup_nh_list[nh], instance_node_comparison_fn);
-    }ITERATE_NH_TYPE_END;
+    routes_t *route = NULL;
+
+    pthread_mutex_lock(&route_slab_mutex);
+    if(!route_free_list)
+        route_slab_grow();
+
+    route = route_free_list;
+    route_free_list = route->slab_next;
+    pthread_mutex_unlock(&route_slab_mutex);
+    memset(route, 0, sizeof(routes_t));
+
     route->like_prefix_list = init_singly_ll();
     singly_ll_set_comparison_fn(route->like_prefix_list, get_prefix_comparison_fn());
     singly_ll_set_order_comparison_fn(route->like_prefix_list, get_prefix_order_comparison_fn());
+    route->nhg = nh_group_new();
     route->install_state = RTE_ADDED;
     return route;
 }
@@ -90,27 +126,26 @@ static void
 merge_route_primary_nexthops(routes_t *route, spf_result_t *result, nh_type_t nh){
 
     unsigned int i = 0;
-    internal_nh_t *int_nxt_hop = NULL;
      
     for( ; i < MAX_NXT_HOPS ; i++){
 
         if(is_internal_nh_t_empty(result->next_hop[nh][i]))
             break;
 
-        if(is_internal_nh_exist(route->primary_nh_list[nh], &result->next_hop[nh][i]))
+        if(route_nh_array_is_exist(&ROUTE_PRIMARY_NH(route, nh), &result->next_hop[nh][i]))
             continue;
-        int_nxt_hop = calloc(1, sizeof(internal_nh_t));
-        copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
-        singly_ll_add_node_by_val(route->primary_nh_list[nh], int_nxt_hop);
+        ROUTE_ADD_PRIMARY_NH(route, nh, &result->next_hop[nh][i]);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
-                     route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                     result->next_hop[nh][i].node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
+                         route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                         result->next_hop[nh][i].node->node_name); 
+            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+        }
 #endif
     }
 
-    assert(GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]) <= MAX_NXT_HOPS);
+    assert(ROUTE_PRIMARY_NH(route, nh).count <= MAX_NXT_HOPS);
 }
 
 static void
@@ -119,8 +154,7 @@ merge_route_backup_nexthops(routes_t *route,
                             nh_type_t nh){
 
     unsigned int i = 0;
-    internal_nh_t *int_nxt_hop = NULL,
-                  *backup = NULL;
+    internal_nh_t *backup = NULL;
 
     boolean dont_collect_onlylink_protecting_backups =
         is_destination_has_multiple_primary_nxthops(result);
@@ -129,7 +163,7 @@ merge_route_backup_nexthops(routes_t *route,
         
         backup = &result->node->backup_next_hop[route->level][nh][i];
         if(is_internal_nh_t_empty(*backup)) break;
-        if(is_internal_nh_exist(route->backup_nh_list[nh], backup))
+        if(route_nh_array_is_exist(&ROUTE_BACKUP_NH(route, nh), backup))
             continue;
 
         if(dont_collect_onlylink_protecting_backups){
@@ -142,30 +176,32 @@ merge_route_backup_nexthops(routes_t *route,
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
-                            backup->oif->intf_name,
-                            next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
-                            next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
-                            backup->node ? backup->node->node_name : backup->rlfa->node_name,
-                            backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                            backup->protected_link->intf_name); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                                backup->oif->intf_name,
+                                next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
+                                next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
+                                backup->node ? backup->node->node_name : backup->rlfa->node_name,
+                                backup->node ? backup->node->router_id : backup->rlfa->router_id, 
+                                backup->protected_link->intf_name); 
+                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                    }
 #endif
                 continue;
             }
         }
 
-        int_nxt_hop = calloc(1, sizeof(internal_nh_t));
-        copy_internal_nh_t(result->node->backup_next_hop[route->level][nh][i], *int_nxt_hop);
-        singly_ll_add_node_by_val(route->backup_nh_list[nh], int_nxt_hop);
+        ROUTE_ADD_BACKUP_NH(route, nh, backup);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's next hop node %s", 
-                     route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                     result->node->backup_next_hop[route->level][nh][i].node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's next hop node %s", 
+                         route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                         result->node->backup_next_hop[route->level][nh][i].node->node_name); 
+            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
     }
-    assert(GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]) <= MAX_NXT_HOPS);
+    assert(ROUTE_BACKUP_NH(route, nh).count <= MAX_NXT_HOPS);
 }
 
 void
@@ -180,42 +216,135 @@ void
 free_route(routes_t *route){
 
     if(!route)  return;
-    nh_type_t nh; 
     route->hosting_node = 0;
     
-    ITERATE_NH_TYPE_BEGIN(nh){
-        ROUTE_FLUSH_PRIMARY_NH_LIST(route, nh);
-        free(route->primary_nh_list[nh]);
-        route->primary_nh_list[nh] = 0;
-        ROUTE_FLUSH_BACKUP_NH_LIST(route, nh);
-        free(route->backup_nh_list[nh]);
-        route->backup_nh_list[nh] = 0;
-    } ITERATE_NH_TYPE_END;
+    nh_group_release(route->nhg);
+    route->nhg = NULL;
     
     delete_singly_ll(route->like_prefix_list);
     free(route->like_prefix_list);
     route->like_prefix_list = NULL;
-    free(route);
+    /*Return to the slab free list*/
+    pthread_mutex_lock(&route_slab_mutex);
+    route->slab_next = route_free_list;
+    route_free_list = route;
+    pthread_mutex_unlock(&route_slab_mutex);
+}
+
+
+static unsigned int
+route_key_hash(char *masked_prefix, char mask){
+
+    unsigned int hash = 2166136261U;
+
+    for(; *masked_prefix; masked_prefix++){
+        hash ^= (unsigned char)*masked_prefix;
+        hash *= 16777619U;
+    }
+    hash ^= (unsigned char)mask;
+    hash *= 16777619U;
+    return hash;
+}
+
+route_index_t *
+init_route_index(){
+
+    route_index_t *index = calloc(1, sizeof(route_index_t));
+    index->hash_size = ROUTE_INDEX_INIT_SIZE;
+    index->bucket = calloc(index->hash_size, sizeof(routes_t *));
+    return index;
+}
+
+#define ROUTE_INDEX_BUCKET(index_ptr, route_ptr)                             \
+    (route_key_hash((route_ptr)->rt_key.u.prefix.prefix,                     \
+        (route_ptr)->rt_key.u.prefix.mask) & ((index_ptr)->hash_size - 1))
+
+static void
+route_index_rehash(route_index_t *index, unsigned int new_hash_size){
+
+    unsigned int i = 0, old_hash_size = index->hash_size;
+    routes_t **old_bucket = index->bucket,
+             *route = NULL,
+             *next = NULL;
+
+    index->hash_size = new_hash_size;
+    index->bucket = calloc(new_hash_size, sizeof(routes_t *));
+
+    for(i = 0; i < old_hash_size; i++){
+        for(route = old_bucket[i]; route; route = next){
+            next = route->index_next;
+            route->index_next = index->bucket[ROUTE_INDEX_BUCKET(index, route)];
+            index->bucket[ROUTE_INDEX_BUCKET(index, route)] = route;
+        }
+    }
+    free(old_bucket);
+}
+
+static routes_t *
+route_index_lookup(route_index_t *index, char *masked_prefix, char mask){
+
+    routes_t *route = 
+        index->bucket[route_key_hash(masked_prefix, mask) & (index->hash_size - 1)];
+
+    for(; route; route = route->index_next){
+        if(strncmp(route->rt_key.u.prefix.prefix, masked_prefix, PREFIX_LEN) == 0 &&
+                route->rt_key.u.prefix.mask == mask)
+            return route;
+    }
+    return NULL;
+}
+
+void
+route_list_add(spf_info_t *spf_info, routes_t *route, rtttype_t rt_type){
+
+    route_index_t *index = spf_info->route_index[rt_type];
+    unsigned int bucket = 0;
+
+    singly_ll_add_node(spf_info->routes_list[rt_type], singly_ll_init_node(route));
+    singly_ll_add_node(spf_info->priority_routes_list[rt_type], singly_ll_init_node(route));
+
+    index->count++;
+    if(index->count > index->hash_size)
+        route_index_rehash(index, index->hash_size << 1);
+    bucket = ROUTE_INDEX_BUCKET(index, route);
+    route->index_next = index->bucket[bucket];
+    index->bucket[bucket] = route;
 }
 
+static void
+route_index_remove(route_index_t *index, routes_t *route){
+
+    routes_t **link = &index->bucket[ROUTE_INDEX_BUCKET(index, route)];
+
+    for(; *link; link = &(*link)->index_next){
+        if(*link != route)
+            continue;
+        *link = route->index_next;
+        route->index_next = NULL;
+        index->count--;
+        return;
+    }
+}
+
+void
+route_list_remove(spf_info_t *spf_info, routes_t *route, rtttype_t rt_type){
+
+    route_index_remove(spf_info->route_index[rt_type], route);
+    singly_ll_delete_node_by_data_ptr(spf_info->routes_list[rt_type], route);
+    singly_ll_delete_node_by_data_ptr(spf_info->priority_routes_list[rt_type], route);
+}
 
 routes_t *
 search_route_in_spf_route_list(spf_info_t *spf_info, 
                                 prefix_t *prefix,
                                 rtttype_t rt_type){
 
-    routes_t *route = NULL;
-    singly_ll_node_t* list_node = NULL;
     char prefix_with_mask[PREFIX_LEN + 1];
+
     apply_mask(prefix->prefix, prefix->mask, prefix_with_mask);
     prefix_with_mask[PREFIX_LEN] = '\0';
-    ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
-        route = list_node->data;
-        if(strncmp(route->rt_key.u.prefix.prefix, prefix_with_mask, PREFIX_LEN) == 0 &&
-                (route->rt_key.u.prefix.mask == prefix->mask))
-            return route;    
-    }ITERATE_LIST_END;
-    return NULL;
+    return route_index_lookup(spf_info->route_index[rt_type], 
+                              prefix_with_mask, prefix->mask);
 }
 
 /*Search internal route using longest prefix
@@ -224,31 +353,18 @@ routes_t *
 search_route_in_spf_route_list_by_lpm(spf_info_t *spf_info,
                                 char *prefix, rtttype_t rt_type){
 
-    routes_t *route = NULL,
-             *default_route = NULL,
-             *lpm_route = NULL;
-
-    char longest_mask = 0;
-    singly_ll_node_t* list_node = NULL;
-
-    ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
+    routes_t *route = NULL;
+    int mask = 32;
 
-        route = list_node->data;
-        if(strncmp("0.0.0.0", route->rt_key.u.prefix.prefix, strlen("0.0.0.0")) == 0 &&
-                route->rt_key.u.prefix.mask == 0){
-            default_route = route;
-        }
-        else if(strncmp(prefix, route->rt_key.u.prefix.prefix, PREFIX_LEN) == 0){
-            if( route->rt_key.u.prefix.mask > longest_mask){
-                longest_mask = route->rt_key.u.prefix.mask;
-                lpm_route = route;   
-            }
-        }
-    } ITERATE_LIST_END;
-    return lpm_route ? lpm_route : default_route;
+    /*Routes whose key is prefix itself, longest mask first*/
+    for(; mask > 0; mask--){
+        route = route_index_lookup(spf_info->route_index[rt_type], prefix, (char)mask);
+        if(route)
+            return route;
+    }
+    return route_index_lookup(spf_info->route_index[rt_type], "0.0.0.0", 0);
 }
 
-
 char * 
 route_intall_status_str(route_intall_status install_status){
 
@@ -268,32 +384,49 @@ route_intall_status_str(route_intall_status install_status){
     }
 }
 
+#define IS_ROUTE_STALE_FOR_LEVEL(route_ptr, _level)  \
+    ((route_ptr)->install_state == RTE_STALE && IS_LEVEL_SET((route_ptr)->level, _level))
+
 static unsigned int 
 delete_stale_routes(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type){
 
-   singly_ll_node_t* list_node = NULL;
+   singly_ll_node_t *list_node = NULL,
+                    *prev = NULL;
    routes_t *route = NULL;
    unsigned int i = 0;
 
 #ifdef __ENABLE_TRACE__   
-   sprintf(instance->traceopts->b, "Deleting Stale Routes"); 
-   trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+   if(instance->traceopts->enable == TR_TRUE){
+       sprintf(instance->traceopts->b, "Deleting Stale Routes"); 
+       trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+   }
 #endif
 
-   ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
+   /*Unlink stale routes from both route lists in one pass each, deleting
+    * them one by one would rescan the lists per route*/
+   ITERATE_LIST_BEGIN2(spf_info->priority_routes_list[rt_type], list_node, prev){
+       route = list_node->data;
+       if(IS_ROUTE_STALE_FOR_LEVEL(route, level))
+           ITERATIVE_LIST_NODE_DELETE2(spf_info->priority_routes_list[rt_type], list_node, prev);
+   } ITERATE_LIST_END2(spf_info->priority_routes_list[rt_type], list_node, prev);
+
+   ITERATE_LIST_BEGIN2(spf_info->routes_list[rt_type], list_node, prev){
            
        route = list_node->data;
-       if(route->install_state == RTE_STALE && IS_LEVEL_SET(route->level, level)){
+       if(IS_ROUTE_STALE_FOR_LEVEL(route, level)){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u is STALE for Level%d, deleted", route->rt_key.u.prefix.prefix, 
-                        route->rt_key.u.prefix.mask, level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "route : %s/%u is STALE for Level%d, deleted", route->rt_key.u.prefix.prefix, 
+                            route->rt_key.u.prefix.mask, level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
         i++;
-        ROUTE_DEL_FROM_ROUTE_LIST(spf_info, route, rt_type);
+        ITERATIVE_LIST_NODE_DELETE2(spf_info->routes_list[rt_type], list_node, prev);
+        route_index_remove(spf_info->route_index[rt_type], route);
         free_route(route);
         route = NULL;
        }
-   }ITERATE_LIST_END;
+   } ITERATE_LIST_END2(spf_info->routes_list[rt_type], list_node, prev);
 
    return i;
 }
@@ -327,16 +460,17 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
 
         unsigned int i = 0;
         nh_type_t nh = NH_MAX;
-        internal_nh_t *int_nxt_hop = NULL,
-                      *backup = NULL;
+        internal_nh_t *backup = NULL;
 
         delete_singly_ll(route->like_prefix_list);
         route_set_key(route, prefix->prefix, prefix->mask); 
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u being over written for %s", route->rt_key.u.prefix.prefix, 
-                    route->rt_key.u.prefix.mask, get_str_level(level)); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "route : %s/%u being over written for %s", route->rt_key.u.prefix.prefix, 
+                        route->rt_key.u.prefix.mask, get_str_level(level)); 
+            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
 
         route->version = spf_info->spf_level_info[level].version;
@@ -361,20 +495,19 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
         boolean dont_collect_onlylink_protecting_backups = 
             is_destination_has_multiple_primary_nxthops(result);
         
-        ITERATE_NH_TYPE_BEGIN(nh){
+        nh_group_reset(&route->nhg);
 
-            ROUTE_FLUSH_PRIMARY_NH_LIST(route, nh);
-            ROUTE_FLUSH_BACKUP_NH_LIST(route, nh);
+        ITERATE_NH_TYPE_BEGIN(nh){
 
             for(i = 0 ; i < MAX_NXT_HOPS; i++){
                 if(!is_internal_nh_t_empty(result->next_hop[nh][i])){
-                    int_nxt_hop = calloc(1, sizeof(internal_nh_t));
-                    copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
-                    ROUTE_ADD_NH(route->primary_nh_list[nh], int_nxt_hop);   
+                    ROUTE_ADD_PRIMARY_NH(route, nh, &result->next_hop[nh][i]);   
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
-                            route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                            result->next_hop[nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                result->next_hop[nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    }
 #endif
                 }
                 else
@@ -393,26 +526,28 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                                 backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                                 backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
 #ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
-                                    backup->oif->intf_name,
-                                    next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
-                                    next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
-                                    backup->node ? backup->node->node_name : backup->rlfa->node_name,
-                                    backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                                    backup->protected_link->intf_name); 
-                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                            if(instance->traceopts->enable == TR_TRUE){
+                                sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                                        backup->oif->intf_name,
+                                        next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
+                                        next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
+                                        backup->node ? backup->node->node_name : backup->rlfa->node_name,
+                                        backup->node ? backup->node->router_id : backup->rlfa->router_id, 
+                                        backup->protected_link->intf_name); 
+                                trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                            }
 #endif
                             continue;
                         }
                     }
 
-                    int_nxt_hop = calloc(1, sizeof(internal_nh_t));
-                    copy_internal_nh_t((result->node->backup_next_hop[level][nh][i]), *int_nxt_hop);
-                    ROUTE_ADD_NH(route->backup_nh_list[nh], int_nxt_hop);   
+                    ROUTE_ADD_BACKUP_NH(route, nh, &result->node->backup_next_hop[level][nh][i]);   
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's backup next hop node %s", 
-                            route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                            result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's backup next hop node %s", 
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    }
 #endif
                 }
                 else
@@ -421,6 +556,10 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
         } ITERATE_NH_TYPE_END;
 }
 
+/*Like prefixes of a route are kept sorted on their selection key, best
+ * prefix is at the head. Metric part of the key depends upon the spf root,
+ * so it is filled in only when preferences tie. New prefix is placed ahead
+ * of the prefix having the same key*/
 static void
 link_prefix_to_route(routes_t *route, prefix_t *new_prefix,
                      unsigned int prefix_hosting_node_metric, 
@@ -433,18 +572,17 @@ link_prefix_to_route(routes_t *route, prefix_t *new_prefix,
     prefix_t *list_prefix = NULL;
     unsigned int new_prefix_metric = 0,
                  list_prefix_metric = 0;
+    unsigned long long new_prefix_key = 0,
+                       list_prefix_key = 0;
 
     spf_result_t *res = NULL;
-    
-    prefix_pref_data_t list_prefix_pref = {ROUTE_UNKNOWN_PREFERENCE, 
-                                          "ROUTE_UNKNOWN_PREFERENCE"},
-
-                        new_prefix_pref = route_preference(new_prefix->prefix_flags, new_prefix->level);
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "To Route : %s/%u, %s, Appending prefix : %s/%u to Route prefix list",
-                 route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(route->level),
-                 new_prefix->prefix, new_prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "To Route : %s/%u, %s, Appending prefix : %s/%u to Route prefix list",
+                     route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(route->level),
+                     new_prefix->prefix, new_prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+    }
 #endif
 
     if(is_singly_ll_empty(route->like_prefix_list)){
@@ -452,80 +590,42 @@ link_prefix_to_route(routes_t *route, prefix_t *new_prefix,
         return;
     }
 
+    if(IS_BIT_SET(new_prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)) 
+        new_prefix_metric = prefix_hosting_node_metric;   
+    else
+        new_prefix_metric = prefix_hosting_node_metric + new_prefix->metric;
+
+    if(new_prefix->metric >= INFINITE_METRIC)
+        new_prefix_metric = INFINITE_METRIC; 
+
+    new_prefix_key = PREFIX_SELECTION_KEY(new_prefix, new_prefix_metric);
     list_new_node = singly_ll_init_node(new_prefix);
 
     ITERATE_LIST_BEGIN(route->like_prefix_list, list_node_next){
         
         list_prefix = (prefix_t *)list_node_next->data;
-        list_prefix_pref = route_preference(list_prefix->prefix_flags, list_prefix->level);
-
-        if(new_prefix_pref.pref > list_prefix_pref.pref){
-            list_node_prev = list_node_next;
-            continue;
-        }
+        list_prefix_key = list_prefix->selection_key;
 
-        if(new_prefix_pref.pref < list_prefix_pref.pref){
-            list_new_node->next =  list_node_next;
-            if(!list_node_prev)
-                route->like_prefix_list->head = list_new_node; 
-            else   
-                list_node_prev->next = list_new_node;
-            INC_NODE_COUNT_SINGLY_LL(route->like_prefix_list);
-            return;
-        }
-
-        /* Now tie based on metric*/
-            
-        res = GET_SPF_RESULT(spf_info, list_prefix->hosting_node, list_prefix->level);
-
-        assert(res);
+        if(list_prefix->pref == new_prefix->pref){
 
-        if(IS_BIT_SET(new_prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)) 
-            new_prefix_metric = prefix_hosting_node_metric;   
-        else
-            new_prefix_metric = prefix_hosting_node_metric + new_prefix->metric;
+            res = GET_SPF_RESULT(spf_info, list_prefix->hosting_node, list_prefix->level);
+            assert(res);
 
-
-        if(IS_BIT_SET(list_prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)) 
-            list_prefix_metric = res->spf_metric;
-        else
-            list_prefix_metric = res->spf_metric + list_prefix->metric;
-
-        if(new_prefix->metric >= INFINITE_METRIC)
-            new_prefix_metric = INFINITE_METRIC; 
-       
-        /*Check with production code, comparison looks unfair to me*/ 
-        if(new_prefix_metric > list_prefix_metric){
-            list_node_prev = list_node_next;
-            continue;
-        }
-
-        if(new_prefix_metric < list_prefix_metric){
-            list_new_node->next =  list_node_next;
-            if(!list_node_prev)
-                route->like_prefix_list->head = list_new_node; 
+            if(IS_BIT_SET(list_prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)) 
+                list_prefix_metric = res->spf_metric;
             else
-                list_node_prev->next = list_new_node; 
-            INC_NODE_COUNT_SINGLY_LL(route->like_prefix_list);
-            return;
-        }
+                list_prefix_metric = res->spf_metric + list_prefix->metric;
 
-        /* We are here because preference and metrics are same.
-         * now tie based on Router ID (We dont support this comparison, so
-         * simply insert the prefix here and exit)*/
+            list_prefix_key = PREFIX_SELECTION_KEY(list_prefix, list_prefix_metric);
+        }
 
-        list_new_node->next =  list_node_next;
-        if(!list_node_prev)
-            route->like_prefix_list->head = list_new_node;
-        else
-            list_node_prev->next = list_new_node; 
-        INC_NODE_COUNT_SINGLY_LL(route->like_prefix_list);
-        return;
+        if(new_prefix_key <= list_prefix_key)
+            break;
 
+        list_node_prev = list_node_next;
     }ITERATE_LIST_END;
 
-    /* Add at the end of list*/
-    list_new_node->next =  list_node_next;
+    list_new_node->next = list_node_next;
     if(!list_node_prev)
         route->like_prefix_list->head = list_new_node; 
     else 
@@ -533,17 +633,105 @@ link_prefix_to_route(routes_t *route, prefix_t *new_prefix,
     INC_NODE_COUNT_SINGLY_LL(route->like_prefix_list);
 }
 
+/*A unit of route build work : one prefix advertised by one spf result*/
+typedef struct route_build_work_{
+
+    spf_result_t *result;
+    prefix_t *prefix;
+    boolean linkage;
+    unsigned int hash; /*hash of the route key prefix maps to*/
+} route_build_work_t;
+
+typedef struct route_build_new_route_{
+
+    unsigned int seq_no; /*index of the work item which created the route*/
+    routes_t *route;
+} route_build_new_route_t;
+
+/*Every route key is owned by exactly one shard. Shard processes its work
+ * items in serial build order, hence each route sees the same sequence of
+ * updates as it would have seen in serial build*/
+typedef struct route_build_shard_{
+
+    unsigned int index;
+    unsigned int n_shards;
+    spf_info_t *spf_info;
+    LEVEL level;
+    route_build_work_t *work;       /*All work items, in serial build order*/
+    unsigned int *work_index;       /*Indices into work[] owned by this shard*/
+    unsigned int n_work;
+    unsigned int curr_work;         /*Index of work item being processed*/
+    routes_t *bucket[ROUTE_BUILD_SHARD_HASH_SIZE];
+    /*Routes created by this shard, linked to spf_info by the caller
+     * thread after all workers are done*/
+    route_build_new_route_t *new_routes;
+    unsigned int n_new_routes;
+} route_build_shard_t;
+
+#define ROUTE_BUILD_SHARD_BUCKET(shard_ptr, hash) \
+    (((hash) / (shard_ptr)->n_shards) & (ROUTE_BUILD_SHARD_HASH_SIZE - 1))
+
+static unsigned int
+prefix_route_key_hash(prefix_t *prefix){
+
+    char prefix_with_mask[PREFIX_LEN + 1];
+
+    apply_mask(prefix->prefix, prefix->mask, prefix_with_mask);
+    prefix_with_mask[PREFIX_LEN] = '\0';
+    return route_key_hash(prefix_with_mask, prefix->mask);
+}
+
+static void
+route_build_shard_add(route_build_shard_t *shard, routes_t *route, unsigned int hash){
+
+    unsigned int bucket = ROUTE_BUILD_SHARD_BUCKET(shard, hash);
+
+    route->shard_next = shard->bucket[bucket];
+    shard->bucket[bucket] = route;
+}
+
+/*Shard local equivalent of search_route_in_spf_route_list()*/
+static routes_t *
+route_build_shard_lookup(route_build_shard_t *shard, prefix_t *prefix){
+
+    routes_t *route = NULL;
+    unsigned int hash = shard->work[shard->curr_work].hash;
+    char prefix_with_mask[PREFIX_LEN + 1];
+
+    apply_mask(prefix->prefix, prefix->mask, prefix_with_mask);
+    prefix_with_mask[PREFIX_LEN] = '\0';
+
+    for(route = shard->bucket[ROUTE_BUILD_SHARD_BUCKET(shard, hash)]; 
+            route; route = route->shard_next){
+        if(strncmp(route->rt_key.u.prefix.prefix, prefix_with_mask, PREFIX_LEN) == 0 &&
+                route->rt_key.u.prefix.mask == prefix->mask)
+            return route;
+    }
+    return NULL;
+}
+
+static void
+route_build_shard_link_new_route(route_build_shard_t *shard, routes_t *route){
+
+    route_build_new_route_t *new_route = 
+        &shard->new_routes[shard->n_new_routes++];
+
+    new_route->seq_no = shard->curr_work;
+    new_route->route = route;
+    route_build_shard_add(shard, route, shard->work[shard->curr_work].hash);
+}
+
 static void
 update_route(spf_info_t *spf_info,          /*spf_info of computing node*/ 
              spf_result_t *result,          /*result representing some network node*/
              prefix_t *prefix,              /*local prefix hosted on 'result' node*/
              LEVEL level,  rtttype_t rt_type,
-             boolean linkage){
+             boolean linkage,
+             route_build_shard_t *shard){   /*NULL if route is not being built by parallel workers*/
 
     routes_t *route = NULL;
     unsigned int i = 0;
     nh_type_t nh = NH_MAX;
-    internal_nh_t *int_nxt_hop = NULL;
 
     prefix_pref_data_t prefix_pref = {ROUTE_UNKNOWN_PREFERENCE, "ROUTE_UNKNOWN_PREFERENCE"},
                        route_pref = {ROUTE_UNKNOWN_PREFERENCE, "ROUTE_UNKNOWN_PREFERENCE"};
@@ -551,26 +739,35 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : result node %s, topo = %s, prefix %s, level %s, prefix metric : %u",
-            GET_SPF_INFO_NODE(spf_info, level)->node_name, result->node->node_name, get_topology_name(rt_type),
-            prefix->prefix, get_str_level(level), prefix->metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "Node : %s : result node %s, topo = %s, prefix %s, level %s, prefix metric : %u",
+                GET_SPF_INFO_NODE(spf_info, level)->node_name, result->node->node_name, get_topology_name(rt_type),
+                prefix->prefix, get_str_level(level), prefix->metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+    }
 #endif
 
     if(prefix->metric == INFINITE_METRIC){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "prefix : %s/%u discarded because of infinite metric", 
-        prefix->prefix, prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "prefix : %s/%u discarded because of infinite metric", 
+            prefix->prefix, prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
         return;
     }
 
-    route = search_route_in_spf_route_list(spf_info, prefix, rt_type);
+    if(shard)
+        route = route_build_shard_lookup(shard, prefix);
+    else
+        route = search_route_in_spf_route_list(spf_info, prefix, rt_type);
 
     if(!route){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "prefix : %s/%u is a New route (malloc'd) in %s, hosting_node %s", 
-                prefix->prefix, prefix->mask, get_str_level(level), prefix->hosting_node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "prefix : %s/%u is a New route (malloc'd) in %s, hosting_node %s", 
+                    prefix->prefix, prefix->mask, get_str_level(level), prefix->hosting_node->node_name); 
+            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
 
         route = route_malloc();
@@ -604,13 +801,13 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
             for(i = 0; i < MAX_NXT_HOPS; i++){
                 if(!is_internal_nh_t_empty(result->next_hop[nh][i])){
-                    int_nxt_hop = calloc(1, sizeof(internal_nh_t));
-                    copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
-                    ROUTE_ADD_NH(route->primary_nh_list[nh], int_nxt_hop);   
+                    ROUTE_ADD_PRIMARY_NH(route, nh, &result->next_hop[nh][i]);   
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Next hop added : %s|%s at %s", 
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask ,
-                            result->next_hop[nh][i].node->node_name, nh == IPNH ? "IPNH":"LSPNH", get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Next hop added : %s|%s at %s", 
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask ,
+                                result->next_hop[nh][i].node->node_name, nh == IPNH ? "IPNH":"LSPNH", get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    }
 #endif
                 }
                 else
@@ -618,40 +815,49 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             }
             for(i = 0 ; i < MAX_NXT_HOPS; i++){
                 if(!is_internal_nh_t_empty((result->node->backup_next_hop[level][nh][i]))){
-                    int_nxt_hop = calloc(1, sizeof(internal_nh_t));
-                    copy_internal_nh_t((result->node->backup_next_hop[level][nh][i]), *int_nxt_hop);
-                    ROUTE_ADD_NH(route->backup_nh_list[nh], int_nxt_hop);   
+                    ROUTE_ADD_BACKUP_NH(route, nh, &result->node->backup_next_hop[level][nh][i]);   
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "route : %s/%u backup next hop is copied with with %s's next hop node %s", 
-                            route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                            result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "route : %s/%u backup next hop is copied with with %s's next hop node %s", 
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    }
 #endif
                 }
                 else
                     break;
             }
         }ITERATE_NH_TYPE_END;
-        /* route->backup_nh_list Not supported yet */
+        /* route->backup_nh Not supported yet */
 
         /*Linkage*/
         if(linkage){
             link_prefix_to_route(route, prefix, result->spf_metric, spf_info);
         }
 
-        ROUTE_ADD_TO_ROUTE_LIST(spf_info, route, rt_type);
+        if(shard){
+            route_build_shard_link_new_route(shard, route);
+        }
+        else{
+            ROUTE_ADD_TO_ROUTE_LIST(spf_info, route, rt_type);
+        }
         route->install_state = RTE_ADDED;
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u, spf_metric = %u, lsp_metric = %u,  marked RTE_ADDED for level%u",  
-                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                route->spf_metric, route->lsp_metric, route->level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u, spf_metric = %u, lsp_metric = %u,  marked RTE_ADDED for level%u",  
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                    route->spf_metric, route->lsp_metric, route->level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
     }
     else{
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u existing route. route verion : %u," 
-                "spf version : %u, route level : %s, spf level : %s", 
-                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->prefix, prefix->mask, route->version, 
-                spf_info->spf_level_info[level].version, get_str_level(route->level), get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u existing route. route verion : %u," 
+                    "spf version : %u, route level : %s, spf level : %s", 
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->prefix, prefix->mask, route->version, 
+                    spf_info->spf_level_info[level].version, get_str_level(route->level), get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        }
 #endif
 
         if(route->install_state == RTE_ADDED){
@@ -663,8 +869,10 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
             if(prefix_pref.pref == ROUTE_UNKNOWN_PREFERENCE){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                        prefix->prefix, prefix->mask, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                            prefix->prefix, prefix->mask, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
                 return;
             }
@@ -673,9 +881,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
                 /* if existing route is better*/ 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
-                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
+                            route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
                 /*Linkage*/
                 if(linkage){
@@ -687,9 +897,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             else if(prefix_pref.pref < route_pref.pref){
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
-                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
+                            route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
 
                 overwrite_route(spf_info, route, prefix, result, level);
@@ -703,9 +915,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             else{
                 /* If route pref = prefix pref, then decide based on metric*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
-                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
+                            route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
 
                 /* If the prefix and route are of same pref, both will have internal metric Or both will have external metric*/
@@ -721,30 +935,38 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                 if(IS_BIT_SET(prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)){
                     /*Decide pref based on external metric*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on External metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);; 
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on External metric",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
+                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);; 
+                    }
 #endif
 
                     if(prefix->metric < route->ext_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(prefix->metric > route->ext_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                     }
                     else{
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         /* Union LFA,s RLFA,s Primary nexthops*/
                         ITERATE_NH_TYPE_BEGIN(nh){
@@ -761,25 +983,31 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                 }else{
                     /*Decide pref based on internal metric*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on Internal metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on Internal metric",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
+                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    }
 #endif
                     if(result->spf_metric + prefix->metric < route->spf_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, 
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, 
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                    result->spf_metric + prefix->metric, route->spf_metric); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(result->spf_metric + prefix->metric == route->spf_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         /* Union LFA,s RLFA,s Primary nexthops*/ 
                         ITERATE_NH_TYPE_BEGIN(nh){
@@ -789,10 +1017,12 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     }
                     else{
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, 
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, 
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                    result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                     }
                     /*Linkage*/
@@ -815,8 +1045,10 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
             if(prefix_pref.pref == ROUTE_UNKNOWN_PREFERENCE){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                        prefix->prefix, prefix->mask, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                            prefix->prefix, prefix->mask, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
                 return;
             }
@@ -825,9 +1057,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
                 /* if existing route is better*/ 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
-                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
+                            route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
                 /*Linkage*/
                 if(linkage){
@@ -839,9 +1073,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             else if(prefix_pref.pref < route_pref.pref){
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
-                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
+                            route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
 
                 overwrite_route(spf_info, route, prefix, result, level);
@@ -855,9 +1091,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             else{
                 /* If route pref = prefix pref, then decide based on metric*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
-                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
+                            route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                }
 #endif
 
                 /* If the prefix and route are of same pref, both will have internal metric Or both will have external metric*/
@@ -873,30 +1111,38 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                 if(IS_BIT_SET(prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)){
                     /*Decide pref based on external metric*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on External metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);; 
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on External metric",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
+                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);; 
+                    }
 #endif
 
                     if(prefix->metric < route->ext_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(prefix->metric > route->ext_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                     }
                     else{
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         /* Union LFA,s RLFA,s Primary nexthops*/
                         ITERATE_NH_TYPE_BEGIN(nh){
@@ -913,23 +1159,29 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                 }else{
                     /*Decide pref based on internal metric*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on Internal metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on Internal metric",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
+                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    }
 #endif
                     if(result->spf_metric + prefix->metric < route->spf_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, 
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, 
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                    result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(result->spf_metric + prefix->metric == route->spf_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                         /* Union LFA,s RLFA,s Primary nexthops*/ 
                         ITERATE_NH_TYPE_BEGIN(nh){
@@ -939,10 +1191,12 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     }
                     else{
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, 
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
+                                    GET_SPF_INFO_NODE(spf_info, level)->node_name, 
+                                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
+                                    result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        }
 #endif
                     }
                     /*Linkage*/
@@ -959,22 +1213,28 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
         {
             /*prefix is from prev run and exists. This code hits only once per given route*/
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "route : %s/%u, updated route(?)", 
-                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            if(instance->traceopts->enable == TR_TRUE){
+                sprintf(instance->traceopts->b, "route : %s/%u, updated route(?)", 
+                        route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            }
 #endif
             route->install_state = RTE_UPDATED;
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u, old spf_metric = %u, new spf metric = %u, marked RTE_UPDATED for level%u",  
-                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                    route->spf_metric, result->spf_metric + prefix->metric, route->level); 
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            if(instance->traceopts->enable == TR_TRUE){
+                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u, old spf_metric = %u, new spf metric = %u, marked RTE_UPDATED for level%u",  
+                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                        route->spf_metric, result->spf_metric + prefix->metric, route->level); 
+                trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            }
 #endif
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u %s is mandatorily over-written because of version mismatch",
-                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level)); 
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            if(instance->traceopts->enable == TR_TRUE){
+                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u %s is mandatorily over-written because of version mismatch",
+                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level)); 
+                trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            }
 #endif
 
             overwrite_route(spf_info, route, prefix, result, level);
@@ -1024,9 +1284,11 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
     D_res->backup_requirement[level] = BACKUPS_REQUIRED;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Testing for Independant primary nexthops at %s for Dest %s",
-                    S->node_name, get_str_level(level), dst_node->node_name);
-    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "Node : %s : Testing for Independant primary nexthops at %s for Dest %s",
+                        S->node_name, get_str_level(level), dst_node->node_name);
+        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+    }
 #endif
     
     ITERATE_NH_TYPE_BEGIN(nh){
@@ -1048,9 +1310,11 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
                     if(dist_prim_nh1_to_D < dist_prim_nh1_to_prim_nh2 + dist_prim_nh2_to_D){
                         D_res->backup_requirement[level] = NO_BACKUP_REQUIRED;
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : Dest %s has independent Primary nexthops at %s",
-                            S->node_name, dst_node->node_name, get_str_level(level));
-                        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "Node : %s : Dest %s has independent Primary nexthops at %s",
+                                S->node_name, dst_node->node_name, get_str_level(level));
+                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        }
 #endif
                         return TRUE;
                     }
@@ -1059,9 +1323,11 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
         }
     }
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Dest %s do not have independent Primary nexthops at %s",
-            S->node_name, dst_node->node_name, get_str_level(level));
-    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "Node : %s : Dest %s do not have independent Primary nexthops at %s",
+                S->node_name, dst_node->node_name, get_str_level(level));
+        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+    }
 #endif
     return FALSE;
 }
@@ -1093,13 +1359,11 @@ is_independant_primary_next_hop_list(routes_t *route){
         ecmp_dest_node = prefix->hosting_node;
 
         ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node2){
-                next_hop = list_node2->data;
+            ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh), next_hop){
                 primary_nh1 = next_hop->node;
                 dist_prim_nh1_to_D = DIST_X_Y(primary_nh1, ecmp_dest_node, level);
                 ITERATE_NH_TYPE_BEGIN(nh1){
-                    ITERATE_LIST_BEGIN(route->primary_nh_list[nh1], list_node3){
-                        next_hop = list_node3->data;
+                    ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh1), next_hop){
                         primary_nh2 = next_hop->node;
                         if(primary_nh1 == primary_nh2)
                             continue;
@@ -1110,9 +1374,9 @@ is_independant_primary_next_hop_list(routes_t *route){
                         if(dist_prim_nh1_to_D < dist_prim_nh1_to_prim_nh2 + dist_prim_nh2_to_D){
                             return TRUE;
                         }
-                    } ITERATE_LIST_END;
+                    } ITERATE_ROUTE_NH_END;
                 } ITERATE_NH_TYPE_END;
-            } ITERATE_LIST_END;
+            } ITERATE_ROUTE_NH_END;
         } ITERATE_NH_TYPE_END;
     } ITERATE_LIST_END;
     return FALSE;
@@ -1122,7 +1386,6 @@ static void
 refine_route_backups(routes_t *route){
 
     nh_type_t nh;
-    singly_ll_node_t *list_node1 = NULL;
 
     if(IS_DEFAULT_ROUTE(route))
         return;
@@ -1130,10 +1393,12 @@ refine_route_backups(routes_t *route){
     LEVEL level = route->level;
     if(is_independant_primary_next_hop_list(route)){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route %s/%u at %s has independant "
-                "Primary Nexthops, All backup nexthops deleted", 
-                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);   
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "route %s/%u at %s has independant "
+                    "Primary Nexthops, All backup nexthops deleted", 
+                    route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
+            trace(instance->traceopts, ROUTE_CALCULATION_BIT);   
+        }
 #endif
         ITERATE_NH_TYPE_BEGIN(nh){
             ROUTE_FLUSH_BACKUP_NH_LIST(route, nh);
@@ -1141,18 +1406,17 @@ refine_route_backups(routes_t *route){
     }else{
         /*If route has more than one primary nexthops, cleanup all only-link protecting
          * backups*/
-        unsigned int count = 0;
-        singly_ll_node_t *prev_list_node = NULL;
+        unsigned int count = 0, i = 0;
         internal_nh_t *backup = NULL;
 
         ITERATE_NH_TYPE_BEGIN(nh){
-            count += GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]);
+            count += ROUTE_PRIMARY_NH(route, nh).count;
         } ITERATE_NH_TYPE_END;
 
         if(count > 1){
             ITERATE_NH_TYPE_BEGIN(nh){
-                ITERATE_LIST_BEGIN2(route->backup_nh_list[nh], list_node1, prev_list_node){
-                    backup = list_node1->data;
+                for(i = 0; i < ROUTE_BACKUP_NH(route, nh).count; i++){
+                    backup = &ROUTE_NH_ARRAY(&ROUTE_BACKUP_NH(route, nh))[i];
                     if(backup->lfa_type == LINK_PROTECTION_LFA                           ||
                             backup->lfa_type == LINK_PROTECTION_LFA_DOWNSTREAM           ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_LFA            ||
@@ -1162,43 +1426,245 @@ refine_route_backups(routes_t *route){
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup deleted : %s----%s---->%-s(%s(%s)) protecting link: %s", 
-                                backup->oif->intf_name,
-                                next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
-                                next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
-                                backup->node ? backup->node->node_name : backup->rlfa->node_name,
-                                backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                                backup->protected_link->intf_name); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                        if(instance->traceopts->enable == TR_TRUE){
+                            sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup deleted : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                                    backup->oif->intf_name,
+                                    next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
+                                    next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
+                                    backup->node ? backup->node->node_name : backup->rlfa->node_name,
+                                    backup->node ? backup->node->router_id : backup->rlfa->router_id, 
+                                    backup->protected_link->intf_name); 
+                            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                        }
 #endif
-                        free(backup);
-                        ITERATIVE_LIST_NODE_DELETE2(route->backup_nh_list[nh], list_node1, prev_list_node);
+                        route_nh_array_delete(&ROUTE_NHG_WRITABLE(route)->backup[nh], i);
+                        i--;
                     }
-                } ITERATE_LIST_END2(route->backup_nh_list[nh], list_node1, prev_list_node);
+                }
             } ITERATE_NH_TYPE_END;
         }
     }
 }
 
+/*L1-only router installs default route towards the L1L2 routers
+ * it can reach*/
+static boolean
+is_L1L2_default_route_required(node_t *spf_root, spf_result_t *result, LEVEL level){
+
+    return (level == LEVEL1                                          &&  /* If current spf run is Level1*/
+            !IS_BIT_SET(spf_root->instance_flags, IGNOREATTACHED)    &&  /* If computing router is programmed to detect the L1L2 routers*/
+            result->node->spf_info.spff_multi_area                   &&  /* if the router being inspected is L1L2 router*/
+            !spf_root->spf_info.spff_multi_area);                        /* if the computing router is L1-only router*/
+}
+
+static void
+init_L1L2_default_prefix(prefix_t *default_prefix, node_t *L1L2_node){
+
+    memset(default_prefix, 0, sizeof(prefix_t)); 
+    UNSET_BIT(default_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
+    UNSET_BIT(default_prefix->prefix_flags, PREFIX_EXTERNABIT_FLAG);
+    UNSET_BIT(default_prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT);
+    default_prefix->hosting_node = L1L2_node;
+    default_prefix->metric = 0;
+    default_prefix->mask = 0;
+    default_prefix->level = LEVEL1;
+    set_prefix_preference(default_prefix);
+}
+
+static void *
+route_build_worker(void *arg){
+
+    unsigned int i = 0, bucket = 0;
+    singly_ll_node_t *list_node = NULL;
+    routes_t *route = NULL;
+    route_build_work_t *work = NULL;
+    route_build_shard_t *shard = arg;
+
+    /*Index the routes of previous runs owned by this shard. Route list
+     * is not modified until all workers are done*/
+    ITERATE_LIST_BEGIN(shard->spf_info->routes_list[UNICAST_T], list_node){
+        route = list_node->data;
+        unsigned int hash = route_key_hash(route->rt_key.u.prefix.prefix,
+                                           route->rt_key.u.prefix.mask);
+        if(hash % shard->n_shards == shard->index)
+            route_build_shard_add(shard, route, hash);
+    } ITERATE_LIST_END;
+
+    for(i = 0; i < shard->n_work; i++){
+        shard->curr_work = shard->work_index[i];
+        work = &shard->work[shard->curr_work];
+        update_route(shard->spf_info, work->result, work->prefix,
+                shard->level, UNICAST_T, work->linkage, shard);
+    }
+
+    /*Routes of this shard are final, refine their backups*/
+    for(bucket = 0; bucket < ROUTE_BUILD_SHARD_HASH_SIZE; bucket++){
+        for(route = shard->bucket[bucket]; route; route = route->shard_next){
+            if(route->level != shard->level)
+                continue;
+            if(route->install_state != RTE_STALE)
+                refine_route_backups(route);
+        }
+    }
+    return NULL;
+}
+
+static int
+route_build_new_route_cmp(const void *a, const void *b){
+
+    const route_build_new_route_t *r1 = a,
+                                  *r2 = b;
+
+    if(r1->seq_no < r2->seq_no) return -1;
+    if(r1->seq_no > r2->seq_no) return 1;
+    return 0;
+}
+
+/*Parallel version of the route build loop of build_routing_table(). Routes
+ * are identical to the serial build, and new routes are linked to route
+ * lists in the same order as serial build would have linked them*/
+static void
+build_routing_table_parallel(spf_info_t *spf_info, node_t *spf_root, 
+                             LEVEL level, unsigned int n_work,
+                             unsigned int n_shards){
+
+    unsigned int i = 0, 
+                 n_results = 0,
+                 n_new_routes = 0;
+
+    singly_ll_node_t *list_node = NULL;
+
+    spf_result_t *result = NULL;
+    prefix_t *prefix = NULL,
+             *default_prefixes = NULL;
+    route_build_work_t *work = NULL;
+    route_build_shard_t *shards = NULL,
+                        *shard = NULL;
+    route_build_new_route_t *new_routes = NULL;
+    pthread_t workers[ROUTE_BUILD_MAX_WORKERS];
+    boolean worker_spawned[ROUTE_BUILD_MAX_WORKERS];
+
+    n_results = GET_NODE_COUNT_SINGLY_LL(spf_root->spf_run_result[level]);
+    default_prefixes = calloc(n_results, sizeof(prefix_t));
+    work = calloc(n_work, sizeof(route_build_work_t));
+    shards = calloc(n_shards, sizeof(route_build_shard_t));
+
+    /*Lay out the work in the same order as serial build*/
+    n_work = 0;
+    ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
+
+        result = (spf_result_t *)list_node->data;
+
+        if(is_L1L2_default_route_required(spf_root, result, level)){
+            init_L1L2_default_prefix(&default_prefixes[i], result->node);
+            work[n_work].result = result;
+            work[n_work].prefix = &default_prefixes[i++];
+            work[n_work].linkage = FALSE;
+            work[n_work].hash = prefix_route_key_hash(work[n_work].prefix);
+            shards[work[n_work].hash % n_shards].n_work++;
+            n_work++;
+        }
+
+        ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(result->node, level), prefix){
+            work[n_work].result = result;
+            work[n_work].prefix = prefix;
+            work[n_work].linkage = TRUE;
+            work[n_work].hash = prefix_route_key_hash(prefix);
+            shards[work[n_work].hash % n_shards].n_work++;
+            n_work++;
+        } ITERATE_PREFIX_STORE_END;
+    } ITERATE_LIST_END;
+
+    for(i = 0; i < n_shards; i++){
+        shard = &shards[i];
+        shard->index = i;
+        shard->n_shards = n_shards;
+        shard->spf_info = spf_info;
+        shard->level = level;
+        shard->work = work;
+        shard->work_index = calloc(shard->n_work ? shard->n_work : 1, sizeof(unsigned int));
+        shard->new_routes = calloc(shard->n_work ? shard->n_work : 1, sizeof(route_build_new_route_t));
+        shard->n_work = 0;
+    }
+
+    for(i = 0; i < n_work; i++){
+        shard = &shards[work[i].hash % n_shards];
+        shard->work_index[shard->n_work++] = i;
+    }
+
+    for(i = 0; i < n_shards; i++){
+        worker_spawned[i] = (pthread_create(&workers[i], NULL, 
+                                route_build_worker, &shards[i]) == 0);
+        if(!worker_spawned[i])
+            route_build_worker(&shards[i]);
+    }
+
+    for(i = 0; i < n_shards; i++){
+        if(worker_spawned[i])
+            pthread_join(workers[i], NULL);
+        n_new_routes += shards[i].n_new_routes;
+    }
+
+    /*Deterministic merge : link new routes in creation order*/
+    new_routes = calloc(n_new_routes ? n_new_routes : 1, sizeof(route_build_new_route_t));
+    n_new_routes = 0;
+    for(i = 0; i < n_shards; i++){
+        memcpy(&new_routes[n_new_routes], shards[i].new_routes, 
+                shards[i].n_new_routes * sizeof(route_build_new_route_t));
+        n_new_routes += shards[i].n_new_routes;
+        free(shards[i].new_routes);
+        free(shards[i].work_index);
+    }
+
+    qsort(new_routes, n_new_routes, sizeof(route_build_new_route_t), 
+            route_build_new_route_cmp);
+
+    for(i = 0; i < n_new_routes; i++){
+        ROUTE_ADD_TO_ROUTE_LIST(spf_info, new_routes[i].route, UNICAST_T);
+    }
+
+    free(new_routes);
+    free(shards);
+    free(work);
+    free(default_prefixes);
+}
+
 void
 build_routing_table(spf_info_t *spf_info,
                     node_t *spf_root, LEVEL level){
 
-    singly_ll_node_t *list_node = NULL,
-                     *prefix_list_node = NULL;
+    singly_ll_node_t *list_node = NULL;
 
     routes_t *route = NULL;
     prefix_t *prefix = NULL;
     spf_result_t *result = NULL,
                  *L1L2_result = NULL;
+    unsigned int n_work = 0,
+                 n_shards = 0;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", spf_root->node_name, get_str_level(level));
+        trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
+    }
 #endif
     
     mark_all_routes_stale(spf_info, level, UNICAST_T);
 
+    ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
+        result = (spf_result_t *)list_node->data;
+        n_work += PREFIX_STORE_COUNT(GET_NODE_PREFIX_STORE(result->node, level)) + 1;
+    } ITERATE_LIST_END;
+
+    /*Workers share the trace buffer*/
+    n_shards = (n_work < ROUTE_BUILD_PARALLEL_THRESHOLD ||
+                instance->traceopts->enable == TR_TRUE) ? 1 :
+        get_worker_count(n_work, ROUTE_BUILD_MAX_WORKERS);
+    if(n_shards > 1){
+        build_routing_table_parallel(spf_info, spf_root, level, n_work, n_shards);
+        return;
+    }
+
     /*Walk over the SPF result list computed in spf run
      * in the same order. Note that order of this list is :
      * most distant router from spf root is first*/
@@ -1208,44 +1674,37 @@ build_routing_table(spf_info_t *spf_info,
 
         result = (spf_result_t *)list_node->data;
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node %s : processing result of %s, at level %s", 
-            spf_root->node_name, result->node->node_name, get_str_level(level)); 
-        trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Node %s : processing result of %s, at level %s", 
+                spf_root->node_name, result->node->node_name, get_str_level(level)); 
+            trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
+        }
 #endif
 
         /*Iterate over all the prefixes of result->node for level 'level'*/
 
 
-        if(level == LEVEL1                                               &&  /* If current spf run is Level1*/
-                !IS_BIT_SET(spf_root->instance_flags, IGNOREATTACHED)    &&  /* If computing router is programmed to detect the L1L2 routers*/
-                result->node->spf_info.spff_multi_area                   &&  /* if the router being inspected is L1L2 router*/
-                !spf_root->spf_info.spff_multi_area){                        /* if the computing router is L1-only router*/
+        if(is_L1L2_default_route_required(spf_root, result, level)){
 
             L1L2_result = result;                                    /* Record the L1L2 router result*/
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node %s : L1L2_result recorded - %s", 
-                            spf_root->node_name, L1L2_result->node->node_name); 
-            trace(instance->traceopts, ROUTE_INSTALLATION_BIT); 
+            if(instance->traceopts->enable == TR_TRUE){
+                sprintf(instance->traceopts->b, "Node %s : L1L2_result recorded - %s", 
+                                spf_root->node_name, L1L2_result->node->node_name); 
+                trace(instance->traceopts, ROUTE_INSTALLATION_BIT); 
+            }
 #endif
 
             prefix_t default_prefix;
-            memset(&default_prefix, 0, sizeof(prefix_t)); 
-            UNSET_BIT(default_prefix.prefix_flags, PREFIX_DOWNBIT_FLAG);
-            UNSET_BIT(default_prefix.prefix_flags, PREFIX_EXTERNABIT_FLAG);
-            UNSET_BIT(default_prefix.prefix_flags, PREFIX_METRIC_TYPE_EXT);
-            default_prefix.hosting_node = L1L2_result->node;
-            default_prefix.metric = 0;
-            default_prefix.mask = 0;
-            default_prefix.level = LEVEL1;
-            update_route(spf_info, L1L2_result, &default_prefix, LEVEL1, UNICAST_T, FALSE);
+            init_L1L2_default_prefix(&default_prefix, L1L2_result->node);
+            update_route(spf_info, L1L2_result, &default_prefix, LEVEL1, UNICAST_T, FALSE, NULL);
         }
 
 
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(result->node, level), prefix_list_node){
+        ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(result->node, level), prefix){
 
-            prefix = (prefix_t *)prefix_list_node->data;  
-            update_route(spf_info, result, prefix, level, UNICAST_T, TRUE);
-        }ITERATE_LIST_END;
+            update_route(spf_info, result, prefix, level, UNICAST_T, TRUE, NULL);
+        } ITERATE_PREFIX_STORE_END;
 
     } ITERATE_LIST_END;
 
@@ -1264,6 +1723,16 @@ build_routing_table(spf_info_t *spf_info,
     } ITERATE_LIST_END;
 }
 
+static void
+evaluate_leak_policies(node_t *spf_root, LEVEL level){
+
+    leak_policy_evaluate(spf_root, level);
+    /*L1L2 attachment is determined by L2 run, L1 routes may become
+     * leakable without any L1 route change*/
+    if(level == LEVEL2)
+        leak_policy_evaluate(spf_root, LEVEL1);
+}
+
 void
 spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
                    node_t *spf_root,     /* computing node which stores the result (list) of spf run*/
@@ -1275,13 +1744,16 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
      *  SPF L1 run to ensure L1 routes are uptodate before updating L2 routes
      *-----------------------------------------------------------------------------*/
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Entered ... ");
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "Entered ... ");
+        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+    }
 #endif
        
-    if(level == LEVEL2 && spf_info->spf_level_info[LEVEL1].version){
-        /*If at least 1 SPF L1 run has been triggered*/
-        
+    if(level == LEVEL2){
+        /*Attachment depends on L2 spf result only, instance sync runs
+         * L2 first precisely so that this bit is set before L1 routes
+         * are built*/
         spf_determine_multi_area_attachment(spf_info, spf_root);  
         /*Schedule level 1 spf run, just to make sure L1 routes are up
          *      * to date before building L2 routes*/
@@ -1299,7 +1771,16 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
         update_node_segment_routes_for_remote(spf_info, level);
         delete_stale_routes(spf_info, level, SPRING_T);
     }
+
+    /*Routes nexthops are final now, share them via nexthop groups*/
+    nh_group_bind_routes(spf_info, level, UNICAST_T);
+    if(is_node_spring_enabled(spf_root, level)){
+        nh_group_bind_routes(spf_info, level, SPRING_T);
+    }
   
+    /*Routes are flushed and reinstalled, log only what changed*/
+    rib_clog_begin_node(spf_root);
+
     /*Flush all Ribs before route installation*/ 
     flush_rib(spf_info->rib[INET_0], level);
     flush_rib(spf_info->rib[INET_3], level);
@@ -1309,6 +1790,14 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
     if(is_node_spring_enabled(spf_root, level)){
         enhanced_start_route_installation(spf_info, level, SPRING_T);   
     }
+
+    evaluate_leak_policies(spf_root, level);
+    /*Set of reachable mapping servers may have changed*/
+    srmc_compute_active_mapping_policy(spf_root, level);
+    /*Algorithm topologies are derived from the same link state*/
+    flex_algo_compute(spf_root, level);
+
+    rib_clog_commit_node(spf_root);
 }
 
 internal_nh_t *
@@ -1319,12 +1808,11 @@ backup_selection_policy(routes_t *route){
    internal_nh_t *backup = NULL;
 
    ITERATE_NH_TYPE_BEGIN(nh){
-        ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
-            backup = (internal_nh_t *)(list_node->data);         
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), backup){
             if(is_internal_nh_t_empty(*backup))
                 continue;
             return backup;
-        } ITERATE_LIST_END;     
+        } ITERATE_ROUTE_NH_END;     
    } ITERATE_NH_TYPE_END;
    return NULL;
 }
@@ -1359,8 +1847,8 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
 
             /*handling local prefixes*/
 
-            if(GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[IPNH]) == 0 &&
-                    GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[LSPNH]) == 0){
+            if(ROUTE_PRIMARY_NH(route, IPNH).count == 0 &&
+                    ROUTE_PRIMARY_NH(route, LSPNH).count == 0){
 
                 sprintf(subnet, "%s/%d", route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);
                 printf("%-20s      %-4d        %-3d (%-3s)     %-2d    %-15s    %-s|%-8s   %-12s      %-16s\n",
@@ -1381,15 +1869,14 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
                     route->level);
 
             ITERATE_NH_TYPE_BEGIN(nh){
-                total_nx_hops += GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]);
+                total_nx_hops += ROUTE_PRIMARY_NH(route, nh).count;
             } ITERATE_NH_TYPE_END;
 
             singly_ll_node_t *list_node = NULL;
             internal_nh_t *nexthop = NULL;
 
             ITERATE_NH_TYPE_BEGIN(nh){
-                ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node){
-                    nexthop = list_node->data;
+                ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh), nexthop){
                     printf("%-15s    %-s|%-22s   %-26s\n",
                             nh == IPNH ? next_hop_gateway_pfx(nexthop) : "--",
                             nexthop->node->node_name,
@@ -1398,13 +1885,12 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
                     if(j < total_nx_hops -1)
                         printf("%-20s      %-4s        %-3s  %-3s      %-2s    ", "","","","","");
                     j++;
-                } ITERATE_LIST_END;
+                } ITERATE_ROUTE_NH_END;
             } ITERATE_NH_TYPE_END;
 
             /*print the back up here*/
             ITERATE_NH_TYPE_BEGIN(nh){
-                ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
-                    nexthop = list_node->data;
+                ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), nexthop){
                     printf("%-20s      %-4s        %-3s  %-3s      %-2s    ", "","","","","");
                     nh = next_hop_type(*nexthop);
                     /*print the back as per its type*/
@@ -1431,7 +1917,7 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
                         default:
                             assert(0);
                     }
-                } ITERATE_LIST_END;
+                } ITERATE_ROUTE_NH_END;
             } ITERATE_NH_TYPE_END;
                 if(prefix)
                     return;
@@ -1452,9 +1938,11 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
     node_t *spf_root = GET_SPF_INFO_NODE(spf_info, level),
            *D_res = NULL;
 #ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", 
-        spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+    if(instance->traceopts->enable == TR_TRUE){
+        sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", 
+            spf_root->node_name, get_str_level(level));
+        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+    }
 #endif
 
     mark_all_routes_stale(spf_info, level, SPRING_T);
@@ -1465,9 +1953,11 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
         
         if(!is_node_spring_enabled(D_res, level)){
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : skipping Dest %s at %s, not SPRING enabled",
-                spf_root->node_name, D_res->node_name, get_str_level(level));
-            trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+            if(instance->traceopts->enable == TR_TRUE){
+                sprintf(instance->traceopts->b, "Node : %s : skipping Dest %s at %s, not SPRING enabled",
+                    spf_root->node_name, D_res->node_name, get_str_level(level));
+                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+            }
 #endif
             continue;
         }
@@ -1479,15 +1969,17 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             assert(prefix_sid->prefix);
             if(!IS_PREFIX_SR_ACTIVE(prefix_sid->prefix)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : skipping prefix %s/%u, hosting node : %s at %s, conflicting prefix",
-                    spf_root->node_name, STR_PREFIX(prefix_sid->prefix), PREFIX_MASK(prefix_sid->prefix), 
-                    D_res->node_name, get_str_level(level)); 
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "Node : %s : skipping prefix %s/%u, hosting node : %s at %s, conflicting prefix",
+                        spf_root->node_name, STR_PREFIX(prefix_sid->prefix), PREFIX_MASK(prefix_sid->prefix), 
+                        D_res->node_name, get_str_level(level)); 
+                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                }
 #endif
                 continue;
             }
             
-            update_route(spf_info, result, prefix_sid->prefix, level, SPRING_T, TRUE);
+            update_route(spf_info, result, prefix_sid->prefix, level, SPRING_T, TRUE, NULL);
 
         } ITERATE_GLTHREAD_END(&D_res->prefix_sids_thread_lst[level], curr);
     } ITERATE_LIST_END;
@@ -1504,12 +1996,16 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             continue;
     } ITERATE_LIST_END;
 
+    /*Label stacks of nexthops are served from the cache, only the ones
+     * whose nexthop or SRGB changed are recomputed*/
+    sr_label_cache_new_run(spf_info->sr_lbl_cache);
     ITERATE_LIST_BEGIN(spf_info->routes_list[SPRING_T], list_node){
         route = list_node->data;
         if(route->install_state == RTE_STALE)
             continue;
         springify_unicast_route(spf_root, list_node->data);
     } ITERATE_LIST_END;
+    sr_label_cache_purge(spf_info->sr_lbl_cache, level);
 }
 
 static void
@@ -1532,107 +2028,111 @@ ldpify_rlfa_nexthop(internal_nh_t *nxthop,
 
 
 static void
-enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
+install_unicast_route(spf_info_t *spf_info, routes_t *route, LEVEL level){
 
-    /*Unicast (IGPs) protocols installs the routes in inet.0 and inet.3 tables
-     * only. Flush both the tables first*/
-
-    singly_ll_node_t *list_node = NULL,
-    *list_node2 = NULL;
-
-    routes_t *route = NULL;
     nh_type_t nh;
-    internal_nh_t *nxthop = NULL;
+    internal_nh_t *nxthop = NULL,
+                  ldp_nxthop;
     internal_un_nh_t *un_nxthop = NULL;
-    boolean rc = FALSE;
     rt_key_t rt_key;
-    boolean is_local_route = FALSE;
+    unsigned int ucmp_buckets[MAX_NXT_HOPS],
+                 ucmp_index = 0;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[UNICAST_T], list_node){
+    assert(route->install_state != RTE_STALE);
 
-        route = list_node->data;
-        if(route->level != level) continue;
-
-        assert(route->install_state != RTE_STALE);
+    memset(&rt_key, 0, sizeof(rt_key_t));
+    strncpy(RT_ENTRY_PFX(&rt_key), route->rt_key.u.prefix.prefix, PREFIX_LEN);
+    RT_ENTRY_MASK(&rt_key) = route->rt_key.u.prefix.mask;
 
-        memset(&rt_key, 0, sizeof(rt_key_t));
-        strncpy(RT_ENTRY_PFX(&rt_key), route->rt_key.u.prefix.prefix, PREFIX_LEN);
-        RT_ENTRY_MASK(&rt_key) = route->rt_key.u.prefix.mask;
+    /*Handle local routes*/
+    if(is_route_local(route)){
+        inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, NULL);
+        inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, NULL);
+        return;
+    }
 
-        /*Handle local routes*/
-        is_local_route = is_route_local(route);
+    /*UCMP : inet.0 primary nexthops share the traffic in proportion
+     * of bottleneck bandwidth of their paths*/
+    ucmp_nh_buckets(ROUTE_NH_ARRAY(&ROUTE_PRIMARY_NH(route, IPNH)),
+                    ROUTE_PRIMARY_NH(route, IPNH).count, ucmp_buckets);
 
-        if(is_local_route){
-            inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, NULL);
-            inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, NULL);
-            continue;
-        }
-
-        /*Install primary nexthop first. Primary nexthops are inet.0 routes Or RSVP routes (inet.3)*/
-        ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node2){
-                nxthop = list_node2->data;
-                rc = FALSE;
-                if(nh == IPNH){
-                    un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
-                    rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-                    if(rc == FALSE){
-                        free_un_nexthop(un_nxthop);
-                    }
+    /*Install primary nexthop first. Primary nexthops are inet.0 routes Or RSVP routes (inet.3)*/
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh), nxthop){
+            if(nh == IPNH){
+                un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
+                un_nxthop->ucmp_weight = ucmp_buckets[ucmp_index++];
+                inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+                free_un_nexthop(un_nxthop);
+            }
+            else{ /*It is RSVP LSP nexthop, which needs to be installed in inet.3 table*/
+                if(is_node_best_prefix_originator(nxthop->node, route)){
+                    /* RSVP nexthop should not be installed in inet.3 table. Instead it should
+                     * be installed in inet.0 table. We will
+                     * revisit this when we shall support RSVP nexthops properly*/
                 }
-                else{ /*It is RSVP LSP nexthop, which needs to be installed in inet.3 table*/
-                    if(is_node_best_prefix_originator(nxthop->node, route)){
-                        /* RSVP nexthop should not be installed in inet.3 table. Instead it should
-                         * be installed in inet.0 table. We will
-                         * revisit this when we shall support RSVP nexthops properly*/
-                    }
-                    else{
-                        un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
-                        rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
-                        if(rc == FALSE){
-                            free_un_nexthop(un_nxthop);
-                        }
-                    }
+                else{
+                    un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
+                    inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                    free_un_nexthop(un_nxthop);
                 }
-            } ITERATE_LIST_END;
-        } ITERATE_NH_TYPE_END;
+            }
+        } ITERATE_ROUTE_NH_END;
+    } ITERATE_NH_TYPE_END;
 
 
-        /*Install backup nexthop now. Backup nexthops are inet.0 routes Or RSVP/LDP routes (inet.3)*/
-        ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node2){
-                nxthop = list_node2->data;
-                rc = FALSE;
-                if(nh == IPNH){
-                    un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
-                    rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-                    if(rc == FALSE){
-                        free_un_nexthop(un_nxthop);
-                    }
-                }
-                else{ /*backup is either RSVP or LDP nexthop*/
-                    if(is_internal_backup_nexthop_rsvp(nxthop)) {
-                        /*ToDo*/
-
-                    }else{
-                        /*LDP backup nexthop(RLFAs)*/
-                        prefix_t *prefix = ROUTE_GET_BEST_PREFIX(route);
-                        ldpify_rlfa_nexthop(nxthop, prefix->prefix, prefix->mask);
-                        /*Could not get LDP label, skip installation of this LDP nexthop*/
-                        if(IS_INTERNAL_NH_MPLS_STACK_EMPTY(nxthop))
-                            continue;
-                        un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
-                        if(IS_BIT_SET(un_nxthop->flags, IPV4_LDP_NH))
-                            rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
-                        else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
-                            rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-                        if(rc == FALSE){
-                            free_un_nexthop(un_nxthop);
-                        }
-                    }
+    /*Install backup nexthop now. Backup nexthops are inet.0 routes Or RSVP/LDP routes (inet.3)*/
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), nxthop){
+            if(nh == IPNH){
+                un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
+                inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+                free_un_nexthop(un_nxthop);
+            }
+            else{ /*backup is either RSVP or LDP nexthop*/
+                if(is_internal_backup_nexthop_rsvp(nxthop)) {
+                    /*ToDo*/
+
+                }else{
+                    /*LDP backup nexthop(RLFAs)*/
+                    /*LDP label depends on the prefix, group is shared
+                     * with other prefixes*/
+                    prefix_t *prefix = ROUTE_GET_BEST_PREFIX(route);
+                    memcpy(&ldp_nxthop, nxthop, sizeof(internal_nh_t));
+                    ldpify_rlfa_nexthop(&ldp_nxthop, prefix->prefix, prefix->mask);
+                    /*Could not get LDP label, skip installation of this LDP nexthop*/
+                    if(IS_INTERNAL_NH_MPLS_STACK_EMPTY((&ldp_nxthop)))
+                        continue;
+                    un_nxthop = inet_3_unifiy_nexthop(&ldp_nxthop, IGP_PROTO, IPV4_LDP_NH, route);
+                    if(IS_BIT_SET(un_nxthop->flags, IPV4_LDP_NH))
+                        inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                    else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
+                        inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+                    free_un_nexthop(un_nxthop);
                 }
-            } ITERATE_LIST_END;
-        } ITERATE_NH_TYPE_END;
+            }
+        } ITERATE_ROUTE_NH_END;
+    } ITERATE_NH_TYPE_END;
+
+    /*Forwarding reads the PIC state of route's nexthop group*/
+    rt_un_entry_set_nh_group(spf_info->rib[INET_0], &rt_key, route->nhg);
+    rt_un_entry_set_nh_group(spf_info->rib[INET_3], &rt_key, route->nhg);
+}
+
+static void
+enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
+
+    /*Unicast (IGPs) protocols installs the routes in inet.0 and inet.3 tables
+     * only. Flush both the tables first*/
+
+    singly_ll_node_t *list_node = NULL;
+    routes_t *route = NULL;
+
+    ITERATE_LIST_BEGIN(spf_info->routes_list[UNICAST_T], list_node){
+
+        route = list_node->data;
+        if(route->level != level) continue;
+        install_unicast_route(spf_info, route, level);
     } ITERATE_LIST_END;
 }
 
@@ -1649,11 +2149,10 @@ is_route_have_backup_protection(routes_t *route, edge_end_t *protected_link){
     internal_nh_t *nxthop = NULL;
 
     ITERATE_NH_TYPE_BEGIN(nh){
-        ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
-            nxthop = list_node->data;
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), nxthop){
             if(nxthop->protected_link == protected_link)
                 return TRUE;  
-        } ITERATE_LIST_END;
+        } ITERATE_ROUTE_NH_END;
     } ITERATE_NH_TYPE_END;
     return FALSE;
 }
@@ -1671,7 +2170,6 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
     nh_type_t nh;
     internal_nh_t *nxthop = NULL;
     internal_un_nh_t *un_nxthop = NULL;
-    boolean rc = FALSE;
     rt_key_t rt_key;
 
     ITERATE_LIST_BEGIN(spf_info->routes_list[SPRING_T], list_node){
@@ -1688,147 +2186,132 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
        
         /*Install springified IPV4 routes in inet.3 table. RSVP LSP Nexthops 
          * should not be springified in the first place*/ 
-        ITERATE_LIST_BEGIN(route->primary_nh_list[IPNH], list_node2){
-            nxthop = list_node2->data;
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, IPNH), nxthop){
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s nexthop (%s)%s not installed, not spring capable", 
-                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
-                nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s nexthop (%s)%s not installed, not spring capable", 
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                    get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
+                    nxthop->proxy_nbr->node_name);
+                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                }
 #endif
                 continue;
             }
-            rc = FALSE;
             un_nxthop = inet_3_unifiy_nexthop(nxthop, L_IGP_PROTO, IPV4_SPRING_NH, route);
             if(IS_BIT_SET(un_nxthop->flags, IPV4_SPRING_NH))
-                rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
             else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
-                rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-            if(rc == FALSE){
-                free_un_nexthop(un_nxthop);
-            }
-        } ITERATE_LIST_END;
+                inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+            free_un_nexthop(un_nxthop);
+        } ITERATE_ROUTE_NH_END;
 
         /* RSVP nexthop Should have been installed in inet.3 table in 
          * enhanced_start_route_installation_unicast(). So no need to
          * do it again during spring route installation*/
 
         /*Spring Backups. Install ipv4 springified backups in inet.3 table*/
-        ITERATE_LIST_BEGIN(route->backup_nh_list[IPNH], list_node2){
-            nxthop = list_node2->data;
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, IPNH), nxthop){
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
-                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
-                nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                    get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
+                    nxthop->proxy_nbr->node_name);
+                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                }
 #endif
                 continue;
             }
-            rc = FALSE;
             un_nxthop = inet_3_unifiy_nexthop(nxthop, L_IGP_PROTO, IPV4_SPRING_NH, route);
             if(IS_BIT_SET(un_nxthop->flags, IPV4_SPRING_NH))
-                rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
             else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
-                rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-            if(rc == FALSE){
-                free_un_nexthop(un_nxthop);
-            }
-        } ITERATE_LIST_END;
+                inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+            free_un_nexthop(un_nxthop);
+        } ITERATE_ROUTE_NH_END;
         
         /*Nw do LSP backups - which could be RSVP backups Or LDP(RLFA) backups*/
-        ITERATE_LIST_BEGIN(route->backup_nh_list[LSPNH], list_node2){
-            nxthop = list_node2->data;
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, LSPNH), nxthop){
             if(is_internal_backup_nexthop_rsvp(nxthop))
                 continue; /*ToDo : Support RSVP later . . . */
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop) || !is_node_spring_enabled(nxthop->rlfa, level)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
-                GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
-                nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                if(instance->traceopts->enable == TR_TRUE){
+                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                    get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
+                    nxthop->proxy_nbr->node_name);
+                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                }
 #endif
                 continue;
             }
-            rc = FALSE;
             /*springified RLFA nexthops*/
             un_nxthop = inet_3_unifiy_nexthop(nxthop, L_IGP_PROTO, IPV4_SPRING_NH, route);
             if(IS_BIT_SET(un_nxthop->flags, IPV4_SPRING_NH))
-                rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
             else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
-                rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-            if(rc == FALSE){
-                free_un_nexthop(un_nxthop);
-            }
-        } ITERATE_LIST_END;
+                inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+            free_un_nexthop(un_nxthop);
+        } ITERATE_ROUTE_NH_END;
+
 
+        rt_un_entry_set_nh_group(spf_info->rib[INET_3], &rt_key, route->nhg);
 
         /*Now install all primary/backups routes in mpls_0 table*/
         RT_ENTRY_LABEL(&rt_key) = route->rt_key.u.label; 
 
         ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node2){
-                nxthop = list_node2->data;
+            ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh), nxthop){
                 if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s primarynexthop (%s)%s not installed, not spring capable", 
-                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                            get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
-                            nxthop->proxy_nbr->node_name);
-                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s primarynexthop (%s)%s not installed, not spring capable", 
+                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                                get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
+                                nxthop->proxy_nbr->node_name);
+                        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                    }
 #endif
                     continue;
                 }
-                rc = FALSE;
                 un_nxthop = mpls_0_unifiy_nexthop(nxthop, L_IGP_PROTO);
-                rc = mpls_0_rt_un_route_install_nexthop(spf_info->rib[MPLS_0], &rt_key, level, un_nxthop);
-                if(rc == FALSE){
-                    free_un_nexthop(un_nxthop);
-                }
-            } ITERATE_LIST_END;
+                mpls_0_rt_un_route_install_nexthop(spf_info->rib[MPLS_0], &rt_key, level, un_nxthop);
+                free_un_nexthop(un_nxthop);
+            } ITERATE_ROUTE_NH_END;
         } ITERATE_NH_TYPE_END;
 
         ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node2){
-                nxthop = list_node2->data;
+            ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), nxthop){
                 if(is_internal_backup_nexthop_rsvp(nxthop))
                     continue;
                 if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop) || (nxthop->rlfa && !is_node_spring_enabled(nxthop->rlfa, level))){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed, not spring capable", 
-                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                            get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
-                            nxthop->proxy_nbr->node_name);
-                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                    if(instance->traceopts->enable == TR_TRUE){
+                        sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed, not spring capable", 
+                        GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
+                                get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
+                                nxthop->proxy_nbr->node_name);
+                        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                    }
 #endif
                     continue;
                 }
-                rc = FALSE;
                 un_nxthop = mpls_0_unifiy_nexthop(nxthop, L_IGP_PROTO);
                 if(nh == LSPNH){
-                    /*In case if RLFA is also a destination, then mpls label stack depth would only be 1.
-                     * The below stack modificiation need not done*/
-                    if(un_nxthop->nh.mpls0_nh.mpls_label_out[1] && 
-                            un_nxthop->nh.mpls0_nh.stack_op[1] != STACK_OPS_UNKNOWN){
-                        /*Means, RLFA is a transient router to destination, and RLFA itself is not
-                         * a destination*/
-                        un_nxthop->nh.mpls0_nh.stack_op[1] = SWAP;
-                    }
-                    else{
-                        /*if RLFA it self is a destination*/
-                        un_nxthop->nh.mpls0_nh.stack_op[0] = SWAP;
-                    }
+                    /*Top operation is SWAP, it is the RLFA's label if RLFA is a transient
+                     * router to destination, else the destination's label if RLFA it self
+                     * is a destination and mpls label stack depth is only 1*/
+                    un_nxthop->label_ops[0].stack_op = SWAP;
                 }
-                rc = mpls_0_rt_un_route_install_nexthop(spf_info->rib[MPLS_0], &rt_key, level, un_nxthop);
-                if(rc == FALSE){
-                    free_un_nexthop(un_nxthop);
-                }
-            } ITERATE_LIST_END;
+                mpls_0_rt_un_route_install_nexthop(spf_info->rib[MPLS_0], &rt_key, level, un_nxthop);
+                free_un_nexthop(un_nxthop);
+            } ITERATE_ROUTE_NH_END;
         } ITERATE_NH_TYPE_END;
+        rt_un_entry_set_nh_group(spf_info->rib[MPLS_0], &rt_key, route->nhg);
     } ITERATE_LIST_END;
 }
 
@@ -1849,6 +2332,114 @@ enhanced_start_route_installation(spf_info_t *spf_info,
     }
 }
 
+static void
+uninstall_unicast_route(spf_info_t *spf_info, rt_key_t *rt_key, LEVEL level){
+
+    rt_un_table_t *rib = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    rib_type_t rib_type[] = {INET_0, INET_3};
+    unsigned int i = 0;
+
+    for(i = 0; i < sizeof(rib_type)/sizeof(rib_type[0]); i++){
+        rib = spf_info->rib[rib_type[i]];
+        rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+        if(rt_un_entry && rt_un_entry->level == level)
+            rib->rt_un_route_delete(rib, rt_key);
+    }
+}
+
+void
+prc_postprocessing(spf_info_t *spf_info, node_t *spf_root, LEVEL level,
+                   common_pfx_key_t *prefixes, unsigned int n_prefixes){
+
+    unsigned int i = 0, 
+                 key_addr = 0;
+
+    singly_ll_node_t *list_node = NULL;
+
+    spf_result_t *result = NULL;
+    routes_t *route = NULL;
+    prefix_t *prefix = NULL;
+    prefix_store_t *store = NULL;
+    prefix_t key_prefix, 
+             default_prefix;
+    rt_key_t rt_key;
+
+    rib_clog_begin_node(spf_root);
+
+    for(i = 0; i < n_prefixes; i++){
+
+        memset(&key_prefix, 0, sizeof(prefix_t));
+        apply_mask(prefixes[i].u.prefix.prefix, prefixes[i].u.prefix.mask, key_prefix.prefix);
+        key_prefix.prefix[PREFIX_LEN] = '\0';
+        key_prefix.mask = prefixes[i].u.prefix.mask;
+        inet_pton(AF_INET, key_prefix.prefix, &key_addr);
+        key_addr = ntohl(key_addr);
+
+#ifdef __ENABLE_TRACE__    
+        if(instance->traceopts->enable == TR_TRUE){
+            sprintf(instance->traceopts->b, "Node : %s : PRC for %s/%u at %s", 
+                    spf_root->node_name, key_prefix.prefix, key_prefix.mask, get_str_level(level));
+            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+        }
+#endif
+        /*Route is rebuilt from scratch. Since PRC has bumped up the spf
+         * version, first contributing prefix overwrites the route*/
+        route = search_route_in_spf_route_list(spf_info, &key_prefix, UNICAST_T);
+        if(route && route->level == level)
+            route->install_state = RTE_STALE;
+
+        /*Same order as build_routing_table() so that ECMP and like prefixes
+         * ordering of the route comes out same as full route build*/
+        ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
+
+            result = (spf_result_t *)list_node->data;
+
+            if(key_prefix.mask == 0 && 
+                    is_L1L2_default_route_required(spf_root, result, level)){
+                init_L1L2_default_prefix(&default_prefix, result->node);
+                update_route(spf_info, result, &default_prefix, LEVEL1, UNICAST_T, FALSE, NULL);
+            }
+
+            store = GET_NODE_PREFIX_STORE(result->node, level);
+            for(prefix = prefix_store_lookup_route_key(store, key_addr, key_prefix.mask, NULL);
+                prefix; prefix = prefix_store_lookup_route_key(store, key_addr, key_prefix.mask, prefix)){
+                update_route(spf_info, result, prefix, level, UNICAST_T, TRUE, NULL);
+            }
+        } ITERATE_LIST_END;
+
+        memset(&rt_key, 0, sizeof(rt_key_t));
+        strncpy(RT_ENTRY_PFX(&rt_key), key_prefix.prefix, PREFIX_LEN);
+        RT_ENTRY_MASK(&rt_key) = key_prefix.mask;
+
+        route = search_route_in_spf_route_list(spf_info, &key_prefix, UNICAST_T);
+        if(!route || route->level != level)
+            continue;
+
+        uninstall_unicast_route(spf_info, &rt_key, level);
+
+        if(route->install_state == RTE_STALE){
+#ifdef __ENABLE_TRACE__    
+            if(instance->traceopts->enable == TR_TRUE){
+                sprintf(instance->traceopts->b, "route : %s/%u is withdrawn for %s, deleted", 
+                        route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
+                trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+            }
+#endif
+            ROUTE_DEL_FROM_ROUTE_LIST(spf_info, route, UNICAST_T);
+            free_route(route);
+            continue;
+        }
+
+        refine_route_backups(route);
+        nh_group_bind_route(spf_info, route);
+        install_unicast_route(spf_info, route, level);
+    }
+
+    evaluate_leak_policies(spf_root, level);
+    rib_clog_commit_node(spf_root);
+}
+
 void 
 flush_routes(node_t *node){
 
@@ -33,7 +33,10 @@
 #ifndef __ROUTES__
 #define __ROUTES__
 
+#include <assert.h>
+#include <string.h>
 #include "instance.h"
+#include "nh_group.h"
 
 /*Routine to build the routing table*/
 typedef enum RTE_INSTALL_STATUS{
@@ -56,9 +59,10 @@ typedef struct routes_{
     unsigned int lsp_metric; /*meaningful if this LSP route*/
     unsigned int ext_metric; /*External metric*/
 
-    /* NH lists*//*ToDo : Convert it into arrays*/
-    ll_t *primary_nh_list[NH_MAX];/*Taking it as a list to accomodate ECMP*/
-    ll_t *backup_nh_list[NH_MAX]; /*List of node_t pointers*/
+    /*Primary and backup nexthops, upto MAX_NXT_HOPS each to accomodate
+     * ECMP. Group is shared with other routes having same nexthops and
+     * with the routing entries installed from them*/
+    nh_group_t *nhg;
 
     /*same subnet prefix lists*/
     ll_t *like_prefix_list; 
@@ -67,8 +71,37 @@ typedef struct routes_{
     /*SR support*/
     mpls_label_t prev_mpls_label;/*MPLS label of this route in its previous incarnation*/
 
+    /*Free list linkage of route slab pool*/
+    struct routes_ *slab_next;
+    /*Hash chain of the route build shard owning this route, valid
+     * only while parallel route build is in progress*/
+    struct routes_ *shard_next;
+    /*Hash chain of route index of spf_info*/
+    struct routes_ *index_next;
 } routes_t;
 
+/*Index of routes_list of a topology on route key*/
+#define ROUTE_INDEX_INIT_SIZE   64 /*Must be power of 2*/
+
+struct route_index_{
+
+    unsigned int count;
+    unsigned int hash_size; /*Power of 2*/
+    routes_t **bucket;
+};
+
+route_index_t *
+init_route_index();
+
+/*Parallel route build : (spf result, prefix) pairs are sharded by
+ * route key across worker threads, so that a route is only ever
+ * built by one worker and in the same order as serial build*/
+#define ROUTE_BUILD_MAX_WORKERS             8
+/*Below this many (spf result, prefix) pairs, build serially*/
+#define ROUTE_BUILD_PARALLEL_THRESHOLD      1024
+/*Must be power of 2*/
+#define ROUTE_BUILD_SHARD_HASH_SIZE         1024
+
 routes_t *route_malloc();
 
 routes_t *
@@ -87,48 +120,37 @@ route_set_key(routes_t *route, char *ipv4_addr, char mask);
 void
 free_route(routes_t *route);
 
-#define ROUTE_ADD_NH(_route_nh_list, _internal_nh_t_ptr)     \
-    singly_ll_add_node_by_val(_route_nh_list, _internal_nh_t_ptr)
-
-static inline void
-ROUTE_FLUSH_PRIMARY_NH_LIST(routes_t *route, nh_type_t nh){
+#define ROUTE_PRIMARY_NH(routeptr, _nh)     ((routeptr)->nhg->primary[_nh])
 
-    singly_ll_node_t *list_node = NULL;
-    ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node){
+#define ROUTE_BACKUP_NH(routeptr, _nh)      ((routeptr)->nhg->backup[_nh])
 
-        free(list_node->data);
-        list_node->data = NULL;
-    } ITERATE_LIST_END;
+/*Group of route about to be modified, copied first if shared*/
+#define ROUTE_NHG_WRITABLE(routeptr)        nh_group_unshare(&(routeptr)->nhg)
 
-    delete_singly_ll(route->primary_nh_list[nh]);
-}
+#define ROUTE_ADD_PRIMARY_NH(routeptr, _nh, _internal_nh_t_ptr)    \
+    route_nh_array_add(&ROUTE_NHG_WRITABLE(routeptr)->primary[_nh], _internal_nh_t_ptr)
 
-static inline void
-ROUTE_FLUSH_BACKUP_NH_LIST(routes_t *route, nh_type_t nh){
+#define ROUTE_ADD_BACKUP_NH(routeptr, _nh, _internal_nh_t_ptr)     \
+    route_nh_array_add(&ROUTE_NHG_WRITABLE(routeptr)->backup[_nh], _internal_nh_t_ptr)
 
-    singly_ll_node_t *list_node = NULL;
-    ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
+#define ROUTE_FLUSH_BACKUP_NH_LIST(routeptr, _nh)   \
+    route_nh_array_flush(&ROUTE_NHG_WRITABLE(routeptr)->backup[_nh])
 
-        free(list_node->data);
-        list_node->data = NULL;
-    } ITERATE_LIST_END;
-
-    delete_singly_ll(route->backup_nh_list[nh]);
-}
+/*Route must not be present in route lists already*/
+void
+route_list_add(spf_info_t *spf_info, routes_t *route, rtttype_t rt_type);
 
-#define ROUTE_ADD_BACKUP_NH(routeptr, nodeptr)      \
-    singly_ll_add_node_by_val(routeptr->backup_nh_list, nodeptr)
+void
+route_list_remove(spf_info_t *spf_info, routes_t *route, rtttype_t rt_type);
 
-#define ROUTE_ADD_TO_ROUTE_LIST(spfinfo_ptr, routeptr, topo)               \
-    singly_ll_add_node_by_val(spfinfo_ptr->routes_list[topo], routeptr);   \
-    singly_ll_add_node_by_val(spfinfo_ptr->priority_routes_list[topo], routeptr)
+#define ROUTE_ADD_TO_ROUTE_LIST(spfinfo_ptr, routeptr, topo)    \
+    route_list_add(spfinfo_ptr, routeptr, topo)
 
-#define ROUTE_DEL_FROM_ROUTE_LIST(spfinfo_ptr, routeptr, topo)    \
-    singly_ll_delete_node_by_data_ptr(spfinfo_ptr->routes_list[topo], routeptr);  \
-    singly_ll_delete_node_by_data_ptr(spfinfo_ptr->priority_routes_list[topo], routeptr)
+#define ROUTE_DEL_FROM_ROUTE_LIST(spfinfo_ptr, routeptr, topo)  \
+    route_list_remove(spfinfo_ptr, routeptr, topo)
 
 #define ROUTE_GET_PR_NH_CNT(routeptr, _nh)   \
-    GET_NODE_COUNT_SINGLY_LL(routeptr->primary_nh_list[_nh])
+    (ROUTE_PRIMARY_NH(routeptr, _nh).count)
 
 #define ROUTE_GET_BEST_PREFIX(routeptr)   \
     ((GET_HEAD_SINGLY_LL(routeptr->like_prefix_list))->data)
@@ -146,6 +168,11 @@ void
 build_routing_table(spf_info_t *spf_info,
                     node_t *spf_root, LEVEL level);
 
+/*Rebuild and reprogram only the unicast routes of given prefixes*/
+void
+prc_postprocessing(spf_info_t *spf_info, node_t *spf_root, LEVEL level,
+                   common_pfx_key_t *prefixes, unsigned int n_prefixes);
+
 void
 delete_all_routes(node_t *node, LEVEL level);
 
@@ -190,7 +217,7 @@ is_route_local(routes_t *route){
     unsigned int nhcount = 0;
 
     ITERATE_NH_TYPE_BEGIN(nh){
-        nhcount += GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]) ;   
+        nhcount += ROUTE_PRIMARY_NH(route, nh).count;
     } ITERATE_NH_TYPE_END;
     return nhcount == 0;
 }
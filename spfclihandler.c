@@ -46,6 +46,11 @@
 #include "no_warn.h"
 #include "complete_spf_path.h"
 #include "spring_adjsid.h"
+#include "rsvp_cspf.h"
+#include "fwd_sim.h"
+#include "fib_check.h"
+#include "fib_export.h"
+#include "rib_changelog.h"
 
 extern instance_t * instance;
 
@@ -93,8 +98,15 @@ _reconstruct_all_rsvp_tunnels(){
             rsvp_tunnel = glthread_to_rsvp_tunnel(curr);
             rc = create_targeted_rsvp_tunnel(node, rsvp_tunnel->egress_lsr->router_id, 
                     0, 0, 0, &rsvp_tunnel_data);
-            if(!rc)
-                memcpy(rsvp_tunnel, &rsvp_tunnel_data, sizeof(rsvp_tunnel_t));
+            if(rc)
+                continue;
+            /*Only the signalled state is refreshed, LSP name, TE constraints
+             * and db linkage are retained*/
+            rsvp_tunnel->physical_oif = rsvp_tunnel_data.physical_oif;
+            memcpy(rsvp_tunnel->gateway, rsvp_tunnel_data.gateway, PREFIX_LEN);
+            rsvp_tunnel->egress_lsr = rsvp_tunnel_data.egress_lsr;
+            rsvp_tunnel->rsvp_label = rsvp_tunnel_data.rsvp_label;
+            rsvp_lspdb_reindex_lsp(node, rsvp_tunnel);
         } ITERATE_GLTHREAD_END(&node->rsvp_config.lspdb, curr);
     } ITERATE_LIST_END;
 }
@@ -102,9 +114,186 @@ _reconstruct_all_rsvp_tunnels(){
 int
 run_spf_run_all_nodes(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
 
+    ldp_dist_stats_t ldp_dist_stats;
+    fib_check_result_t *fib_check_result = NULL;
+    singly_ll_node_t *list_node = NULL;
+
+    /*Each RIB logs the net change of whole sync*/
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        rib_clog_begin_node(list_node->data);
+    } ITERATE_LIST_END;
+
     _run_spf_run_all_nodes();
+    /*Distribute LDP bindings on the converged IGP routes*/
+    ldp_distribute_fec_bindings(instance, &ldp_dist_stats);
+    if(ldp_dist_stats.n_nodes)
+        print_ldp_dist_stats(&ldp_dist_stats);
     /*now reconstruct all RSVP tunnels*/
     _reconstruct_all_rsvp_tunnels();
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        rib_clog_commit_node(list_node->data);
+    } ITERATE_LIST_END;
+
+    /*Verify the converged RIBs, report only if inconsistent*/
+    fib_check_result = calloc(1, sizeof(fib_check_result_t));
+    fib_check_run(instance, fib_check_result);
+    if(FIB_CHECK_VIOLATIONS(fib_check_result))
+        print_fib_check_result(fib_check_result);
+    free(fib_check_result);
+    return 0;
+}
+
+int
+run_instance_rsvp_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+    rsvp_cspf_stats_t rsvp_cspf_stats;
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_RSVP_CSPF:
+            rsvp_cspf_place_all(instance, RSVP_CSPF_ORDER_CONFIG, &rsvp_cspf_stats);
+            print_rsvp_cspf_stats("placement", &rsvp_cspf_stats);
+            break;
+        case CMDCODE_RUN_INSTANCE_RSVP_CSPF_BW_ORDER:
+            rsvp_cspf_place_all(instance, RSVP_CSPF_ORDER_BW_DESC, &rsvp_cspf_stats);
+            print_rsvp_cspf_stats("placement", &rsvp_cspf_stats);
+            break;
+        case CMDCODE_RUN_INSTANCE_RSVP_REOPTIMIZE:
+            rsvp_cspf_reoptimize(instance, &rsvp_cspf_stats);
+            print_rsvp_cspf_stats("re-optimization", &rsvp_cspf_stats);
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
+int
+run_instance_fwd_sim_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+    fwd_sim_matrix_t matrix;
+    fwd_sim_load_stats_t load_stats;
+
+    fwd_sim_init_all_pairs(instance, &matrix);
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_FWD_SIM:
+            fwd_sim_run(instance, &matrix);
+            print_fwd_sim_matrix(&matrix, FALSE);
+            break;
+        case CMDCODE_RUN_INSTANCE_FWD_SIM_DETAIL:
+            fwd_sim_run(instance, &matrix);
+            print_fwd_sim_matrix(&matrix, TRUE);
+            break;
+        case CMDCODE_RUN_INSTANCE_FWD_SIM_LOAD:
+            fwd_sim_load_run(instance, &matrix, &load_stats);
+            print_fwd_sim_load_stats(&load_stats);
+            break;
+        default:
+            assert(0);
+    }
+    fwd_sim_free_matrix(&matrix);
+    return 0;
+}
+
+int
+run_instance_frr_sim_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+    tlv_struct_t *tlv = NULL;
+    unsigned int i = 0;
+    char *node_name = NULL,
+         *slot_name = NULL;
+    node_t *node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+    fwd_sim_matrix_t base, frr;
+    fwd_sim_frr_stats_t frr_stats;
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
+            node_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "slot-no", strlen("slot-no")) ==0)
+            slot_name = tlv->value;
+    } TLV_LOOP_END;
+
+    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node->edges[i];
+        if(!edge_end)
+            break;
+        if(edge_end->dirn == OUTGOING &&
+            strncmp(edge_end->intf_name, slot_name, IF_NAME_SIZE) == 0){
+            edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+            break;
+        }
+    }
+    if(!edge){
+        printf("Error : slot-no %s do not exist\n", slot_name);
+        return 0;
+    }
+
+    fwd_sim_init_all_pairs(instance, &base);
+    fwd_sim_init_all_pairs(instance, &frr);
+    fwd_sim_frr_run(instance, edge, &base, &frr, &frr_stats);
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_FRR_SIM:
+            print_fwd_sim_frr(edge, &base, &frr, &frr_stats, FALSE);
+            break;
+        case CMDCODE_RUN_INSTANCE_FRR_SIM_DETAIL:
+            print_fwd_sim_frr(edge, &base, &frr, &frr_stats, TRUE);
+            break;
+        default:
+            assert(0);
+    }
+    fwd_sim_free_matrix(&base);
+    fwd_sim_free_matrix(&frr);
+    return 0;
+}
+
+int
+run_instance_fib_export_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+    tlv_struct_t *tlv = NULL;
+    char *file_name = NULL;
+    fib_export_stats_t stats;
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "file-name", strlen("file-name")) ==0)
+            file_name = tlv->value;
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_FIB_EXPORT:
+            if(fib_export_to_file(instance, file_name, &stats) == 0)
+                print_fib_export_stats(file_name, &stats);
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
+int
+run_instance_fib_check_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+    fib_check_result_t *fib_check_result = NULL;
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_FIB_CHECK:
+            fib_check_result = calloc(1, sizeof(fib_check_result_t));
+            fib_check_run(instance, fib_check_result);
+            print_fib_check_result(fib_check_result);
+            free(fib_check_result);
+            break;
+        default:
+            assert(0);
+    }
     return 0;
 }
 
@@ -147,6 +336,13 @@ spf_node_slot_enable_disable(node_t *node, char *slot_name,
         printf("%s() : INFO : Node : %s, slot %s not found\n", __FUNCTION__, node->node_name, slot_name);
         return;
     }
+
+    if(edge->status == 0){
+        unsigned int n_lsps = rsvp_cspf_reroute_oif_lsps(node, &edge->from);
+        if(n_lsps)
+            printf("Node : %s, slot %s down, %u RSVP LSPs re-routed\n",
+                    node->node_name, slot_name, n_lsps);
+    }
     
     dist_info_hdr_t dist_info_hdr;
     node_t *nbr_node = edge->to.node;
@@ -190,22 +386,14 @@ show_node_spring_details(node_t *node, LEVEL level){
     printf("\tRange : %u, starting mpls label = %u\n", 
         node->srgb->range, node->srgb->first_sid.sid);
 
-    unsigned int i = 0, in_use_count = 0, 
-                        avail_count = 0;
-    for(; i < srgb->range; i++){
-        if(is_bit_set(SRGB_INDEX_ARRAY(srgb), i))
-            in_use_count++;
-        else
-            avail_count++;
-    }
+    unsigned int in_use_count = BIT_ARRAY_SET_COUNT(SRGB_INDEX_ARRAY(srgb)),
+                 avail_count = srgb->range - in_use_count;
     printf("\t# Mpls labels in Use : %u, Available : %u\n", in_use_count, avail_count);
 
     printf("\tPrefix SID Database :\n");
-    ITERATE_LIST_BEGIN(node->local_prefix_list[level], list_node){
-    
-        prefix = list_node->data;
+    ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(node, level), prefix){
         diplay_prefix_sid(prefix);
-    } ITERATE_LIST_END;
+    } ITERATE_PREFIX_STORE_END;
 }
 
 void
@@ -346,20 +534,18 @@ dump_route_info(routes_t *route){
 
     ITERATE_NH_TYPE_BEGIN(nh){
         printf("%s Primary Nxt Hops count : %u\n",
-                nh == IPNH ? "IPNH" : "LSPNH", GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]));
-        ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node){
-            nxthop = (internal_nh_t *)list_node->data;
+                nh == IPNH ? "IPNH" : "LSPNH", ROUTE_PRIMARY_NH(route, nh).count);
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh), nxthop){
             PRINT_ONE_LINER_NXT_HOP(nxthop);
-        }ITERATE_LIST_END;
+        } ITERATE_ROUTE_NH_END;
     } ITERATE_NH_TYPE_END;
     
     ITERATE_NH_TYPE_BEGIN(nh){
         printf("%s Backup Nxt Hops count : %u\n",
-                nh == IPNH ? "IPNH" : "LSPNH", GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]));
-        ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
-            nxthop = (internal_nh_t *)list_node->data;
+                nh == IPNH ? "IPNH" : "LSPNH", ROUTE_BACKUP_NH(route, nh).count);
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), nxthop){
             PRINT_ONE_LINER_NXT_HOP(nxthop);
-        }ITERATE_LIST_END;
+        } ITERATE_ROUTE_NH_END;
     } ITERATE_NH_TYPE_END;
 }
 
@@ -402,20 +588,18 @@ dump_spring_route_info(routes_t *route){
 
     ITERATE_NH_TYPE_BEGIN(nh){
         printf("%s Primary Nxt Hops count : %u\n",
-                nh == IPNH ? "IPNH" : "LSPNH", GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]));
-        ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node){
-            nxthop = (internal_nh_t *)list_node->data;
+                nh == IPNH ? "IPNH" : "LSPNH", ROUTE_PRIMARY_NH(route, nh).count);
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_PRIMARY_NH(route, nh), nxthop){
             PRINT_ONE_LINER_SPRING_NXT_HOP(nxthop);
-        }ITERATE_LIST_END;
+        } ITERATE_ROUTE_NH_END;
     } ITERATE_NH_TYPE_END;
     
     ITERATE_NH_TYPE_BEGIN(nh){
         printf("%s Backup Nxt Hops count : %u\n",
-                nh == IPNH ? "IPNH" : "LSPNH", GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]));
-        ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
-            nxthop = (internal_nh_t *)list_node->data;
+                nh == IPNH ? "IPNH" : "LSPNH", ROUTE_BACKUP_NH(route, nh).count);
+        ITERATE_ROUTE_NH_BEGIN(ROUTE_BACKUP_NH(route, nh), nxthop){
             PRINT_ONE_LINER_SPRING_NXT_HOP(nxthop);
-        }ITERATE_LIST_END;
+        } ITERATE_ROUTE_NH_END;
     } ITERATE_NH_TYPE_END;
 }
 
@@ -606,6 +790,22 @@ lfa_rlfa_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
             }
         }
         break;
+        case CMDCODE_CONFIG_INTF_PIC_FAILOVER:
+        {
+            switch(enable_or_disable){
+                case CONFIG_ENABLE:
+                    printf("Node : %s : PIC link %s down, nexthop groups repaired = %u\n",
+                        node->node_name, edge_end->intf_name,
+                        nh_group_pic_link_down(node, edge_end));
+                    break;
+                case CONFIG_DISABLE:
+                    nh_group_pic_link_up(node, edge_end);
+                    break;
+                default:
+                    ;
+            }
+        }
+        break;
     } 
     return 0;
 }
@@ -864,7 +1064,11 @@ instance_node_spring_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode
     char *intf_name = NULL;
     unsigned int prefix_sid = 0,
                  index_range = 0,
-                 first_sid = 0;
+                 first_sid = 0,
+                 first_sid_index = 0,
+                 range = 0;
+    char *prefix = NULL;
+    char mask = 0;
     TLV_LOOP_BEGIN(tlv_buf, tlv){
         if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
             node_name = tlv->value;
@@ -878,6 +1082,14 @@ instance_node_spring_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode
             index_range = atoi(tlv->value);
         else if(strncmp(tlv->leaf_id, "start-label",  strlen("start-label")) ==0)
             first_sid = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "prefix",  strlen("prefix")) ==0)
+            prefix = tlv->value;
+        else if(strncmp(tlv->leaf_id, "mask",  strlen("mask")) ==0)
+            mask = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "first-sid-index",  strlen("first-sid-index")) ==0)
+            first_sid_index = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "range",  strlen("range")) ==0)
+            range = atoi(tlv->value);
         else
             assert(0);
     } TLV_LOOP_END;
@@ -963,7 +1175,7 @@ instance_node_spring_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode
             printf("Source Packet Routing Not Enabled\n");
             return 0;
         }
-        node->srgb->range = index_range;
+        resize_srgb(node->srgb, index_range);
         printf("SRGB config changed, run - \"run instance sync\"\n");
         break;
 
@@ -973,8 +1185,46 @@ instance_node_spring_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode
             return 0;
         }
         node->srgb->first_sid.sid = first_sid;
+        srgb_update_version(node->srgb);
         printf("SRGB config changed, run - \"run instance sync\"\n");
         break; 
+        case CMDCODE_CONFIG_NODE_SRMS_LCL_POLICY:
+        {
+            if(node->spring_enabled == FALSE){
+                printf("Source Packet Routing Not Enabled\n");
+                return 0;
+            }
+            srms_sid_label_binding_tlv_t srms_local_policy;
+            memset(&srms_local_policy, 0, sizeof(srms_sid_label_binding_tlv_t));
+            srms_local_policy.type = SRMS_SID_LABEL_BINDING_TLV_TYPE;
+            strncpy(srms_local_policy.fec_prefix, prefix, PREFIX_LEN);
+            srms_local_policy.mask = mask;
+            srms_local_policy.range = range;
+            srms_local_policy.prefix_sid.type = PREFIX_SID_SUBTLV_TYPE;
+            srms_local_policy.prefix_sid.sid.sid = first_sid_index;
+            switch(enable_or_disable){
+                case CONFIG_ENABLE:
+                    if(!srms_add_local_policy(node, &srms_local_policy))
+                        return 0;
+                    break;
+                case CONFIG_DISABLE:
+                    if(!srms_delete_local_policy(node, &srms_local_policy))
+                        return 0;
+                    break;
+                default:
+                    ;
+            }
+            printf("SRMS config changed, run - \"run instance sync\"\n");
+        }
+        break;
+        case CMDCODE_CONFIG_NODE_SRMS:
+        node->am_i_mapping_server = (enable_or_disable == CONFIG_DISABLE) ? FALSE : TRUE;
+        printf("SRMS config changed, run - \"run instance sync\"\n");
+        break;
+        case CMDCODE_CONFIG_NODE_SRMS_CLIENT_DISABLE:
+        node->am_i_mapping_client = (enable_or_disable == CONFIG_DISABLE) ? TRUE : FALSE;
+        printf("SRMS config changed, run - \"run instance sync\"\n");
+        break;
         default:
         ;
     }
@@ -1024,6 +1274,7 @@ instance_node_spring_show_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
     tlv_struct_t *tlv = NULL;
     int cmd_code = -1;
     char *prefix = NULL;
+    char mask = 0;
     char str_prefix_with_mask[PREFIX_LEN_WITH_MASK + 1];
 
     cmd_code = EXTRACT_CMD_CODE(tlv_buf);
@@ -1035,6 +1286,8 @@ instance_node_spring_show_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
             level = atoi(tlv->value);
         else if (strncmp(tlv->leaf_id, "prefix" , strlen("prefix")) ==0)
             prefix = tlv->value;
+        else if (strncmp(tlv->leaf_id, "mask" , strlen("mask")) ==0)
+            mask = atoi(tlv->value);
         else
             assert(0);
     } TLV_LOOP_END;
@@ -1062,7 +1315,6 @@ instance_node_spring_show_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
                 ITERATE_LIST_BEGIN(res, list_node){
                     
                     prefix = list_node->data;
-                    assert(IS_PREFIX_SR_ACTIVE(prefix));
                     memset(str_prefix_with_mask, 0, PREFIX_LEN_WITH_MASK + 1);
                     apply_mask2(prefix->prefix, prefix->mask, str_prefix_with_mask);
                     printf("\t%-20s %-20s %u\n", 
@@ -1100,12 +1352,24 @@ instance_node_spring_show_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
         case CMDCODE_SHOW_NODE_SPRING:
             show_node_spring_details(node, level);
         break;
+        case CMDCODE_SHOW_NODE_SRMS_LCL_POLICY:
+            show_srms_local_policy(node);
+            break;
+        case CMDCODE_SHOW_NODE_SRMS_CLIENT_ACTIVE_POLICY:
+            show_srmc_mapping_policy(node, TRUE, prefix, mask);
+            break;
+        case CMDCODE_SHOW_NODE_SRMS_CLIENT_BACKUP_POLICY:
+            show_srmc_mapping_policy(node, FALSE, NULL, 0);
+            break;
         case CMDCODE_SHOW_NODE_MPLS_FORWARDINNG_TABLE:
             mpls_0_display(node->spf_info.rib[MPLS_0], 0);
             break;
         case CMDCODE_SHOW_NODE_MPLS_RSVP_LSP:
             print_all_rsvp_lsp(node);
             break;
+        case CMDCODE_SHOW_NODE_MPLS_RSVP_TE_LINKS:
+            show_rsvp_te_links(node);
+            break;
         case CMDCODE_SHOW_SR_TUNNEL:
             show_sr_tunnels(node, prefix);
         default:
@@ -1134,15 +1398,15 @@ debug_trace_mpls_stack_label(param_t *param, ser_buff_t *tlv_buf, op_mode enable
             assert(0);
     } TLV_LOOP_END;
 
-    mpls_label_stack_t *mpls_label_stack = get_new_mpls_label_stack();
+    mpls_label_stack_t mpls_label_stack;
+    init_mpls_label_stack(&mpls_label_stack);
     i--;
     
     for(; i >= 0; i-- )
-        PUSH_MPLS_LABEL(mpls_label_stack, label[i]);
+        PUSH_MPLS_LABEL(&mpls_label_stack, label[i]);
     
     node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
-    transient_mpls_pfe_engine(node, mpls_label_stack, &next_node);
-    free_mpls_label_stack(mpls_label_stack); 
+    transient_mpls_pfe_engine(node, &mpls_label_stack, &next_node);
     return 0;
 }
 
@@ -1200,6 +1464,9 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
     char *node_name = NULL;
     char *router_id = NULL;
     char *rsvp_lsp_name = NULL;
+    unsigned int bw_mbps = 0,
+                 bit_no = 0;
+    rsvp_tunnel_t *rsvp_tunnel = NULL;
     int rc = -1;
            
     TLV_LOOP_BEGIN(tlv_buf, tlv){
@@ -1210,6 +1477,10 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
             router_id = tlv->value;
         else if(strncmp(tlv->leaf_id, "rsvp-lsp-name", strlen("rsvp-lsp-name")) ==0)
             rsvp_lsp_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "bw-mbps", strlen("bw-mbps")) ==0)
+            bw_mbps = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "bit-no", strlen("bit-no")) ==0)
+            bit_no = atoi(tlv->value);
         else
             assert(0);
     } TLV_LOOP_END;
@@ -1231,7 +1502,7 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
         break;
         case CMDCODE_CONFIG_NODE_RSVP_TUNNEL:
         {
-            rsvp_tunnel_t *rsvp_tunnel = look_up_rsvp_tunnel(node, rsvp_lsp_name);
+            rsvp_tunnel = look_up_rsvp_tunnel(node, rsvp_lsp_name);
             if(rsvp_tunnel){
                 printf("Error : RSVP tunnel %s already exists\n", rsvp_lsp_name);
                 return 0;
@@ -1248,9 +1519,40 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
             rc = add_new_rsvp_tunnel(node, rsvp_tunnel);
             if(rc == -1){
                 free(rsvp_tunnel);
+                break;
             }
+            if(!rsvp_cspf_place_lsp(node, rsvp_tunnel))
+                printf("CSPF : No path for LSP %s\n", rsvp_lsp_name);
         }   
         break;
+        case CMDCODE_CONFIG_NODE_RSVP_TUNNEL_BANDWIDTH:
+        case CMDCODE_CONFIG_NODE_RSVP_TUNNEL_EXCLUDE_ANY:
+        case CMDCODE_CONFIG_NODE_RSVP_TUNNEL_INCLUDE_ANY:
+            rsvp_tunnel = look_up_rsvp_tunnel(node, rsvp_lsp_name);
+            if(!rsvp_tunnel){
+                printf("Error : RSVP tunnel %s do not exist\n", rsvp_lsp_name);
+                return 0;
+            }
+            if(cmd_code == CMDCODE_CONFIG_NODE_RSVP_TUNNEL_BANDWIDTH){
+                rsvp_cspf_release_lsp(rsvp_tunnel);
+                rsvp_tunnel->bandwidth = (enable_or_disable == CONFIG_DISABLE) ? 0 : bw_mbps;
+            }
+            else if(cmd_code == CMDCODE_CONFIG_NODE_RSVP_TUNNEL_EXCLUDE_ANY){
+                if(enable_or_disable == CONFIG_DISABLE)
+                    rsvp_tunnel->exclude_any &= ~(1U << bit_no);
+                else
+                    rsvp_tunnel->exclude_any |= (1U << bit_no);
+            }
+            else{
+                if(enable_or_disable == CONFIG_DISABLE)
+                    rsvp_tunnel->include_any &= ~(1U << bit_no);
+                else
+                    rsvp_tunnel->include_any |= (1U << bit_no);
+            }
+            /*Re-signal the LSP with new constraints*/
+            if(!rsvp_cspf_place_lsp(node, rsvp_tunnel))
+                printf("CSPF : No path for LSP %s\n", rsvp_lsp_name);
+            break;
     }
     return 0;
 }
@@ -80,6 +80,21 @@ show_route_tree_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
 int
 run_spf_run_all_nodes(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
 
+int
+run_instance_rsvp_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
+int
+run_instance_fwd_sim_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
+int
+run_instance_fib_check_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
+int
+run_instance_frr_sim_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
+int
+run_instance_fib_export_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
 boolean
 insert_lsp_as_forward_adjacency(node_t *node, char *lsp_name, unsigned int metric, 
                            char *tail_end_ip, LEVEL level);
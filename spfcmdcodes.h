@@ -175,4 +175,39 @@
 #define CMDCODE_CONFIG_NODE_INTF_LAN_ADJ_SID_PROTECTED      109 /*config node <node-name> interface <intf-name> level <level-no> ipv4-adjacency-segment lan-neighbor <router-id> <protected|unprotected> label <lebel-no>*/
 #define CMDCODE_CONFIG_NODE_INTF_LAN_ADJ_SID_UNPROTECTED    110
 #define CMDCODE_SHOW_NODE_INTF_ADJ_SIDS                     111 /*show instance node <node-name> interface <intf-name> adjacency-sids*/
+#define CMDCODE_SHOW_NODE_RIB_CHANGELOG                     112 /*show instance node <node-name> rib-changelog*/
+#define CMDCODE_SHOW_NODE_NH_GROUPS                         113 /*show instance node <node-name> nh-groups*/
+#define CMDCODE_CONFIG_INTF_PIC_FAILOVER                    114 /*config node <node-name> [no] interface <slot-no> pic-failover*/
+#define CMDCODE_CONFIG_NODE_IMPORT_PREFIXES                 115 /*config node <node-name> import prefixes <file-name> level <level-no>*/
+#define CMDCODE_CONFIG_NODE_LEAK_POLICY                     116 /*config node <node-name> [no] leak-policy level <level-no> seq <seq-no>*/
+#define CMDCODE_CONFIG_NODE_LEAK_POLICY_PERMIT              117 /*config node <node-name> leak-policy level <level-no> seq <seq-no> prefix <prefix> <mask> upto <upto-mask> [metric <max-metric>] permit*/
+#define CMDCODE_CONFIG_NODE_LEAK_POLICY_DENY                118 /*config node <node-name> leak-policy level <level-no> seq <seq-no> prefix <prefix> <mask> upto <upto-mask> [metric <max-metric>] deny*/
+#define CMDCODE_SHOW_NODE_LEAK_POLICY                       119 /*show instance node <node-name> leak-policy*/
+
+/*Flexible Algorithms*/
+#define CMDCODE_CONFIG_NODE_SLOT_AFFINITY                   120 /*config node <node-name> [no] interface <slot-no> affinity <bit-no>*/
+#define CMDCODE_CONFIG_NODE_SLOT_TE_METRIC                  121 /*config node <node-name> [no] interface <slot-no> te-metric <te-metric>*/
+#define CMDCODE_CONFIG_NODE_FLEX_ALGO                       122 /*config node <node-name> [no] flex-algo <algo-no>*/
+#define CMDCODE_CONFIG_NODE_FLEX_ALGO_METRIC_TYPE           123 /*config node <node-name> [no] flex-algo <algo-no> metric-type <igp|te>*/
+#define CMDCODE_CONFIG_NODE_FLEX_ALGO_EXCLUDE_ANY           124 /*config node <node-name> [no] flex-algo <algo-no> exclude-any <bit-no>*/
+#define CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ANY           125 /*config node <node-name> [no] flex-algo <algo-no> include-any <bit-no>*/
+#define CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ALL           126 /*config node <node-name> [no] flex-algo <algo-no> include-all <bit-no>*/
+#define CMDCODE_CONFIG_NODE_FLEX_ALGO_NODE_SID              127 /*config node <node-name> [no] flex-algo <algo-no> node-segment <sid-index>*/
+#define CMDCODE_SHOW_NODE_FLEX_ALGO                         128 /*show instance node <node-name> flex-algo [<algo-no>]*/
+#define CMDCODE_CONFIG_NODE_SLOT_BANDWIDTH                  129 /*config node <node-name> [no] interface <slot-no> bandwidth <bw-mbps>*/
+#define CMDCODE_CONFIG_NODE_RSVP_TUNNEL_BANDWIDTH           130 /*config node <node-name> [no] rsvp tunnel <router-id> <rsvp-lsp-name> bandwidth <bw-mbps>*/
+#define CMDCODE_CONFIG_NODE_RSVP_TUNNEL_EXCLUDE_ANY         131 /*config node <node-name> [no] rsvp tunnel <router-id> <rsvp-lsp-name> exclude-any <bit-no>*/
+#define CMDCODE_CONFIG_NODE_RSVP_TUNNEL_INCLUDE_ANY         132 /*config node <node-name> [no] rsvp tunnel <router-id> <rsvp-lsp-name> include-any <bit-no>*/
+#define CMDCODE_RUN_INSTANCE_RSVP_CSPF                      133 /*run instance rsvp cspf*/
+#define CMDCODE_RUN_INSTANCE_RSVP_CSPF_BW_ORDER             134 /*run instance rsvp cspf bandwidth-order*/
+#define CMDCODE_RUN_INSTANCE_RSVP_REOPTIMIZE                135 /*run instance rsvp reoptimize*/
+#define CMDCODE_SHOW_NODE_MPLS_RSVP_TE_LINKS                136 /*show instance node <node-name> mpls rsvp te-links*/
+#define CMDCODE_RUN_INSTANCE_FWD_SIM                        137 /*run instance forwarding-simulation*/
+#define CMDCODE_RUN_INSTANCE_FWD_SIM_DETAIL                 138 /*run instance forwarding-simulation detail*/
+#define CMDCODE_RUN_INSTANCE_FIB_CHECK                      139 /*run instance fib-check*/
+#define CMDCODE_RUN_INSTANCE_FRR_SIM                        140 /*run instance frr-simulation <node-name> <slot-no>*/
+#define CMDCODE_RUN_INSTANCE_FRR_SIM_DETAIL                 141 /*run instance frr-simulation <node-name> <slot-no> detail*/
+#define CMDCODE_SHOW_NODE_FIB_MEMORY                        142 /*show instance node <node-name> fib-memory*/
+#define CMDCODE_RUN_INSTANCE_FIB_EXPORT                     143 /*run instance fib-export <file-name>*/
+#define CMDCODE_RUN_INSTANCE_FWD_SIM_LOAD                   144 /*run instance forwarding-simulation load-distribution*/
 #endif /* __SPFCMDCODES__H */
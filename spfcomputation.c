@@ -32,6 +32,7 @@
  */
 
 #include <stdio.h>
+#include <float.h>
 #include "spfutil.h"
 #include "spfcomputation.h"
 #include "routes.h"
@@ -154,6 +155,17 @@ inverse_topology(instance_t *instance, LEVEL level){
     }ITERATE_LIST_END;
 }
 
+/*UCMP : bandwidth of the link over which nexthops of candidate node
+ * are inherited by its nbr. PN to nbr links are part of the LAN whose
+ * bandwidth is already accounted on the link of the router to the PN*/
+static float
+ucmp_link_bw(node_t *candidate_node, edge_t *edge, LEVEL level){
+
+    if(candidate_node->node_type[level] == PSEUDONODE)
+        return FLT_MAX;
+    return edge->bandwidth;
+}
+
 static void
 run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree){
 
@@ -316,6 +328,7 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree){
                                 nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
 #endif
                         copy_nh_list2(&candidate_node->next_hop[level][nh][0], &nbr_node->next_hop[level][nh][0]);
+                        ucmp_clamp_nh_list2(&nbr_node->next_hop[level][nh][0], ucmp_link_bw(candidate_node, edge, level));
 #ifdef __ENABLE_TRACE__                        
                         sprintf(instance->traceopts->b, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
                                 nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
@@ -378,7 +391,8 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree){
                             nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
 #endif
 
-                    union_nh_list2(&candidate_node->next_hop[level][nh][0]  , &nbr_node->next_hop[level][nh][0]);
+                    ucmp_union_nh_list2(&candidate_node->next_hop[level][nh][0], &nbr_node->next_hop[level][nh][0],
+                                        ucmp_link_bw(candidate_node, edge, level));
 #ifdef __ENABLE_TRACE__                    
                     sprintf(instance->traceopts->b, "next_hop of %s at %s %s after Union", nbr_node->node_name,
                             get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
@@ -670,6 +684,7 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
            broadcast_filter_select_pq_nodes_from_ex_pspace(spf_root, edge, level);
        }
     }
+    instance->backup_owner[level] = spf_root;
 #ifdef __ENABLE_TRACE__    
     sprintf(instance->traceopts->b, "END of SPF back up calculation"); 
     trace(instance->traceopts, SPF_EVENTS_BIT);
@@ -779,6 +794,48 @@ partial_spf_run(node_t *spf_root, LEVEL level){
     }
 }
 
+/*PRC for a set of changed prefixes. Dijkstra and backup results are
+ * reused, only the routes of given prefixes are rebuilt and reprogrammed.
+ * Beyond PRC_MAX_PREFIXES, all routes are rebuilt in one pass instead and
+ * prefixes may be NULL*/
+void
+partial_spf_run_prefixes(node_t *spf_root, LEVEL level, 
+                         common_pfx_key_t *prefixes, 
+                         unsigned int n_prefixes){
+
+#ifdef __ENABLE_TRACE__    
+    sprintf(instance->traceopts->b, "Root : %s, %s, changed prefixes = %u", 
+            spf_root->node_name, get_str_level(level), n_prefixes); 
+    trace(instance->traceopts, DIJKSTRA_BIT);
+#endif
+
+    if(spf_root->spf_info.spf_level_info[level].version == 0){
+        spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN);      
+        return;
+    }
+
+    init_prc_run(spf_root, level);
+
+    /*Backups stored on destination nodes could be of some other root*/
+    if(IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
+        if(instance->backup_owner[level] != spf_root)
+            compute_backup_routine(spf_root, level);
+    }
+    else if(instance->backup_owner[level]){
+        init_back_up_computation(spf_root, level);
+    }
+
+    /*SR routes of a prefix depends on prefix SIDs of all nodes, let full
+     * route build take care of them*/
+    if(is_node_spring_enabled(spf_root, level) ||
+        n_prefixes > PRC_MAX_PREFIXES)
+        spf_postprocessing(&spf_root->spf_info, spf_root, level);
+    else
+        prc_postprocessing(&spf_root->spf_info, spf_root, level, prefixes, n_prefixes);
+
+    spf_root->spf_info.spf_level_info[level].spf_type = FULL_RUN;
+}
+
 /*This macro should work as follows :
  * 1. if X and Y both are non-PN, then compute the dist from X to Y from spf result of X
  * 2. if X is a PN, then compute the dist from X to Y from spf result of X, explicit forward SPF computation on X is required in this case
@@ -73,6 +73,9 @@ typedef struct internal_nh_t_{
     /*No of destinations covered by this RLFA backup*/
     unsigned int *ref_count; 
     boolean is_eligible;
+    /*UCMP : Bottleneck bandwidth (in GIG) of the widest shortest path
+     * through this nexthop. Valid for primary nexthops only*/
+    float ucmp_bw;
 } internal_nh_t;
 
 /*macros to operate on above internal_nh_t DS*/
@@ -116,7 +119,8 @@ typedef struct internal_nh_t_{
     (_internal_nh_t).rlfa = NULL;                                            \
     (_internal_nh_t).root_metric = 0;                                        \
     (_internal_nh_t).dest_metric = 0;                                        \
-    (_internal_nh_t).is_eligible = FALSE
+    (_internal_nh_t).is_eligible = FALSE;                                    \
+    (_internal_nh_t).ucmp_bw = _oif_edge->bandwidth
 
 #define copy_internal_nh_t(_src, _dst)    \
     (_dst).level = (_src).level;          \
@@ -130,7 +134,8 @@ typedef struct internal_nh_t_{
     (_dst).rlfa = (_src).rlfa;                          \
     (_dst).root_metric = (_src).root_metric;            \
     (_dst).dest_metric = (_src).dest_metric;            \
-    (_dst).is_eligible = (_src).is_eligible
+    (_dst).is_eligible = (_src).is_eligible;            \
+    (_dst).ucmp_bw = (_src).ucmp_bw
 
 /*ToDo : MPLS Label stack has been skipped for comparison*/
 #define is_internal_nh_t_equal(_nh1, _nh2)                   \
@@ -251,6 +256,10 @@ get_topology_name(rtttype_t topo){
     }
 }
 
+typedef struct nh_group_table_ nh_group_table_t;
+typedef struct sr_label_cache_ sr_label_cache_t;
+typedef struct route_index_ route_index_t;
+
 typedef struct spf_info_{
 
     spf_level_info_t spf_level_info[MAX_LEVEL];
@@ -260,9 +269,17 @@ typedef struct spf_info_{
     ll_t *routes_list[TOPO_MAX];/*Routes computed as a result of SPF run, routes computed are not level specific*/
     ll_t *priority_routes_list[TOPO_MAX];/*Always add route in this list*/
     ll_t *deferred_routes_list[TOPO_MAX];
+    /*routes_list indexed on route key, see route_index_t*/
+    route_index_t *route_index[TOPO_MAX];
 
     /*Routing tables*/
     rt_un_table_t *rib[RIB_COUNT];
+
+    /*Shared nexthop groups of routes, used for PIC*/
+    nh_group_table_t *nhg_table;
+
+    /*SPRING nexthop label stacks, see igp_sr_ext.h*/
+    sr_label_cache_t *sr_lbl_cache;
 } spf_info_t;
 
 #define GET_SPF_INFO_NODE(spf_info_ptr, _level)  \
@@ -293,6 +310,17 @@ self_spf_run_result_comparison_fn(void *self_spf_result_ptr, void *node_ptr);
 void
 partial_spf_run(node_t *spf_root, LEVEL level);
 
+typedef struct common_pfx_ common_pfx_key_t;
+
+/*Each changed prefix costs one walk over the spf result, rebuilding all
+ * routes is cheaper beyond this*/
+#define PRC_MAX_PREFIXES    64
+
+void
+partial_spf_run_prefixes(node_t *spf_root, LEVEL level, 
+                         common_pfx_key_t *prefixes, 
+                         unsigned int n_prefixes);
+
 unsigned int 
 DIST_X_Y(node_t *X, node_t *Y, LEVEL _level);
 
@@ -47,6 +47,9 @@
 #include "no_warn.h"
 #include "spf_candidate_tree.h"
 #include "complete_spf_path.h"
+#include "rib_changelog.h"
+#include "prefix_import.h"
+#include "fib_export.h"
 
 extern
 instance_t *instance;
@@ -174,6 +177,53 @@ validate_metric_value(char *value_passed){
     return VALIDATION_FAILED;
 }
 
+int
+validate_flex_algo_no(char *value_passed){
+
+    int algo = atoi(value_passed);
+    if(algo >= FLEX_ALGO_MIN && algo <= FLEX_ALGO_MAX)
+        return VALIDATION_SUCCESS;
+
+    printf("Error : Incorrect flex algo. Valid range : [%u,%u]\n",
+        FLEX_ALGO_MIN, FLEX_ALGO_MAX);
+    return VALIDATION_FAILED;
+}
+
+int
+validate_affinity_bit_no(char *value_passed){
+
+    int bit_no = atoi(value_passed);
+    if(bit_no >= 0 && bit_no < FLEX_ALGO_MAX_AFFINITY)
+        return VALIDATION_SUCCESS;
+
+    printf("Error : Incorrect affinity. Valid range : [0,%u]\n",
+        FLEX_ALGO_MAX_AFFINITY - 1);
+    return VALIDATION_FAILED;
+}
+
+int
+validate_bandwidth_mbps(char *value_passed){
+
+    int bw_mbps = atoi(value_passed);
+    /*Upto 1 Tbps*/
+    if(bw_mbps >= 0 && bw_mbps <= 1000000)
+        return VALIDATION_SUCCESS;
+
+    printf("Error : Incorrect bandwidth. Valid range : [0,1000000] Mbps\n");
+    return VALIDATION_FAILED;
+}
+
+int
+validate_flex_algo_metric_type(char *value_passed){
+
+    if(strcmp(value_passed, "igp") == 0 ||
+        strcmp(value_passed, "te") == 0)
+        return VALIDATION_SUCCESS;
+
+    printf("Error : Incorrect metric type. Valid values : igp | te\n");
+    return VALIDATION_FAILED;
+}
+
 static int
 node_slot_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
 
@@ -183,7 +233,12 @@ node_slot_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_
     node_t *node = NULL;
     int cmd_code = -1;
     LEVEL level = MAX_LEVEL;
-    unsigned int metric = 0;
+    unsigned int metric = 0,
+                 te_metric = 0,
+                 bit_no = 0,
+                 bw_mbps = 0;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
       
     TLV_LOOP_BEGIN(tlv_buf, tlv){
         if(strncmp(tlv->leaf_id, "slot-no", strlen("slot-no")) ==0)
@@ -194,6 +249,12 @@ node_slot_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_
             level = atoi(tlv->value);
         else if(strncmp(tlv->leaf_id, "metric", strlen("metric")) ==0)
             metric = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "te-metric", strlen("te-metric")) ==0)
+            te_metric = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "bit-no", strlen("bit-no")) ==0)
+            bit_no = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "bw-mbps", strlen("bw-mbps")) ==0)
+            bw_mbps = atoi(tlv->value);
     } TLV_LOOP_END;
 
     node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
@@ -210,6 +271,38 @@ node_slot_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_
             else
                 spf_node_slot_metric_change(node, slot_name, level, metric);
             break;
+        case CMDCODE_CONFIG_NODE_SLOT_AFFINITY:
+        case CMDCODE_CONFIG_NODE_SLOT_TE_METRIC:
+            edge_end = get_interface_from_intf_name(node, slot_name);
+            if(!edge_end){
+                printf("Error : node %s, Interface %s not found\n", node->node_name, slot_name);
+                return 0;
+            }
+            edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+            if(cmd_code == CMDCODE_CONFIG_NODE_SLOT_AFFINITY){
+                if(enable_or_disable == CONFIG_DISABLE)
+                    edge->affinity &= ~(1U << bit_no);
+                else
+                    edge->affinity |= (1U << bit_no);
+            }
+            else{
+                edge->te_metric = (enable_or_disable == CONFIG_DISABLE) ? 0 : te_metric;
+            }
+            /*Link attributes matter to flex algos only*/
+            flex_algo_recompute_all(instance);
+            break;
+        case CMDCODE_CONFIG_NODE_SLOT_BANDWIDTH:
+            edge_end = get_interface_from_intf_name(node, slot_name);
+            if(!edge_end){
+                printf("Error : node %s, Interface %s not found\n", node->node_name, slot_name);
+                return 0;
+            }
+            edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+            /*Existing reservations are retained, run rsvp re-optimization
+             * to move LSPs off the links which no longer have the capacity*/
+            edge->bandwidth = (enable_or_disable == CONFIG_DISABLE) ?
+                DEFAULT_LINK_BW : (float)bw_mbps / 1000;
+            break;
         default:
             printf("%s() : Error : No Handler for command code : %d\n", __FUNCTION__, cmd_code);
             break;
@@ -225,6 +318,7 @@ show_route_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disabl
     node_t *node = NULL;
     char *prefix = NULL;
     char mask = 0;
+    unsigned char algo = 0;
     int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
 
     TLV_LOOP_BEGIN(tlv_buf, tlv){
@@ -234,6 +328,8 @@ show_route_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disabl
              prefix = tlv->value;
         else if(strncmp(tlv->leaf_id, "mask", strlen("mask")) ==0)
              mask = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "algo-no", strlen("algo-no")) ==0)
+             algo = atoi(tlv->value);
     } TLV_LOOP_END;
 
     node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
@@ -250,6 +346,21 @@ show_route_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disabl
         case CMDCODE_SHOW_NODE_INET3_FORWARDING_TABLE:
             inet_3_display(node->spf_info.rib[INET_3], prefix, mask);
             break;
+        case CMDCODE_SHOW_NODE_RIB_CHANGELOG:
+            show_rib_clog(node);
+            break;
+        case CMDCODE_SHOW_NODE_NH_GROUPS:
+            show_nh_groups(node);
+            break;
+        case CMDCODE_SHOW_NODE_LEAK_POLICY:
+            show_leak_policy(node);
+            break;
+        case CMDCODE_SHOW_NODE_FLEX_ALGO:
+            show_flex_algo(node, algo);
+            break;
+        case CMDCODE_SHOW_NODE_FIB_MEMORY:
+            show_fib_memory(node);
+            break;
         default:
             assert(0); 
     }
@@ -403,11 +514,20 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
     node_t *node = NULL;
     tlv_struct_t *tlv = NULL;
     unsigned int i = 0,
-                 metric = 0;
+                 metric = 0,
+                 seq_no = 0,
+                 upto_mask = 0,
+                 max_metric = LEAK_POLICY_ANY_METRIC,
+                 bit_no = 0,
+                 sid_index = 0;
+    unsigned char algo = 0;
+    flex_algo_def_t *fad = NULL;
     char *node_name = NULL,
          *intf_name = NULL,
          *lsp_name = NULL,
-         *tail_end_ip = NULL;
+         *tail_end_ip = NULL,
+         *file_name = NULL,
+         *metric_type = NULL;
 
     LEVEL level         = MAX_LEVEL,
           from_level_no = MAX_LEVEL,
@@ -440,6 +560,22 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
             metric = atoi(tlv->value);
         else if(strncmp(tlv->leaf_id, "tail-end-ip", strlen("tail-end-ip")) ==0)
             tail_end_ip = tlv->value;
+        else if(strncmp(tlv->leaf_id, "file-name", strlen("file-name")) ==0)
+            file_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "seq-no", strlen("seq-no")) ==0)
+            seq_no = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "upto-mask", strlen("upto-mask")) ==0)
+            upto_mask = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "max-metric", strlen("max-metric")) ==0)
+            max_metric = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "algo-no", strlen("algo-no")) ==0)
+            algo = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "bit-no", strlen("bit-no")) ==0)
+            bit_no = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "metric-type", strlen("metric-type")) ==0)
+            metric_type = tlv->value;
+        else if(strncmp(tlv->leaf_id, "sid-index", strlen("sid-index")) ==0)
+            sid_index = atoi(tlv->value);
         else
             assert(0);
     } TLV_LOOP_END;
@@ -563,14 +699,17 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
                     assert(list_prefix);
 
                     list_prefix->metric = prefix->metric;
+                    prefix_store_reorder(GET_NODE_PREFIX_STORE(node, level), list_prefix);
 
                     /*Update if the prefix is leaked across levels*/
                     LEVEL other_level = (level == LEVEL1) ? LEVEL2 : LEVEL1;
 
                     prefix_t *leaked_prefix = node_local_prefix_search(node, other_level, prefix->prefix, prefix->mask);
 
-                    if(leaked_prefix)
+                    if(leaked_prefix){
                         leaked_prefix->metric = list_prefix->metric;
+                        prefix_store_reorder(GET_NODE_PREFIX_STORE(node, other_level), leaked_prefix);
+                    }
                         
                     tlv128_ip_reach_t ad_msg;
                     memset(&ad_msg, 0, sizeof(tlv128_ip_reach_t));
@@ -663,6 +802,103 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
             generate_lsp(instance, node, lsp_distribution_routine, &dist_info_hdr);
         }
             break;     
+        case CMDCODE_CONFIG_NODE_IMPORT_PREFIXES:
+        {
+            prefix_import_stats_t stats;
+            if(enable_or_disable == CONFIG_DISABLE){
+                printf("Error : Bulk withdrawl of imported prefixes is not supported\n");
+                return 0;
+            }
+            import_prefixes_from_file(node, level, file_name, &stats);
+            print_prefix_import_stats(node, level, &stats);
+        }
+            break;
+        case CMDCODE_CONFIG_NODE_LEAK_POLICY:
+            if(enable_or_disable != CONFIG_DISABLE){
+                printf("Error : Incomplete leak policy rule\n");
+                return 0;
+            }
+            leak_policy_delete_rule(node, level, seq_no);
+            break;
+        case CMDCODE_CONFIG_NODE_LEAK_POLICY_PERMIT:
+        case CMDCODE_CONFIG_NODE_LEAK_POLICY_DENY:
+        {
+            if(enable_or_disable == CONFIG_DISABLE){
+                leak_policy_delete_rule(node, level, seq_no);
+                return 0;
+            }
+            if(upto_mask < mask){
+                printf("Error : upto mask %u is shorter than prefix mask %d\n", upto_mask, mask);
+                return 0;
+            }
+            leak_policy_rule_t rule;
+            memset(&rule, 0, sizeof(leak_policy_rule_t));
+            rule.seq_no = seq_no;
+            strncpy(rule.prefix, prefix, PREFIX_LEN);
+            rule.mask = mask;
+            rule.le = upto_mask;
+            rule.metric_max = max_metric;
+            rule.action = (cmd_code == CMDCODE_CONFIG_NODE_LEAK_POLICY_PERMIT) ?
+                            LEAK_POLICY_PERMIT : LEAK_POLICY_DENY;
+            leak_policy_add_rule(node, level, &rule);
+        }
+            break;
+        case CMDCODE_CONFIG_NODE_FLEX_ALGO:
+            if(enable_or_disable == CONFIG_DISABLE)
+                flex_algo_delete_def(node, algo);
+            else
+                flex_algo_add_def(node, algo);
+            flex_algo_recompute_all(instance);
+            break;
+        case CMDCODE_CONFIG_NODE_FLEX_ALGO_METRIC_TYPE:
+        case CMDCODE_CONFIG_NODE_FLEX_ALGO_EXCLUDE_ANY:
+        case CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ANY:
+        case CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ALL:
+        case CMDCODE_CONFIG_NODE_FLEX_ALGO_NODE_SID:
+        {
+            unsigned int *affinity = NULL;
+            if(enable_or_disable == CONFIG_DISABLE){
+                fad = flex_algo_get_def(node, algo);
+                if(!fad){
+                    printf("Error : node %s do not participate in flex algo %u\n", node->node_name, algo);
+                    return 0;
+                }
+            }
+            /*Configuring any attribute of algorithm enables participation*/
+            else if(!(fad = flex_algo_add_def(node, algo)))
+                return 0;
+
+            switch(cmd_code){
+                case CMDCODE_CONFIG_NODE_FLEX_ALGO_METRIC_TYPE:
+                    fad->metric_type = (enable_or_disable == CONFIG_ENABLE &&
+                            strcmp(metric_type, "te") == 0) ?
+                            FLEX_ALGO_METRIC_TE : FLEX_ALGO_METRIC_IGP;
+                    break;
+                case CMDCODE_CONFIG_NODE_FLEX_ALGO_NODE_SID:
+                    if(enable_or_disable == CONFIG_DISABLE){
+                        fad->node_sid_set = FALSE;
+                        memset(&fad->node_sid, 0, sizeof(prefix_sid_subtlv_t));
+                        break;
+                    }
+                    fad->node_sid_set = TRUE;
+                    fad->node_sid.type = PREFIX_SID_SUBTLV_TYPE;
+                    fad->node_sid.algorithm = algo;
+                    fad->node_sid.flags = 0;
+                    SET_BIT(fad->node_sid.flags, NODE_SID_N_FLAG);
+                    fad->node_sid.sid.sid = sid_index;
+                    break;
+                default:
+                    affinity = (cmd_code == CMDCODE_CONFIG_NODE_FLEX_ALGO_EXCLUDE_ANY) ? &fad->exclude_any :
+                               (cmd_code == CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ANY) ? &fad->include_any :
+                               &fad->include_all;
+                    if(enable_or_disable == CONFIG_DISABLE)
+                        *affinity &= ~(1U << bit_no);
+                    else
+                        *affinity |= (1U << bit_no);
+            }
+            flex_algo_recompute_all(instance);
+        }
+            break;
         case CMDCODE_CONFIG_NODE_LEAK_PREFIX:
         {
             prefix_t *leaked_prefix = NULL;
@@ -771,8 +1007,8 @@ config_static_route_handler(param_t *param,
 
             un_nxthop = inet_0_unifiy_nexthop(&nexthop, IGP_PROTO);
             rc = inet_0_rt_un_route_install_nexthop(inet_0_rib, &inet_key, level, un_nxthop);
+            free_un_nexthop(un_nxthop);
             if(!rc){
-                free_un_nexthop(un_nxthop);
                 printf("Error : Route installation failed\n");
                 return -1;
             }
@@ -1111,6 +1347,97 @@ spf_init_dcm(){
             libcli_register_param(&instance, &sync);
             set_param_cmd_code(&sync, CMDCODE_RUN_INSTANCE_SYNC);
         }
+
+        /*run instance rsvp cspf [bandwidth-order]*/
+        {
+            static param_t rsvp;
+            init_param(&rsvp, CMD, "rsvp", 0, 0, INVALID, 0, "RSVP-TE LSPs of entire Network graph");
+            libcli_register_param(&instance, &rsvp);
+            {
+                static param_t cspf;
+                init_param(&cspf, CMD, "cspf", run_instance_rsvp_handler, 0, INVALID, 0, "Place all LSPs afresh in order of configuration");
+                libcli_register_param(&rsvp, &cspf);
+                set_param_cmd_code(&cspf, CMDCODE_RUN_INSTANCE_RSVP_CSPF);
+                {
+                    static param_t bw_order;
+                    init_param(&bw_order, CMD, "bandwidth-order", run_instance_rsvp_handler, 0, INVALID, 0, "Place all LSPs afresh, largest first");
+                    libcli_register_param(&cspf, &bw_order);
+                    set_param_cmd_code(&bw_order, CMDCODE_RUN_INSTANCE_RSVP_CSPF_BW_ORDER);
+                }
+            }
+            /*run instance rsvp reoptimize*/
+            {
+                static param_t reoptimize;
+                init_param(&reoptimize, CMD, "reoptimize", run_instance_rsvp_handler, 0, INVALID, 0, "Re-place broken LSPs, move LSPs to better paths");
+                libcli_register_param(&rsvp, &reoptimize);
+                set_param_cmd_code(&reoptimize, CMDCODE_RUN_INSTANCE_RSVP_REOPTIMIZE);
+            }
+        }
+
+        /*run instance forwarding-simulation [detail|load-distribution]*/
+        {
+            static param_t fwd_sim;
+            init_param(&fwd_sim, CMD, "forwarding-simulation", run_instance_fwd_sim_handler, 0, INVALID, 0, "Forward packets between all pairs of routers, show reachability matrix");
+            libcli_register_param(&instance, &fwd_sim);
+            set_param_cmd_code(&fwd_sim, CMDCODE_RUN_INSTANCE_FWD_SIM);
+            {
+                static param_t detail;
+                init_param(&detail, CMD, "detail", run_instance_fwd_sim_handler, 0, INVALID, 0, "Outcome, hops and path hash of every pair");
+                libcli_register_param(&fwd_sim, &detail);
+                set_param_cmd_code(&detail, CMDCODE_RUN_INSTANCE_FWD_SIM_DETAIL);
+            }
+            {
+                static param_t load_distribution;
+                init_param(&load_distribution, CMD, "load-distribution", run_instance_fwd_sim_handler, 0, INVALID, 0, "Share of traffic of every path of pairs sprayed over UCMP/ECMP nexthops");
+                libcli_register_param(&fwd_sim, &load_distribution);
+                set_param_cmd_code(&load_distribution, CMDCODE_RUN_INSTANCE_FWD_SIM_LOAD);
+            }
+        }
+
+        /*run instance fib-check*/
+        {
+            static param_t fib_check;
+            init_param(&fib_check, CMD, "fib-check", run_instance_fib_check_handler, 0, INVALID, 0, "Check RIBs of all routers for forwarding loops and dead ends");
+            libcli_register_param(&instance, &fib_check);
+            set_param_cmd_code(&fib_check, CMDCODE_RUN_INSTANCE_FIB_CHECK);
+        }
+
+        /*run instance fib-export <file-name>*/
+        {
+            static param_t fib_export;
+            init_param(&fib_export, CMD, "fib-export", 0, 0, INVALID, 0, "Export FIBs of all routers in compact binary format");
+            libcli_register_param(&instance, &fib_export);
+            {
+                static param_t file_name;
+                init_param(&file_name, LEAF, 0, run_instance_fib_export_handler, 0, STRING, "file-name", "file to write");
+                libcli_register_param(&fib_export, &file_name);
+                set_param_cmd_code(&file_name, CMDCODE_RUN_INSTANCE_FIB_EXPORT);
+            }
+        }
+
+        /*run instance frr-simulation <node-name> <slot-no> [detail]*/
+        {
+            static param_t frr_sim;
+            init_param(&frr_sim, CMD, "frr-simulation", 0, 0, INVALID, 0, "Forward all pairs of routers over backups on link failure, without SPF run");
+            libcli_register_param(&instance, &frr_sim);
+            {
+                static param_t node_name;
+                init_param(&node_name, LEAF, 0, 0, validate_node_extistence, STRING, "node-name", "Node Name");
+                libcli_register_param(&frr_sim, &node_name);
+                {
+                    static param_t slot_no;
+                    init_param(&slot_no, LEAF, 0, run_instance_frr_sim_handler, 0, STRING, "slot-no", "interface name ethx/y format");
+                    libcli_register_param(&node_name, &slot_no);
+                    set_param_cmd_code(&slot_no, CMDCODE_RUN_INSTANCE_FRR_SIM);
+                    {
+                        static param_t detail;
+                        init_param(&detail, CMD, "detail", run_instance_frr_sim_handler, 0, INVALID, 0, "Outcome and hops of every affected pair");
+                        libcli_register_param(&slot_no, &detail);
+                        set_param_cmd_code(&detail, CMDCODE_RUN_INSTANCE_FRR_SIM_DETAIL);
+                    }
+                }
+            }
+        }
     }
 
     /*Show commands*/
@@ -1207,6 +1534,55 @@ spf_init_dcm(){
         }
     }
 
+    /*show instance node <node-name> source-packet-routing*/
+    {
+        static param_t spring;
+        init_param(&spring, CMD, "source-packet-routing", 0, 0, INVALID, 0, "Segment Routing");
+        libcli_register_param(&instance_node_name, &spring);
+        {
+            /*show instance node <node-name> source-packet-routing mapping-server prefix-sid-map*/
+            static param_t mapping_server;
+            init_param(&mapping_server, CMD, "mapping-server", 0, 0, INVALID, 0, "Mapping Server");
+            libcli_register_param(&spring, &mapping_server);
+            {
+                static param_t prefix_sid_map;
+                init_param(&prefix_sid_map, CMD, "prefix-sid-map", instance_node_spring_show_handler, 0, INVALID, 0, "Mapping Server local policies");
+                libcli_register_param(&mapping_server, &prefix_sid_map);
+                set_param_cmd_code(&prefix_sid_map, CMDCODE_SHOW_NODE_SRMS_LCL_POLICY);
+            }
+        }
+        {
+            static param_t prefix_sid_map;
+            init_param(&prefix_sid_map, CMD, "prefix-sid-map", 0, 0, INVALID, 0, "Mapping Client");
+            libcli_register_param(&spring, &prefix_sid_map);
+            {
+                /*show instance node <node-name> source-packet-routing prefix-sid-map active-policy [<prefix> <mask>]*/
+                static param_t active_policy;
+                init_param(&active_policy, CMD, "active-policy", instance_node_spring_show_handler, 0, INVALID, 0, "Active mapping ranges");
+                libcli_register_param(&prefix_sid_map, &active_policy);
+                set_param_cmd_code(&active_policy, CMDCODE_SHOW_NODE_SRMS_CLIENT_ACTIVE_POLICY);
+                {
+                    static param_t prefix;
+                    init_param(&prefix, LEAF, 0, 0, 0, IPV4, "prefix", "Ipv4 prefix without mask");
+                    libcli_register_param(&active_policy, &prefix);
+                    {
+                        static param_t mask;
+                        init_param(&mask, LEAF, 0, instance_node_spring_show_handler, validate_ipv4_mask, INT, "mask", "mask (0-32)");
+                        libcli_register_param(&prefix, &mask);
+                        set_param_cmd_code(&mask, CMDCODE_SHOW_NODE_SRMS_CLIENT_ACTIVE_POLICY);
+                    }
+                }
+            }
+            {
+                /*show instance node <node-name> source-packet-routing prefix-sid-map backup-policy*/
+                static param_t backup_policy;
+                init_param(&backup_policy, CMD, "backup-policy", instance_node_spring_show_handler, 0, INVALID, 0, "Backup mapping ranges");
+                libcli_register_param(&prefix_sid_map, &backup_policy);
+                set_param_cmd_code(&backup_policy, CMDCODE_SHOW_NODE_SRMS_CLIENT_BACKUP_POLICY);
+            }
+        }
+    }
+
     /*show instance node <node-name> mpls forwarding-table*/
     {
         static param_t mpls;
@@ -1239,6 +1615,12 @@ spf_init_dcm(){
                     libcli_register_param(&rsvp, &bindings);
                     set_param_cmd_code(&bindings, CMDCODE_SHOW_NODE_MPLS_RSVP_BINDINGS);
                 }
+                {
+                    static param_t te_links;
+                    init_param(&te_links, CMD, "te-links", instance_node_spring_show_handler, 0, INVALID, 0, "Show TE attributes and reservations of links");
+                    libcli_register_param(&rsvp, &te_links);
+                    set_param_cmd_code(&te_links, CMDCODE_SHOW_NODE_MPLS_RSVP_TE_LINKS);
+                }
             }
         }
     }
@@ -1269,6 +1651,52 @@ spf_init_dcm(){
         }
     }
 
+    /*show instance node <node-name> rib-changelog*/
+    {
+        static param_t rib_changelog;
+        init_param(&rib_changelog, CMD, "rib-changelog", show_route_handler, 0, INVALID, 0, "Drain and show RIB change log");
+        libcli_register_param(&instance_node_name, &rib_changelog);
+        set_param_cmd_code(&rib_changelog, CMDCODE_SHOW_NODE_RIB_CHANGELOG);
+    }
+
+    /*show instance node <node-name> fib-memory*/
+    {
+        static param_t fib_memory;
+        init_param(&fib_memory, CMD, "fib-memory", show_route_handler, 0, INVALID, 0, "Show memory consumed by RIBs");
+        libcli_register_param(&instance_node_name, &fib_memory);
+        set_param_cmd_code(&fib_memory, CMDCODE_SHOW_NODE_FIB_MEMORY);
+    }
+
+    /*show instance node <node-name> nh-groups*/
+    {
+        static param_t nh_groups;
+        init_param(&nh_groups, CMD, "nh-groups", show_route_handler, 0, INVALID, 0, "Show shared nexthop groups");
+        libcli_register_param(&instance_node_name, &nh_groups);
+        set_param_cmd_code(&nh_groups, CMDCODE_SHOW_NODE_NH_GROUPS);
+    }
+
+    {
+        /*show instance node <node-name> leak-policy*/
+        static param_t leak_policy;
+        init_param(&leak_policy, CMD, "leak-policy", show_route_handler, 0, INVALID, 0, "Show route leaking policies");
+        libcli_register_param(&instance_node_name, &leak_policy);
+        set_param_cmd_code(&leak_policy, CMDCODE_SHOW_NODE_LEAK_POLICY);
+    }
+
+    {
+        /*show instance node <node-name> flex-algo [<algo-no>]*/
+        static param_t flex_algo;
+        init_param(&flex_algo, CMD, "flex-algo", show_route_handler, 0, INVALID, 0, "Show flex algo definitions and routes");
+        libcli_register_param(&instance_node_name, &flex_algo);
+        set_param_cmd_code(&flex_algo, CMDCODE_SHOW_NODE_FLEX_ALGO);
+        {
+            static param_t algo_no;
+            init_param(&algo_no, LEAF, 0, show_route_handler, validate_flex_algo_no, INT, "algo-no", "flex algo (128-255)");
+            libcli_register_param(&flex_algo, &algo_no);
+            set_param_cmd_code(&algo_no, CMDCODE_SHOW_NODE_FLEX_ALGO);
+        }
+    }
+
     /*show instance node <node-name> level <level-no>*/ 
     static param_t instance_node_name_level;
     init_param(&instance_node_name_level, CMD, "level", 0, 0, INVALID, 0, "level");
@@ -1498,6 +1926,42 @@ spf_init_dcm(){
                        init_param(&rsvp_lsp_name, LEAF, 0, instance_node_rsvp_config_handler, 0, STRING, "rsvp-lsp-name", "RSVP LSP name");
                        libcli_register_param(&router_id, &rsvp_lsp_name);
                        set_param_cmd_code(&rsvp_lsp_name, CMDCODE_CONFIG_NODE_RSVP_TUNNEL);
+                       {
+                           /*config node <node-name> [no] rsvp tunnel <router-id> <rsvp-lsp-name> bandwidth <bw-mbps>*/
+                           static param_t bandwidth;
+                           init_param(&bandwidth, CMD, "bandwidth", 0, 0, INVALID, 0, "LSP bandwidth");
+                           libcli_register_param(&rsvp_lsp_name, &bandwidth);
+                           {
+                               static param_t bw_mbps;
+                               init_param(&bw_mbps, LEAF, 0, instance_node_rsvp_config_handler, validate_bandwidth_mbps, INT, "bw-mbps", "bandwidth in Mbps");
+                               libcli_register_param(&bandwidth, &bw_mbps);
+                               set_param_cmd_code(&bw_mbps, CMDCODE_CONFIG_NODE_RSVP_TUNNEL_BANDWIDTH);
+                           }
+                       }
+                       {
+                           /*config node <node-name> [no] rsvp tunnel <router-id> <rsvp-lsp-name> exclude-any <bit-no>*/
+                           static param_t exclude_any;
+                           init_param(&exclude_any, CMD, "exclude-any", 0, 0, INVALID, 0, "Avoid links having the affinity");
+                           libcli_register_param(&rsvp_lsp_name, &exclude_any);
+                           {
+                               static param_t bit_no;
+                               init_param(&bit_no, LEAF, 0, instance_node_rsvp_config_handler, validate_affinity_bit_no, INT, "bit-no", "affinity bit (0-31)");
+                               libcli_register_param(&exclude_any, &bit_no);
+                               set_param_cmd_code(&bit_no, CMDCODE_CONFIG_NODE_RSVP_TUNNEL_EXCLUDE_ANY);
+                           }
+                       }
+                       {
+                           /*config node <node-name> [no] rsvp tunnel <router-id> <rsvp-lsp-name> include-any <bit-no>*/
+                           static param_t include_any;
+                           init_param(&include_any, CMD, "include-any", 0, 0, INVALID, 0, "Use only links having any of the affinities");
+                           libcli_register_param(&rsvp_lsp_name, &include_any);
+                           {
+                               static param_t bit_no;
+                               init_param(&bit_no, LEAF, 0, instance_node_rsvp_config_handler, validate_affinity_bit_no, INT, "bit-no", "affinity bit (0-31)");
+                               libcli_register_param(&include_any, &bit_no);
+                               set_param_cmd_code(&bit_no, CMDCODE_CONFIG_NODE_RSVP_TUNNEL_INCLUDE_ANY);
+                           }
+                       }
                     }
                 }
             }
@@ -1575,6 +2039,62 @@ spf_init_dcm(){
                     set_param_cmd_code(&start_label, CMDCODE_CONFIG_NODE_SR_SRGB_START_LABEL);
                 }
             }
+            {
+                /*config node <node-name> source-packet-routing mapping-server <prefix> <mask> <first-sid-index> range <range>*/
+                static param_t mapping_server;
+                init_param(&mapping_server, CMD, "mapping-server", 0, 0, INVALID, 0, "Configure Mapping Server local policy");
+                libcli_register_param(&spring, &mapping_server);
+                {
+                    static param_t prefix;
+                    init_param(&prefix, LEAF, 0, 0, 0, IPV4, "prefix", "First Ipv4 prefix of the range without mask");
+                    libcli_register_param(&mapping_server, &prefix);
+                    {
+                        static param_t mask;
+                        init_param(&mask, LEAF, 0, 0, validate_ipv4_mask, INT, "mask", "mask (0-32)");
+                        libcli_register_param(&prefix, &mask);
+                        {
+                            static param_t first_sid_index;
+                            init_param(&first_sid_index, LEAF, 0, 0, 0, INT, "first-sid-index", "SID index mapped to first prefix");
+                            libcli_register_param(&mask, &first_sid_index);
+                            {
+                                static param_t range;
+                                init_param(&range, CMD, "range", 0, 0, INVALID, 0, "No of prefixes in the range");
+                                libcli_register_param(&first_sid_index, &range);
+                                {
+                                    static param_t range_val;
+                                    init_param(&range_val, LEAF, 0, instance_node_spring_config_handler, 0, INT, "range", "No of prefixes in the range");
+                                    libcli_register_param(&range, &range_val);
+                                    set_param_cmd_code(&range_val, CMDCODE_CONFIG_NODE_SRMS_LCL_POLICY);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            {
+                static param_t prefix_sid_map;
+                init_param(&prefix_sid_map, CMD, "prefix-sid-map", 0, 0, INVALID, 0, "Mapping Server / Client");
+                libcli_register_param(&spring, &prefix_sid_map);
+                {
+                    /*config node <node-name> source-packet-routing prefix-sid-map advertise-local*/
+                    static param_t advertise_local;
+                    init_param(&advertise_local, CMD, "advertise-local", instance_node_spring_config_handler, 0, INVALID, 0, "Advertise Mapping Server local policies");
+                    libcli_register_param(&prefix_sid_map, &advertise_local);
+                    set_param_cmd_code(&advertise_local, CMDCODE_CONFIG_NODE_SRMS);
+                }
+                {
+                    /*config node <node-name> source-packet-routing prefix-sid-map receive disable*/
+                    static param_t receive;
+                    init_param(&receive, CMD, "receive", 0, 0, INVALID, 0, "Mapping Client");
+                    libcli_register_param(&prefix_sid_map, &receive);
+                    {
+                        static param_t disable;
+                        init_param(&disable, CMD, "disable", instance_node_spring_config_handler, 0, INVALID, 0, "Ignore ranges advertised by Mapping Servers");
+                        libcli_register_param(&receive, &disable);
+                        set_param_cmd_code(&disable, CMDCODE_CONFIG_NODE_SRMS_CLIENT_DISABLE);
+                    }
+                }
+            }
         }
 
         static param_t config_node_node_name_slot;
@@ -1739,6 +2259,53 @@ spf_init_dcm(){
             libcli_register_param(&config_node_node_name_slot_slotname, &no_eligible_backup);
             set_param_cmd_code(&no_eligible_backup, CMDCODE_CONFIG_INTF_NO_ELIGIBLE_BACKUP);
         }
+
+        /*config node <node-name> [no] interface <slot-no> affinity <bit-no>*/
+        {
+            static param_t affinity;
+            init_param(&affinity, CMD, "affinity", 0, 0, INVALID, 0, "admin group of the link");
+            libcli_register_param(&config_node_node_name_slot_slotname, &affinity);
+            {
+                static param_t bit_no;
+                init_param(&bit_no, LEAF, 0, node_slot_config_handler, validate_affinity_bit_no, INT, "bit-no", "affinity bit (0-31)");
+                libcli_register_param(&affinity, &bit_no);
+                set_param_cmd_code(&bit_no, CMDCODE_CONFIG_NODE_SLOT_AFFINITY);
+            }
+        }
+
+        /*config node <node-name> [no] interface <slot-no> te-metric <te-metric>*/
+        {
+            static param_t te_metric;
+            init_param(&te_metric, CMD, "te-metric", 0, 0, INVALID, 0, "TE metric of the link");
+            libcli_register_param(&config_node_node_name_slot_slotname, &te_metric);
+            {
+                static param_t te_metric_val;
+                init_param(&te_metric_val, LEAF, 0, node_slot_config_handler, validate_metric_value, INT, "te-metric", "TE metric value");
+                libcli_register_param(&te_metric, &te_metric_val);
+                set_param_cmd_code(&te_metric_val, CMDCODE_CONFIG_NODE_SLOT_TE_METRIC);
+            }
+        }
+
+        /*config node <node-name> [no] interface <slot-no> bandwidth <bw-mbps>*/
+        {
+            static param_t bandwidth;
+            init_param(&bandwidth, CMD, "bandwidth", 0, 0, INVALID, 0, "TE bandwidth of the link");
+            libcli_register_param(&config_node_node_name_slot_slotname, &bandwidth);
+            {
+                static param_t bw_mbps;
+                init_param(&bw_mbps, LEAF, 0, node_slot_config_handler, validate_bandwidth_mbps, INT, "bw-mbps", "bandwidth in Mbps");
+                libcli_register_param(&bandwidth, &bw_mbps);
+                set_param_cmd_code(&bw_mbps, CMDCODE_CONFIG_NODE_SLOT_BANDWIDTH);
+            }
+        }
+
+        /*config node <node-name> [no] interface <slot-no> pic-failover*/
+        {
+            static param_t pic_failover;
+            init_param(&pic_failover, CMD, "pic-failover", lfa_rlfa_config_handler, 0, INVALID, 0, "Simulate local link failure, promote backups in nexthop groups");
+            libcli_register_param(&config_node_node_name_slot_slotname, &pic_failover);
+            set_param_cmd_code(&pic_failover, CMDCODE_CONFIG_INTF_PIC_FAILOVER);
+        }
        
         { 
             static param_t config_node_node_name_slot_slotname_enable;
@@ -1812,6 +2379,171 @@ spf_init_dcm(){
                     &config_node_node_name_add_prefix_prefix_mask_level_level);
     set_param_cmd_code(&config_node_node_name_add_prefix_prefix_mask_level_level, CMDCODE_CONFIG_NODE_EXPORT_PREFIX);
     
+    /*config node <node name> import prefixes <file-name> level <level no>*/
+    static param_t config_node_node_name_import;
+    init_param(&config_node_node_name_import, CMD, "import", 0, 0, INVALID, 0, "bulk import");
+    libcli_register_param(&config_node_node_name, &config_node_node_name_import);
+
+    static param_t config_node_node_name_import_prefixes;
+    init_param(&config_node_node_name_import_prefixes, CMD, "prefixes", 0, 0, INVALID, 0, "redistribute external prefixes from file");
+    libcli_register_param(&config_node_node_name_import, &config_node_node_name_import_prefixes);
+
+    static param_t config_node_node_name_import_prefixes_file;
+    init_param(&config_node_node_name_import_prefixes_file, LEAF, 0, 0, 0, STRING, "file-name", "file with one <prefix>/<mask> [metric] per line");
+    libcli_register_param(&config_node_node_name_import_prefixes, &config_node_node_name_import_prefixes_file);
+
+    static param_t config_node_node_name_import_prefixes_file_level;
+    init_param(&config_node_node_name_import_prefixes_file_level, CMD, "level", 0, 0, INVALID, 0, "level");
+    libcli_register_param(&config_node_node_name_import_prefixes_file, &config_node_node_name_import_prefixes_file_level);
+
+    static param_t config_node_node_name_import_prefixes_file_level_level;
+    init_param(&config_node_node_name_import_prefixes_file_level_level, LEAF, 0, 
+                    instance_node_config_handler, validate_level_no, INT, "level-no", "level : 1 | 2");
+    libcli_register_param(&config_node_node_name_import_prefixes_file_level,
+                    &config_node_node_name_import_prefixes_file_level_level);
+    set_param_cmd_code(&config_node_node_name_import_prefixes_file_level_level, CMDCODE_CONFIG_NODE_IMPORT_PREFIXES);
+
+    /*config node <node name> [no] leak-policy level <level no> seq <seq-no> 
+     * prefix <prefix> <mask> upto <upto-mask> [metric <max-metric>] permit|deny*/
+    static param_t config_node_node_name_leak_policy;
+    init_param(&config_node_node_name_leak_policy, CMD, "leak-policy", 0, 0, INVALID, 0, "route leaking policy of L1L2 router");
+    libcli_register_param(&config_node_node_name, &config_node_node_name_leak_policy);
+
+    static param_t config_node_node_name_leak_policy_level;
+    init_param(&config_node_node_name_leak_policy_level, CMD, "level", 0, 0, INVALID, 0, "level");
+    libcli_register_param(&config_node_node_name_leak_policy, &config_node_node_name_leak_policy_level);
+
+    static param_t config_node_node_name_leak_policy_level_level;
+    init_param(&config_node_node_name_leak_policy_level_level, LEAF, 0, 0, validate_level_no, INT, "level-no", "level routes are leaked from : 1 | 2");
+    libcli_register_param(&config_node_node_name_leak_policy_level, &config_node_node_name_leak_policy_level_level);
+
+    static param_t config_node_node_name_leak_policy_level_level_seq;
+    init_param(&config_node_node_name_leak_policy_level_level_seq, CMD, "seq", 0, 0, INVALID, 0, "rule sequence no");
+    libcli_register_param(&config_node_node_name_leak_policy_level_level, &config_node_node_name_leak_policy_level_level_seq);
+
+    static param_t config_node_node_name_leak_policy_seq_no;
+    init_param(&config_node_node_name_leak_policy_seq_no, LEAF, 0, instance_node_config_handler, 0, INT, "seq-no", "rules are matched in increasing seq no");
+    libcli_register_param(&config_node_node_name_leak_policy_level_level_seq, &config_node_node_name_leak_policy_seq_no);
+    set_param_cmd_code(&config_node_node_name_leak_policy_seq_no, CMDCODE_CONFIG_NODE_LEAK_POLICY);
+
+    static param_t config_node_node_name_leak_policy_prefix;
+    init_param(&config_node_node_name_leak_policy_prefix, CMD, "prefix", 0, 0, INVALID, 0, "prefix");
+    libcli_register_param(&config_node_node_name_leak_policy_seq_no, &config_node_node_name_leak_policy_prefix);
+
+    static param_t config_node_node_name_leak_policy_prefix_prefix;
+    init_param(&config_node_node_name_leak_policy_prefix_prefix, LEAF, 0, 0, 0, IPV4, "prefix", "Ipv4 prefix without mask");
+    libcli_register_param(&config_node_node_name_leak_policy_prefix, &config_node_node_name_leak_policy_prefix_prefix);
+
+    static param_t config_node_node_name_leak_policy_prefix_prefix_mask;
+    init_param(&config_node_node_name_leak_policy_prefix_prefix_mask, LEAF, 0, 0, validate_ipv4_mask, INT, "mask", "mask (0-32)");
+    libcli_register_param(&config_node_node_name_leak_policy_prefix_prefix, &config_node_node_name_leak_policy_prefix_prefix_mask);
+
+    static param_t config_node_node_name_leak_policy_upto;
+    init_param(&config_node_node_name_leak_policy_upto, CMD, "upto", 0, 0, INVALID, 0, "match routes of mask upto");
+    libcli_register_param(&config_node_node_name_leak_policy_prefix_prefix_mask, &config_node_node_name_leak_policy_upto);
+
+    static param_t config_node_node_name_leak_policy_upto_mask;
+    init_param(&config_node_node_name_leak_policy_upto_mask, LEAF, 0, 0, validate_ipv4_mask, INT, "upto-mask", "mask (0-32)");
+    libcli_register_param(&config_node_node_name_leak_policy_upto, &config_node_node_name_leak_policy_upto_mask);
+
+    static param_t config_node_node_name_leak_policy_upto_mask_permit;
+    init_param(&config_node_node_name_leak_policy_upto_mask_permit, CMD, "permit", instance_node_config_handler, 0, INVALID, 0, "leak matching routes");
+    libcli_register_param(&config_node_node_name_leak_policy_upto_mask, &config_node_node_name_leak_policy_upto_mask_permit);
+    set_param_cmd_code(&config_node_node_name_leak_policy_upto_mask_permit, CMDCODE_CONFIG_NODE_LEAK_POLICY_PERMIT);
+
+    static param_t config_node_node_name_leak_policy_upto_mask_deny;
+    init_param(&config_node_node_name_leak_policy_upto_mask_deny, CMD, "deny", instance_node_config_handler, 0, INVALID, 0, "do not leak matching routes");
+    libcli_register_param(&config_node_node_name_leak_policy_upto_mask, &config_node_node_name_leak_policy_upto_mask_deny);
+    set_param_cmd_code(&config_node_node_name_leak_policy_upto_mask_deny, CMDCODE_CONFIG_NODE_LEAK_POLICY_DENY);
+
+    static param_t config_node_node_name_leak_policy_metric;
+    init_param(&config_node_node_name_leak_policy_metric, CMD, "metric", 0, 0, INVALID, 0, "match routes of metric upto");
+    libcli_register_param(&config_node_node_name_leak_policy_upto_mask, &config_node_node_name_leak_policy_metric);
+
+    static param_t config_node_node_name_leak_policy_metric_max;
+    init_param(&config_node_node_name_leak_policy_metric_max, LEAF, 0, 0, validate_metric_value, INT, "max-metric", "metric value");
+    libcli_register_param(&config_node_node_name_leak_policy_metric, &config_node_node_name_leak_policy_metric_max);
+
+    static param_t config_node_node_name_leak_policy_metric_max_permit;
+    init_param(&config_node_node_name_leak_policy_metric_max_permit, CMD, "permit", instance_node_config_handler, 0, INVALID, 0, "leak matching routes");
+    libcli_register_param(&config_node_node_name_leak_policy_metric_max, &config_node_node_name_leak_policy_metric_max_permit);
+    set_param_cmd_code(&config_node_node_name_leak_policy_metric_max_permit, CMDCODE_CONFIG_NODE_LEAK_POLICY_PERMIT);
+
+    static param_t config_node_node_name_leak_policy_metric_max_deny;
+    init_param(&config_node_node_name_leak_policy_metric_max_deny, CMD, "deny", instance_node_config_handler, 0, INVALID, 0, "do not leak matching routes");
+    libcli_register_param(&config_node_node_name_leak_policy_metric_max, &config_node_node_name_leak_policy_metric_max_deny);
+    set_param_cmd_code(&config_node_node_name_leak_policy_metric_max_deny, CMDCODE_CONFIG_NODE_LEAK_POLICY_DENY);
+
+    /*config node <node-name> [no] flex-algo <algo-no> 
+     * [metric-type <igp|te> | exclude-any <bit-no> | include-any <bit-no> | 
+     *  include-all <bit-no> | node-segment <sid-index>]*/
+    {
+        static param_t flex_algo;
+        init_param(&flex_algo, CMD, "flex-algo", 0, 0, INVALID, 0, "Flexible Algorithm");
+        libcli_register_param(&config_node_node_name, &flex_algo);
+        {
+            static param_t algo_no;
+            init_param(&algo_no, LEAF, 0, instance_node_config_handler, validate_flex_algo_no, INT, "algo-no", "flex algo (128-255)");
+            libcli_register_param(&flex_algo, &algo_no);
+            set_param_cmd_code(&algo_no, CMDCODE_CONFIG_NODE_FLEX_ALGO);
+            {
+                static param_t metric_type;
+                init_param(&metric_type, CMD, "metric-type", 0, 0, INVALID, 0, "metric type of algorithm");
+                libcli_register_param(&algo_no, &metric_type);
+                {
+                    static param_t metric_type_val;
+                    init_param(&metric_type_val, LEAF, 0, instance_node_config_handler, validate_flex_algo_metric_type, STRING, "metric-type", "igp | te");
+                    libcli_register_param(&metric_type, &metric_type_val);
+                    set_param_cmd_code(&metric_type_val, CMDCODE_CONFIG_NODE_FLEX_ALGO_METRIC_TYPE);
+                }
+            }
+            {
+                static param_t exclude_any;
+                init_param(&exclude_any, CMD, "exclude-any", 0, 0, INVALID, 0, "exclude links having affinity");
+                libcli_register_param(&algo_no, &exclude_any);
+                {
+                    static param_t bit_no;
+                    init_param(&bit_no, LEAF, 0, instance_node_config_handler, validate_affinity_bit_no, INT, "bit-no", "affinity bit (0-31)");
+                    libcli_register_param(&exclude_any, &bit_no);
+                    set_param_cmd_code(&bit_no, CMDCODE_CONFIG_NODE_FLEX_ALGO_EXCLUDE_ANY);
+                }
+            }
+            {
+                static param_t include_any;
+                init_param(&include_any, CMD, "include-any", 0, 0, INVALID, 0, "include links having any of affinities");
+                libcli_register_param(&algo_no, &include_any);
+                {
+                    static param_t bit_no;
+                    init_param(&bit_no, LEAF, 0, instance_node_config_handler, validate_affinity_bit_no, INT, "bit-no", "affinity bit (0-31)");
+                    libcli_register_param(&include_any, &bit_no);
+                    set_param_cmd_code(&bit_no, CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ANY);
+                }
+            }
+            {
+                static param_t include_all;
+                init_param(&include_all, CMD, "include-all", 0, 0, INVALID, 0, "include links having all of affinities");
+                libcli_register_param(&algo_no, &include_all);
+                {
+                    static param_t bit_no;
+                    init_param(&bit_no, LEAF, 0, instance_node_config_handler, validate_affinity_bit_no, INT, "bit-no", "affinity bit (0-31)");
+                    libcli_register_param(&include_all, &bit_no);
+                    set_param_cmd_code(&bit_no, CMDCODE_CONFIG_NODE_FLEX_ALGO_INCLUDE_ALL);
+                }
+            }
+            {
+                static param_t node_segment;
+                init_param(&node_segment, CMD, "node-segment", 0, 0, INVALID, 0, "node SID of router in algorithm");
+                libcli_register_param(&algo_no, &node_segment);
+                {
+                    static param_t sid_index;
+                    init_param(&sid_index, LEAF, 0, instance_node_config_handler, 0, INT, "sid-index", "SRGB index");
+                    libcli_register_param(&node_segment, &sid_index);
+                    set_param_cmd_code(&sid_index, CMDCODE_CONFIG_NODE_FLEX_ALGO_NODE_SID);
+                }
+            }
+        }
+    }
+
     /* config node <node-name> [no] attachbit enable*/    
     static param_t config_node_node_name_attachbit;
     init_param(&config_node_node_name_attachbit, CMD, "attachbit", 0, 0, INVALID, 0, "Set / Unset Attach bit");
@@ -2182,12 +2914,11 @@ dump_node_info(node_t *node){
     for(level = LEVEL2; level >= LEVEL1; level--){
 
         printf("%s prefixes:\n", get_str_level(level));
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(node, level), list_node){
+        ITERATE_PREFIX_STORE_BEGIN(GET_NODE_PREFIX_STORE(node, level), prefix){
             count++;
-            prefix = (prefix_t *)list_node->data;        
             printf("%s/%u%s(%s)     ", prefix->prefix, prefix->mask, IS_BIT_SET(prefix->prefix_flags, PREFIX_DOWNBIT_FLAG) ? "*": "", prefix->hosting_node->node_name);
             if(count % 5 == 0) printf("\n");
-        }ITERATE_LIST_END;
+        } ITERATE_PREFIX_STORE_END;
         printf("\n"); 
     }
 
@@ -31,6 +31,8 @@
  */
 
 #include <arpa/inet.h>
+#include <unistd.h>
+#include <sys/time.h>
 #include "spfutil.h"
 #include "bitsop.h"
 #include "Queue.h"
@@ -126,6 +128,112 @@ union_nh_list2(internal_nh_t *src_nh_list, internal_nh_t *dst_nh_list){
 }
 
 
+/*UCMP : Nexthops in nh_list reach the destination through link of
+ * bandwidth link_bw, path bottleneck bandwidth can only shrink*/
+void
+ucmp_clamp_nh_list2(internal_nh_t *nh_list, float link_bw){
+
+    unsigned int i = 0;
+
+    for(; i < MAX_NXT_HOPS; i++){
+        if(is_nh_list_empty2(&nh_list[i]))
+            continue;
+        if(nh_list[i].ucmp_bw > link_bw)
+            nh_list[i].ucmp_bw = link_bw;
+    }
+}
+
+/*union_nh_list2() which also merges the bandwidth of equal cost paths. If
+ * a nexthop is already present, destination is reachable through it over
+ * one more path, nexthop keeps the bandwidth of the widest path*/
+void
+ucmp_union_nh_list2(internal_nh_t *src_nh_list, internal_nh_t *dst_nh_list,
+                    float link_bw){
+
+    unsigned int i = 0, j = 0;
+    float bw = 0;
+    boolean present[MAX_NXT_HOPS];
+
+    for(i = 0; i < MAX_NXT_HOPS; i++)
+        present[i] = !is_nh_list_empty2(&dst_nh_list[i]);
+
+    for(j = 0; j < MAX_NXT_HOPS; j++){
+        if(is_nh_list_empty2(&src_nh_list[j]))
+            break;
+        bw = src_nh_list[j].ucmp_bw < link_bw ? src_nh_list[j].ucmp_bw : link_bw;
+        for(i = 0; i < MAX_NXT_HOPS; i++){
+            if(!present[i] || !is_internal_nh_t_equal(dst_nh_list[i], src_nh_list[j]))
+                continue;
+            if(dst_nh_list[i].ucmp_bw < bw)
+                dst_nh_list[i].ucmp_bw = bw;
+            break;
+        }
+    }
+
+    union_nh_list2(src_nh_list, dst_nh_list);
+
+    /*Nexthops newly added from src_nh_list*/
+    for(i = 0; i < MAX_NXT_HOPS; i++){
+        if(present[i] || is_nh_list_empty2(&dst_nh_list[i]))
+            continue;
+        if(dst_nh_list[i].ucmp_bw > link_bw)
+            dst_nh_list[i].ucmp_bw = link_bw;
+    }
+}
+
+/*Normalize the bandwidths of count UCMP nexthops into integer bucket
+ * counts. Smallest bucket total (atmost UCMP_MAX_BUCKETS) which best
+ * approximates the bandwidth ratio is chosen, so that 3:0.5 Gig maps to
+ * 6:1 and equal bandwidths map to 1 bucket each. Every nexthop gets
+ * atleast 1 bucket*/
+void
+ucmp_nh_buckets(internal_nh_t *nh_array, unsigned int count,
+                unsigned int *buckets){
+
+    unsigned int i = 0, total = 0, sum = 0;
+    unsigned int trial[MAX_NXT_HOPS];
+    float total_bw = 0, err = 0, max_err = 0, best_err = 2;
+
+    assert(count <= MAX_NXT_HOPS);
+
+    for(i = 0; i < count; i++){
+        buckets[i] = 1;
+        if(nh_array[i].ucmp_bw > 0)
+            total_bw += nh_array[i].ucmp_bw;
+    }
+
+    if(total_bw <= 0)
+        return;
+
+    for(total = count; total <= UCMP_MAX_BUCKETS; total++){
+
+        sum = 0;
+        for(i = 0; i < count; i++){
+            trial[i] = nh_array[i].ucmp_bw <= 0 ? 0 :
+                (unsigned int)(nh_array[i].ucmp_bw * total / total_bw + 0.5);
+            if(!trial[i])
+                trial[i] = 1;
+            sum += trial[i];
+        }
+
+        max_err = 0;
+        for(i = 0; i < count; i++){
+            err = (float)trial[i] / sum -
+                  (nh_array[i].ucmp_bw > 0 ? nh_array[i].ucmp_bw / total_bw : 0);
+            if(err < 0)
+                err = -err;
+            if(err > max_err)
+                max_err = err;
+        }
+
+        /*Larger tables must be noticeably more accurate*/
+        if(max_err + UCMP_BUCKET_TOLERANCE >= best_err)
+            continue;
+        best_err = max_err;
+        memcpy(buckets, trial, count * sizeof(unsigned int));
+    }
+}
+
 void
 union_direct_nh_list2(internal_nh_t *src_direct_nh_list, internal_nh_t *dst_nh_list){
 
@@ -432,3 +540,22 @@ hash_code(void *ptr, unsigned int size){
     return value;
 }
 
+unsigned int
+get_worker_count(unsigned int n_work, unsigned int max_workers){
+
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if(n_cpus < 2 || n_work < 2)
+        return 1;
+    if(n_cpus > max_workers)
+        n_cpus = max_workers;
+    return n_work < n_cpus ? n_work : (unsigned int)n_cpus;
+}
+
+unsigned long long
+get_time_usec(){
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (unsigned long long)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
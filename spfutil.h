@@ -59,6 +59,17 @@ get_str_level(LEVEL level);
 void
 union_nh_list2(internal_nh_t *src_nh_list, internal_nh_t *dst_nh_list);
 
+void
+ucmp_clamp_nh_list2(internal_nh_t *nh_list, float link_bw);
+
+void
+ucmp_union_nh_list2(internal_nh_t *src_nh_list, internal_nh_t *dst_nh_list,
+                    float link_bw);
+
+void
+ucmp_nh_buckets(internal_nh_t *nh_array, unsigned int count,
+                unsigned int *buckets);
+
 char*
 get_str_node_area(AREA area);
 
@@ -121,6 +132,15 @@ get_new_if_index();
 
 unsigned int
 hash_code(void *ptr, unsigned int size);
+
+/*No of threads to spread n_work independant work units over, bounded
+ * by online CPUs and max_workers. 1 means work is done in caller thread*/
+unsigned int
+get_worker_count(unsigned int n_work, unsigned int max_workers);
+
+/*Wall clock time in micro seconds, for timing stats*/
+unsigned long long
+get_time_usec();
     
 #endif /* __SPFUTIL__ */ 
 
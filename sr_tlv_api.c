@@ -36,6 +36,7 @@
 #include "spfutil.h"
 #include "bitsop.h"
 #include "glthread.h"
+#include "conflct_res.h"
 
 void
 diplay_prefix_sid(prefix_t *prefix){
@@ -224,6 +225,7 @@ update_prefix_sid(node_t *node, prefix_t *prefix,
         trigger_conflict_res = TRUE;
         mark_srgb_index_in_use(node->srgb, prefix_sid_value);
         glthread_add_next(&node->prefix_sids_thread_lst[level], &prefix_sid->glthread);
+        sr_conflict_index_update(prefix, level);
         return trigger_conflict_res;
     }
 
@@ -233,10 +235,13 @@ update_prefix_sid(node_t *node, prefix_t *prefix,
         mark_srgb_index_not_in_use(node->srgb, PREFIX_SID_INDEX(prefix));
     }
 
+    prefix_sid = get_prefix_sid(prefix);
     prefix_sid->sid.sid = prefix_sid_value;
 
-    if(trigger_conflict_res)
+    if(trigger_conflict_res){
         MARK_PREFIX_SR_ACTIVE(prefix);
+        sr_conflict_index_update(prefix, level);
+    }
 
     return trigger_conflict_res;
 }
@@ -261,6 +266,8 @@ free_prefix_sid(prefix_t *prefix){
 
     if(!prefix->psid_thread_ptr)
         return;
+    /*Prefixes which lost to this one may win now*/
+    sr_conflict_index_remove(prefix);
     /*de-associate the prefix SID and free it*/
     glthread_t *glthread = prefix->psid_thread_ptr;
     prefix->psid_thread_ptr = NULL;
@@ -30,9 +30,244 @@
  * =====================================================================================
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
 #include "srms.h"
 #include "LinkedListApi.h"
 #include "instance.h"
+#include "spfutil.h"
+
+/*Distance between two consecutive prefixes of a range*/
+static inline unsigned long long
+srms_prefix_step(char pfx_len){
+
+    return 1ULL << (32 - pfx_len);
+}
+
+static unsigned int
+srms_binary_prefix(char *prefix, char mask){
+
+    unsigned int binary_prefix = 0;
+
+    inet_pton(AF_INET, prefix, &binary_prefix);
+    binary_prefix = ntohl(binary_prefix);
+    if(mask < 32)
+        binary_prefix &= mask ? ~(0xFFFFFFFFU >> mask) : 0;
+    return binary_prefix;
+}
+
+void
+construct_srms_sid_mapping_entry(srms_sid_label_binding_tlv_t *srms_sid_label_binding_tlv,
+        sr_mapping_entry_t *mapping_entry_out){
+
+    unsigned int range = srms_sid_label_binding_tlv->range ? 
+                         srms_sid_label_binding_tlv->range : 1;
+    char mask = srms_sid_label_binding_tlv->mask;
+
+    mapping_entry_out->prf         = IGP_DEFAULT_SID_SRMS_PFX_PREFERENCE_VALUE;
+    mapping_entry_out->pi          = srms_binary_prefix(srms_sid_label_binding_tlv->fec_prefix, mask);
+    mapping_entry_out->pe          = (unsigned int)(mapping_entry_out->pi + 
+                                        (range - 1) * srms_prefix_step(mask));
+    mapping_entry_out->pfx_len     = mask;
+    mapping_entry_out->max_pfx_len = 32;
+    mapping_entry_out->si          = srms_sid_label_binding_tlv->prefix_sid.sid.sid;
+    mapping_entry_out->se          = mapping_entry_out->si + range - 1;
+    mapping_entry_out->range_value = range;
+    mapping_entry_out->algorithm   = srms_sid_label_binding_tlv->prefix_sid.algorithm;
+    mapping_entry_out->topology    = 0;
+}
+
+static boolean
+is_srms_policy_valid(srms_sid_label_binding_tlv_t *srms_local_policy){
+
+    unsigned long long pe = 0;
+    unsigned int range = srms_local_policy->range;
+
+    if(srms_local_policy->mask < 0 || srms_local_policy->mask > 32 || !range)
+        return FALSE;
+
+    pe = srms_binary_prefix(srms_local_policy->fec_prefix, srms_local_policy->mask) + 
+         (range - 1) * srms_prefix_step(srms_local_policy->mask);
+    if(pe > 0xFFFFFFFFULL)
+        return FALSE;
+    if(srms_local_policy->prefix_sid.sid.sid > 0xFFFFFFFF - (range - 1))
+        return FALSE;
+    return TRUE;
+}
+
+srms_ranges_comparison_result_t
+srms_mapping_entries_comparison(sr_mapping_entry_t *mapping_entry1,
+                                sr_mapping_entry_t *mapping_entry2){
+
+    long long pfx_offset = 0, sid_offset = 0;
+
+    if(mapping_entry1->topology  == mapping_entry2->topology  &&
+       mapping_entry1->algorithm == mapping_entry2->algorithm &&
+       mapping_entry1->pfx_len   == mapping_entry2->pfx_len   &&
+       mapping_entry1->pi <= mapping_entry2->pe && mapping_entry2->pi <= mapping_entry1->pe){
+
+        if(mapping_entry1->pi == mapping_entry2->pi && 
+           mapping_entry1->pe == mapping_entry2->pe &&
+           mapping_entry1->si == mapping_entry2->si)
+            return SRMS_RANGES_IDENTICAL;
+
+        /*Overlapping ranges are not conflicting if common prefixes are
+         * mapped to same SIDs*/
+        pfx_offset = ((long long)mapping_entry1->pi - (long long)mapping_entry2->pi) / 
+                        (long long)srms_prefix_step(mapping_entry1->pfx_len);
+        sid_offset = (long long)mapping_entry1->si - (long long)mapping_entry2->si;
+        return pfx_offset == sid_offset ? SRMS_RANGES_OVERLAPPING : 
+                                          SRMS_RANGES_PREFIX_CONFLICT;
+    }
+
+    /*Different prefixes mapped to same SID*/
+    if(mapping_entry1->si <= mapping_entry2->se && mapping_entry2->si <= mapping_entry1->se)
+        return SRMS_RANGES_SID_CONFLICT;
+
+    return SRMS_RANGES_NON_OVERLAPPING;
+}
+
+srms_ranges_comparison_result_t
+srms_ranges_comparison(srms_sid_label_binding_tlv_t *srms_local_policy1,
+                       srms_sid_label_binding_tlv_t *srms_local_policy2){
+
+    sr_mapping_entry_t mapping_entry1, 
+                       mapping_entry2;
+
+    construct_srms_sid_mapping_entry(srms_local_policy1, &mapping_entry1);
+    construct_srms_sid_mapping_entry(srms_local_policy2, &mapping_entry2);
+    return srms_mapping_entries_comparison(&mapping_entry1, &mapping_entry2);
+}
+
+/*
++-------------------------------------------------+
+|Sorted mapping range array                       |
++-------------------------------------------------+
+*/
+
+static inline boolean
+is_srms_same_range_group(sr_mapping_entry_t *mapping_entry1,
+                         sr_mapping_entry_t *mapping_entry2){
+
+    return (mapping_entry1->topology  == mapping_entry2->topology  &&
+            mapping_entry1->algorithm == mapping_entry2->algorithm &&
+            mapping_entry1->pfx_len   == mapping_entry2->pfx_len) ? TRUE : FALSE;
+}
+
+static int
+srms_mapping_entry_key_cmp(sr_mapping_entry_t *mapping_entry1,
+                           sr_mapping_entry_t *mapping_entry2){
+
+    if(mapping_entry1->topology != mapping_entry2->topology)
+        return mapping_entry1->topology < mapping_entry2->topology ? -1 : 1;
+    if(mapping_entry1->algorithm != mapping_entry2->algorithm)
+        return mapping_entry1->algorithm < mapping_entry2->algorithm ? -1 : 1;
+    if(mapping_entry1->pfx_len != mapping_entry2->pfx_len)
+        return mapping_entry1->pfx_len < mapping_entry2->pfx_len ? -1 : 1;
+    if(mapping_entry1->pi != mapping_entry2->pi)
+        return mapping_entry1->pi < mapping_entry2->pi ? -1 : 1;
+    if(mapping_entry1->si != mapping_entry2->si)
+        return mapping_entry1->si < mapping_entry2->si ? -1 : 1;
+    return 0;
+}
+
+static int
+srms_mapping_range_qsort_cmp(const void *range1, const void *range2){
+
+    return srms_mapping_entry_key_cmp(
+            &((srms_mapping_range_t *)range1)->mapping_entry,
+            &((srms_mapping_range_t *)range2)->mapping_entry);
+}
+
+/*Index of first range not less than key if upper is FALSE, 
+ * else of first range greater than key*/
+static unsigned int
+srms_mapping_db_bound(srms_mapping_db_t *db, sr_mapping_entry_t *key, 
+                      boolean upper){
+
+    unsigned int low = 0, high = db->count, mid = 0;
+    int rc = 0;
+
+    while(low < high){
+        mid = low + (high - low) / 2;
+        rc = srms_mapping_entry_key_cmp(&db->ranges[mid].mapping_entry, key);
+        if(rc < 0 || (upper && rc == 0))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+static void
+srms_mapping_db_reserve(srms_mapping_db_t *db, unsigned int count){
+
+    if(count <= db->size)
+        return;
+    db->size = db->size ? db->size : 16;
+    while(db->size < count)
+        db->size <<= 1;
+    db->ranges = realloc(db->ranges, db->size * sizeof(srms_mapping_range_t));
+}
+
+static void
+srms_mapping_db_free(srms_mapping_db_t *db){
+
+    free(db->ranges);
+    memset(db, 0, sizeof(srms_mapping_db_t));
+}
+
+/*Sort the ranges and compute running max_pe within every group of
+ * ranges of same prefix length*/
+static void
+srms_mapping_db_sort(srms_mapping_db_t *db){
+
+    unsigned int i = 0;
+    srms_mapping_range_t *range = NULL;
+
+    qsort(db->ranges, db->count, sizeof(srms_mapping_range_t), 
+          srms_mapping_range_qsort_cmp);
+
+    for(i = 0; i < db->count; i++){
+        range = &db->ranges[i];
+        range->max_pe = range->mapping_entry.pe;
+        if(i && is_srms_same_range_group(&db->ranges[i - 1].mapping_entry, 
+                                          &range->mapping_entry) &&
+           db->ranges[i - 1].max_pe > range->max_pe)
+            range->max_pe = db->ranges[i - 1].max_pe;
+    }
+}
+
+static void
+srms_mapping_db_append(srms_mapping_db_t *db, srms_mapping_range_t *range){
+
+    srms_mapping_db_reserve(db, db->count + 1);
+    memcpy(&db->ranges[db->count], range, sizeof(srms_mapping_range_t));
+    db->count++;
+}
+
+/*
++-------------------------------------------------+
+|Mapping server local policies                    |
++-------------------------------------------------+
+*/
+
+static unsigned int
+srms_sid_span_bound(srms_lcl_policy_db_t *lcl_db, unsigned int si){
+
+    unsigned int low = 0, high = lcl_db->db.count, mid = 0;
+
+    while(low < high){
+        mid = low + (high - low) / 2;
+        if(lcl_db->sid_spans[mid].si < si)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
 
 /*Return true if the new policy being configured by the
  *  administrator do not create any conflict with already
@@ -49,26 +284,419 @@
  *  more than one SRMS. This fn prevents the admin from configuring
  *  undesirable local policy on a Mapping server*/
 
+/*Local policies are mutually disjoint, so only the neighbors of the new
+ * policy in prefix order and in SID order need to be checked*/
 boolean
 srms_local_policy_configuration_verifier(node_t *node,
                                          LEVEL level ,
                                          srms_sid_label_binding_tlv_t *srms_local_policy){
 
+    unsigned int index = 0;
+    sr_mapping_entry_t mapping_entry;
+    srms_lcl_policy_db_t *lcl_db = &node->srms_lcl_policy_db;
+    srms_mapping_range_t *nbr_range = NULL;
+
+    if(!is_srms_policy_valid(srms_local_policy)){
+        printf("Error : Invalid mapping range %s/%d, range %u\n", 
+            srms_local_policy->fec_prefix, srms_local_policy->mask, 
+            srms_local_policy->range);
+        return FALSE;
+    }
+
+    construct_srms_sid_mapping_entry(srms_local_policy, &mapping_entry);
+
+    index = srms_mapping_db_bound(&lcl_db->db, &mapping_entry, FALSE);
+    if(index > 0){
+        nbr_range = &lcl_db->db.ranges[index - 1];
+        if(srms_mapping_entries_comparison(&nbr_range->mapping_entry, 
+                    &mapping_entry) != SRMS_RANGES_NON_OVERLAPPING)
+            goto overlap;
+    }
+    if(index < lcl_db->db.count){
+        nbr_range = &lcl_db->db.ranges[index];
+        if(srms_mapping_entries_comparison(&nbr_range->mapping_entry, 
+                    &mapping_entry) != SRMS_RANGES_NON_OVERLAPPING)
+            goto overlap;
+    }
+
+    index = srms_sid_span_bound(lcl_db, mapping_entry.si);
+    if((index > 0 && lcl_db->sid_spans[index - 1].se >= mapping_entry.si) ||
+       (index < lcl_db->db.count && lcl_db->sid_spans[index].si <= mapping_entry.se)){
+        printf("Error : SID range [%u-%u] overlaps with existing mapping server local policy\n",
+            mapping_entry.si, mapping_entry.se);
+        return FALSE;
+    }
+    return TRUE;
+
+    overlap:
+    printf("Error : Mapping range %s/%d, range %u overlaps with existing mapping server local policy\n",
+        srms_local_policy->fec_prefix, srms_local_policy->mask, srms_local_policy->range);
     return FALSE;
 }
 
-/*To be called by SRMS clients only to choose one between the two SRMS ranges which
- * overlaps. The selected one is added to active_mapping_policy list, and rejected one
- * is added to backup_mapping_policy on SRMS client node*/
+boolean
+srms_add_local_policy(node_t *node, srms_sid_label_binding_tlv_t *srms_local_policy){
+
+    unsigned int index = 0;
+    srms_lcl_policy_db_t *lcl_db = &node->srms_lcl_policy_db;
+    srms_mapping_range_t *range = NULL;
+
+    if(!srms_local_policy_configuration_verifier(node, LEVEL1, srms_local_policy))
+        return FALSE;
+
+    if(lcl_db->db.count == lcl_db->db.size){
+        srms_mapping_db_reserve(&lcl_db->db, lcl_db->db.count + 1);
+        lcl_db->sid_spans = realloc(lcl_db->sid_spans, 
+                                lcl_db->db.size * sizeof(srms_sid_span_t));
+    }
+
+    sr_mapping_entry_t mapping_entry;
+    construct_srms_sid_mapping_entry(srms_local_policy, &mapping_entry);
+
+    index = srms_mapping_db_bound(&lcl_db->db, &mapping_entry, FALSE);
+    memmove(&lcl_db->db.ranges[index + 1], &lcl_db->db.ranges[index], 
+            (lcl_db->db.count - index) * sizeof(srms_mapping_range_t));
+    range = &lcl_db->db.ranges[index];
+    memset(range, 0, sizeof(srms_mapping_range_t));
+    range->mapping_entry = mapping_entry;
+    range->max_pe = mapping_entry.pe; /*Ranges are disjoint*/
+    range->srms_node = node;
+
+    index = srms_sid_span_bound(lcl_db, mapping_entry.si);
+    memmove(&lcl_db->sid_spans[index + 1], &lcl_db->sid_spans[index], 
+            (lcl_db->db.count - index) * sizeof(srms_sid_span_t));
+    lcl_db->sid_spans[index].si = mapping_entry.si;
+    lcl_db->sid_spans[index].se = mapping_entry.se;
+
+    lcl_db->db.count++;
+    return TRUE;
+}
+
+boolean
+srms_delete_local_policy(node_t *node, srms_sid_label_binding_tlv_t *srms_local_policy){
+
+    unsigned int index = 0;
+    sr_mapping_entry_t mapping_entry;
+    srms_lcl_policy_db_t *lcl_db = &node->srms_lcl_policy_db;
+
+    construct_srms_sid_mapping_entry(srms_local_policy, &mapping_entry);
+
+    index = srms_mapping_db_bound(&lcl_db->db, &mapping_entry, FALSE);
+    if(index == lcl_db->db.count || 
+       srms_mapping_entries_comparison(&lcl_db->db.ranges[index].mapping_entry, 
+           &mapping_entry) != SRMS_RANGES_IDENTICAL){
+        printf("Error : Mapping server local policy %s/%d, range %u do not exist\n",
+            srms_local_policy->fec_prefix, srms_local_policy->mask, srms_local_policy->range);
+        return FALSE;
+    }
+
+    memmove(&lcl_db->db.ranges[index], &lcl_db->db.ranges[index + 1], 
+            (lcl_db->db.count - index - 1) * sizeof(srms_mapping_range_t));
+
+    index = srms_sid_span_bound(lcl_db, mapping_entry.si);
+    memmove(&lcl_db->sid_spans[index], &lcl_db->sid_spans[index + 1], 
+            (lcl_db->db.count - index - 1) * sizeof(srms_sid_span_t));
+
+    lcl_db->db.count--;
+    return TRUE;
+}
+
+/*
++-------------------------------------------------+
+|Mapping client                                   |
++-------------------------------------------------+
+*/
+
+/*Order in which ranges are considered for selection, most preferred
+ * first*/
+static int
+srms_mapping_range_preference_cmp(const void *range_ptr1, const void *range_ptr2){
+
+    srms_mapping_range_t *range1 = *(srms_mapping_range_t **)range_ptr1,
+                         *range2 = *(srms_mapping_range_t **)range_ptr2;
+    sr_mapping_entry_t *mapping_entry1 = &range1->mapping_entry,
+                       *mapping_entry2 = &range2->mapping_entry;
+
+    if(mapping_entry1->prf != mapping_entry2->prf)
+        return mapping_entry1->prf > mapping_entry2->prf ? -1 : 1;
+
+    if(mapping_entry1->range_value != mapping_entry2->range_value)
+        return mapping_entry1->range_value < mapping_entry2->range_value ? -1 : 1;
+
+    if(mapping_entry1->pfx_len != mapping_entry2->pfx_len)
+        return mapping_entry1->pfx_len > mapping_entry2->pfx_len ? -1 : 1;
+
+    if(mapping_entry1->pi != mapping_entry2->pi)
+        return mapping_entry1->pi < mapping_entry2->pi ? -1 : 1;
+
+    if(mapping_entry1->si != mapping_entry2->si)
+        return mapping_entry1->si < mapping_entry2->si ? -1 : 1;
+
+    /*Keep the order of collection for determinism*/
+    return range1 < range2 ? -1 : (range1 > range2 ? 1 : 0);
+}
+
+typedef struct srms_selection_ctxt_{
+
+    srms_mapping_range_t *candidate;
+    boolean rejected;
+} srms_selection_ctxt_t;
+
+static void
+srms_pfx_range_overlap_fn(itree_node_t *itree_node, void *arg){
+
+    srms_selection_ctxt_t *ctxt = arg;
+    srms_mapping_range_t *selected = itree_to_srms_pfx_range(itree_node);
+
+    if(ctxt->rejected)
+        return;
+
+    switch(srms_mapping_entries_comparison(&selected->mapping_entry,
+                &ctxt->candidate->mapping_entry)){
+        case SRMS_RANGES_IDENTICAL:
+        case SRMS_RANGES_PREFIX_CONFLICT:
+        case SRMS_RANGES_SID_CONFLICT:
+            ctxt->rejected = TRUE;
+            break;
+        default:
+            ;
+    }
+}
+
+static void
+srms_sid_range_overlap_fn(itree_node_t *itree_node, void *arg){
+
+    srms_selection_ctxt_t *ctxt = arg;
+    srms_mapping_range_t *selected = itree_to_srms_sid_range(itree_node);
+
+    if(ctxt->rejected)
+        return;
+
+    switch(srms_mapping_entries_comparison(&selected->mapping_entry,
+                &ctxt->candidate->mapping_entry)){
+        case SRMS_RANGES_IDENTICAL:
+        case SRMS_RANGES_PREFIX_CONFLICT:
+        case SRMS_RANGES_SID_CONFLICT:
+            ctxt->rejected = TRUE;
+            break;
+        default:
+            ;
+    }
+}
+
+/*Ranges are considered in order of preference. A range is selected
+ * (active) if it neither prefix-conflicts nor SID-conflicts with any
+ * range selected so far, else it is kept as backup. Selected ranges are
+ * indexed on prefix and on SID interval, so that a candidate is compared
+ * only with the selected ranges it overlaps*/
 void
-srmc_advertised_srms_overlapping_local_policy_selection(srms_sid_label_binding_tlv_t *srms_local_policy1,
-                        srms_sid_label_binding_tlv_t *srms_local_policy2){
+srmc_compute_active_mapping_policy(node_t *node, LEVEL level){
+
+    unsigned int n_ranges = 0, i = 0, j = 0;
+    singly_ll_node_t *list_node = NULL;
+    spf_result_t *res = NULL;
+    srms_mapping_db_t *active = &node->active_mapping_policy[level],
+                      *backup = &node->backup_mapping_policy[level],
+                      *lcl_db = NULL;
+    srms_mapping_range_t *candidates = NULL,
+                         **preference_order = NULL,
+                         *candidate = NULL;
+    itree_t pfx_range_index, sid_range_index;
+    srms_selection_ctxt_t ctxt;
+    node_t **srms_nodes = NULL;
+    unsigned int n_srms_nodes = 0, n_spf_results = 0, k = 0;
+
+    active->count = 0;
+    backup->count = 0;
 
+    if(!node->am_i_mapping_client)
+        return;
 
+    /*Mapping servers reachable in this level, a node may be present more
+     * than once in spf result*/
+    ITERATE_LIST_BEGIN(node->spf_run_result[level], list_node){
+        n_spf_results++;
+    } ITERATE_LIST_END;
+
+    srms_nodes = calloc(n_spf_results ? n_spf_results : 1, sizeof(node_t *));
+
+    ITERATE_LIST_BEGIN(node->spf_run_result[level], list_node){
+        res = list_node->data;
+        if(!res->node->am_i_mapping_server || 
+           !res->node->srms_lcl_policy_db.db.count)
+            continue;
+        for(j = 0; j < n_srms_nodes; j++){
+            if(srms_nodes[j] == res->node)
+                break;
+        }
+        if(j < n_srms_nodes)
+            continue;
+        srms_nodes[n_srms_nodes++] = res->node;
+        n_ranges += res->node->srms_lcl_policy_db.db.count;
+    } ITERATE_LIST_END;
+
+    if(!n_ranges){
+        free(srms_nodes);
+        return;
+    }
+
+    candidates = calloc(n_ranges, sizeof(srms_mapping_range_t));
+    preference_order = calloc(n_ranges, sizeof(srms_mapping_range_t *));
+
+    for(k = 0; k < n_srms_nodes; k++){
+        lcl_db = &srms_nodes[k]->srms_lcl_policy_db.db;
+        for(j = 0; j < lcl_db->count; j++, i++){
+            candidates[i].mapping_entry = lcl_db->ranges[j].mapping_entry;
+            candidates[i].srms_node = srms_nodes[k];
+            preference_order[i] = &candidates[i];
+        }
+    }
+    free(srms_nodes);
+
+    qsort(preference_order, n_ranges, sizeof(srms_mapping_range_t *),
+          srms_mapping_range_preference_cmp);
+
+    itree_init(&pfx_range_index);
+    itree_init(&sid_range_index);
+
+    for(i = 0; i < n_ranges; i++){
+        candidate = preference_order[i];
+        ctxt.candidate = candidate;
+        ctxt.rejected = FALSE;
+
+        itree_overlap_walk(&pfx_range_index, candidate->mapping_entry.pi, 
+                candidate->mapping_entry.pe, srms_pfx_range_overlap_fn, &ctxt);
+        if(!ctxt.rejected)
+            itree_overlap_walk(&sid_range_index, candidate->mapping_entry.si, 
+                candidate->mapping_entry.se, srms_sid_range_overlap_fn, &ctxt);
+
+        if(ctxt.rejected){
+            srms_mapping_db_append(backup, candidate);
+            continue;
+        }
+
+        candidate->pfx_range_node.low  = candidate->mapping_entry.pi;
+        candidate->pfx_range_node.high = candidate->mapping_entry.pe;
+        itree_insert(&pfx_range_index, &candidate->pfx_range_node);
+        candidate->sid_range_node.low  = candidate->mapping_entry.si;
+        candidate->sid_range_node.high = candidate->mapping_entry.se;
+        itree_insert(&sid_range_index, &candidate->sid_range_node);
+        srms_mapping_db_append(active, candidate);
+    }
+
+    /*Copies in db carry stale tree linkage, which is never used*/
+    srms_mapping_db_sort(active);
+    srms_mapping_db_sort(backup);
+
+    free(preference_order);
+    free(candidates);
+}
+
+/*Active ranges of a prefix length may overlap (consistently), so walk
+ * back from the last range starting at or before the prefix as long as
+ * some range upto there extends upto the prefix*/
+srms_mapping_range_t *
+srmc_lookup_prefix_sid_mapping(node_t *node, LEVEL level, char *prefix, 
+                               char mask, unsigned int *sid_index){
+
+    unsigned int index = 0;
+    sr_mapping_entry_t key;
+    srms_mapping_range_t *range = NULL;
+    srms_mapping_db_t *active = &node->active_mapping_policy[level];
+
+    if(mask < 0 || mask > 32)
+        return NULL;
+
+    memset(&key, 0, sizeof(sr_mapping_entry_t));
+    key.pfx_len = mask;
+    key.pi = srms_binary_prefix(prefix, mask);
+    key.si = 0xFFFFFFFF;
+
+    index = srms_mapping_db_bound(active, &key, TRUE);
+    while(index > 0){
+        range = &active->ranges[--index];
+        if(!is_srms_same_range_group(&range->mapping_entry, &key) ||
+            range->max_pe < key.pi)
+            break;
+        if(range->mapping_entry.pi <= key.pi && key.pi <= range->mapping_entry.pe){
+            *sid_index = range->mapping_entry.si + (unsigned int)
+                ((key.pi - range->mapping_entry.pi) / srms_prefix_step(mask));
+            return range;
+        }
+    }
+    return NULL;
 }
 
 void
-clean_srms_mapping_cached_policies(node_t *node, LEVEL level){
-    delete_singly_ll(node->active_mapping_policy[level]);
-    delete_singly_ll(node->backup_mapping_policy[level]);
+srmc_clean_srms_mapping_cached_policies(node_t *node, LEVEL level){
+
+    srms_mapping_db_free(&node->active_mapping_policy[level]);
+    srms_mapping_db_free(&node->backup_mapping_policy[level]);
+}
+
+/*
++-------------------------------------------------+
+|Show functions                                   |
++-------------------------------------------------+
+*/
+
+static void
+print_srms_mapping_range(srms_mapping_range_t *range, boolean print_srms){
+
+    char prefix[PREFIX_LEN + 1];
+    unsigned int binary_prefix = htonl(range->mapping_entry.pi);
+
+    inet_ntop(AF_INET, &binary_prefix, prefix, PREFIX_LEN + 1);
+    printf("\t%s/%d range %u SID [%u-%u] prf %u", prefix, 
+        range->mapping_entry.pfx_len, range->mapping_entry.range_value, 
+        range->mapping_entry.si, range->mapping_entry.se, 
+        range->mapping_entry.prf);
+    if(print_srms)
+        printf(" SRMS %s", range->srms_node->node_name);
+    printf("\n");
+}
+
+void
+show_srms_local_policy(node_t *node){
+
+    unsigned int i = 0;
+    srms_mapping_db_t *db = &node->srms_lcl_policy_db.db;
+
+    printf("Node : %s, Mapping server : %s, Local policies : %u\n", 
+        node->node_name, node->am_i_mapping_server ? "Advertise" : "No advertise", 
+        db->count);
+    for(i = 0; i < db->count; i++)
+        print_srms_mapping_range(&db->ranges[i], FALSE);
+}
+
+void
+show_srmc_mapping_policy(node_t *node, boolean active, char *prefix, char mask){
+
+    LEVEL level_it;
+    unsigned int i = 0, sid_index = 0;
+    srms_mapping_db_t *db = NULL;
+    srms_mapping_range_t *range = NULL;
+
+    printf("Node : %s, Mapping client : %s\n", node->node_name, 
+        node->am_i_mapping_client ? "Yes" : "No");
+
+    for(level_it = LEVEL1; level_it <= LEVEL2; level_it++){
+        if(prefix){
+            range = srmc_lookup_prefix_sid_mapping(node, level_it, 
+                        prefix, mask, &sid_index);
+            if(range){
+                printf("%s : %s/%d SID %u\n", get_str_level(level_it), prefix, mask, sid_index);
+                print_srms_mapping_range(range, TRUE);
+            }
+            else
+                printf("%s : %s/%d no mapping\n", get_str_level(level_it), prefix, mask);
+            continue;
+        }
+        db = active ? &node->active_mapping_policy[level_it] :
+                      &node->backup_mapping_policy[level_it];
+        printf("%s : %s ranges : %u\n", get_str_level(level_it), 
+            active ? "Active" : "Backup", db->count);
+        for(i = 0; i < db->count; i++)
+            print_srms_mapping_range(&db->ranges[i], TRUE);
+    }
 }
@@ -34,6 +34,7 @@
 #define __MAPPINGSERVER__
 
 #include "igp_sr_ext.h"
+#include "Tree/interval_tree.h"
 
 typedef struct _node_t node_t;
 
@@ -46,6 +47,8 @@ init_mapping_server(node_t *node, LEVEL level);
 /*Mapping server SID/LABEL Binding TLV*/
 /*TLV used by mapping server to advertise prefix-sid ranges*/
 
+#define SRMS_SID_LABEL_BINDING_TLV_TYPE 149
+
 typedef struct srms_sid_label_binding_tlv_{
 
     BYTE type; /*constant = 149*/
@@ -55,8 +58,7 @@ typedef struct srms_sid_label_binding_tlv_{
     BYTE weight;
     unsigned short int range;
     char mask;
-    char fec_prefix;
-    unsigned int fec_prefix2;
+    char fec_prefix[PREFIX_LEN + 1];
     prefix_sid_subtlv_t prefix_sid; 
 } srms_sid_label_binding_tlv_t;
 
@@ -73,6 +75,47 @@ GLTHREAD_TO_STRUCT(glthread_to_srms_sid_lbl_binding_tlv, \
 /*Flags used for prefix_sid_subtlv_t*/
 #define SRMS_SUBTLV_NODE_SID_FLAG  6
 
+/*One mapping range, [pi, pe] prefixes of length pfx_len are mapped to
+ * SIDs [si, se]*/
+typedef struct srms_mapping_range_{
+
+    sr_mapping_entry_t mapping_entry;
+    unsigned int max_pe;    /*Max pe of the ranges of same prefix length upto this one, 
+                              in sorted order. Lets lookup skip back over ranges which 
+                              can not cover the prefix*/
+    node_t *srms_node;      /*Mapping server advertising the range*/
+    /*Used only while active mapping policy is being computed*/
+    itree_node_t pfx_range_node;
+    itree_node_t sid_range_node;
+} srms_mapping_range_t;
+
+ITREE_NODE_TO_STRUCT(itree_to_srms_pfx_range, srms_mapping_range_t, pfx_range_node);
+ITREE_NODE_TO_STRUCT(itree_to_srms_sid_range, srms_mapping_range_t, sid_range_node);
+
+/*Flat array of ranges sorted on (topology, algorithm, pfx_len, pi, si)*/
+typedef struct srms_mapping_db_{
+
+    unsigned int count;
+    unsigned int size;
+    srms_mapping_range_t *ranges;
+} srms_mapping_db_t;
+
+/*SID range of a local policy*/
+typedef struct srms_sid_span_{
+
+    unsigned int si;
+    unsigned int se;
+} srms_sid_span_t;
+
+/*Mapping server local policies do not overlap, neither in prefixes nor in
+ * SIDs. Ranges are sorted on prefix, and SID spans on si, so that a new
+ * policy needs to be checked only against its neighbors in either array*/
+typedef struct srms_lcl_policy_db_{
+
+    srms_mapping_db_t db;
+    srms_sid_span_t *sid_spans;
+} srms_lcl_policy_db_t;
+
 void
 construct_srms_sid_mapping_entry(srms_sid_label_binding_tlv_t *srms_sid_label_binding_tlv,
     sr_mapping_entry_t *mapping_entry_out);
@@ -96,14 +139,35 @@ srms_ranges_comparison_result_t
 srms_ranges_comparison(srms_sid_label_binding_tlv_t *srms_local_policy1,
                        srms_sid_label_binding_tlv_t *srms_local_policy2);
 
-#define ADD_SRMS_LCL_POLICY_TO_ACTIVE_MAPPING(nodeptr, _level, srms_sid_label_binding_tlv_t_ptr) \
-    singly_ll_add_node_by_val(nodeptr->active_mapping_policy[_level], srms_sid_label_binding_tlv_t_ptr)
-    
-#define ADD_SRMS_LCL_POLICY_TO_BACKUP_MAPPING(nodeptr, _level, srms_sid_label_binding_tlv_t_ptr) \
-    singly_ll_add_node_by_val(nodeptr->backup_mapping_policy[_level], srms_sid_label_binding_tlv_t_ptr)
-     
+srms_ranges_comparison_result_t
+srms_mapping_entries_comparison(sr_mapping_entry_t *mapping_entry1,
+                                sr_mapping_entry_t *mapping_entry2);
+
+/*Mapping server local policy config, returns TRUE on success*/
+boolean
+srms_add_local_policy(node_t *node, srms_sid_label_binding_tlv_t *srms_local_policy);
+
+boolean
+srms_delete_local_policy(node_t *node, srms_sid_label_binding_tlv_t *srms_local_policy);
+
+/*Mapping client : select the active and backup mapping ranges out of the
+ * ranges advertised by all mapping servers reachable in level*/
+void
+srmc_compute_active_mapping_policy(node_t *node, LEVEL level);
+
+/*Mapping client : returns the active range mapping prefix/mask, NULL if none.
+ * sid_index is the SID mapped to the prefix*/
+srms_mapping_range_t *
+srmc_lookup_prefix_sid_mapping(node_t *node, LEVEL level, char *prefix, 
+                               char mask, unsigned int *sid_index);
+
 void
 srmc_clean_srms_mapping_cached_policies(node_t *node, LEVEL level);
 
+void
+show_srms_local_policy(node_t *node);
+
+void
+show_srmc_mapping_policy(node_t *node, boolean active, char *prefix, char mask);
 
 #endif /* __MAPPINGSERVER__ */
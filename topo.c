@@ -1234,7 +1234,7 @@ config_dynamic_topology(param_t *param,
             }
 
             if(prefix){
-                delete_prefix_from_prefix_list(node1->local_prefix_list[LEVEL1], 
+                delete_prefix_from_prefix_store(node1->local_prefix_store[LEVEL1], 
                         prefix->prefix, prefix->mask);
             }
 
@@ -1257,7 +1257,7 @@ config_dynamic_topology(param_t *param,
             clone_prefix->hosting_node = node1;
             set_prefix_property_metric(clone_prefix, DEFAULT_LOCAL_PREFIX_METRIC);
 
-            assert(add_prefix_to_prefix_list(node1->local_prefix_list[LEVEL1], 
+            assert(add_prefix_to_prefix_store(node1->local_prefix_store[LEVEL1], 
                         clone_prefix, 0));
 
             edge_end = &inv_edge->to;